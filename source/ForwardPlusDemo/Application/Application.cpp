@@ -2,12 +2,29 @@
 
 #include <ForwardPlusDemo/GraphicsAPI/GraphicsAPI.hpp>
 #include <ForwardPlusDemo/Render/RenderSystem.hpp>
+#include <ForwardPlusDemo/Render/VertexFormat.hpp>
+
+#include <ForwardPlusDemo/Scene/CameraPath.hpp>
+#include <ForwardPlusDemo/Scene/ScenarioGenerator.hpp>
+
+#include <ForwardPlusDemo/Utilities/Fence.hpp>
+#include <ForwardPlusDemo/Utilities/FrameScheduler.hpp>
+#include <ForwardPlusDemo/Utilities/Profiler.hpp>
+
+#include <timeapi.h>
 
 #include <array>
+#include <charconv>
 #include <chrono>
+#include <cstdio>
+#include <string_view>
+#include <vector>
 
 namespace
 {
+	// Frames the render thread keeps in flight between preparing & presenting, see RenderSystem
+	constexpr uint32_t c_max_pipeline_depth = 4;
+
 	struct MainWindowState
 	{
 		HWND window_handle = nullptr;
@@ -36,12 +53,17 @@ namespace
 			ACTION_COUNT
 		};
 
-		static constexpr float c_move_speed = 0.005f;
-		static constexpr float c_turn_speed = 0.001f;
+		// Per second
+		static constexpr float c_move_speed = 5.0f;
+		static constexpr float c_turn_speed = 1.0f;
 
 		ForwardPlusDemo::XMVector position = DirectX::XMVectorSet(0.0f, 0.0f, 1.0f, 1.0f);
 		ForwardPlusDemo::Vector2 rotation = { 0, 0 }; // Pitch & yaw
 
+		// Before the last update, frames drawn between two fixed steps blend the two
+		ForwardPlusDemo::XMVector previous_position = position;
+		ForwardPlusDemo::Vector2 previous_rotation = rotation;
+
 		ForwardPlusDemo::Vector3 velocity = { 0, 0, 0 };
 		ForwardPlusDemo::Vector2 angular_velocity = { 0, 0 };
 
@@ -54,6 +76,9 @@ namespace
 
 		void update(float dt)
 		{
+			previous_position = position;
+			previous_rotation = rotation;
+
 			update_inputs();
 
 			// Rotation
@@ -88,6 +113,19 @@ namespace
 			angular_velocity = { 0, 0 };
 		}
 
+		ForwardPlusDemo::CameraTransformUpdate get_interpolated_transform(float interpolation) const
+		{
+			ForwardPlusDemo::CameraTransformUpdate transform;
+			transform.position = DirectX::XMVectorLerp(previous_position, position, interpolation);
+			transform.rotation.x = previous_rotation.x + (rotation.x - previous_rotation.x) * interpolation;
+
+			// Yaw wraps around, so blend over the shorter side
+			const float yaw_change = ForwardPlusDemo::clamp_angle(rotation.y - previous_rotation.y);
+			transform.rotation.y = ForwardPlusDemo::clamp_angle(previous_rotation.y + yaw_change * interpolation);
+
+			return transform;
+		}
+
 		void update_inputs()
 		{
 			// Camera translation
@@ -154,6 +192,16 @@ namespace
 			return input_action_values[static_cast<size_t>(action)];
 		}
 	};
+
+	// The whole argument has to be a number that fits, bad input fails the parse instead of throwing
+	template<typename T>
+	bool parse_number(std::string_view text, T& value)
+	{
+		const char* text_end = text.data() + text.size();
+		const std::from_chars_result result = std::from_chars(text.data(), text_end, value);
+
+		return (result.ec == std::errc()) && (result.ptr == text_end);
+	}
 }
 
 namespace ForwardPlusDemo
@@ -166,6 +214,32 @@ namespace ForwardPlusDemo
 		MainCameraState m_camera;
 		bool m_paused = false;
 
+		std::string m_scene_path;
+		std::string m_scene_output_path; // Text & generated scenes are also written here in the binary format
+		ScenarioParameters m_scenario;
+		uint32_t m_moving_light_count = 0;
+
+		CameraPath m_camera_path;
+		std::string m_camera_record_path;
+		bool m_camera_playback = false;
+		float m_simulation_time = 0.0f;
+
+		// Headless runs use the null graphics backend and stop after a fixed number of simulation steps
+		bool m_headless = false;
+		uint64_t m_headless_step_count = 0;
+		std::string m_software_image_path;
+
+		VertexFormat m_vertex_format = VertexFormat::FULL;
+
+		// Paces the windowed main loop, the simulation always advances in fixed steps
+		FrameScheduler m_frame_scheduler;
+
+		// Chrome trace of the profiled scopes, written at exit
+		std::string m_profile_path;
+
+		// Preparing the next frame overlaps recording the current one from a depth of 2 on, every extra frame adds a frame of latency
+		uint32_t m_pipeline_depth = 2;
+
 		Internal(Application& application)
 			: m_render_system(application)
 		{
@@ -184,11 +258,14 @@ namespace ForwardPlusDemo
 			return 0;
 		}
 
-		bool initialize(HINSTANCE hInstance, HINSTANCE /*hPrevInstance*/, LPSTR /*lpCmdLine*/, int nCmdShow)
+		bool initialize(HINSTANCE hInstance, HINSTANCE /*hPrevInstance*/, LPSTR lpCmdLine, int nCmdShow)
 		{
-			std::srand(static_cast<unsigned int>(std::time(0)));
+			if (!parse_command_line(lpCmdLine))
+			{
+				return false;
+			}
 
-			if (!init_window(hInstance, nCmdShow))
+			if (!m_headless && !init_window(hInstance, nCmdShow))
 			{
 				return false;
 			}
@@ -204,6 +281,246 @@ namespace ForwardPlusDemo
 		void shutdown()
 		{
 			m_render_system.shutdown();
+
+#if FORWARDPLUSDEMO_PROFILER
+			// Every profiled thread is done by now
+			if (m_headless || !m_profile_path.empty())
+			{
+				log_profile_summary();
+			}
+
+			if (!m_profile_path.empty() && !Profiler::write_chrome_trace(m_profile_path))
+			{
+				OutputDebugStringA("Failed to write the profile trace\n");
+			}
+#else
+			if (!m_profile_path.empty())
+			{
+				OutputDebugStringA("--profile ignored, built without FORWARDPLUSDEMO_PROFILER\n");
+			}
+#endif
+
+			if (!m_camera_record_path.empty())
+			{
+				m_camera_path.save(m_camera_record_path);
+			}
+		}
+
+		static std::vector<std::string> split_command_line(const char* command_line)
+		{
+			// Whitespace separated, double quotes can be used for arguments that contain spaces
+			std::vector<std::string> arguments;
+			std::string current_argument;
+			bool in_quotes = false;
+			bool has_argument = false;
+
+			for (const char* current_char = command_line; *current_char != '\0'; ++current_char)
+			{
+				if (*current_char == '"')
+				{
+					in_quotes = !in_quotes;
+					has_argument = true;
+				}
+				else if (((*current_char == ' ') || (*current_char == '\t')) && !in_quotes)
+				{
+					if (has_argument)
+					{
+						arguments.push_back(current_argument);
+						current_argument.clear();
+						has_argument = false;
+					}
+				}
+				else
+				{
+					current_argument.push_back(*current_char);
+					has_argument = true;
+				}
+			}
+
+			if (has_argument)
+			{
+				arguments.push_back(current_argument);
+			}
+
+			return arguments;
+		}
+
+		bool parse_command_line(LPSTR command_line)
+		{
+			// Usage: [scene file] [--scenario <name>] [--seed <n>] [--lights <n>] [--spot-ratio <0-1>] [--directional <n>] [--objects <n>] [--moving-lights <n>] [--record-camera <file>] [--play-camera <file>] [--headless <steps>] [--software-image <file>] [--vertex-format <full|packed>] [--pipeline-depth <1-4>] [--frame-rate <fps, 0 = unlimited>] [--step-rate <steps per second>] [--profile <file.json>] [--write-scene <file.fpscene>]
+			if (command_line == nullptr)
+			{
+				return true;
+			}
+
+			const std::vector<std::string> arguments = split_command_line(command_line);
+			for (size_t argument_index = 0; argument_index < arguments.size(); ++argument_index)
+			{
+				const std::string_view current_argument = arguments[argument_index];
+				if (current_argument.starts_with("--") == false)
+				{
+					m_scene_path = current_argument;
+					continue;
+				}
+
+				// All options take a value
+				if ((argument_index + 1) >= arguments.size())
+				{
+					return false;
+				}
+
+				const std::string& value = arguments[++argument_index];
+				if (current_argument == "--scenario")
+				{
+					if (!parse_scenario_type(value, m_scenario.type))
+					{
+						return false;
+					}
+				}
+				else if (current_argument == "--seed")
+				{
+					if (!parse_number(value, m_scenario.seed))
+					{
+						return false;
+					}
+				}
+				else if (current_argument == "--lights")
+				{
+					if (!parse_number(value, m_scenario.light_count))
+					{
+						return false;
+					}
+				}
+				else if (current_argument == "--spot-ratio")
+				{
+					if (!parse_number(value, m_scenario.spot_ratio) || (m_scenario.spot_ratio < 0.0f) || (m_scenario.spot_ratio > 1.0f))
+					{
+						return false;
+					}
+				}
+				else if (current_argument == "--directional")
+				{
+					if (!parse_number(value, m_scenario.directional_light_count))
+					{
+						return false;
+					}
+				}
+				else if (current_argument == "--objects")
+				{
+					if (!parse_number(value, m_scenario.object_count))
+					{
+						return false;
+					}
+				}
+				else if (current_argument == "--moving-lights")
+				{
+					if (!parse_number(value, m_moving_light_count))
+					{
+						return false;
+					}
+				}
+				else if (current_argument == "--record-camera")
+				{
+					m_camera_record_path = value;
+				}
+				else if (current_argument == "--play-camera")
+				{
+					if (!m_camera_path.load(value))
+					{
+						return false;
+					}
+
+					m_camera_playback = true;
+				}
+				else if (current_argument == "--headless")
+				{
+					m_headless = true;
+					if (!parse_number(value, m_headless_step_count))
+					{
+						return false;
+					}
+				}
+				else if (current_argument == "--software-image")
+				{
+					m_software_image_path = value;
+				}
+				else if (current_argument == "--vertex-format")
+				{
+					if (!parse_vertex_format(value, m_vertex_format))
+					{
+						return false;
+					}
+				}
+				else if (current_argument == "--frame-rate")
+				{
+					double frame_rate = 0.0;
+					if (!parse_number(value, frame_rate) || (frame_rate < 0.0))
+					{
+						return false;
+					}
+
+					m_frame_scheduler.set_frame_rate(frame_rate);
+				}
+				else if (current_argument == "--step-rate")
+				{
+					double step_rate = 0.0;
+					if (!parse_number(value, step_rate) || (step_rate <= 0.0))
+					{
+						return false;
+					}
+
+					m_frame_scheduler.set_step_rate(step_rate);
+				}
+				else if (current_argument == "--profile")
+				{
+					m_profile_path = value;
+				}
+				else if (current_argument == "--write-scene")
+				{
+					m_scene_output_path = value;
+				}
+				else if (current_argument == "--pipeline-depth")
+				{
+					if (!parse_number(value, m_pipeline_depth) || (m_pipeline_depth == 0) || (m_pipeline_depth > c_max_pipeline_depth))
+					{
+						return false;
+					}
+				}
+				else
+				{
+					return false;
+				}
+			}
+
+			// The software rasterizer draws for the null backend, which is only used by headless runs
+			if (!m_software_image_path.empty() && !m_headless)
+			{
+				return false;
+			}
+
+			return true;
+		}
+
+		void update_camera_path(float dt)
+		{
+			m_simulation_time += dt;
+
+			if (m_camera_playback)
+			{
+				// Override the camera with the recorded path
+				const CameraKeyframe keyframe = m_camera_path.sample(m_simulation_time);
+				m_camera.position = DirectX::XMVectorSet(keyframe.position.x, keyframe.position.y, keyframe.position.z, 1.0f);
+				m_camera.rotation = keyframe.rotation;
+			}
+			else if (!m_camera_record_path.empty())
+			{
+				CameraKeyframe keyframe;
+				keyframe.time = m_simulation_time;
+				keyframe.position = ForwardPlusDemo::to_vector3(m_camera.position);
+				keyframe.rotation = m_camera.rotation;
+
+				m_camera_path.add_keyframe(keyframe);
+			}
 		}
 
 		bool init_window(HINSTANCE hInstance, int nCmdShow)
@@ -248,47 +565,140 @@ namespace ForwardPlusDemo
 
 		void main_loop()
 		{
-			MSG window_message = { 0 };
+			if (m_headless)
+			{
+				headless_loop();
+				return;
+			}
 
-			std::chrono::milliseconds frame_delay_time(0);
-			std::chrono::steady_clock::time_point last_frame = std::chrono::steady_clock::now();
-			while (true)
+			FORWARDPLUSDEMO_PROFILE_THREAD_NAME("Main");
+
+			// The scheduler sleeps 1 ms at a time, which would take a whole 15.6 ms tick with the default timer resolution
+			timeBeginPeriod(1);
+
+			m_frame_scheduler.reset(std::chrono::steady_clock::now());
+			while (process_window_messages())
 			{
-				if (PeekMessage(&window_message, NULL, 0, 0, PM_REMOVE))
+				if (m_paused)
+				{
+					// Nothing to simulate while paused (e.g minimized), hand over what is queued (the pause itself) and sleep until the next message
+					m_render_system.dispatch_events();
+					WaitMessage();
+					continue;
+				}
+
+				const FrameTiming timing = m_frame_scheduler.begin_frame(std::chrono::steady_clock::now());
+
 				{
-					TranslateMessage(&window_message);
-					DispatchMessage(&window_message);
+					FORWARDPLUSDEMO_PROFILE_SCOPE("Application::update_simulation");
 
-					// check to see if it's time to quit
-					if (window_message.message == WM_QUIT)
+					const float step_time = static_cast<float>(m_frame_scheduler.get_step_time());
+					for (uint32_t current_step = 0; current_step < timing.step_count; ++current_step)
 					{
-						break;
+						update_simulation(step_time);
 					}
+
+					send_camera_update(static_cast<float>(timing.interpolation));
 				}
 
-				// Done processing events, check if we can dispatch them
-				// Limit to 16 ms (i.e ~60 FPS)
-				if (frame_delay_time.count() >= 16)
 				{
-					if (m_paused == false)
-					{
-						constexpr float c_delta_time = 1.0f / 60.0f;
-						{
-							m_camera.update(c_delta_time);
-							CameraTransformUpdate camera_update;
-							camera_update.position = m_camera.position;
-							camera_update.rotation = m_camera.rotation;
-							m_render_system.update_camera_transform(camera_update);
-						}
-					}
+					FORWARDPLUSDEMO_PROFILE_SCOPE("Application::dispatch_events");
 					m_render_system.dispatch_events();
-					frame_delay_time = std::chrono::milliseconds(0);
 				}
 
-				// End of frame, update timer
-				const std::chrono::steady_clock::time_point current_frame_end = std::chrono::steady_clock::now();
-				frame_delay_time = std::chrono::duration_cast<std::chrono::milliseconds>(current_frame_end - last_frame);
+				{
+					FORWARDPLUSDEMO_PROFILE_SCOPE("Application::wait_for_next_frame");
+					m_frame_scheduler.wait_for_next_frame();
+				}
+			}
+
+			timeEndPeriod(1);
+
+			log_frame_statistics();
+		}
+
+		// False once the window is closed
+		bool process_window_messages()
+		{
+			MSG window_message = { 0 };
+			while (PeekMessage(&window_message, NULL, 0, 0, PM_REMOVE))
+			{
+				TranslateMessage(&window_message);
+				DispatchMessage(&window_message);
+
+				if (window_message.message == WM_QUIT)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		void headless_loop()
+		{
+			// No window messages and no frame limiter, one step per frame the render thread finishes
+			// The render thread doesn't wait for input, so without this the steps would be over before many frames were drawn
+			const Fence& frame_fence = m_render_system.get_frame_fence();
+			const uint64_t first_frame = frame_fence.get_value();
+
+			const float step_time = static_cast<float>(m_frame_scheduler.get_step_time());
+			for (uint64_t current_step = 0; current_step < m_headless_step_count; ++current_step)
+			{
+				update_simulation(step_time);
+				send_camera_update(1.0f);
+				m_render_system.dispatch_events();
+
+				frame_fence.wait_until(first_frame + current_step + 1);
 			}
+
+			// The frame being recorded may have snapshotted the camera before the last step, the next one to be prepared is recorded a pipeline depth later
+			frame_fence.wait_until(frame_fence.get_value() + 1 + m_pipeline_depth);
+		}
+
+		void update_simulation(float dt)
+		{
+			m_camera.update(dt);
+			update_camera_path(dt);
+		}
+
+		void send_camera_update(float interpolation)
+		{
+			m_render_system.update_simulation_time(m_simulation_time);
+			m_render_system.update_camera_transform(m_camera.get_interpolated_transform(interpolation));
+		}
+
+		void log_profile_summary() const
+		{
+			const std::vector<ProfileStageSummary> summary = Profiler::get_summary();
+			for (const ProfileStageSummary& current_stage : summary)
+			{
+				char line[256];
+				std::snprintf(line, sizeof(line), "Profile: %-40s %8llu calls, %.3f ms min, %.3f ms average, %.3f ms p99, %.3f ms max, %.1f ms total\n",
+					current_stage.name.c_str(), static_cast<unsigned long long>(current_stage.count), current_stage.min_time, current_stage.average_time,
+					current_stage.p99_time, current_stage.max_time, current_stage.total_time);
+				OutputDebugStringA(line);
+			}
+		}
+
+		void log_frame_statistics() const
+		{
+			const FrameTimeStatistics statistics = m_frame_scheduler.get_statistics();
+			if (statistics.frame_count == 0)
+			{
+				return;
+			}
+
+			const double wait_time = statistics.sleep_time + statistics.spin_time;
+
+			char summary[384];
+			std::snprintf(summary, sizeof(summary), "Frame pacing: %.1f fps target, %llu frames, interval %.3f ms average (%.3f - %.3f), jitter %.3f ms, p99 %.3f ms, "
+				"wake delay %.3f ms average (%.3f max), %llu late frames, %llu dropped steps, %.1f%% of the wait time asleep\n",
+				m_frame_scheduler.get_frame_rate(), static_cast<unsigned long long>(statistics.frame_count), statistics.average_interval, statistics.min_interval, statistics.max_interval,
+				statistics.interval_deviation, statistics.p99_interval, statistics.average_wake_delay, statistics.max_wake_delay,
+				static_cast<unsigned long long>(statistics.late_frame_count), static_cast<unsigned long long>(statistics.dropped_step_count),
+				(wait_time > 0.0) ? (100.0 * statistics.sleep_time / wait_time) : 0.0);
+			OutputDebugStringA(summary);
 		}
 
 		LRESULT window_procedure(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
@@ -437,6 +847,12 @@ namespace ForwardPlusDemo
 
 		void set_paused(bool paused)
 		{
+			// Time spent paused is neither simulated nor a frame interval
+			if (m_paused && !paused)
+			{
+				m_frame_scheduler.reset(std::chrono::steady_clock::now());
+			}
+
 			m_paused = paused;
 			m_render_system.set_paused(paused);
 		}
@@ -509,6 +925,46 @@ namespace ForwardPlusDemo
 		return m_internal->m_window.window_handle;
 	}
 
+	bool Application::is_headless() const
+	{
+		return m_internal->m_headless;
+	}
+
+	const std::string& Application::get_software_image_path() const
+	{
+		return m_internal->m_software_image_path;
+	}
+
+	VertexFormat Application::get_vertex_format() const
+	{
+		return m_internal->m_vertex_format;
+	}
+
+	uint32_t Application::get_pipeline_depth() const
+	{
+		return m_internal->m_pipeline_depth;
+	}
+
+	const std::string& Application::get_scene_path() const
+	{
+		return m_internal->m_scene_path;
+	}
+
+	const std::string& Application::get_scene_output_path() const
+	{
+		return m_internal->m_scene_output_path;
+	}
+
+	const ScenarioParameters& Application::get_scenario_parameters() const
+	{
+		return m_internal->m_scenario;
+	}
+
+	uint32_t Application::get_moving_light_count() const
+	{
+		return m_internal->m_moving_light_count;
+	}
+
 	LRESULT CALLBACK Application::window_procedure(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 	{
 		if (message == WM_NCCREATE)
@@ -5,10 +5,14 @@
 #define NOMINMAX
 #include <windows.h>
 
+#include <cstdint>
 #include <memory>
+#include <string>
 namespace ForwardPlusDemo
 {
 	class RenderSystem;
+	struct ScenarioParameters;
+	enum class VertexFormat : uint32_t;
 
 	class Application
 	{
@@ -20,6 +24,22 @@ namespace ForwardPlusDemo
 
 		RenderSystem& get_render_system();
 		HWND get_window_handle();
+		bool is_headless() const;
+
+		// Empty unless headless frames should be drawn by the software rasterizer
+		const std::string& get_software_image_path() const;
+
+		VertexFormat get_vertex_format() const;
+
+		// Frames in flight on the render thread, one prepared while an older one is recorded
+		uint32_t get_pipeline_depth() const;
+
+		const std::string& get_scene_path() const;
+		const std::string& get_scene_output_path() const; // Empty unless the scene should be converted to a binary scene file
+		const ScenarioParameters& get_scenario_parameters() const;
+
+		// Lights circling around their scene position, driven by the simulation time (exercises the incremental light updates)
+		uint32_t get_moving_light_count() const;
 	private:
 		static LRESULT CALLBACK window_procedure(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
 
@@ -0,0 +1,176 @@
+#include <ForwardPlusDemo/GraphicsAPI/CommandList.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace ForwardPlusDemo
+{
+	void CommandList::clear()
+	{
+		m_data.clear();
+		m_command_count = 0;
+	}
+
+	void CommandList::set_primitive_topology(PrimitiveTopology topology)
+	{
+		Commands::SetPrimitiveTopology* command = allocate_command<Commands::SetPrimitiveTopology>(CommandType::SET_PRIMITIVE_TOPOLOGY);
+		command->topology = topology;
+	}
+
+	void CommandList::set_input_layout(CommandHandle input_layout)
+	{
+		Commands::SetInputLayout* command = allocate_command<Commands::SetInputLayout>(CommandType::SET_INPUT_LAYOUT);
+		command->input_layout = input_layout;
+	}
+
+	void CommandList::set_shader(ShaderStage stage, CommandHandle shader)
+	{
+		Commands::SetShader* command = allocate_command<Commands::SetShader>(CommandType::SET_SHADER);
+		command->stage = stage;
+		command->shader = shader;
+	}
+
+	void CommandList::set_vertex_buffer(uint32_t slot, CommandHandle buffer, uint32_t stride, uint32_t offset)
+	{
+		Commands::SetVertexBuffer* command = allocate_command<Commands::SetVertexBuffer>(CommandType::SET_VERTEX_BUFFER);
+		command->slot = slot;
+		command->stride = stride;
+		command->offset = offset;
+		command->buffer = buffer;
+	}
+
+	void CommandList::set_index_buffer(CommandHandle buffer, IndexFormat format, uint32_t offset)
+	{
+		Commands::SetIndexBuffer* command = allocate_command<Commands::SetIndexBuffer>(CommandType::SET_INDEX_BUFFER);
+		command->format = format;
+		command->offset = offset;
+		command->buffer = buffer;
+	}
+
+	void CommandList::set_constant_buffers(ShaderStage stage, uint32_t start_slot, uint32_t count, const CommandHandle* buffers)
+	{
+		write_bindings(CommandType::SET_CONSTANT_BUFFERS, stage, start_slot, count, buffers);
+	}
+
+	void CommandList::set_constant_buffer_range(ShaderStage stage, uint32_t slot, CommandHandle buffer, uint32_t offset, uint32_t size)
+	{
+		assert((offset % Commands::c_constant_buffer_offset_alignment) == 0);
+
+		Commands::SetConstantBufferRange* command = allocate_command<Commands::SetConstantBufferRange>(CommandType::SET_CONSTANT_BUFFER_RANGE);
+		command->stage = stage;
+		command->slot = slot;
+		command->offset = offset;
+		command->size = size;
+		command->buffer = buffer;
+	}
+
+	void CommandList::set_shader_resources(ShaderStage stage, uint32_t start_slot, uint32_t count, const CommandHandle* views)
+	{
+		write_bindings(CommandType::SET_SHADER_RESOURCES, stage, start_slot, count, views);
+	}
+
+	void CommandList::set_unordered_access_views(uint32_t start_slot, uint32_t count, const CommandHandle* views)
+	{
+		write_bindings(CommandType::SET_UNORDERED_ACCESS_VIEWS, ShaderStage::COMPUTE, start_slot, count, views);
+	}
+
+	void CommandList::update_buffer(CommandHandle buffer, const void* data, uint32_t data_size)
+	{
+		Commands::UpdateBuffer* command = allocate_command<Commands::UpdateBuffer>(CommandType::UPDATE_BUFFER, data_size);
+		command->buffer = buffer;
+		command->data_size = data_size;
+
+		if (data_size > 0)
+		{
+			std::memcpy(reinterpret_cast<char*>(command) + get_payload_offset<Commands::UpdateBuffer>(), data, data_size);
+		}
+	}
+
+	void CommandList::update_buffer_range(CommandHandle buffer, uint32_t offset, const void* data, uint32_t data_size)
+	{
+		Commands::UpdateBufferRange* command = allocate_command<Commands::UpdateBufferRange>(CommandType::UPDATE_BUFFER_RANGE, data_size);
+		command->buffer = buffer;
+		command->offset = offset;
+		command->data_size = data_size;
+
+		if (data_size > 0)
+		{
+			std::memcpy(reinterpret_cast<char*>(command) + get_payload_offset<Commands::UpdateBufferRange>(), data, data_size);
+		}
+	}
+
+	void CommandList::clear_unordered_access_view(CommandHandle view, const std::array<uint32_t, 4>& values)
+	{
+		Commands::ClearUnorderedAccessView* command = allocate_command<Commands::ClearUnorderedAccessView>(CommandType::CLEAR_UNORDERED_ACCESS_VIEW);
+		command->view = view;
+		command->values = values;
+	}
+
+	void CommandList::draw(uint32_t vertex_count, uint32_t start_vertex)
+	{
+		Commands::Draw* command = allocate_command<Commands::Draw>(CommandType::DRAW);
+		command->vertex_count = vertex_count;
+		command->start_vertex = start_vertex;
+	}
+
+	void CommandList::draw_instanced(uint32_t vertex_count, uint32_t instance_count, uint32_t start_vertex, uint32_t start_instance)
+	{
+		Commands::DrawInstanced* command = allocate_command<Commands::DrawInstanced>(CommandType::DRAW_INSTANCED);
+		command->vertex_count = vertex_count;
+		command->instance_count = instance_count;
+		command->start_vertex = start_vertex;
+		command->start_instance = start_instance;
+	}
+
+	void CommandList::draw_indexed_instanced(uint32_t index_count, uint32_t instance_count, uint32_t start_index, int32_t base_vertex, uint32_t start_instance)
+	{
+		Commands::DrawIndexedInstanced* command = allocate_command<Commands::DrawIndexedInstanced>(CommandType::DRAW_INDEXED_INSTANCED);
+		command->index_count = index_count;
+		command->instance_count = instance_count;
+		command->start_index = start_index;
+		command->base_vertex = base_vertex;
+		command->start_instance = start_instance;
+	}
+
+	void CommandList::dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z)
+	{
+		Commands::Dispatch* command = allocate_command<Commands::Dispatch>(CommandType::DISPATCH);
+		command->group_count_x = group_count_x;
+		command->group_count_y = group_count_y;
+		command->group_count_z = group_count_z;
+	}
+
+	char* CommandList::allocate_raw_command(CommandType type, size_t size)
+	{
+		const size_t block_count = (sizeof(Header) + size + sizeof(Block) - 1) / sizeof(Block);
+
+		const size_t header_offset = m_data.size();
+		m_data.resize(header_offset + block_count, Block(0));
+
+		Header* header = reinterpret_cast<Header*>(&m_data[header_offset]);
+		header->type = type;
+		header->size = static_cast<uint32_t>(block_count * sizeof(Block));
+
+		++m_command_count;
+
+		return reinterpret_cast<char*>(header) + sizeof(Header);
+	}
+
+	void CommandList::write_bindings(CommandType type, ShaderStage stage, uint32_t start_slot, uint32_t count, const CommandHandle* handles)
+	{
+		// Split larger ranges over several commands
+		for (uint32_t binding_offset = 0; binding_offset < count; binding_offset += Commands::c_max_bindings)
+		{
+			Commands::SetBindings* command = allocate_command<Commands::SetBindings>(type);
+			command->stage = stage;
+			command->start_slot = start_slot + binding_offset;
+			command->count = std::min(count - binding_offset, Commands::c_max_bindings);
+
+			for (uint32_t current_binding_index = 0; current_binding_index < command->count; ++current_binding_index)
+			{
+				command->handles[current_binding_index] = handles[binding_offset + current_binding_index];
+			}
+		}
+	}
+}
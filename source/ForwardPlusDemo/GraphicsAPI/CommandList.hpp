@@ -0,0 +1,273 @@
+#ifndef FORWARDPLUSDEMO_GRAPHICSAPI_COMMANDLIST_HPP
+#define FORWARDPLUSDEMO_GRAPHICSAPI_COMMANDLIST_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+namespace ForwardPlusDemo
+{
+	// Opaque API object (e.g ID3D11Buffer*), only the replayer knows what it points to
+	using CommandHandle = const void*;
+
+	enum class ShaderStage : uint32_t
+	{
+		VERTEX,
+		PIXEL,
+		COMPUTE,
+		STAGE_COUNT
+	};
+
+	enum class PrimitiveTopology : uint32_t
+	{
+		TRIANGLE_LIST,
+		LINE_LIST
+	};
+
+	enum class IndexFormat : uint32_t
+	{
+		UINT16,
+		UINT32
+	};
+
+	enum class CommandType : uint32_t
+	{
+		SET_PRIMITIVE_TOPOLOGY,
+		SET_INPUT_LAYOUT,
+		SET_SHADER,
+		SET_VERTEX_BUFFER,
+		SET_INDEX_BUFFER,
+		SET_CONSTANT_BUFFERS,
+		SET_CONSTANT_BUFFER_RANGE,
+		SET_SHADER_RESOURCES,
+		SET_UNORDERED_ACCESS_VIEWS,
+		UPDATE_BUFFER,
+		UPDATE_BUFFER_RANGE,
+		CLEAR_UNORDERED_ACCESS_VIEW,
+		DRAW,
+		DRAW_INSTANCED,
+		DRAW_INDEXED_INSTANCED,
+		DISPATCH,
+		COMMAND_COUNT
+	};
+
+	namespace Commands
+	{
+		constexpr uint32_t c_max_bindings = 8;
+
+		// D3D11.1 binds constant buffer ranges in blocks of 16 constants
+		constexpr uint32_t c_constant_buffer_offset_alignment = 256;
+
+		struct SetPrimitiveTopology
+		{
+			PrimitiveTopology topology;
+		};
+
+		struct SetInputLayout
+		{
+			CommandHandle input_layout;
+		};
+
+		struct SetShader
+		{
+			ShaderStage stage;
+			CommandHandle shader;
+		};
+
+		struct SetVertexBuffer
+		{
+			uint32_t slot;
+			uint32_t stride;
+			uint32_t offset;
+			CommandHandle buffer;
+		};
+
+		struct SetIndexBuffer
+		{
+			IndexFormat format;
+			uint32_t offset;
+			CommandHandle buffer;
+		};
+
+		// Used for constant buffers, shader resources & UAVs (UAVs ignore the stage)
+		struct SetBindings
+		{
+			ShaderStage stage;
+			uint32_t start_slot;
+			uint32_t count;
+			std::array<CommandHandle, c_max_bindings> handles;
+		};
+
+		// Part of a constant buffer, offset must be a multiple of c_constant_buffer_offset_alignment
+		struct SetConstantBufferRange
+		{
+			ShaderStage stage;
+			uint32_t slot;
+			uint32_t offset;
+			uint32_t size;
+			CommandHandle buffer;
+		};
+
+		// Followed by data_size bytes of data, replaces the whole buffer contents
+		struct UpdateBuffer
+		{
+			CommandHandle buffer;
+			uint32_t data_size;
+		};
+
+		// Followed by data_size bytes of data, written at offset without discarding the rest of the buffer
+		// Only safe for parts of the buffer the GPU is no longer reading (see ConstantBufferRing)
+		struct UpdateBufferRange
+		{
+			CommandHandle buffer;
+			uint32_t offset;
+			uint32_t data_size;
+		};
+
+		struct ClearUnorderedAccessView
+		{
+			CommandHandle view;
+			std::array<uint32_t, 4> values;
+		};
+
+		struct Draw
+		{
+			uint32_t vertex_count;
+			uint32_t start_vertex;
+		};
+
+		struct DrawInstanced
+		{
+			uint32_t vertex_count;
+			uint32_t instance_count;
+			uint32_t start_vertex;
+			uint32_t start_instance;
+		};
+
+		// Indices are relative to base_vertex
+		struct DrawIndexedInstanced
+		{
+			uint32_t index_count;
+			uint32_t instance_count;
+			uint32_t start_index;
+			int32_t base_vertex;
+			uint32_t start_instance;
+		};
+
+		struct Dispatch
+		{
+			uint32_t group_count_x;
+			uint32_t group_count_y;
+			uint32_t group_count_z;
+		};
+	}
+
+	// Linear buffer of POD render commands, recorded by the render code and executed later by a replayer
+	// Recording does not touch the graphics API, so it can be done on any thread
+	class CommandList
+	{
+	public:
+		struct Header
+		{
+			CommandType type;
+			uint32_t size; // Including the header & padding
+		};
+
+		bool is_empty() const { return m_data.empty(); }
+		size_t get_size() const { return m_data.size() * sizeof(Block); }
+		uint32_t get_command_count() const { return m_command_count; }
+
+		void clear();
+
+		void set_primitive_topology(PrimitiveTopology topology);
+		void set_input_layout(CommandHandle input_layout);
+		void set_shader(ShaderStage stage, CommandHandle shader);
+		void set_vertex_buffer(uint32_t slot, CommandHandle buffer, uint32_t stride, uint32_t offset);
+		void set_index_buffer(CommandHandle buffer, IndexFormat format, uint32_t offset);
+
+		void set_constant_buffers(ShaderStage stage, uint32_t start_slot, uint32_t count, const CommandHandle* buffers);
+		void set_constant_buffer_range(ShaderStage stage, uint32_t slot, CommandHandle buffer, uint32_t offset, uint32_t size);
+		void set_shader_resources(ShaderStage stage, uint32_t start_slot, uint32_t count, const CommandHandle* views);
+		void set_unordered_access_views(uint32_t start_slot, uint32_t count, const CommandHandle* views);
+
+		// Data is copied into the command list
+		void update_buffer(CommandHandle buffer, const void* data, uint32_t data_size);
+		void update_buffer_range(CommandHandle buffer, uint32_t offset, const void* data, uint32_t data_size);
+		void clear_unordered_access_view(CommandHandle view, const std::array<uint32_t, 4>& values);
+
+		void draw(uint32_t vertex_count, uint32_t start_vertex);
+		void draw_instanced(uint32_t vertex_count, uint32_t instance_count, uint32_t start_vertex, uint32_t start_instance);
+		void draw_indexed_instanced(uint32_t index_count, uint32_t instance_count, uint32_t start_index, int32_t base_vertex, uint32_t start_instance);
+		void dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z);
+
+		class Iterator
+		{
+		public:
+			bool is_valid() const { return m_offset < m_list.m_data.size(); }
+
+			void advance() { m_offset += get_header().size / sizeof(Block); }
+
+			const Header& get_header() const { return *reinterpret_cast<const Header*>(&m_list.m_data[m_offset]); }
+			CommandType get_type() const { return get_header().type; }
+
+			template<typename T>
+			const T* get_command() const
+			{
+				return reinterpret_cast<const T*>(get_command_data());
+			}
+
+			// Trailing data after the command struct (e.g buffer contents)
+			template<typename T>
+			const void* get_payload() const
+			{
+				return get_command_data() + get_payload_offset<T>();
+			}
+		private:
+			Iterator(const CommandList& list) : m_list(list) {}
+
+			const char* get_command_data() const { return reinterpret_cast<const char*>(&m_list.m_data[m_offset]) + sizeof(Header); }
+
+			const CommandList& m_list;
+			size_t m_offset = 0;
+
+			friend CommandList;
+		};
+
+		Iterator get_iterator() const { return Iterator(*this); }
+	private:
+		// Keeps every command (and the handles inside it) 8 byte aligned
+		using Block = uint64_t;
+
+		static_assert((sizeof(Header) % sizeof(Block)) == 0);
+
+		template<typename T>
+		static constexpr size_t get_payload_offset()
+		{
+			return ((sizeof(T) + sizeof(Block) - 1) / sizeof(Block)) * sizeof(Block);
+		}
+
+		template<typename T>
+		T* allocate_command(CommandType type, size_t payload_size = 0)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			return reinterpret_cast<T*>(allocate_raw_command(type, get_payload_offset<T>() + payload_size));
+		}
+
+		char* allocate_raw_command(CommandType type, size_t size);
+
+		void write_bindings(CommandType type, ShaderStage stage, uint32_t start_slot, uint32_t count, const CommandHandle* handles);
+
+		std::vector<Block> m_data;
+		uint32_t m_command_count = 0;
+	};
+
+	// Executes a recorded command list
+	class CommandReplayer
+	{
+	public:
+		virtual ~CommandReplayer() = default;
+
+		virtual void replay(const CommandList& command_list) = 0;
+	};
+}
+#endif
@@ -1,6 +1,6 @@
 #ifndef FORWARDPLUSDEMO_GRAPHICSAPI_COMMON_HPP
 #define FORWARDPLUSDEMO_GRAPHICSAPI_COMMON_HPP
-#include <d3d11.h>
+#include <d3d11_1.h>
 
 #include <wrl/client.h>
 using Microsoft::WRL::ComPtr;
@@ -9,6 +9,7 @@ namespace ForwardPlusDemo
 {
 	using D3DDevice = ID3D11Device;
 	using D3DDeviceContext = ID3D11DeviceContext;
+	using D3DDeviceContext1 = ID3D11DeviceContext1; // Constant buffer ranges
 
 	using D3DBlob = ComPtr<ID3DBlob>;
 	using D3DVertexShader = ComPtr<ID3D11VertexShader>;
@@ -0,0 +1,86 @@
+#include <ForwardPlusDemo/GraphicsAPI/ConstantBufferRing.hpp>
+
+#include <ForwardPlusDemo/GraphicsAPI/GraphicsAPI.hpp>
+#include <ForwardPlusDemo/GraphicsAPI/NullDevice.hpp>
+
+#include <cstring>
+
+namespace ForwardPlusDemo
+{
+	bool ConstantBufferRing::initialize(GraphicsAPI& graphics_api, uint32_t capacity)
+	{
+		m_allocator.reset(capacity);
+		m_staging_data.assign(capacity, 0);
+		m_upload_runs.clear();
+
+		NullDevice* null_device = graphics_api.get_null_device();
+		if (null_device != nullptr)
+		{
+			m_buffer_handle = null_device->create_buffer(capacity);
+			return true;
+		}
+
+		// D3D11.1 allows constant buffers bigger than a shader can see at once, ranges are bound with *SetConstantBuffers1
+		D3D11_BUFFER_DESC buffer_description;
+		ZeroMemory(&buffer_description, sizeof(D3D11_BUFFER_DESC));
+
+		buffer_description.ByteWidth = capacity;
+		buffer_description.Usage = D3D11_USAGE_DYNAMIC;
+		buffer_description.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+		buffer_description.MiscFlags = 0;
+		buffer_description.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+		if (FAILED(graphics_api.get_device()->CreateBuffer(&buffer_description, nullptr, m_buffer.ReleaseAndGetAddressOf())))
+		{
+			return false;
+		}
+
+		m_buffer_handle = m_buffer.Get();
+
+		return true;
+	}
+
+	void ConstantBufferRing::begin_frame(uint64_t completed_fence_value)
+	{
+		m_allocator.release_completed_frames(completed_fence_value);
+		m_upload_runs.clear();
+	}
+
+	bool ConstantBufferRing::allocate(const void* data, uint32_t size, ConstantBufferRange& range)
+	{
+		uint32_t offset = 0;
+		if (!m_allocator.allocate(size, Commands::c_constant_buffer_offset_alignment, offset))
+		{
+			return false;
+		}
+
+		std::memcpy(&m_staging_data[offset], data, size);
+
+		// Alignment gaps are uploaded along with the constants, a new run only starts when the ring wraps around
+		if (m_upload_runs.empty() || (offset < m_upload_runs.back().end))
+		{
+			m_upload_runs.push_back(UploadRun{ offset, offset + size });
+		}
+		else
+		{
+			m_upload_runs.back().end = offset + size;
+		}
+
+		range.buffer = m_buffer_handle;
+		range.offset = offset;
+		range.size = size;
+
+		return true;
+	}
+
+	void ConstantBufferRing::end_frame(CommandList& command_list, uint64_t fence_value)
+	{
+		for (const UploadRun& current_run : m_upload_runs)
+		{
+			command_list.update_buffer_range(m_buffer_handle, current_run.begin, &m_staging_data[current_run.begin], current_run.end - current_run.begin);
+		}
+
+		m_upload_runs.clear();
+		m_allocator.finish_frame(fence_value);
+	}
+}
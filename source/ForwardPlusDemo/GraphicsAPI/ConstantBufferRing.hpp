@@ -0,0 +1,67 @@
+#ifndef FORWARDPLUSDEMO_GRAPHICSAPI_CONSTANTBUFFERRING_HPP
+#define FORWARDPLUSDEMO_GRAPHICSAPI_CONSTANTBUFFERRING_HPP
+#include <ForwardPlusDemo/GraphicsAPI/CommandList.hpp>
+#include <ForwardPlusDemo/GraphicsAPI/Common.hpp>
+
+#include <ForwardPlusDemo/Utilities/RingAllocator.hpp>
+
+#include <type_traits>
+#include <vector>
+namespace ForwardPlusDemo
+{
+	class GraphicsAPI;
+
+	// Part of the ring buffer holding one set of constants, bind with bind()
+	struct ConstantBufferRange
+	{
+		CommandHandle buffer = nullptr;
+		uint32_t offset = 0;
+		uint32_t size = 0;
+
+		void bind(CommandList& command_list, ShaderStage stage, uint32_t slot) const
+		{
+			command_list.set_constant_buffer_range(stage, slot, buffer, offset, size);
+		}
+	};
+
+	// One large dynamic constant buffer for the per-draw & per-dispatch constants of every frame, bound by offset
+	// Constants are staged while the frame is recorded and uploaded with one map per frame (two when it wraps around),
+	// space is reused once the GPU has passed the frame's fence
+	class ConstantBufferRing
+	{
+	public:
+		bool initialize(GraphicsAPI& graphics_api, uint32_t capacity);
+
+		void begin_frame(uint64_t completed_fence_value);
+
+		// False when the frames in flight use up the whole ring
+		bool allocate(const void* data, uint32_t size, ConstantBufferRange& range);
+
+		template<typename T>
+		bool allocate(const T& constants, ConstantBufferRange& range)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			return allocate(&constants, sizeof(T), range);
+		}
+
+		// Records the upload of this frame's constants, which has to be replayed before any command using them
+		void end_frame(CommandList& command_list, uint64_t fence_value);
+
+		uint32_t get_used_size() const { return m_allocator.get_used_size(); }
+	private:
+		// Contiguous part of the ring written this frame
+		struct UploadRun
+		{
+			uint32_t begin;
+			uint32_t end;
+		};
+
+		RingAllocator m_allocator;
+		std::vector<uint8_t> m_staging_data; // Same layout as the GPU buffer
+		std::vector<UploadRun> m_upload_runs;
+
+		D3DBuffer m_buffer;
+		CommandHandle m_buffer_handle = nullptr;
+	};
+}
+#endif
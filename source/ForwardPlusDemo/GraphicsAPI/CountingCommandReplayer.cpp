@@ -0,0 +1,180 @@
+#include <ForwardPlusDemo/GraphicsAPI/CountingCommandReplayer.hpp>
+
+namespace ForwardPlusDemo
+{
+	void CountingCommandReplayer::replay(const CommandList& command_list)
+	{
+		CommandList::Iterator command_it = command_list.get_iterator();
+		while (command_it.is_valid() == true)
+		{
+			const CommandType command_type = command_it.get_type();
+			++m_statistics.command_counts[static_cast<size_t>(command_type)];
+
+			switch (command_type)
+			{
+			case CommandType::SET_PRIMITIVE_TOPOLOGY:
+			{
+				const Commands::SetPrimitiveTopology* command = command_it.get_command<Commands::SetPrimitiveTopology>();
+				if (m_state.topology_set && (m_state.topology == command->topology))
+				{
+					++m_statistics.redundant_binds;
+				}
+
+				m_state.topology = command->topology;
+				m_state.topology_set = true;
+			}
+				break;
+			case CommandType::SET_INPUT_LAYOUT:
+				track_binding(m_state.input_layout, command_it.get_command<Commands::SetInputLayout>()->input_layout);
+				break;
+			case CommandType::SET_SHADER:
+			{
+				const Commands::SetShader* command = command_it.get_command<Commands::SetShader>();
+				track_binding(m_state.shaders[static_cast<size_t>(command->stage)], command->shader);
+			}
+				break;
+			case CommandType::SET_VERTEX_BUFFER:
+			{
+				const Commands::SetVertexBuffer* command = command_it.get_command<Commands::SetVertexBuffer>();
+				if (command->slot < c_max_tracked_slots)
+				{
+					track_binding(m_state.vertex_buffers[command->slot], command->buffer);
+				}
+			}
+				break;
+			case CommandType::SET_INDEX_BUFFER:
+				track_binding(m_state.index_buffer, command_it.get_command<Commands::SetIndexBuffer>()->buffer);
+				break;
+			case CommandType::SET_CONSTANT_BUFFERS:
+			{
+				const Commands::SetBindings* command = command_it.get_command<Commands::SetBindings>();
+				const size_t stage_index = static_cast<size_t>(command->stage);
+
+				// Binding the whole buffer where a range of it was bound is a change
+				for (uint32_t current_binding_index = 0; current_binding_index < command->count; ++current_binding_index)
+				{
+					const uint32_t current_slot = command->start_slot + current_binding_index;
+					if ((current_slot < c_max_tracked_slots) && (m_state.constant_buffer_offsets[stage_index][current_slot] != c_whole_buffer))
+					{
+						m_state.constant_buffers[stage_index][current_slot] = nullptr;
+						m_state.constant_buffer_offsets[stage_index][current_slot] = c_whole_buffer;
+					}
+				}
+
+				track_bindings(m_state.constant_buffers[stage_index], *command);
+			}
+				break;
+			case CommandType::SET_CONSTANT_BUFFER_RANGE:
+				track_constant_buffer_range(*command_it.get_command<Commands::SetConstantBufferRange>());
+				break;
+			case CommandType::SET_SHADER_RESOURCES:
+			{
+				const Commands::SetBindings* command = command_it.get_command<Commands::SetBindings>();
+				track_bindings(m_state.shader_resources[static_cast<size_t>(command->stage)], *command);
+			}
+				break;
+			case CommandType::SET_UNORDERED_ACCESS_VIEWS:
+				track_bindings(m_state.unordered_access_views, *command_it.get_command<Commands::SetBindings>());
+				break;
+			case CommandType::UPDATE_BUFFER:
+				m_statistics.bytes_uploaded += command_it.get_command<Commands::UpdateBuffer>()->data_size;
+				break;
+			case CommandType::UPDATE_BUFFER_RANGE:
+				m_statistics.bytes_uploaded += command_it.get_command<Commands::UpdateBufferRange>()->data_size;
+				break;
+			case CommandType::CLEAR_UNORDERED_ACCESS_VIEW:
+				// Nothing to track
+				break;
+			case CommandType::DRAW:
+			{
+				const Commands::Draw* command = command_it.get_command<Commands::Draw>();
+				++m_statistics.draw_count;
+				++m_statistics.instance_count;
+				m_statistics.vertex_count += command->vertex_count;
+			}
+				break;
+			case CommandType::DRAW_INSTANCED:
+			{
+				const Commands::DrawInstanced* command = command_it.get_command<Commands::DrawInstanced>();
+				++m_statistics.draw_count;
+				m_statistics.instance_count += command->instance_count;
+				m_statistics.vertex_count += static_cast<uint64_t>(command->vertex_count) * command->instance_count;
+			}
+				break;
+			case CommandType::DRAW_INDEXED_INSTANCED:
+			{
+				const Commands::DrawIndexedInstanced* command = command_it.get_command<Commands::DrawIndexedInstanced>();
+				++m_statistics.draw_count;
+				m_statistics.instance_count += command->instance_count;
+				m_statistics.vertex_count += static_cast<uint64_t>(command->index_count) * command->instance_count;
+			}
+				break;
+			case CommandType::DISPATCH:
+			{
+				const Commands::Dispatch* command = command_it.get_command<Commands::Dispatch>();
+				m_statistics.dispatch_group_count += static_cast<uint64_t>(command->group_count_x) * command->group_count_y * command->group_count_z;
+			}
+				break;
+			case CommandType::COMMAND_COUNT:
+				// Not a command, listed so a new command type without a case still warns
+				break;
+			}
+
+			command_it.advance();
+		}
+	}
+
+	CountingCommandReplayer::StageOffsetArray CountingCommandReplayer::get_whole_buffer_offsets()
+	{
+		StageOffsetArray offsets;
+		for (std::array<uint32_t, c_max_tracked_slots>& current_stage_offsets : offsets)
+		{
+			current_stage_offsets.fill(c_whole_buffer);
+		}
+
+		return offsets;
+	}
+
+	void CountingCommandReplayer::track_binding(CommandHandle& bound_handle, CommandHandle new_handle)
+	{
+		if (bound_handle == new_handle)
+		{
+			++m_statistics.redundant_binds;
+		}
+
+		bound_handle = new_handle;
+	}
+
+	void CountingCommandReplayer::track_bindings(SlotArray& slots, const Commands::SetBindings& command)
+	{
+		for (uint32_t current_binding_index = 0; current_binding_index < command.count; ++current_binding_index)
+		{
+			const uint32_t current_slot = command.start_slot + current_binding_index;
+			if (current_slot >= c_max_tracked_slots)
+			{
+				break;
+			}
+
+			track_binding(slots[current_slot], command.handles[current_binding_index]);
+		}
+	}
+
+	void CountingCommandReplayer::track_constant_buffer_range(const Commands::SetConstantBufferRange& command)
+	{
+		if (command.slot >= c_max_tracked_slots)
+		{
+			return;
+		}
+
+		// Only redundant when the same range of the same buffer is bound again
+		CommandHandle& bound_handle = m_state.constant_buffers[static_cast<size_t>(command.stage)][command.slot];
+		uint32_t& bound_offset = m_state.constant_buffer_offsets[static_cast<size_t>(command.stage)][command.slot];
+		if ((bound_handle == command.buffer) && (bound_offset == command.offset))
+		{
+			++m_statistics.redundant_binds;
+		}
+
+		bound_handle = command.buffer;
+		bound_offset = command.offset;
+	}
+}
@@ -0,0 +1,65 @@
+#ifndef FORWARDPLUSDEMO_GRAPHICSAPI_COUNTINGCOMMANDREPLAYER_HPP
+#define FORWARDPLUSDEMO_GRAPHICSAPI_COUNTINGCOMMANDREPLAYER_HPP
+#include <ForwardPlusDemo/GraphicsAPI/CommandList.hpp>
+namespace ForwardPlusDemo
+{
+	struct CommandStatistics
+	{
+		std::array<uint64_t, static_cast<size_t>(CommandType::COMMAND_COUNT)> command_counts = {};
+
+		uint64_t bytes_uploaded = 0;
+		uint64_t redundant_binds = 0; // State changes that set what was already bound
+
+		uint64_t draw_count = 0;
+		uint64_t instance_count = 0;
+		uint64_t vertex_count = 0; // Indices for indexed draws
+		uint64_t dispatch_group_count = 0;
+	};
+
+	// Null replayer, executes nothing but tracks the bound state to gather statistics (no GPU required)
+	class CountingCommandReplayer : public CommandReplayer
+	{
+	public:
+		void replay(const CommandList& command_list) override;
+
+		const CommandStatistics& get_statistics() const { return m_statistics; }
+		void reset_statistics() { m_statistics = CommandStatistics(); }
+
+		// Forget the tracked bindings, e.g when something else touched the API state
+		void reset_state() { m_state = BindingState(); }
+	private:
+		static constexpr uint32_t c_max_tracked_slots = 32;
+
+		using SlotArray = std::array<CommandHandle, c_max_tracked_slots>;
+		using StageSlotArray = std::array<SlotArray, static_cast<size_t>(ShaderStage::STAGE_COUNT)>;
+		using StageOffsetArray = std::array<std::array<uint32_t, c_max_tracked_slots>, static_cast<size_t>(ShaderStage::STAGE_COUNT)>;
+
+		static constexpr uint32_t c_whole_buffer = UINT32_MAX;
+
+		struct BindingState
+		{
+			PrimitiveTopology topology = PrimitiveTopology::TRIANGLE_LIST;
+			bool topology_set = false;
+
+			CommandHandle input_layout = nullptr;
+			std::array<CommandHandle, static_cast<size_t>(ShaderStage::STAGE_COUNT)> shaders = {};
+
+			SlotArray vertex_buffers = {};
+			CommandHandle index_buffer = nullptr;
+			StageSlotArray constant_buffers = {};
+			StageOffsetArray constant_buffer_offsets = get_whole_buffer_offsets(); // c_whole_buffer unless bound as a range
+			StageSlotArray shader_resources = {};
+			SlotArray unordered_access_views = {};
+		};
+
+		static StageOffsetArray get_whole_buffer_offsets();
+
+		void track_binding(CommandHandle& bound_handle, CommandHandle new_handle);
+		void track_constant_buffer_range(const Commands::SetConstantBufferRange& command);
+		void track_bindings(SlotArray& slots, const Commands::SetBindings& command);
+
+		BindingState m_state;
+		CommandStatistics m_statistics;
+	};
+}
+#endif
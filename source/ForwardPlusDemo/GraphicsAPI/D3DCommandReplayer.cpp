@@ -0,0 +1,245 @@
+#include <ForwardPlusDemo/GraphicsAPI/D3DCommandReplayer.hpp>
+
+namespace ForwardPlusDemo
+{
+	namespace
+	{
+		template<typename T>
+		T* get_d3d_object(CommandHandle handle)
+		{
+			return static_cast<T*>(const_cast<void*>(handle));
+		}
+
+		template<typename T>
+		void get_d3d_objects(const Commands::SetBindings& command, std::array<T*, Commands::c_max_bindings>& objects)
+		{
+			for (uint32_t current_binding_index = 0; current_binding_index < command.count; ++current_binding_index)
+			{
+				objects[current_binding_index] = get_d3d_object<T>(command.handles[current_binding_index]);
+			}
+		}
+
+		D3D11_PRIMITIVE_TOPOLOGY get_d3d_topology(PrimitiveTopology topology)
+		{
+			switch (topology)
+			{
+			case PrimitiveTopology::LINE_LIST:
+				return D3D11_PRIMITIVE_TOPOLOGY_LINELIST;
+			default:
+				return D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+			}
+		}
+	}
+
+	void D3DCommandReplayer::set_device_context(D3DDeviceContext* device_context)
+	{
+		m_device_context = device_context;
+
+		m_device_context1.Reset();
+		if (m_device_context != nullptr)
+		{
+			m_device_context->QueryInterface(IID_PPV_ARGS(m_device_context1.ReleaseAndGetAddressOf()));
+		}
+	}
+
+	void D3DCommandReplayer::replay(const CommandList& command_list)
+	{
+		CommandList::Iterator command_it = command_list.get_iterator();
+		while (command_it.is_valid() == true)
+		{
+			switch (command_it.get_type())
+			{
+			case CommandType::SET_PRIMITIVE_TOPOLOGY:
+				m_device_context->IASetPrimitiveTopology(get_d3d_topology(command_it.get_command<Commands::SetPrimitiveTopology>()->topology));
+				break;
+			case CommandType::SET_INPUT_LAYOUT:
+				m_device_context->IASetInputLayout(get_d3d_object<ID3D11InputLayout>(command_it.get_command<Commands::SetInputLayout>()->input_layout));
+				break;
+			case CommandType::SET_SHADER:
+			{
+				const Commands::SetShader* command = command_it.get_command<Commands::SetShader>();
+				switch (command->stage)
+				{
+				case ShaderStage::VERTEX:
+					m_device_context->VSSetShader(get_d3d_object<ID3D11VertexShader>(command->shader), nullptr, 0);
+					break;
+				case ShaderStage::PIXEL:
+					m_device_context->PSSetShader(get_d3d_object<ID3D11PixelShader>(command->shader), nullptr, 0);
+					break;
+				case ShaderStage::COMPUTE:
+					m_device_context->CSSetShader(get_d3d_object<ID3D11ComputeShader>(command->shader), nullptr, 0);
+					break;
+				}
+			}
+				break;
+			case CommandType::SET_VERTEX_BUFFER:
+			{
+				const Commands::SetVertexBuffer* command = command_it.get_command<Commands::SetVertexBuffer>();
+
+				ID3D11Buffer* vertex_buffer = get_d3d_object<ID3D11Buffer>(command->buffer);
+				m_device_context->IASetVertexBuffers(command->slot, 1, &vertex_buffer, &command->stride, &command->offset);
+			}
+				break;
+			case CommandType::SET_INDEX_BUFFER:
+			{
+				const Commands::SetIndexBuffer* command = command_it.get_command<Commands::SetIndexBuffer>();
+
+				const DXGI_FORMAT index_format = (command->format == IndexFormat::UINT16) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+				m_device_context->IASetIndexBuffer(get_d3d_object<ID3D11Buffer>(command->buffer), index_format, command->offset);
+			}
+				break;
+			case CommandType::SET_CONSTANT_BUFFERS:
+				set_constant_buffers(*command_it.get_command<Commands::SetBindings>());
+				break;
+			case CommandType::SET_CONSTANT_BUFFER_RANGE:
+				set_constant_buffer_range(*command_it.get_command<Commands::SetConstantBufferRange>());
+				break;
+			case CommandType::SET_SHADER_RESOURCES:
+				set_shader_resources(*command_it.get_command<Commands::SetBindings>());
+				break;
+			case CommandType::SET_UNORDERED_ACCESS_VIEWS:
+				set_unordered_access_views(*command_it.get_command<Commands::SetBindings>());
+				break;
+			case CommandType::UPDATE_BUFFER:
+				update_buffer(*command_it.get_command<Commands::UpdateBuffer>(), command_it.get_payload<Commands::UpdateBuffer>());
+				break;
+			case CommandType::UPDATE_BUFFER_RANGE:
+				update_buffer_range(*command_it.get_command<Commands::UpdateBufferRange>(), command_it.get_payload<Commands::UpdateBufferRange>());
+				break;
+			case CommandType::CLEAR_UNORDERED_ACCESS_VIEW:
+			{
+				const Commands::ClearUnorderedAccessView* command = command_it.get_command<Commands::ClearUnorderedAccessView>();
+				m_device_context->ClearUnorderedAccessViewUint(get_d3d_object<ID3D11UnorderedAccessView>(command->view), command->values.data());
+			}
+				break;
+			case CommandType::DRAW:
+			{
+				const Commands::Draw* command = command_it.get_command<Commands::Draw>();
+				m_device_context->Draw(command->vertex_count, command->start_vertex);
+			}
+				break;
+			case CommandType::DRAW_INSTANCED:
+			{
+				const Commands::DrawInstanced* command = command_it.get_command<Commands::DrawInstanced>();
+				m_device_context->DrawInstanced(command->vertex_count, command->instance_count, command->start_vertex, command->start_instance);
+			}
+				break;
+			case CommandType::DRAW_INDEXED_INSTANCED:
+			{
+				const Commands::DrawIndexedInstanced* command = command_it.get_command<Commands::DrawIndexedInstanced>();
+				m_device_context->DrawIndexedInstanced(command->index_count, command->instance_count, command->start_index, command->base_vertex, command->start_instance);
+			}
+				break;
+			case CommandType::DISPATCH:
+			{
+				const Commands::Dispatch* command = command_it.get_command<Commands::Dispatch>();
+				m_device_context->Dispatch(command->group_count_x, command->group_count_y, command->group_count_z);
+			}
+				break;
+			}
+
+			command_it.advance();
+		}
+	}
+
+	void D3DCommandReplayer::set_constant_buffers(const Commands::SetBindings& command)
+	{
+		std::array<ID3D11Buffer*, Commands::c_max_bindings> buffers = {};
+		get_d3d_objects(command, buffers);
+
+		switch (command.stage)
+		{
+		case ShaderStage::VERTEX:
+			m_device_context->VSSetConstantBuffers(command.start_slot, command.count, buffers.data());
+			break;
+		case ShaderStage::PIXEL:
+			m_device_context->PSSetConstantBuffers(command.start_slot, command.count, buffers.data());
+			break;
+		case ShaderStage::COMPUTE:
+			m_device_context->CSSetConstantBuffers(command.start_slot, command.count, buffers.data());
+			break;
+		}
+	}
+
+	void D3DCommandReplayer::set_constant_buffer_range(const Commands::SetConstantBufferRange& command)
+	{
+		ID3D11Buffer* buffer = get_d3d_object<ID3D11Buffer>(command.buffer);
+
+		// Offsets & sizes are in shader constants, the size has to be a multiple of 16 constants as well
+		constexpr uint32_t c_constant_size = 16;
+		const UINT first_constant = command.offset / c_constant_size;
+		const UINT constant_count = ((command.size + Commands::c_constant_buffer_offset_alignment - 1) / Commands::c_constant_buffer_offset_alignment) * (Commands::c_constant_buffer_offset_alignment / c_constant_size);
+
+		switch (command.stage)
+		{
+		case ShaderStage::VERTEX:
+			m_device_context1->VSSetConstantBuffers1(command.slot, 1, &buffer, &first_constant, &constant_count);
+			break;
+		case ShaderStage::PIXEL:
+			m_device_context1->PSSetConstantBuffers1(command.slot, 1, &buffer, &first_constant, &constant_count);
+			break;
+		case ShaderStage::COMPUTE:
+			m_device_context1->CSSetConstantBuffers1(command.slot, 1, &buffer, &first_constant, &constant_count);
+			break;
+		}
+	}
+
+	void D3DCommandReplayer::set_shader_resources(const Commands::SetBindings& command)
+	{
+		std::array<ID3D11ShaderResourceView*, Commands::c_max_bindings> views = {};
+		get_d3d_objects(command, views);
+
+		switch (command.stage)
+		{
+		case ShaderStage::VERTEX:
+			m_device_context->VSSetShaderResources(command.start_slot, command.count, views.data());
+			break;
+		case ShaderStage::PIXEL:
+			m_device_context->PSSetShaderResources(command.start_slot, command.count, views.data());
+			break;
+		case ShaderStage::COMPUTE:
+			m_device_context->CSSetShaderResources(command.start_slot, command.count, views.data());
+			break;
+		}
+	}
+
+	void D3DCommandReplayer::set_unordered_access_views(const Commands::SetBindings& command)
+	{
+		std::array<ID3D11UnorderedAccessView*, Commands::c_max_bindings> views = {};
+		get_d3d_objects(command, views);
+
+		m_device_context->CSSetUnorderedAccessViews(command.start_slot, command.count, views.data(), nullptr);
+	}
+
+	void D3DCommandReplayer::update_buffer(const Commands::UpdateBuffer& command, const void* data)
+	{
+		ID3D11Buffer* buffer = get_d3d_object<ID3D11Buffer>(command.buffer);
+
+		D3D11_MAPPED_SUBRESOURCE mapped_subresource;
+		ZeroMemory(&mapped_subresource, sizeof(D3D11_MAPPED_SUBRESOURCE));
+
+		const HRESULT result = m_device_context->Map(buffer, 0, D3D11_MAP::D3D11_MAP_WRITE_DISCARD, 0, &mapped_subresource);
+		if (SUCCEEDED(result))
+		{
+			memcpy(mapped_subresource.pData, data, command.data_size);
+		}
+
+		m_device_context->Unmap(buffer, 0);
+	}
+
+	void D3DCommandReplayer::update_buffer_range(const Commands::UpdateBufferRange& command, const void* data)
+	{
+		ID3D11Buffer* buffer = get_d3d_object<ID3D11Buffer>(command.buffer);
+
+		D3D11_MAPPED_SUBRESOURCE mapped_subresource;
+		ZeroMemory(&mapped_subresource, sizeof(D3D11_MAPPED_SUBRESOURCE));
+
+		// No renaming, the caller guarantees the GPU is done with this part of the buffer
+		const HRESULT result = m_device_context->Map(buffer, 0, D3D11_MAP::D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mapped_subresource);
+		if (SUCCEEDED(result))
+		{
+			memcpy(static_cast<char*>(mapped_subresource.pData) + command.offset, data, command.data_size);
+			m_device_context->Unmap(buffer, 0);
+		}
+	}
+}
@@ -0,0 +1,27 @@
+#ifndef FORWARDPLUSDEMO_GRAPHICSAPI_D3DCOMMANDREPLAYER_HPP
+#define FORWARDPLUSDEMO_GRAPHICSAPI_D3DCOMMANDREPLAYER_HPP
+#include <ForwardPlusDemo/GraphicsAPI/Common.hpp>
+#include <ForwardPlusDemo/GraphicsAPI/CommandList.hpp>
+namespace ForwardPlusDemo
+{
+	// Executes recorded commands on a D3D11 device context, must be used from the thread that owns the context
+	class D3DCommandReplayer : public CommandReplayer
+	{
+	public:
+		// The context has to support D3D11.1 constant buffer offsets (checked by GraphicsAPI)
+		void set_device_context(D3DDeviceContext* device_context);
+
+		void replay(const CommandList& command_list) override;
+	private:
+		void set_constant_buffers(const Commands::SetBindings& command);
+		void set_constant_buffer_range(const Commands::SetConstantBufferRange& command);
+		void set_shader_resources(const Commands::SetBindings& command);
+		void set_unordered_access_views(const Commands::SetBindings& command);
+		void update_buffer(const Commands::UpdateBuffer& command, const void* data);
+		void update_buffer_range(const Commands::UpdateBufferRange& command, const void* data);
+
+		D3DDeviceContext* m_device_context = nullptr;
+		ComPtr<D3DDeviceContext1> m_device_context1;
+	};
+}
+#endif
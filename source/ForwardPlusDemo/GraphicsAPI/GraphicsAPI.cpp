@@ -1,6 +1,8 @@
  #include <ForwardPlusDemo/GraphicsAPI/GraphicsAPI.hpp>
 
 #include <ForwardPlusDemo/Application/Application.hpp>
+#include <ForwardPlusDemo/GraphicsAPI/D3DCommandReplayer.hpp>
+#include <ForwardPlusDemo/GraphicsAPI/NullDevice.hpp>
 
 #ifndef NDEBUG
 #include <dxgidebug.h>
@@ -11,6 +13,13 @@
 
 namespace
 {
+	// Render target size used by the null backend, matches the default window size
+	constexpr UINT c_null_device_width = 1024;
+	constexpr UINT c_null_device_height = 768;
+
+	// Event queries used as frame fences, the CPU waits when it gets this far ahead of the GPU
+	constexpr uint32_t c_max_frames_in_flight = 8;
+
 	struct RenderWindowState
 	{
 		UINT width = 0;
@@ -37,8 +46,16 @@ namespace ForwardPlusDemo
 	{
 		Application& m_application;
 
+		GraphicsBackend m_backend = GraphicsBackend::D3D11;
 		RenderWindowState m_window_state;
 
+		D3DCommandReplayer m_d3d_command_replayer;
+		std::unique_ptr<NullDevice> m_null_device;
+
+		std::array<ComPtr<ID3D11Query>, c_max_frames_in_flight> m_frame_queries;
+		uint64_t m_frame_fence_value = 1;
+		uint64_t m_completed_fence_value = 0;
+
 		ComPtr<IDXGISwapChain> m_swap_chain;
 		ComPtr<ID3D11RenderTargetView> m_back_buffer_view;
 		ComPtr<ID3D11Texture2D> m_back_buffer_texture;
@@ -66,6 +83,12 @@ namespace ForwardPlusDemo
 
 		~Internal()
 		{
+			if (m_backend == GraphicsBackend::NULL_DEVICE)
+			{
+				// Nothing was created on the D3D side
+				return;
+			}
+
 			// Perform explicit cleanup so we can use the debug output
 			m_device_context->ClearState();
 			m_device_context->Flush();
@@ -102,8 +125,15 @@ namespace ForwardPlusDemo
 			m_dxgi_factory.Reset();
 		}
 
-		bool initialize()
+		bool initialize(GraphicsBackend backend)
 		{
+			m_backend = backend;
+
+			if (m_backend == GraphicsBackend::NULL_DEVICE)
+			{
+				return initialize_null_device();
+			}
+
 			// NOTE: feature level is 10.1, although this is not relevant, as 10.0 should also work
 			// The main limitation is in the compute shader features (particularly the lack of atomics)
 			constexpr D3D_FEATURE_LEVEL c_feature_level = D3D_FEATURE_LEVEL::D3D_FEATURE_LEVEL_10_1;
@@ -271,6 +301,41 @@ namespace ForwardPlusDemo
 				return false;
 			}
 
+			// Per-frame constants are bound as ranges of one big buffer, written without renaming
+			{
+				D3D11_FEATURE_DATA_D3D11_OPTIONS options;
+				ZeroMemory(&options, sizeof(D3D11_FEATURE_DATA_D3D11_OPTIONS));
+
+				if (FAILED(m_device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(D3D11_FEATURE_DATA_D3D11_OPTIONS)))
+					|| !options.ConstantBufferOffsetting || !options.MapNoOverwriteOnDynamicConstantBuffer)
+				{
+					OutputDebugStringA("Constant buffer offsets are not supported by this device\n");
+					return false;
+				}
+			}
+
+			for (ComPtr<ID3D11Query>& current_query : m_frame_queries)
+			{
+				D3D11_QUERY_DESC query_desc;
+				ZeroMemory(&query_desc, sizeof(D3D11_QUERY_DESC));
+				query_desc.Query = D3D11_QUERY_EVENT;
+
+				if (FAILED(m_device->CreateQuery(&query_desc, current_query.ReleaseAndGetAddressOf())))
+				{
+					return false;
+				}
+			}
+
+			m_d3d_command_replayer.set_device_context(m_device_context.Get());
+
+			return true;
+		}
+
+		bool initialize_null_device()
+		{
+			m_null_device = std::make_unique<NullDevice>();
+			m_window_state.update_size(c_null_device_width, c_null_device_height);
+
 			return true;
 		}
 
@@ -282,6 +347,11 @@ namespace ForwardPlusDemo
 				return true;
 			}
 
+			if (m_backend == GraphicsBackend::NULL_DEVICE)
+			{
+				return true;
+			}
+
 			// Release prior references to back buffer
 			m_back_buffer_texture.Reset();
 			m_back_buffer_view.Reset();
@@ -480,6 +550,14 @@ namespace ForwardPlusDemo
 
 		void begin_frame()
 		{
+			if (m_backend == GraphicsBackend::NULL_DEVICE)
+			{
+				m_null_device->begin_frame();
+				return;
+			}
+
+			update_completed_fence_value(false);
+
 			// Clear back buffer
 			constexpr FLOAT c_clear_color[] = { 0.0f, 0.0f, 1.0f, 1.0f };
 			m_device_context->ClearRenderTargetView(m_back_buffer_view.Get(), &c_clear_color[0]);
@@ -495,13 +573,57 @@ namespace ForwardPlusDemo
 
 		void end_frame()
 		{
+			if (m_backend == GraphicsBackend::NULL_DEVICE)
+			{
+				m_null_device->end_frame();
+				return;
+			}
+
+			// The query slot is reused, so the frame that last used it has to be done
+			if (m_frame_fence_value > c_max_frames_in_flight)
+			{
+				while (m_completed_fence_value < (m_frame_fence_value - c_max_frames_in_flight))
+				{
+					update_completed_fence_value(true);
+				}
+			}
+
+			m_device_context->End(get_frame_query(m_frame_fence_value));
+			++m_frame_fence_value;
+
 			// Assume everything has been drawn, present to the swap chain
 			m_swap_chain->Present(0, 0);
 		}
+
+		ID3D11Query* get_frame_query(uint64_t fence_value) const
+		{
+			return m_frame_queries[fence_value % c_max_frames_in_flight].Get();
+		}
+
+		// Retires the finished frames in order, flushing makes sure the oldest one eventually finishes when waiting on it
+		void update_completed_fence_value(bool flush)
+		{
+			const UINT get_data_flags = flush ? 0 : D3D11_ASYNC_GETDATA_DONOTFLUSH;
+
+			while ((m_completed_fence_value + 1) < m_frame_fence_value)
+			{
+				if (m_device_context->GetData(get_frame_query(m_completed_fence_value + 1), nullptr, 0, get_data_flags) != S_OK)
+				{
+					return;
+				}
+
+				++m_completed_fence_value;
+			}
+		}
 	};
 
 	GraphicsAPI::~GraphicsAPI() = default;
 
+	GraphicsBackend GraphicsAPI::get_backend() const
+	{
+		return m_internal->m_backend;
+	}
+
 	D3DDevice* GraphicsAPI::get_device() const
 	{
 		return m_internal->m_device.Get();
@@ -512,20 +634,55 @@ namespace ForwardPlusDemo
 		return m_internal->m_device_context.Get();
 	}
 
+	NullDevice* GraphicsAPI::get_null_device() const
+	{
+		return m_internal->m_null_device.get();
+	}
+
+	CommandReplayer& GraphicsAPI::get_command_replayer()
+	{
+		if (m_internal->m_backend == GraphicsBackend::NULL_DEVICE)
+		{
+			return *m_internal->m_null_device;
+		}
+
+		return m_internal->m_d3d_command_replayer;
+	}
+
 	void GraphicsAPI::get_window_resolution(UINT& width, UINT& height)
 	{
 		width = m_internal->m_window_state.width;
 		height = m_internal->m_window_state.height;
 	}
 
+	uint64_t GraphicsAPI::get_frame_fence_value() const
+	{
+		if (m_internal->m_backend == GraphicsBackend::NULL_DEVICE)
+		{
+			return m_internal->m_null_device->get_frame_count() + 1;
+		}
+
+		return m_internal->m_frame_fence_value;
+	}
+
+	uint64_t GraphicsAPI::get_completed_fence_value() const
+	{
+		if (m_internal->m_backend == GraphicsBackend::NULL_DEVICE)
+		{
+			return m_internal->m_null_device->get_frame_count();
+		}
+
+		return m_internal->m_completed_fence_value;
+	}
+
 	GraphicsAPI::GraphicsAPI(Application& application)
 		: m_internal(std::make_unique<Internal>(application))
 	{
 	}
 
-	bool GraphicsAPI::initialize()
+	bool GraphicsAPI::initialize(GraphicsBackend backend)
 	{
-		return m_internal->initialize();
+		return m_internal->initialize(backend);
 	}
 
 	void GraphicsAPI::begin_frame()
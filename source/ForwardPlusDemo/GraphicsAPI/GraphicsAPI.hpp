@@ -7,19 +7,40 @@
 namespace ForwardPlusDemo
 {
 	class Application;
+	class CommandReplayer;
+	class NullDevice;
+
+	enum class GraphicsBackend
+	{
+		D3D11,
+		NULL_DEVICE // Headless, no window or GPU required
+	};
+
 	class GraphicsAPI
 	{
 	public:
 		~GraphicsAPI();
 
+		GraphicsBackend get_backend() const;
+
+		// Only valid for the matching backend, null otherwise
 		D3DDevice* get_device() const;
 		D3DDeviceContext* get_device_context() const;
+		NullDevice* get_null_device() const;
+
+		// Executes recorded command lists with the active backend
+		CommandReplayer& get_command_replayer();
 
 		void get_window_resolution(UINT& width, UINT& height);
+
+		// Every frame signals a fence value when it ends, values complete in order once the GPU is done with the frame
+		// The null device finishes its work during replay, so its frames complete right away
+		uint64_t get_frame_fence_value() const; // Signaled by the frame being recorded
+		uint64_t get_completed_fence_value() const;
 	private:
 		GraphicsAPI(Application& application);
 
-		bool initialize();
+		bool initialize(GraphicsBackend backend);
 
 		void begin_frame();
 		void end_frame();
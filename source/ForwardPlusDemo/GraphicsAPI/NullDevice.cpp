@@ -0,0 +1,376 @@
+#include <ForwardPlusDemo/GraphicsAPI/NullDevice.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace ForwardPlusDemo
+{
+	struct NullDevice::Resource
+	{
+		std::vector<uint64_t> data; // 8 byte aligned storage, large enough for any of the shader structs
+		uint32_t size = 0;
+
+		NullComputeKernel kernel;
+	};
+
+	NullDevice::NullDevice() = default;
+
+	NullDevice::~NullDevice() = default;
+
+	CommandHandle NullDevice::create_buffer(uint32_t size, const void* initial_data)
+	{
+		std::unique_ptr<Resource> resource = std::make_unique<Resource>();
+		resource->data.resize((size + sizeof(uint64_t) - 1) / sizeof(uint64_t), 0);
+		resource->size = size;
+
+		if ((initial_data != nullptr) && (size > 0))
+		{
+			std::memcpy(resource->data.data(), initial_data, size);
+		}
+
+		m_resources.push_back(std::move(resource));
+		return m_resources.back().get();
+	}
+
+	CommandHandle NullDevice::create_compute_shader(NullComputeKernel kernel)
+	{
+		std::unique_ptr<Resource> resource = std::make_unique<Resource>();
+		resource->kernel = std::move(kernel);
+
+		m_resources.push_back(std::move(resource));
+		return m_resources.back().get();
+	}
+
+	CommandHandle NullDevice::create_object()
+	{
+		m_resources.push_back(std::make_unique<Resource>());
+		return m_resources.back().get();
+	}
+
+	void NullDevice::release(CommandHandle handle)
+	{
+		auto resource_it = std::find_if(m_resources.begin(), m_resources.end(), [handle](const std::unique_ptr<Resource>& resource) { return resource.get() == handle; });
+		if (resource_it != m_resources.end())
+		{
+			m_resources.erase(resource_it);
+		}
+	}
+
+	NullBufferView NullDevice::get_buffer(CommandHandle handle) const
+	{
+		NullBufferView view;
+
+		Resource* resource = get_resource(handle);
+		if (resource != nullptr)
+		{
+			view.data = resource->data.data();
+			view.size = resource->size;
+		}
+
+		return view;
+	}
+
+	void NullDevice::begin_frame()
+	{
+		assert(m_in_frame == false);
+		m_in_frame = true;
+
+		if (m_graphics_pipeline != nullptr)
+		{
+			m_graphics_pipeline->begin_frame();
+		}
+	}
+
+	void NullDevice::end_frame()
+	{
+		assert(m_in_frame == true);
+		m_in_frame = false;
+
+		if (m_graphics_pipeline != nullptr)
+		{
+			m_graphics_pipeline->end_frame();
+		}
+
+		// Stands in for Present, nothing to wait on
+		++m_frame_count;
+	}
+
+	void NullDevice::replay(const CommandList& command_list)
+	{
+		CommandList::Iterator command_it = command_list.get_iterator();
+		while (command_it.is_valid() == true)
+		{
+			switch (command_it.get_type())
+			{
+			case CommandType::SET_PRIMITIVE_TOPOLOGY:
+				m_topology = command_it.get_command<Commands::SetPrimitiveTopology>()->topology;
+				break;
+			case CommandType::SET_SHADER:
+			{
+				const Commands::SetShader* command = command_it.get_command<Commands::SetShader>();
+				m_shaders[get_stage_index(command->stage)] = command->shader;
+			}
+				break;
+			case CommandType::SET_VERTEX_BUFFER:
+			{
+				// Only slot 0 is used by the renderer
+				const Commands::SetVertexBuffer* command = command_it.get_command<Commands::SetVertexBuffer>();
+				if (command->slot == 0)
+				{
+					m_vertex_buffer = command->buffer;
+					m_vertex_stride = command->stride;
+					m_vertex_offset = command->offset;
+				}
+			}
+				break;
+			case CommandType::SET_INDEX_BUFFER:
+			{
+				const Commands::SetIndexBuffer* command = command_it.get_command<Commands::SetIndexBuffer>();
+				m_index_buffer = command->buffer;
+				m_index_format = command->format;
+				m_index_offset = command->offset;
+			}
+				break;
+			case CommandType::SET_CONSTANT_BUFFERS:
+				set_constant_buffers(*command_it.get_command<Commands::SetBindings>());
+				break;
+			case CommandType::SET_CONSTANT_BUFFER_RANGE:
+				set_constant_buffer_range(*command_it.get_command<Commands::SetConstantBufferRange>());
+				break;
+			case CommandType::SET_SHADER_RESOURCES:
+			{
+				const Commands::SetBindings* command = command_it.get_command<Commands::SetBindings>();
+				set_bindings(m_shader_resources[get_stage_index(command->stage)], *command);
+			}
+				break;
+			case CommandType::SET_UNORDERED_ACCESS_VIEWS:
+				set_bindings(m_unordered_access_views, *command_it.get_command<Commands::SetBindings>());
+				break;
+			case CommandType::UPDATE_BUFFER:
+				update_buffer(*command_it.get_command<Commands::UpdateBuffer>(), command_it.get_payload<Commands::UpdateBuffer>());
+				break;
+			case CommandType::UPDATE_BUFFER_RANGE:
+				update_buffer_range(*command_it.get_command<Commands::UpdateBufferRange>(), command_it.get_payload<Commands::UpdateBufferRange>());
+				break;
+			case CommandType::CLEAR_UNORDERED_ACCESS_VIEW:
+				clear_unordered_access_view(*command_it.get_command<Commands::ClearUnorderedAccessView>());
+				break;
+			case CommandType::DRAW:
+			{
+				const Commands::Draw* command = command_it.get_command<Commands::Draw>();
+				draw(command->vertex_count, 1, command->start_vertex, 0);
+			}
+				break;
+			case CommandType::DRAW_INSTANCED:
+			{
+				const Commands::DrawInstanced* command = command_it.get_command<Commands::DrawInstanced>();
+				draw(command->vertex_count, command->instance_count, command->start_vertex, command->start_instance);
+			}
+				break;
+			case CommandType::DRAW_INDEXED_INSTANCED:
+				draw_indexed(*command_it.get_command<Commands::DrawIndexedInstanced>());
+				break;
+			case CommandType::DISPATCH:
+				dispatch(*command_it.get_command<Commands::Dispatch>());
+				break;
+			default:
+				// Input layouts have no effect, vertex layouts are known by the pipeline
+				break;
+			}
+
+			command_it.advance();
+		}
+
+		m_command_counter.replay(command_list);
+	}
+
+	void NullDevice::set_bindings(SlotArray& slots, const Commands::SetBindings& command)
+	{
+		for (uint32_t current_binding_index = 0; current_binding_index < command.count; ++current_binding_index)
+		{
+			const uint32_t slot = command.start_slot + current_binding_index;
+			if (slot < slots.size())
+			{
+				slots[slot] = command.handles[current_binding_index];
+			}
+		}
+	}
+
+	void NullDevice::fill_views(std::array<NullBufferView, NullDispatchContext::c_max_slots>& views, const SlotArray& slots) const
+	{
+		for (size_t current_slot = 0; current_slot < slots.size(); ++current_slot)
+		{
+			views[current_slot] = get_buffer(slots[current_slot]);
+		}
+	}
+
+	void NullDevice::fill_constant_buffer_views(std::array<NullBufferView, NullDispatchContext::c_max_slots>& views, ShaderStage stage) const
+	{
+		fill_views(views, m_constant_buffers[get_stage_index(stage)]);
+
+		// Views of a range start at its offset, like the shader sees them
+		for (size_t current_slot = 0; current_slot < views.size(); ++current_slot)
+		{
+			const BufferRange& range = m_constant_buffer_ranges[get_stage_index(stage)][current_slot];
+			NullBufferView& view = views[current_slot];
+
+			if (range.offset >= view.size)
+			{
+				view = NullBufferView();
+				continue;
+			}
+
+			view.data = static_cast<char*>(view.data) + range.offset;
+			view.size = std::min(view.size - range.offset, range.size);
+		}
+	}
+
+	void NullDevice::set_constant_buffers(const Commands::SetBindings& command)
+	{
+		set_bindings(m_constant_buffers[get_stage_index(command.stage)], command);
+
+		for (uint32_t current_binding_index = 0; current_binding_index < command.count; ++current_binding_index)
+		{
+			const uint32_t slot = command.start_slot + current_binding_index;
+			if (slot < NullDispatchContext::c_max_slots)
+			{
+				m_constant_buffer_ranges[get_stage_index(command.stage)][slot] = BufferRange();
+			}
+		}
+	}
+
+	void NullDevice::set_constant_buffer_range(const Commands::SetConstantBufferRange& command)
+	{
+		if (command.slot >= NullDispatchContext::c_max_slots)
+		{
+			return;
+		}
+
+		m_constant_buffers[get_stage_index(command.stage)][command.slot] = command.buffer;
+		m_constant_buffer_ranges[get_stage_index(command.stage)][command.slot] = BufferRange{ command.offset, command.size };
+	}
+
+	NullDevice::Resource* NullDevice::get_resource(CommandHandle handle) const
+	{
+		// Handles only ever come from this device, so they can be used directly
+		return static_cast<Resource*>(const_cast<void*>(handle));
+	}
+
+	void NullDevice::update_buffer(const Commands::UpdateBuffer& command, const void* data)
+	{
+		Resource* resource = get_resource(command.buffer);
+		if (resource == nullptr)
+		{
+			return;
+		}
+
+		assert(command.data_size <= resource->size);
+		std::memcpy(resource->data.data(), data, std::min(command.data_size, resource->size));
+	}
+
+	void NullDevice::update_buffer_range(const Commands::UpdateBufferRange& command, const void* data)
+	{
+		Resource* resource = get_resource(command.buffer);
+		if (resource == nullptr)
+		{
+			return;
+		}
+
+		assert((static_cast<uint64_t>(command.offset) + command.data_size) <= resource->size);
+		if (command.offset < resource->size)
+		{
+			std::memcpy(reinterpret_cast<char*>(resource->data.data()) + command.offset, data, std::min(command.data_size, resource->size - command.offset));
+		}
+	}
+
+	void NullDevice::clear_unordered_access_view(const Commands::ClearUnorderedAccessView& command)
+	{
+		Resource* resource = get_resource(command.view);
+		if (resource == nullptr)
+		{
+			return;
+		}
+
+		// Buffer UAVs are cleared with the first value only (same as D3D for single channel formats)
+		uint32_t* values = reinterpret_cast<uint32_t*>(resource->data.data());
+		std::fill(values, values + (resource->size / sizeof(uint32_t)), command.values[0]);
+	}
+
+	void NullDevice::dispatch(const Commands::Dispatch& command)
+	{
+		Resource* shader = get_resource(m_shaders[get_stage_index(ShaderStage::COMPUTE)]);
+		if ((shader == nullptr) || !shader->kernel)
+		{
+			return;
+		}
+
+		NullDispatchContext context;
+		context.group_counts = { command.group_count_x, command.group_count_y, command.group_count_z };
+
+		fill_constant_buffer_views(context.constant_buffers, ShaderStage::COMPUTE);
+		fill_views(context.shader_resources, m_shader_resources[get_stage_index(ShaderStage::COMPUTE)]);
+		fill_views(context.unordered_access_views, m_unordered_access_views);
+
+		shader->kernel(context);
+	}
+
+	void NullDevice::draw(uint32_t vertex_count, uint32_t instance_count, uint32_t start_vertex, uint32_t start_instance)
+	{
+		if (m_graphics_pipeline == nullptr)
+		{
+			return;
+		}
+
+		NullDrawContext context;
+		fill_draw_context(context);
+
+		context.vertex_count = vertex_count;
+		context.instance_count = instance_count;
+		context.start_vertex = start_vertex;
+		context.start_instance = start_instance;
+
+		m_graphics_pipeline->draw(context);
+	}
+
+	void NullDevice::draw_indexed(const Commands::DrawIndexedInstanced& command)
+	{
+		if (m_graphics_pipeline == nullptr)
+		{
+			return;
+		}
+
+		NullDrawContext context;
+		fill_draw_context(context);
+
+		context.indexed = true;
+		context.index_buffer = get_buffer(m_index_buffer);
+		context.index_format = m_index_format;
+		context.index_offset = m_index_offset;
+
+		context.vertex_count = command.index_count;
+		context.instance_count = command.instance_count;
+		context.start_index = command.start_index;
+		context.base_vertex = command.base_vertex;
+		context.start_instance = command.start_instance;
+
+		m_graphics_pipeline->draw(context);
+	}
+
+	void NullDevice::fill_draw_context(NullDrawContext& context) const
+	{
+		context.topology = m_topology;
+
+		context.vertex_shader = m_shaders[get_stage_index(ShaderStage::VERTEX)];
+		context.pixel_shader = m_shaders[get_stage_index(ShaderStage::PIXEL)];
+
+		context.vertex_buffer = get_buffer(m_vertex_buffer);
+		context.vertex_stride = m_vertex_stride;
+		context.vertex_offset = m_vertex_offset;
+
+		fill_constant_buffer_views(context.vertex_constant_buffers, ShaderStage::VERTEX);
+		fill_views(context.vertex_shader_resources, m_shader_resources[get_stage_index(ShaderStage::VERTEX)]);
+		fill_constant_buffer_views(context.pixel_constant_buffers, ShaderStage::PIXEL);
+		fill_views(context.pixel_shader_resources, m_shader_resources[get_stage_index(ShaderStage::PIXEL)]);
+	}
+}
@@ -0,0 +1,199 @@
+#ifndef FORWARDPLUSDEMO_GRAPHICSAPI_NULLDEVICE_HPP
+#define FORWARDPLUSDEMO_GRAPHICSAPI_NULLDEVICE_HPP
+#include <ForwardPlusDemo/GraphicsAPI/CommandList.hpp>
+#include <ForwardPlusDemo/GraphicsAPI/CountingCommandReplayer.hpp>
+
+#include <functional>
+#include <memory>
+namespace ForwardPlusDemo
+{
+	// Host memory behind a null device buffer (or view, views alias their buffer)
+	struct NullBufferView
+	{
+		void* data = nullptr;
+		uint32_t size = 0;
+
+		template<typename T>
+		T* as() const { return static_cast<T*>(data); }
+
+		template<typename T>
+		uint32_t get_element_count() const { return size / sizeof(T); }
+	};
+
+	// Compute resources bound at the time of a dispatch
+	struct NullDispatchContext
+	{
+		static constexpr uint32_t c_max_slots = 16;
+
+		std::array<uint32_t, 3> group_counts = {};
+
+		std::array<NullBufferView, c_max_slots> constant_buffers;
+		std::array<NullBufferView, c_max_slots> shader_resources;
+		std::array<NullBufferView, c_max_slots> unordered_access_views;
+	};
+
+	// CPU stand-in for a compute shader, runs once per dispatch
+	using NullComputeKernel = std::function<void(const NullDispatchContext&)>;
+
+	// Graphics pipeline state at the time of a draw
+	struct NullDrawContext
+	{
+		using ViewArray = std::array<NullBufferView, NullDispatchContext::c_max_slots>;
+
+		PrimitiveTopology topology = PrimitiveTopology::TRIANGLE_LIST;
+
+		CommandHandle vertex_shader = nullptr;
+		CommandHandle pixel_shader = nullptr;
+
+		NullBufferView vertex_buffer;
+		uint32_t vertex_stride = 0;
+		uint32_t vertex_offset = 0;
+
+		uint32_t vertex_count = 0; // Index count for indexed draws
+		uint32_t instance_count = 1;
+		uint32_t start_vertex = 0;
+		uint32_t start_instance = 0;
+
+		// Indexed draws only, indices are relative to base_vertex
+		bool indexed = false;
+		NullBufferView index_buffer;
+		IndexFormat index_format = IndexFormat::UINT16;
+		uint32_t index_offset = 0;
+		uint32_t start_index = 0;
+		int32_t base_vertex = 0;
+
+		ViewArray vertex_constant_buffers;
+		ViewArray vertex_shader_resources;
+		ViewArray pixel_constant_buffers;
+		ViewArray pixel_shader_resources;
+
+		// Vertex buffer element for the Nth vertex of the draw, false when it falls outside the bound buffers
+		bool get_vertex_index(uint32_t draw_vertex, uint32_t& vertex_index) const
+		{
+			if (indexed == false)
+			{
+				vertex_index = start_vertex + draw_vertex;
+				return true;
+			}
+
+			const size_t index_size = (index_format == IndexFormat::UINT16) ? sizeof(uint16_t) : sizeof(uint32_t);
+			const size_t offset = index_offset + (static_cast<size_t>(start_index) + draw_vertex) * index_size;
+			if ((offset + index_size) > index_buffer.size)
+			{
+				return false;
+			}
+
+			const char* index_data = index_buffer.as<const char>() + offset;
+			const uint32_t index = (index_format == IndexFormat::UINT16) ? *reinterpret_cast<const uint16_t*>(index_data) : *reinterpret_cast<const uint32_t*>(index_data);
+
+			const int64_t base_index = static_cast<int64_t>(base_vertex) + index;
+			if (base_index < 0)
+			{
+				return false;
+			}
+
+			vertex_index = static_cast<uint32_t>(base_index);
+			return true;
+		}
+	};
+
+	// Optional draw implementation for the null device (e.g a software rasterizer), without one draws are only counted
+	class NullGraphicsPipeline
+	{
+	public:
+		virtual ~NullGraphicsPipeline() = default;
+
+		virtual void begin_frame() = 0;
+		virtual void draw(const NullDrawContext& context) = 0;
+		virtual void end_frame() = 0;
+	};
+
+	// Device for the null graphics backend, resources live in host memory and handles are plain pointers
+	// Uploads and UAV clears are applied, dispatches run their CPU kernel, draws go to the graphics pipeline if one is set
+	// Like the D3D immediate context, replay has to happen on a single thread
+	class NullDevice : public CommandReplayer
+	{
+	public:
+		NullDevice();
+		~NullDevice();
+
+		// Buffer contents are zero initialized unless initial data is given
+		CommandHandle create_buffer(uint32_t size, const void* initial_data = nullptr);
+		CommandHandle create_compute_shader(NullComputeKernel kernel);
+
+		// Shaders, input layouts & such, only their identity matters
+		CommandHandle create_object();
+
+		void release(CommandHandle handle);
+
+		NullBufferView get_buffer(CommandHandle handle) const;
+
+		// The pipeline has to outlive the device, or be unset first
+		void set_graphics_pipeline(NullGraphicsPipeline* graphics_pipeline) { m_graphics_pipeline = graphics_pipeline; }
+
+		void begin_frame();
+		void end_frame();
+
+		uint64_t get_frame_count() const { return m_frame_count; }
+		const CommandStatistics& get_statistics() const { return m_command_counter.get_statistics(); }
+
+		void replay(const CommandList& command_list) override;
+	private:
+		struct Resource;
+
+		using SlotArray = std::array<CommandHandle, NullDispatchContext::c_max_slots>;
+		using StageSlotArray = std::array<SlotArray, static_cast<size_t>(ShaderStage::STAGE_COUNT)>;
+
+		// Bound part of a constant buffer, all of it unless bound with set_constant_buffer_range
+		struct BufferRange
+		{
+			uint32_t offset = 0;
+			uint32_t size = UINT32_MAX;
+		};
+
+		using StageRangeArray = std::array<std::array<BufferRange, NullDispatchContext::c_max_slots>, static_cast<size_t>(ShaderStage::STAGE_COUNT)>;
+
+		static size_t get_stage_index(ShaderStage stage) { return static_cast<size_t>(stage); }
+
+		void set_bindings(SlotArray& slots, const Commands::SetBindings& command);
+		void fill_views(std::array<NullBufferView, NullDispatchContext::c_max_slots>& views, const SlotArray& slots) const;
+		void fill_constant_buffer_views(std::array<NullBufferView, NullDispatchContext::c_max_slots>& views, ShaderStage stage) const;
+		void set_constant_buffers(const Commands::SetBindings& command);
+		void set_constant_buffer_range(const Commands::SetConstantBufferRange& command);
+
+		Resource* get_resource(CommandHandle handle) const;
+
+		void update_buffer(const Commands::UpdateBuffer& command, const void* data);
+		void update_buffer_range(const Commands::UpdateBufferRange& command, const void* data);
+		void clear_unordered_access_view(const Commands::ClearUnorderedAccessView& command);
+		void dispatch(const Commands::Dispatch& command);
+		void draw(uint32_t vertex_count, uint32_t instance_count, uint32_t start_vertex, uint32_t start_instance);
+		void draw_indexed(const Commands::DrawIndexedInstanced& command);
+		void fill_draw_context(NullDrawContext& context) const;
+
+		std::vector<std::unique_ptr<Resource>> m_resources;
+
+		PrimitiveTopology m_topology = PrimitiveTopology::TRIANGLE_LIST;
+		CommandHandle m_vertex_buffer = nullptr;
+		uint32_t m_vertex_stride = 0;
+		uint32_t m_vertex_offset = 0;
+
+		CommandHandle m_index_buffer = nullptr;
+		IndexFormat m_index_format = IndexFormat::UINT16;
+		uint32_t m_index_offset = 0;
+
+		std::array<CommandHandle, static_cast<size_t>(ShaderStage::STAGE_COUNT)> m_shaders = {};
+		StageSlotArray m_constant_buffers = {};
+		StageRangeArray m_constant_buffer_ranges = {};
+		StageSlotArray m_shader_resources = {};
+		SlotArray m_unordered_access_views = {};
+
+		NullGraphicsPipeline* m_graphics_pipeline = nullptr;
+
+		CountingCommandReplayer m_command_counter;
+
+		uint64_t m_frame_count = 0;
+		bool m_in_frame = false;
+	};
+}
+#endif
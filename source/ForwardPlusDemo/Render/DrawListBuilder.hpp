@@ -0,0 +1,122 @@
+#ifndef FORWARDPLUSDEMO_RENDER_DRAWLISTBUILDER_HPP
+#define FORWARDPLUSDEMO_RENDER_DRAWLISTBUILDER_HPP
+#include <ForwardPlusDemo/Render/RenderSystem.hpp>
+#include <ForwardPlusDemo/Utilities/RadixSort.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+namespace ForwardPlusDemo
+{
+	struct DrawBatch
+	{
+		ObjectType type = ObjectType::CUBE;
+		uint32_t first_instance = 0; // Into the instance array of the builder
+		uint32_t instance_count = 0;
+	};
+
+	// 64 bit draw order, from the most significant bits: object type (8), view depth (24), instance index (32)
+	// Sorting groups draws by the state they need first, then front to back so the depth test rejects more pixels
+	// The index makes every key unique, so the order only depends on the instances and not on how they were added
+	namespace DrawSortKey
+	{
+		constexpr uint32_t c_type_shift = 56;
+		constexpr uint32_t c_depth_shift = 32;
+		constexpr uint64_t c_depth_mask = (1ull << 24) - 1;
+
+		// Top 24 bits of the float, which order like the depth itself for positive values
+		// Keeps 15 mantissa bits, so the precision follows the distance instead of a fixed depth range
+		inline uint64_t quantize_depth(float view_depth)
+		{
+			return std::bit_cast<uint32_t>(std::max(view_depth, 0.0f)) >> 8;
+		}
+
+		inline uint64_t make(ObjectType type, float view_depth, uint32_t instance_index)
+		{
+			return (static_cast<uint64_t>(type) << c_type_shift) | ((quantize_depth(view_depth) & c_depth_mask) << c_depth_shift) | instance_index;
+		}
+
+		// Draws with the same state bits can share one instanced draw
+		inline uint32_t get_state(uint64_t key) { return static_cast<uint32_t>(key >> c_type_shift); }
+		inline ObjectType get_type(uint64_t key) { return static_cast<ObjectType>(get_state(key)); }
+		inline uint32_t get_instance_index(uint64_t key) { return static_cast<uint32_t>(key); }
+	}
+
+	// Sorts visible instances by state and depth, so each object type can be submitted as a single front to back instanced draw
+	// Has no graphics API dependencies, the renderer uploads the instance array and issues one draw per batch
+	template<typename InstanceData>
+	class DrawListBuilder
+	{
+	public:
+		void begin()
+		{
+			m_added_instances.clear();
+			m_sort_keys.clear();
+
+			m_instances.clear();
+			m_batches.clear();
+		}
+
+		// View depth is the distance along the camera forward axis, anything behind the camera sorts first
+		void add_instance(ObjectType type, float view_depth, const InstanceData& instance_data)
+		{
+			m_sort_keys.push_back(DrawSortKey::make(type, view_depth, static_cast<uint32_t>(m_added_instances.size())));
+			m_added_instances.push_back(instance_data);
+		}
+
+		// Appends count instances to be filled with set_instance, returns the index of the first one
+		// Different indices can be set from different threads, as long as nothing is added meanwhile
+		uint32_t add_instances(uint32_t count)
+		{
+			const uint32_t first_index = static_cast<uint32_t>(m_added_instances.size());
+
+			m_sort_keys.resize(first_index + count);
+			m_added_instances.resize(first_index + count);
+
+			return first_index;
+		}
+
+		void set_instance(uint32_t index, ObjectType type, float view_depth, const InstanceData& instance_data)
+		{
+			m_sort_keys[index] = DrawSortKey::make(type, view_depth, index);
+			m_added_instances[index] = instance_data;
+		}
+
+		// Lays out the instances in key order and starts a batch whenever the state bits change
+		void build()
+		{
+			radix_sort(m_sort_keys, m_sort_scratch);
+
+			m_instances.reserve(m_sort_keys.size());
+
+			for (const uint64_t current_key : m_sort_keys)
+			{
+				if (m_batches.empty() || (DrawSortKey::get_state(current_key) != static_cast<uint32_t>(m_batches.back().type)))
+				{
+					DrawBatch batch;
+					batch.type = DrawSortKey::get_type(current_key);
+					batch.first_instance = static_cast<uint32_t>(m_instances.size());
+
+					m_batches.push_back(batch);
+				}
+
+				m_instances.push_back(m_added_instances[DrawSortKey::get_instance_index(current_key)]);
+				++m_batches.back().instance_count;
+			}
+		}
+
+		const std::vector<InstanceData>& get_instances() const { return m_instances; }
+		const std::vector<DrawBatch>& get_batches() const { return m_batches; }
+
+		// Every batch after the first switches the mesh & draw constants
+		uint32_t get_state_change_count() const { return m_batches.empty() ? 0 : static_cast<uint32_t>(m_batches.size() - 1); }
+	private:
+		std::vector<InstanceData> m_added_instances;
+		std::vector<uint64_t> m_sort_keys;
+		std::vector<uint64_t> m_sort_scratch;
+
+		std::vector<InstanceData> m_instances;
+		std::vector<DrawBatch> m_batches;
+	};
+}
+#endif
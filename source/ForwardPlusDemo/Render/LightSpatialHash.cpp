@@ -0,0 +1,330 @@
+#include <ForwardPlusDemo/Render/LightSpatialHash.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace ForwardPlusDemo
+{
+	namespace
+	{
+		// Lights covering more cells than this go to a separate list that every query checks
+		constexpr int64_t c_max_cells_per_light = 512;
+
+		constexpr int32_t c_cell_coordinate_bits = 21;
+		constexpr int32_t c_cell_coordinate_bias = 1 << (c_cell_coordinate_bits - 1);
+		constexpr uint64_t c_cell_coordinate_mask = (1ULL << c_cell_coordinate_bits) - 1;
+
+		uint64_t get_cell_key(int32_t x, int32_t y, int32_t z)
+		{
+			const uint64_t key_x = static_cast<uint64_t>(x + c_cell_coordinate_bias) & c_cell_coordinate_mask;
+			const uint64_t key_y = static_cast<uint64_t>(y + c_cell_coordinate_bias) & c_cell_coordinate_mask;
+			const uint64_t key_z = static_cast<uint64_t>(z + c_cell_coordinate_bias) & c_cell_coordinate_mask;
+
+			return (key_x << (2 * c_cell_coordinate_bits)) | (key_y << c_cell_coordinate_bits) | key_z;
+		}
+
+		Vector3i get_cell_coordinates(uint64_t key)
+		{
+			const int32_t x = static_cast<int32_t>((key >> (2 * c_cell_coordinate_bits)) & c_cell_coordinate_mask) - c_cell_coordinate_bias;
+			const int32_t y = static_cast<int32_t>((key >> c_cell_coordinate_bits) & c_cell_coordinate_mask) - c_cell_coordinate_bias;
+			const int32_t z = static_cast<int32_t>(key & c_cell_coordinate_mask) - c_cell_coordinate_bias;
+
+			return Vector3i(x, y, z);
+		}
+
+		int64_t get_cell_count(const Vector3i& min, const Vector3i& max)
+		{
+			return static_cast<int64_t>(max.x - min.x + 1) * static_cast<int64_t>(max.y - min.y + 1) * static_cast<int64_t>(max.z - min.z + 1);
+		}
+
+		bool is_in_range(const Vector3i& cell, const Vector3i& min, const Vector3i& max)
+		{
+			return (cell.x >= min.x) && (cell.x <= max.x) && (cell.y >= min.y) && (cell.y <= max.y) && (cell.z >= min.z) && (cell.z <= max.z);
+		}
+	}
+
+	LightSpatialHash::LightSpatialHash(float cell_size)
+		: m_cell_size(cell_size)
+		, m_inv_cell_size(1.0f / cell_size)
+	{
+	}
+
+	void LightSpatialHash::clear()
+	{
+		std::unique_lock lock = lock_exclusive();
+
+		m_cells.clear();
+		m_oversized_lights.clear();
+		m_lights.clear();
+		m_light_count = 0;
+	}
+
+	void LightSpatialHash::insert(uint32_t light_id, const DirectX::BoundingSphere& bounds)
+	{
+		std::unique_lock lock = lock_exclusive();
+
+		if (light_id >= m_lights.size())
+		{
+			m_lights.resize(light_id + 1);
+		}
+
+		LightEntry& entry = m_lights[light_id];
+		if (entry.valid)
+		{
+			remove_from_cells(light_id, entry);
+			--m_light_count;
+		}
+
+		const Vector3 bounds_min(bounds.Center.x - bounds.Radius, bounds.Center.y - bounds.Radius, bounds.Center.z - bounds.Radius);
+		const Vector3 bounds_max(bounds.Center.x + bounds.Radius, bounds.Center.y + bounds.Radius, bounds.Center.z + bounds.Radius);
+
+		entry.bounds = bounds;
+		entry.cells = get_cell_range(bounds_min, bounds_max);
+		entry.valid = true;
+		entry.oversized = get_cell_count(entry.cells.min, entry.cells.max) > c_max_cells_per_light;
+
+		add_to_cells(light_id, entry);
+		++m_light_count;
+	}
+
+	void LightSpatialHash::update(uint32_t light_id, const DirectX::BoundingSphere& bounds)
+	{
+		{
+			std::unique_lock lock = lock_exclusive();
+
+			if ((light_id < m_lights.size()) && m_lights[light_id].valid)
+			{
+				LightEntry& entry = m_lights[light_id];
+
+				const Vector3 bounds_min(bounds.Center.x - bounds.Radius, bounds.Center.y - bounds.Radius, bounds.Center.z - bounds.Radius);
+				const Vector3 bounds_max(bounds.Center.x + bounds.Radius, bounds.Center.y + bounds.Radius, bounds.Center.z + bounds.Radius);
+				const CellRange new_cells = get_cell_range(bounds_min, bounds_max);
+
+				const bool same_cells = (new_cells.min.x == entry.cells.min.x) && (new_cells.min.y == entry.cells.min.y) && (new_cells.min.z == entry.cells.min.z)
+					&& (new_cells.max.x == entry.cells.max.x) && (new_cells.max.y == entry.cells.max.y) && (new_cells.max.z == entry.cells.max.z);
+
+				if (same_cells)
+				{
+					// Common case for small movements, only the bounds change
+					entry.bounds = bounds;
+					return;
+				}
+			}
+		}
+
+		// Cell membership changed (or light is new), reinsert
+		insert(light_id, bounds);
+	}
+
+	void LightSpatialHash::remove(uint32_t light_id)
+	{
+		std::unique_lock lock = lock_exclusive();
+
+		if ((light_id >= m_lights.size()) || !m_lights[light_id].valid)
+		{
+			return;
+		}
+
+		LightEntry& entry = m_lights[light_id];
+		remove_from_cells(light_id, entry);
+
+		entry.valid = false;
+		--m_light_count;
+	}
+
+	void LightSpatialHash::query(const DirectX::BoundingBox& bounds, std::vector<uint32_t>& light_ids) const
+	{
+		const Vector3 bounds_min(bounds.Center.x - bounds.Extents.x, bounds.Center.y - bounds.Extents.y, bounds.Center.z - bounds.Extents.z);
+		const Vector3 bounds_max(bounds.Center.x + bounds.Extents.x, bounds.Center.y + bounds.Extents.y, bounds.Center.z + bounds.Extents.z);
+
+		query_range(get_cell_range(bounds_min, bounds_max), light_ids, [&bounds](const LightEntry& entry) { return entry.bounds.Intersects(bounds); });
+	}
+
+	void LightSpatialHash::query(const DirectX::BoundingSphere& bounds, std::vector<uint32_t>& light_ids) const
+	{
+		const Vector3 bounds_min(bounds.Center.x - bounds.Radius, bounds.Center.y - bounds.Radius, bounds.Center.z - bounds.Radius);
+		const Vector3 bounds_max(bounds.Center.x + bounds.Radius, bounds.Center.y + bounds.Radius, bounds.Center.z + bounds.Radius);
+
+		query_range(get_cell_range(bounds_min, bounds_max), light_ids, [&bounds](const LightEntry& entry) { return entry.bounds.Intersects(bounds); });
+	}
+
+	void LightSpatialHash::query(const Vector3& point, std::vector<uint32_t>& light_ids) const
+	{
+		const XMVector xm_point = to_xmvector(point);
+		query_range(get_cell_range(point, point), light_ids, [&xm_point](const LightEntry& entry) { return entry.bounds.Contains(xm_point) != DirectX::DISJOINT; });
+	}
+
+	size_t LightSpatialHash::get_light_count() const
+	{
+		std::shared_lock lock = lock_shared();
+		return m_light_count;
+	}
+
+	std::unique_lock<std::shared_mutex> LightSpatialHash::lock_exclusive()
+	{
+		m_waiting_writer_count.fetch_add(1);
+		std::unique_lock lock(m_mutex);
+
+		if (m_waiting_writer_count.fetch_sub(1) == 1)
+		{
+			m_waiting_writer_count.notify_all();
+		}
+
+		return lock;
+	}
+
+	std::shared_lock<std::shared_mutex> LightSpatialHash::lock_shared() const
+	{
+		// Let waiting writers in first, the shared_mutex itself may prefer readers
+		uint32_t waiting_writer_count = m_waiting_writer_count.load();
+		while (waiting_writer_count != 0)
+		{
+			m_waiting_writer_count.wait(waiting_writer_count);
+			waiting_writer_count = m_waiting_writer_count.load();
+		}
+
+		return std::shared_lock(m_mutex);
+	}
+
+	LightSpatialHash::CellRange LightSpatialHash::get_cell_range(const Vector3& min, const Vector3& max) const
+	{
+		auto to_cell = [this](float coordinate)
+		{
+			const float cell = std::floor(coordinate * m_inv_cell_size);
+			return static_cast<int32_t>(std::clamp(cell, static_cast<float>(-c_cell_coordinate_bias), static_cast<float>(c_cell_coordinate_bias - 1)));
+		};
+
+		CellRange range;
+		range.min = Vector3i(to_cell(min.x), to_cell(min.y), to_cell(min.z));
+		range.max = Vector3i(to_cell(max.x), to_cell(max.y), to_cell(max.z));
+
+		return range;
+	}
+
+	void LightSpatialHash::add_to_cells(uint32_t light_id, const LightEntry& entry)
+	{
+		if (entry.oversized)
+		{
+			m_oversized_lights.push_back(light_id);
+			return;
+		}
+
+		for (int32_t z = entry.cells.min.z; z <= entry.cells.max.z; ++z)
+		{
+			for (int32_t y = entry.cells.min.y; y <= entry.cells.max.y; ++y)
+			{
+				for (int32_t x = entry.cells.min.x; x <= entry.cells.max.x; ++x)
+				{
+					m_cells[get_cell_key(x, y, z)].push_back(light_id);
+				}
+			}
+		}
+	}
+
+	void LightSpatialHash::remove_from_cells(uint32_t light_id, const LightEntry& entry)
+	{
+		auto remove_id = [light_id](std::vector<uint32_t>& id_vector)
+		{
+			auto id_it = std::find(id_vector.begin(), id_vector.end(), light_id);
+			if (id_it != id_vector.end())
+			{
+				// Order within a cell does not matter
+				*id_it = id_vector.back();
+				id_vector.pop_back();
+			}
+		};
+
+		if (entry.oversized)
+		{
+			remove_id(m_oversized_lights);
+			return;
+		}
+
+		for (int32_t z = entry.cells.min.z; z <= entry.cells.max.z; ++z)
+		{
+			for (int32_t y = entry.cells.min.y; y <= entry.cells.max.y; ++y)
+			{
+				for (int32_t x = entry.cells.min.x; x <= entry.cells.max.x; ++x)
+				{
+					auto cell_it = m_cells.find(get_cell_key(x, y, z));
+					if (cell_it == m_cells.end())
+					{
+						continue;
+					}
+
+					remove_id(cell_it->second);
+					if (cell_it->second.empty())
+					{
+						m_cells.erase(cell_it);
+					}
+				}
+			}
+		}
+	}
+
+	template<typename TestFunc>
+	void LightSpatialHash::query_range(const CellRange& query_cells, std::vector<uint32_t>& light_ids, TestFunc&& test) const
+	{
+		std::shared_lock lock = lock_shared();
+
+		// A light spanning several cells is only reported from the first cell where it overlaps the query range
+		auto process_cell = [this, &query_cells, &light_ids, &test](const Vector3i& cell, const std::vector<uint32_t>& cell_lights)
+		{
+			for (uint32_t current_light_id : cell_lights)
+			{
+				const LightEntry& entry = m_lights[current_light_id];
+
+				const Vector3i first_cell(std::max(entry.cells.min.x, query_cells.min.x), std::max(entry.cells.min.y, query_cells.min.y), std::max(entry.cells.min.z, query_cells.min.z));
+				if ((first_cell.x != cell.x) || (first_cell.y != cell.y) || (first_cell.z != cell.z))
+				{
+					continue;
+				}
+
+				if (test(entry))
+				{
+					light_ids.push_back(current_light_id);
+				}
+			}
+		};
+
+		if (get_cell_count(query_cells.min, query_cells.max) <= static_cast<int64_t>(m_cells.size()))
+		{
+			// Visit the cells covered by the query
+			for (int32_t z = query_cells.min.z; z <= query_cells.max.z; ++z)
+			{
+				for (int32_t y = query_cells.min.y; y <= query_cells.max.y; ++y)
+				{
+					for (int32_t x = query_cells.min.x; x <= query_cells.max.x; ++x)
+					{
+						auto cell_it = m_cells.find(get_cell_key(x, y, z));
+						if (cell_it != m_cells.end())
+						{
+							process_cell(Vector3i(x, y, z), cell_it->second);
+						}
+					}
+				}
+			}
+		}
+		else
+		{
+			// Query covers more cells than are occupied, cheaper to visit the occupied ones
+			for (const auto& current_cell : m_cells)
+			{
+				const Vector3i cell = get_cell_coordinates(current_cell.first);
+				if (is_in_range(cell, query_cells.min, query_cells.max))
+				{
+					process_cell(cell, current_cell.second);
+				}
+			}
+		}
+
+		for (uint32_t current_light_id : m_oversized_lights)
+		{
+			if (test(m_lights[current_light_id]))
+			{
+				light_ids.push_back(current_light_id);
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef FORWARDPLUSDEMO_RENDER_LIGHTSPATIALHASH_HPP
+#define FORWARDPLUSDEMO_RENDER_LIGHTSPATIALHASH_HPP
+#include <ForwardPlusDemo/Render/Math.hpp>
+
+#include <DirectXCollision.h>
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+namespace ForwardPlusDemo
+{
+	// Uniform spatial hash over light bounding spheres, for CPU-side "which lights affect this volume" queries
+	// Queries can run concurrently from any thread, insert/update/remove take an exclusive lock
+	// New queries wait while a writer is waiting, so a steady stream of queries can't starve updates
+	class LightSpatialHash
+	{
+	public:
+		explicit LightSpatialHash(float cell_size = 8.0f);
+
+		void clear();
+
+		// Light IDs are expected to be small and dense (e.g indices into the light array)
+		void insert(uint32_t light_id, const DirectX::BoundingSphere& bounds);
+		void update(uint32_t light_id, const DirectX::BoundingSphere& bounds);
+		void remove(uint32_t light_id);
+
+		// Results are appended, each light is reported at most once
+		void query(const DirectX::BoundingBox& bounds, std::vector<uint32_t>& light_ids) const;
+		void query(const DirectX::BoundingSphere& bounds, std::vector<uint32_t>& light_ids) const;
+		void query(const Vector3& point, std::vector<uint32_t>& light_ids) const;
+
+		size_t get_light_count() const;
+	private:
+		struct CellRange
+		{
+			Vector3i min;
+			Vector3i max;
+		};
+
+		struct LightEntry
+		{
+			DirectX::BoundingSphere bounds;
+			CellRange cells;
+			bool valid = false;
+			bool oversized = false;
+		};
+
+		CellRange get_cell_range(const Vector3& min, const Vector3& max) const;
+
+		void add_to_cells(uint32_t light_id, const LightEntry& entry);
+		void remove_from_cells(uint32_t light_id, const LightEntry& entry);
+
+		std::unique_lock<std::shared_mutex> lock_exclusive();
+		std::shared_lock<std::shared_mutex> lock_shared() const;
+
+		template<typename TestFunc>
+		void query_range(const CellRange& query_cells, std::vector<uint32_t>& light_ids, TestFunc&& test) const;
+
+		float m_cell_size;
+		float m_inv_cell_size;
+
+		std::unordered_map<uint64_t, std::vector<uint32_t>> m_cells;
+		std::vector<uint32_t> m_oversized_lights; // Lights that span too many cells are always tested
+		std::vector<LightEntry> m_lights;
+		size_t m_light_count = 0;
+
+		mutable std::shared_mutex m_mutex;
+		mutable std::atomic<uint32_t> m_waiting_writer_count = 0;
+	};
+}
+#endif
\ No newline at end of file
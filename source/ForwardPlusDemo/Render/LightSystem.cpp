@@ -2,9 +2,20 @@
 
 #include <ForwardPlusDemo/Application/Application.hpp>
 #include <ForwardPlusDemo/Render/RenderSystem.hpp>
+#include <ForwardPlusDemo/GraphicsAPI/CommandList.hpp>
+#include <ForwardPlusDemo/GraphicsAPI/ConstantBufferRing.hpp>
 #include <ForwardPlusDemo/GraphicsAPI/GraphicsAPI.hpp>
+#include <ForwardPlusDemo/GraphicsAPI/NullDevice.hpp>
 
 #include <ForwardPlusDemo/Render/Math.hpp>
+#include <ForwardPlusDemo/Render/LightSpatialHash.hpp>
+#include <ForwardPlusDemo/Render/LightVisibility.hpp>
+#include <ForwardPlusDemo/Render/TileCulling.hpp>
+
+#include <ForwardPlusDemo/Scene/SceneDescription.hpp>
+
+#include <ForwardPlusDemo/Utilities/JobSystem.hpp>
+#include <ForwardPlusDemo/Utilities/Profiler.hpp>
 
 #include <DirectXCollision.h>
 
@@ -15,6 +26,9 @@
 #include <cmath>
 #include <string>
 #include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <unordered_map>
 
 namespace ForwardPlusDemo
 {
@@ -54,19 +68,27 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
     return input.color;
 })";
 
-		constexpr uint32_t c_tile_x_dim = 32;
-		constexpr uint32_t c_tile_y_dim = 24;
-
 		constexpr uint32_t c_empty_z_bin = 0xFFFF;
 		constexpr uint32_t c_z_bin_min_mask = ((1 << 16) - 1);
 		constexpr uint32_t c_z_bin_count = 1024;
 		constexpr uint32_t c_z_binning_group_size = 128;
 
 		constexpr uint32_t c_max_light_count = 10000;
+		constexpr uint32_t c_min_light_job_size = 256; // Lights per job for the CPU side visibility tests & packing
+
+		// Per-object light lists are used below the enter count, and dropped above the exit count (the gap avoids flip-flopping every frame)
+		// Measured with the object_light_list_crossover benchmark (generated scenes, ~900 visible objects, 1080p): without large objects
+		// the lists shade 0.3-0.5x (streetlights), 0.4-0.7x (grid) and 0.7-1.0x (corridor) the lights of tiled culling at every count from 8 to 256,
+		// so the counts are bound by the CPU side instead, the list build grows from 0.1-0.2 ms at 32 lights to 0.2-0.3 ms at 48 and 0.7-1.3 ms at 256
+		constexpr uint32_t c_object_light_list_enter_count = 32;
+		constexpr uint32_t c_object_light_list_exit_count = 48;
+		// A large object touching every light (e.g. a ground plane) makes the lists shade 2.4-5.7x the lights of tiled culling from 8 lights on,
+		// which the counts can't catch, so the lists are also dropped when they cover more tiles than tiled culling would, then retried later
+		constexpr uint32_t c_object_light_list_retry_frame_count = 60;
+		constexpr uint32_t c_max_object_light_index_count = 65536;
 		constexpr uint32_t c_spot_light_culling_data_stride = 6;
 		constexpr uint32_t c_spot_light_max_triangle_count = 8;
 		constexpr uint32_t c_tiles_per_group = 4;
-		constexpr uint32_t c_light_batch_size = 32;
 		constexpr uint32_t c_max_cs_thread_count = 128;
 
 		enum class ForwardPlusShaderMacro
@@ -137,7 +159,6 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 		{
 			PARAMETERS,
 			CS_CONSTANTS,
-			Z_BINNING_CONSTANTS,
 			BUFFER_COUNT
 		};
 
@@ -150,6 +171,8 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 			TILE_CULLING_DATA,
 			TILE_BIT_MASKS,
 			LIGHT_DATA,
+			GLOBAL_LIGHT_DATA,
+			OBJECT_LIGHT_INDICES,
 			RESOURCE_COUNT
 		};
 
@@ -158,11 +181,6 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 			return (numerator + (denominator - 1)) / denominator;
 		}
 
-		float random_float(float min, float max)
-		{
-			return min + static_cast<float>(std::rand()) / (static_cast<float>(RAND_MAX / (max - min)));
-		}
-
 		constexpr uint32_t c_max_light_batch_count = integer_division_ceil(c_max_light_count, c_light_batch_size);
 
 		std::vector<ForwardPlusShaderMacro> get_default_shader_macros()
@@ -281,8 +299,6 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 			}
 		};
 
-		using LightDataVector = std::vector<LightData>;
-
 		struct alignas(16) ShaderLightInfo
 		{
 			uint32_t type = static_cast<uint32_t>(LightType::POINT);
@@ -317,9 +333,9 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 			{
 				position = to_vector3(light_data.get_position());
 
-				if (light_data.type == LightType::SPOT)
+				if ((light_data.type == LightType::SPOT) || (light_data.type == LightType::DIRECTIONAL))
 				{
-					direction = to_vector3(-light_data.transform.r[2]);
+					direction = to_vector3(DirectX::XMVector3Normalize(-light_data.transform.r[2]));
 				}
 
 				inv_range = 1.0f / light_data.range;
@@ -339,7 +355,7 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 		{
 			ShaderLightData global_light;
 
-			std::array<uint32_t, 4> light_counts; // In same order as light types
+			std::array<uint32_t, 4> light_counts; // Culled light counts in same order as light types, last element is the global light count
 
 			float z_near = 0.0f;
 			float z_far = 1.0f;
@@ -368,20 +384,11 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 			XMMatrix view_projection;
 		};
 
+		// One per Z binning dispatch, allocated from the constant buffer ring
 		struct alignas(16) ZBinningConstants
 		{
 			uint32_t invocation = 0; // This indicates which set of lights we are processing
 			Vector3i _padding = { 0, 0, 0 };
-
-			void update()
-			{
-				++invocation;
-			}
-
-			void reset()
-			{
-				invocation = 0;
-			}
 		};
 
 		int clamp_int(int value, int min, int max)
@@ -443,23 +450,56 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 			return z_bin_data;
 		}
 
+		// Screen tiles & view depth range of a light, to estimate what tiled culling would shade while object light lists are in use
+		struct LightTileRange
+		{
+			Vector2i tile_min;
+			Vector2i tile_max;
+			Vector2 z_range;
+			bool on_screen;
+		};
+
 		struct LightDebugVertex
 		{
 			Vector4 position;
 			Vector4 color;
 		};
 
+		// Everything recording a frame's light culling needs, written by prepare_frame while older frames are still being recorded
+		struct LightFrame
+		{
+			ForwardPlusParameters forward_plus_params;
+			ForwardPlusCSConstants cs_constants;
+
+			// Sorted by view Z
+			std::vector<ShaderLightInfo> light_info;
+			ShaderLightDataVector light_data;
+			std::vector<DirectX::BoundingSphere> light_bounds;
+
+			std::vector<XMMatrix> spot_light_models;
+			ShaderLightDataVector global_light_data; // Directional and screen-filling lights, not culled
+
+			bool use_object_light_lists = false;
+			std::vector<uint32_t> object_light_indices;
+			std::vector<LightTileRange> light_tile_ranges; // Same order as light_bounds, only with object light lists
+
+			std::vector<LightDebugVertex> debug_vertices;
+			XMMatrix debug_view_projection;
+
+			uint32_t get_light_count() const { return static_cast<uint32_t>(light_info.size()); }
+		};
+
 		struct LightDebugRender
 		{
 			Application& application;
 
 			Shader shader;
+			bool available = false; // Needs the D3D backend
 			bool enabled = false;
 
 			D3DBuffer vertex_buffer;
 			D3DBuffer camera_cbuffer;
 
-			std::vector<LightDebugVertex> debug_vertices;
 			uint32_t vbuffer_capacity = 0;
 
 			LightDebugRender(Application& app) : application(app) {}
@@ -467,6 +507,11 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 			bool initialize()
 			{
 				GraphicsAPI& graphics_api = application.get_render_system().get_graphics_api();
+				if (graphics_api.get_backend() != GraphicsBackend::D3D11)
+				{
+					return true;
+				}
+
 				ID3D11Device* d3d_device = graphics_api.get_device();
 
 				// Vertex shader
@@ -576,10 +621,12 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 					}
 				}
 
+				available = true;
+
 				return true;
 			}
 
-			void add_visible_light(const LightData& light, const ShaderLightData& shader_data)
+			void add_visible_light(std::vector<LightDebugVertex>& debug_vertices, const LightData& light, const ShaderLightData& shader_data) const
 			{
 				Vector4 light_position(shader_data.position.x, shader_data.position.y, shader_data.position.z, 1.0f);
 				switch (light.type)
@@ -692,7 +739,7 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 				}
 			}
 
-			void render()
+			void render(CommandList& command_list, const std::vector<LightDebugVertex>& debug_vertices, const XMMatrix& view_projection)
 			{
 				if (!enabled)
 				{
@@ -705,55 +752,34 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 				}
 
 				const uint32_t vertex_count = static_cast<uint32_t>(debug_vertices.size());
-				buffer_data();
-
-				GraphicsAPI& graphics_api = application.get_render_system().get_graphics_api();
+				buffer_data(command_list, debug_vertices, view_projection);
 
 				// Set primitive topology
-				ID3D11DeviceContext* device_context = graphics_api.get_device_context();
-				device_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
+				command_list.set_primitive_topology(PrimitiveTopology::LINE_LIST);
 
 				// Set shaders and constant buffers
 				{
-					device_context->VSSetShader(shader.vertex_shader.Get(), nullptr, 0);
-					device_context->IASetInputLayout(shader.input_layout.Get());
-					device_context->VSSetConstantBuffers(0, 1, camera_cbuffer.GetAddressOf());
-					device_context->PSSetShader(shader.pixel_shader.Get(), nullptr, 0);
+					const CommandHandle camera_cbuffer_handle = camera_cbuffer.Get();
+
+					command_list.set_shader(ShaderStage::VERTEX, shader.vertex_shader.Get());
+					command_list.set_input_layout(shader.input_layout.Get());
+					command_list.set_constant_buffers(ShaderStage::VERTEX, 0, 1, &camera_cbuffer_handle);
+					command_list.set_shader(ShaderStage::PIXEL, shader.pixel_shader.Get());
 				}
 
 				// Set vertex buffer
-				{
-					constexpr UINT c_vertex_stride = sizeof(LightDebugVertex);
-					constexpr UINT c_null_offset = 0;
-					device_context->IASetVertexBuffers(0, 1, vertex_buffer.GetAddressOf(), &c_vertex_stride, &c_null_offset);
-				}
+				command_list.set_vertex_buffer(0, vertex_buffer.Get(), sizeof(LightDebugVertex), 0);
 
 				// Draw the debug lines
-				device_context->Draw(vertex_count, 0);
+				command_list.draw(vertex_count, 0);
 			}
 
-			void buffer_data()
+			void buffer_data(CommandList& command_list, const std::vector<LightDebugVertex>& debug_vertices, const XMMatrix& view_projection)
 			{
 				GraphicsAPI& graphics_api = application.get_render_system().get_graphics_api();
-				ID3D11DeviceContext* device_context = graphics_api.get_device_context();
 
 				// Update the camera
-				{
-					const RenderSystem& render_system = application.get_render_system();
-					const CameraInfo camera_info = render_system.get_camera_info();
-					const XMMatrix view_projection = DirectX::XMMatrixMultiply(camera_info.view, render_system.get_camera_projection());
-
-					D3D11_MAPPED_SUBRESOURCE mapped_subresource;
-					ZeroMemory(&mapped_subresource, sizeof(D3D11_MAPPED_SUBRESOURCE));
-
-					const HRESULT result = device_context->Map(camera_cbuffer.Get(), 0, D3D11_MAP::D3D11_MAP_WRITE_DISCARD, 0, &mapped_subresource);
-					if (SUCCEEDED(result))
-					{
-						memcpy(mapped_subresource.pData, &view_projection, sizeof(XMMatrix));
-					}
-
-					device_context->Unmap(camera_cbuffer.Get(), 0);
-				}
+				command_list.update_buffer(camera_cbuffer.Get(), &view_projection, sizeof(XMMatrix));
 
 				{
 					const uint32_t vertex_count = static_cast<uint32_t>(debug_vertices.size());
@@ -784,18 +810,8 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 					else
 					{
 						// Simply map new data into vertex buffer
-						D3D11_MAPPED_SUBRESOURCE mapped_subresource;
-						ZeroMemory(&mapped_subresource, sizeof(D3D11_MAPPED_SUBRESOURCE));
-
-						const HRESULT result = device_context->Map(vertex_buffer.Get(), 0, D3D11_MAP::D3D11_MAP_WRITE_DISCARD, 0, &mapped_subresource);
-						if (SUCCEEDED(result))
-						{
-							memcpy(mapped_subresource.pData, debug_vertices.data(), sizeof(LightDebugVertex) * debug_vertices.size());
-						}
-
-						device_context->Unmap(vertex_buffer.Get(), 0);
+						command_list.update_buffer(vertex_buffer.Get(), debug_vertices.data(), static_cast<uint32_t>(sizeof(LightDebugVertex) * debug_vertices.size()));
 					}
-					debug_vertices.clear();
 				}
 			}
 		};
@@ -805,17 +821,35 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 	{
 		Application& m_application;
 
+		// Constants of the frame being prepared, copied into its LightFrame at the end
 		ForwardPlusParameters m_forward_plus_params;
 		ForwardPlusCSConstants m_cs_constants;
-		ZBinningConstants m_z_binning_constants;
 
-		LightDataVector m_active_lights;
+		// Scene light columns (mapped file or scene description), read in place
+		SceneLightView m_scene_lights;
+		std::vector<DirectX::BoundingSphere> m_light_bounds; // Per scene light, the only attribute derived up front
+		std::unordered_map<uint32_t, XMMatrix> m_moved_light_transforms; // Set by set_light_transform, the others come from the columns
+		LightSpatialHash m_spatial_hash; // Indexed by scene light index
+		std::vector<LightVisibility> m_light_visibility; // Per scene light, rebuilt every frame
 
+		// Visible lights of the frame being prepared, before sorting
 		std::vector<Vector2> m_light_z_ranges;
 		std::vector<ShaderLightInfo> m_light_info;
-		std::vector<XMMatrix> m_spot_light_models;
-
 		std::array<ShaderLightDataVector, static_cast<size_t>(LightType::TYPE_COUNT)> m_light_type_data;
+		std::vector<DirectX::BoundingSphere> m_visible_light_bounds; // Same order as m_light_info
+
+		// Carried over from frame to frame
+		bool m_use_object_light_lists = false;
+		bool m_object_light_indices_overflow = false;
+		uint64_t m_object_light_list_tile_count = 0; // Tiles times lights shaded by the object lists of the last frame
+		uint64_t m_tiled_light_tile_count = 0; // The same for tiled culling, estimated from the light & object tile ranges
+		uint32_t m_object_light_list_retry_frames = 0;
+		bool m_light_limit_reported = false;
+		bool m_global_light_limit_reported = false;
+
+		// One per pipeline slot, see RenderSystem::Internal::render_loop
+		std::vector<LightFrame> m_frames;
+		const LightFrame* m_recorded_frame = nullptr; // Read by the null device compute shaders while the commands are replayed
 
 		std::array<D3DComputeShader, static_cast<size_t>(ForwardPlusComputeShader::SHADER_COUNT)> m_compute_shaders;
 
@@ -825,6 +859,13 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 		std::array<D3DShaderResourceView, static_cast<size_t>(ForwardPlusShaderResource::RESOURCE_COUNT)> m_shader_resource_views;
 		std::array<D3DUnorderedAccessView, static_cast<size_t>(ForwardPlusShaderResource::RESOURCE_COUNT)> m_unordered_access_views;
 
+		// What the recorded commands refer to, either the D3D objects above or their null device counterparts
+		std::array<CommandHandle, static_cast<size_t>(ForwardPlusComputeShader::SHADER_COUNT)> m_compute_shader_handles = {};
+		std::array<CommandHandle, static_cast<size_t>(ForwardPlusConstantBuffer::BUFFER_COUNT)> m_constant_buffer_handles = {};
+		std::array<CommandHandle, static_cast<size_t>(ForwardPlusShaderResource::RESOURCE_COUNT)> m_shader_resource_buffer_handles = {};
+		std::array<CommandHandle, static_cast<size_t>(ForwardPlusShaderResource::RESOURCE_COUNT)> m_shader_resource_view_handles = {};
+		std::array<CommandHandle, static_cast<size_t>(ForwardPlusShaderResource::RESOURCE_COUNT)> m_unordered_access_view_handles = {};
+
 		LightDebugRender m_debug_render;
 
 		Internal(Application& application)
@@ -841,6 +882,12 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 		D3DShaderResourceView& get_shader_resource_view(ForwardPlusShaderResource shader_resource) { return m_shader_resource_views[static_cast<size_t>(shader_resource)]; }
 		D3DUnorderedAccessView& get_unordered_access_view(ForwardPlusShaderResource shader_resource) { return m_unordered_access_views[static_cast<size_t>(shader_resource)]; }
 
+		CommandHandle get_compute_shader_handle(ForwardPlusComputeShader shader) const { return m_compute_shader_handles[static_cast<size_t>(shader)]; }
+		CommandHandle get_constant_buffer_handle(ForwardPlusConstantBuffer buffer) const { return m_constant_buffer_handles[static_cast<size_t>(buffer)]; }
+		CommandHandle get_shader_resource_buffer_handle(ForwardPlusShaderResource shader_resource) const { return m_shader_resource_buffer_handles[static_cast<size_t>(shader_resource)]; }
+		CommandHandle get_shader_resource_view_handle(ForwardPlusShaderResource shader_resource) const { return m_shader_resource_view_handles[static_cast<size_t>(shader_resource)]; }
+		CommandHandle get_unordered_access_view_handle(ForwardPlusShaderResource shader_resource) const { return m_unordered_access_view_handles[static_cast<size_t>(shader_resource)]; }
+
 		uint32_t get_light_type_count(LightType type) const
 		{
 			const ShaderLightDataVector& light_data_vec = m_light_type_data[static_cast<size_t>(type)];
@@ -849,99 +896,88 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 
 		uint32_t get_total_light_count() const { return static_cast<uint32_t>(m_light_info.size()); }
 
-		void set_compute_shader_resources(const std::vector<ForwardPlusShaderResource>& srv_resources, ForwardPlusShaderResource uav_resource)
+		void set_compute_shader_resources(CommandList& command_list, const std::vector<ForwardPlusShaderResource>& srv_resources, ForwardPlusShaderResource uav_resource)
 		{
-			std::vector<ID3D11ShaderResourceView*> srv_vector;
+			std::vector<CommandHandle> srv_vector;
 			for (ForwardPlusShaderResource current_resource : srv_resources)
 			{
-				const D3DShaderResourceView& current_srv = get_shader_resource_view(current_resource);
-				srv_vector.push_back(current_srv.Get());
+				srv_vector.push_back(get_shader_resource_view_handle(current_resource));
 			}
 
 			// Set the UAV
-			const D3DUnorderedAccessView& current_uav = get_unordered_access_view(uav_resource);
+			const CommandHandle current_uav = get_unordered_access_view_handle(uav_resource);
 
-			D3DDeviceContext* d3d_context = m_application.get_render_system().get_graphics_api().get_device_context();
-			d3d_context->CSSetShaderResources(1, static_cast<uint32_t>(srv_vector.size()), srv_vector.data());
-			d3d_context->CSSetUnorderedAccessViews(0, 1, current_uav.GetAddressOf(), nullptr);
+			command_list.set_shader_resources(ShaderStage::COMPUTE, 1, static_cast<uint32_t>(srv_vector.size()), srv_vector.data());
+			command_list.set_unordered_access_views(0, 1, &current_uav);
 		}
 
-		void run_compute_shader(ForwardPlusComputeShader cs_type)
+		void run_compute_shader(CommandList& command_list, const LightFrame& frame, ForwardPlusComputeShader cs_type)
 		{
+			FORWARDPLUSDEMO_PROFILE_SCOPE("LightSystem::run_compute_shader");
+
 			// Set the compute shader
-			D3DDeviceContext* d3d_context = m_application.get_render_system().get_graphics_api().get_device_context();
-			d3d_context->CSSetShader(get_compute_shader(cs_type).Get(), nullptr, 0);
+			command_list.set_shader(ShaderStage::COMPUTE, get_compute_shader_handle(cs_type));
 
 			// Gather the resources and UAV
 			std::vector<ForwardPlusShaderResource> srv_resources;
 
 			// Unbind previously used resources
 			{
-				ID3D11ShaderResourceView* null_srv[2] = { nullptr };
-				d3d_context->CSSetShaderResources(1, 2, null_srv);
+				const CommandHandle null_srv[2] = { nullptr, nullptr };
+				command_list.set_shader_resources(ShaderStage::COMPUTE, 1, 2, null_srv);
 			}
 
 			{
-				ID3D11UnorderedAccessView* null_uav[] = { nullptr };
-				d3d_context->CSSetUnorderedAccessViews(0, 1, null_uav, 0);
+				const CommandHandle null_uav[] = { nullptr };
+				command_list.set_unordered_access_views(0, 1, null_uav);
 			}
 
 			switch (cs_type)
 			{
 			case ForwardPlusComputeShader::Z_BINNING:
 			{
-				set_compute_shader_resources(srv_resources, ForwardPlusShaderResource::Z_BINS);
+				set_compute_shader_resources(command_list, srv_resources, ForwardPlusShaderResource::Z_BINS);
 
 				// Reset the Z bins in the UAV
-				constexpr uint32_t z_bin_init[4] = { c_empty_z_bin, c_empty_z_bin, c_empty_z_bin, c_empty_z_bin };
-				const D3DUnorderedAccessView& z_bins_uav = get_unordered_access_view(ForwardPlusShaderResource::Z_BINS);
-
-				d3d_context->ClearUnorderedAccessViewUint(z_bins_uav.Get(), z_bin_init);
+				constexpr std::array<uint32_t, 4> z_bin_init = { c_empty_z_bin, c_empty_z_bin, c_empty_z_bin, c_empty_z_bin };
+				command_list.clear_unordered_access_view(get_unordered_access_view_handle(ForwardPlusShaderResource::Z_BINS), z_bin_init);
 
 				// Count how many dispatches are needed to process all lights
 				constexpr uint32_t group_count = integer_division_ceil(c_z_bin_count, c_z_binning_group_size);
-				const uint32_t dispatch_count = integer_division_ceil(get_total_light_count(), c_z_binning_group_size);
+				const uint32_t dispatch_count = integer_division_ceil(frame.get_light_count(), c_z_binning_group_size);
 
-				const D3DBuffer& z_binning_cbuffer = get_constant_buffer(ForwardPlusConstantBuffer::Z_BINNING_CONSTANTS);
-				d3d_context->CSSetConstantBuffers(2, 1, z_binning_cbuffer.GetAddressOf());
+				ConstantBufferRing& constant_buffer_ring = m_application.get_render_system().get_constant_buffer_ring();
 
 				for (uint32_t current_dispatch_index = 0; current_dispatch_index < dispatch_count; ++current_dispatch_index)
 				{
-					// Update the cbuffer in the shader
-					{
-						D3D11_MAPPED_SUBRESOURCE mapped_subresource;
-						ZeroMemory(&mapped_subresource, sizeof(D3D11_MAPPED_SUBRESOURCE));
+					// Each dispatch binds its own part of the ring instead of rewriting a shared cbuffer
+					ZBinningConstants z_binning_constants;
+					z_binning_constants.invocation = current_dispatch_index;
 
-						const HRESULT result = d3d_context->Map(z_binning_cbuffer.Get(), 0, D3D11_MAP::D3D11_MAP_WRITE_DISCARD, 0, &mapped_subresource);
-						if (SUCCEEDED(result))
-						{
-							memcpy(mapped_subresource.pData, &m_z_binning_constants, sizeof(ZBinningConstants));
-						}
-
-						d3d_context->Unmap(z_binning_cbuffer.Get(), 0);
+					ConstantBufferRange z_binning_range;
+					if (!constant_buffer_ring.allocate(z_binning_constants, z_binning_range))
+					{
+						assert(false);
+						break;
 					}
 
-					// Dispatch the current group
-					d3d_context->Dispatch(group_count, 1, 1);
+					z_binning_range.bind(command_list, ShaderStage::COMPUTE, 2);
 
-					// Update the cbuffer data for the next dispatch
-					m_z_binning_constants.update();
+					// Dispatch the current group
+					command_list.dispatch(group_count, 1, 1);
 				}
-
-				// Reset after we are done
-				m_z_binning_constants.reset();
 			}
 			break;
 			case ForwardPlusComputeShader::SPOT_LIGHT_TRANSFORM:
 			{
 				// Dispatch enough groups to cover all spot lights
-				const uint32_t group_count = integer_division_ceil(get_light_type_count(LightType::SPOT), c_max_cs_thread_count);
+				const uint32_t group_count = integer_division_ceil(frame.forward_plus_params.light_counts[static_cast<size_t>(LightType::SPOT)], c_max_cs_thread_count);
 				if (group_count > 0)
 				{
 					srv_resources.push_back(ForwardPlusShaderResource::SPOT_LIGHT_MODELS);
-					set_compute_shader_resources(srv_resources, ForwardPlusShaderResource::SPOT_LIGHT_CULLING_DATA);
+					set_compute_shader_resources(command_list, srv_resources, ForwardPlusShaderResource::SPOT_LIGHT_CULLING_DATA);
 
-					d3d_context->Dispatch(group_count, 1, 1);
+					command_list.dispatch(group_count, 1, 1);
 				}
 			}
 			break;
@@ -949,63 +985,70 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 			{
 				srv_resources.push_back(ForwardPlusShaderResource::SPOT_LIGHT_CULLING_DATA);
 				srv_resources.push_back(ForwardPlusShaderResource::LIGHT_DATA);
-				set_compute_shader_resources(srv_resources, ForwardPlusShaderResource::TILE_CULLING_DATA);
+				set_compute_shader_resources(command_list, srv_resources, ForwardPlusShaderResource::TILE_CULLING_DATA);
 
 				// Dispatch enough groups to cover all lights
-				const uint32_t group_count = integer_division_ceil(get_total_light_count(), c_max_cs_thread_count);
-				d3d_context->Dispatch(group_count, 1, 1);
+				const uint32_t group_count = integer_division_ceil(frame.get_light_count(), c_max_cs_thread_count);
+				command_list.dispatch(group_count, 1, 1);
 			}
 			break;
 			case ForwardPlusComputeShader::TILE_CULLING:
 			{
 				srv_resources.push_back(ForwardPlusShaderResource::TILE_CULLING_DATA);
-				set_compute_shader_resources(srv_resources, ForwardPlusShaderResource::TILE_BIT_MASKS);
+				set_compute_shader_resources(command_list, srv_resources, ForwardPlusShaderResource::TILE_BIT_MASKS);
 
 				// Dispatch enough groups to cover all lights for all tiles
-				const uint32_t group_x_dim = integer_division_ceil(get_total_light_count(), c_light_batch_size);
+				const uint32_t group_x_dim = integer_division_ceil(frame.get_light_count(), c_light_batch_size);
 				constexpr uint32_t group_y_dim = integer_division_ceil(c_tile_x_dim * c_tile_y_dim, c_tiles_per_group);
 
-				d3d_context->Dispatch(group_x_dim, group_y_dim, 1);
+				command_list.dispatch(group_x_dim, group_y_dim, 1);
 			}
 			break;
 			}
 		}
 
-		void set_pixel_shader_resources()
+		void set_pixel_shader_resources(CommandList& command_list)
 		{
-			D3DDeviceContext* d3d_context = m_application.get_render_system().get_graphics_api().get_device_context();
-			const D3DBuffer& forward_plus_params_cbuffer = get_constant_buffer(ForwardPlusConstantBuffer::PARAMETERS);
-			d3d_context->PSSetConstantBuffers(0, 1, forward_plus_params_cbuffer.GetAddressOf());
+			const CommandHandle forward_plus_params_cbuffer = get_constant_buffer_handle(ForwardPlusConstantBuffer::PARAMETERS);
+			command_list.set_constant_buffers(ShaderStage::PIXEL, 0, 1, &forward_plus_params_cbuffer);
 
 			// Gather the shader resources
-			std::array<ID3D11ShaderResourceView*, 3> resource_ptr_array = {};
-			std::array<ForwardPlusShaderResource, 3> resource_type_array = { ForwardPlusShaderResource::Z_BINS,	ForwardPlusShaderResource::TILE_BIT_MASKS,  ForwardPlusShaderResource::LIGHT_DATA };
+			std::array<CommandHandle, 5> resource_ptr_array = {};
+			std::array<ForwardPlusShaderResource, 5> resource_type_array = { ForwardPlusShaderResource::Z_BINS,	ForwardPlusShaderResource::TILE_BIT_MASKS,  ForwardPlusShaderResource::LIGHT_DATA, ForwardPlusShaderResource::GLOBAL_LIGHT_DATA, ForwardPlusShaderResource::OBJECT_LIGHT_INDICES };
 
 			size_t srv_index = 0;
 			for (ForwardPlusShaderResource current_resource_type : resource_type_array)
 			{
-				const D3DShaderResourceView& current_srv = get_shader_resource_view(current_resource_type);
-				resource_ptr_array[srv_index] = current_srv.Get();
+				resource_ptr_array[srv_index] = get_shader_resource_view_handle(current_resource_type);
 
 				++srv_index;
 			}
 
-			d3d_context->PSSetShaderResources(0, static_cast<uint32_t>(resource_ptr_array.size()), resource_ptr_array.data());
+			command_list.set_shader_resources(ShaderStage::PIXEL, 0, static_cast<uint32_t>(resource_ptr_array.size()), resource_ptr_array.data());
 		}
 
-		bool initialize()
+		bool initialize(const SceneLightView& scene_lights, uint32_t frame_count)
 		{
 			if (!m_debug_render.initialize())
 			{
 				return false;
 			}
 
+			m_frames.resize(frame_count);
+
 			const auto default_macros = get_default_shader_macros();
+			NullDevice* null_device = m_application.get_render_system().get_graphics_api().get_null_device();
 
 			// Create the compute shaders
 			for (int current_shader_index = 0; current_shader_index < static_cast<int>(ForwardPlusComputeShader::SHADER_COUNT); ++current_shader_index)
 			{
 				const ForwardPlusComputeShader current_shader_type = static_cast<ForwardPlusComputeShader>(current_shader_index);
+				if (null_device != nullptr)
+				{
+					m_compute_shader_handles[current_shader_index] = create_null_compute_shader(*null_device, current_shader_type);
+					continue;
+				}
+
 				ComPtr<ID3D11ComputeShader>& current_shader_ptr = get_compute_shader(current_shader_type);
 
 				if (!current_shader_ptr)
@@ -1044,6 +1087,8 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 					// Set debug name
 					current_shader_ptr.Get()->SetPrivateData(WKPDID_D3DDebugObjectName, static_cast<UINT>(debug_name.length()), debug_name.c_str());
 				}
+
+				m_compute_shader_handles[current_shader_index] = current_shader_ptr.Get();
 			}
 
 			// Create constant buffers
@@ -1082,65 +1127,152 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 				m_cs_constants.clip_scale = DirectX::XMVectorSet(projection_matrix.m[0][0], -projection_matrix.m[1][1], inv_projection_matrix.m[0][0], inv_projection_matrix.m[1][1]);
 			}
 
-			generate_lights();
+			set_scene_lights(scene_lights);
 
 			return true;
 		}
 
-		void generate_lights()
+		void set_scene_lights(const SceneLightView& scene_lights)
 		{
-			constexpr size_t c_test_light_count = 10;
+			// Every frame tests all the bounds, so they are computed once, everything else is expanded per visible light
+			m_scene_lights = scene_lights;
+			m_light_bounds.resize(scene_lights.count);
 
-			for (size_t current_light_index = 0; current_light_index < c_test_light_count; ++current_light_index)
+			for (uint32_t current_light_index = 0; current_light_index < scene_lights.count; ++current_light_index)
 			{
+				LightData light_data = get_light_data(current_light_index);
+				light_data.update_bounds();
+
+				m_light_bounds[current_light_index] = light_data.bounding_sphere;
+
+				if (light_data.type != LightType::DIRECTIONAL)
 				{
-					LightData point_light_data;
-					point_light_data.type = LightType::POINT;
+					// Directional lights have no bounds, queries don't need to report them
+					m_spatial_hash.insert(current_light_index, light_data.bounding_sphere);
+				}
+			}
+		}
 
-					// Generate random position
-					const XMVector translation = DirectX::XMVectorSet(static_cast<float>(std::rand() % 10) * 10 - 50.0f, 5.0f, static_cast<float>(current_light_index) * 10 - 50.0f, 0.0f);
+		LightType get_light_type(uint32_t light_index) const
+		{
+			return static_cast<LightType>(m_scene_lights.types[light_index]);
+		}
 
-					point_light_data.transform = DirectX::XMMatrixTranslationFromVector(translation);
-					point_light_data.range = 25.0f;
+		XMMatrix get_light_transform(uint32_t light_index) const
+		{
+			const auto moved_light_it = m_moved_light_transforms.find(light_index);
+			if (moved_light_it != m_moved_light_transforms.end())
+			{
+				return moved_light_it->second;
+			}
 
-					// Generate random color
-					const float red_component = 1.0f / (1.0f + static_cast<float>(std::rand() % 10));
-					const float blue_component = 1.0f / (1.0f + static_cast<float>(std::rand() % 10));
-					point_light_data.diffuse = Vector3(red_component, 1.0f / (1.0f + static_cast<float>(std::rand() % 10)), std::max(1.0f - red_component, blue_component));
-					point_light_data.ambient = Vector3(point_light_data.diffuse.x * 0.3f, point_light_data.diffuse.y * 0.3f, point_light_data.diffuse.z * 0.3f);
+			const Vector3& rotation = m_scene_lights.rotations[light_index];
+			const Vector3& position = m_scene_lights.positions[light_index];
 
-					point_light_data.update_bounds();
+			return DirectX::XMMatrixRotationRollPitchYaw(rotation.x, rotation.y, rotation.z) * DirectX::XMMatrixTranslation(position.x, position.y, position.z);
+		}
 
-					m_active_lights.push_back(point_light_data);
-				}
-				{
-					LightData spot_light_data;
+		// Gathers a light from the scene columns, only done for the visible lights of a frame
+		LightData get_light_data(uint32_t light_index) const
+		{
+			LightData light_data;
+			light_data.type = get_light_type(light_index);
+			light_data.transform = get_light_transform(light_index);
+
+			light_data.range = m_scene_lights.ranges[light_index];
+			light_data.outer_angle = m_scene_lights.outer_angles[light_index];
+			light_data.inner_angle = m_scene_lights.inner_angles[light_index];
+			light_data.linear_attenuation = m_scene_lights.linear_attenuations[light_index];
+
+			light_data.diffuse = m_scene_lights.diffuse[light_index];
+			light_data.ambient = m_scene_lights.ambient[light_index];
+
+			light_data.bounding_sphere = m_light_bounds[light_index];
 
-					spot_light_data.type = LightType::SPOT;
+			return light_data;
+		}
+
+		CommandHandle create_null_compute_shader(NullDevice& null_device, ForwardPlusComputeShader shader)
+		{
+			switch (shader)
+			{
+			case ForwardPlusComputeShader::Z_BINNING:
+				return null_device.create_compute_shader([this](const NullDispatchContext& context) { run_null_z_binning(context); });
+			case ForwardPlusComputeShader::TILE_CULLING:
+				return null_device.create_compute_shader([this](const NullDispatchContext& context) { run_null_tile_culling(context); });
+			default:
+				// Spot transform & tile setup only prepare data for the GPU tile culling, the CPU version works from the light bounds
+				return null_device.create_object();
+			}
+		}
 
-					// Generate random position and rotation
-					const XMVector translation = DirectX::XMVectorSet(random_float(-50.f, 50.f), 5.0f, static_cast<float>(current_light_index) * 10.f - 50.0f, 0.0f);
-					const XMVector rpy_rotation = DirectX::XMVectorSet(random_float(DirectX::XMConvertToRadians(-120.f), DirectX::XMConvertToRadians(-60.f)), 0.0f, 0.0f, 0.0f);
+		// CPU version of ZBinning.hlsl, processes the same batch of lights per dispatch
+		void run_null_z_binning(const NullDispatchContext& context)
+		{
+			const ForwardPlusParameters* forward_plus_params = context.constant_buffers[0].as<ForwardPlusParameters>();
+			const ZBinningConstants* z_binning_constants = context.constant_buffers[2].as<ZBinningConstants>();
+			const ShaderLightInfo* light_info = context.shader_resources[0].as<ShaderLightInfo>();
+			uint32_t* z_bins = context.unordered_access_views[0].as<uint32_t>();
 
-					spot_light_data.transform = DirectX::XMMatrixRotationRollPitchYawFromVector(rpy_rotation) * DirectX::XMMatrixTranslationFromVector(translation);
+			if ((forward_plus_params == nullptr) || (z_binning_constants == nullptr) || (light_info == nullptr) || (z_bins == nullptr))
+			{
+				return;
+			}
 
-					spot_light_data.outer_angle = DirectX::XMConvertToRadians(random_float(10.0f, 45.0f));
-					spot_light_data.range = 20.0f;
-					spot_light_data.inner_angle = DirectX::XMConvertToRadians(spot_light_data.outer_angle * 0.25f);
+			const uint32_t light_count = forward_plus_params->light_counts[0] + forward_plus_params->light_counts[1] + forward_plus_params->light_counts[2];
+			const uint32_t light_begin = z_binning_constants->invocation * c_z_binning_group_size;
+			const uint32_t light_end = std::min(light_begin + c_z_binning_group_size, light_count);
 
-					// Generate random color
-					const float red_component = 1.0f / (1.0f + static_cast<float>(std::rand() % 10));
-					const float blue_component = 1.0f / (1.0f + static_cast<float>(std::rand() % 10));
-					spot_light_data.diffuse = Vector3(red_component, 1.0f / (1.0f + static_cast<float>(std::rand() % 10)), std::max(1.0f - red_component, blue_component));
-					spot_light_data.ambient = Vector3(spot_light_data.diffuse.x * 0.3f, spot_light_data.diffuse.y * 0.3f, spot_light_data.diffuse.z * 0.3f);
+			for (uint32_t current_light_index = light_begin; current_light_index < light_end; ++current_light_index)
+			{
+				const uint32_t light_z_range = light_info[current_light_index].z_range;
+				const uint32_t z_bin_min = light_z_range & c_z_bin_min_mask;
+				const uint32_t z_bin_max = std::min(light_z_range >> 16, c_z_bin_count - 1);
 
-					spot_light_data.update_bounds();
+				for (uint32_t current_z_bin = z_bin_min; current_z_bin <= z_bin_max; ++current_z_bin)
+				{
+					// Empty bins have a min of 0xFFFF and a max of 0, so the first light overwrites both
+					const uint32_t z_bin = z_bins[current_z_bin];
+					const uint32_t min_light_index = std::min(z_bin & c_z_bin_min_mask, current_light_index);
+					const uint32_t max_light_index = std::max(z_bin >> 16, current_light_index);
 
-					m_active_lights.push_back(spot_light_data);
+					z_bins[current_z_bin] = convert_z_bin(Vector2i(static_cast<int>(min_light_index), static_cast<int>(max_light_index)));
 				}
 			}
 		}
 
+		// Null device kernel for TileCulling.hlsl, see cull_light_tiles
+		void run_null_tile_culling(const NullDispatchContext& context)
+		{
+			FORWARDPLUSDEMO_PROFILE_SCOPE("LightSystem::run_null_tile_culling");
+
+			const ForwardPlusCSConstants* cs_constants = context.constant_buffers[1].as<ForwardPlusCSConstants>();
+			const NullBufferView& tile_bitmask_view = context.unordered_access_views[0];
+
+			const std::vector<DirectX::BoundingSphere>& light_bounds = m_recorded_frame->light_bounds;
+
+			const uint32_t light_count = static_cast<uint32_t>(light_bounds.size());
+			const uint32_t batch_count = integer_division_ceil(light_count, c_light_batch_size);
+			const uint32_t bitmask_count = c_tile_x_dim * c_tile_y_dim * batch_count;
+
+			if ((cs_constants == nullptr) || (tile_bitmask_view.get_element_count<uint32_t>() < bitmask_count))
+			{
+				return;
+			}
+
+			uint32_t* tile_bitmasks = tile_bitmask_view.as<uint32_t>();
+			std::fill(tile_bitmasks, tile_bitmasks + bitmask_count, 0);
+
+			// Stored transposed for the shaders
+			const XMMatrix view_projection = DirectX::XMMatrixTranspose(cs_constants->view_projection);
+
+			// A light batch owns its own bitmask words, so the jobs split the lights on batch boundaries
+			m_application.get_render_system().get_job_system().parallel_for(batch_count, 1, [&](uint32_t first_batch, uint32_t end_batch)
+			{
+				cull_light_tiles(light_bounds.data(), light_count, view_projection, first_batch, end_batch, tile_bitmasks);
+			});
+		}
+
 		bool compile_compute_shader(const wchar_t* source_file, const char* entry_point, const std::vector<ForwardPlusShaderMacro>& macros, D3DComputeShader& compute_shader)
 		{
 			constexpr const char* c_cs_target = "cs_4_0";
@@ -1191,8 +1323,9 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 			D3D11_SUBRESOURCE_DATA resource_data;
 			ZeroMemory(&resource_data, sizeof(D3D11_SUBRESOURCE_DATA));
 
-			D3DDevice* d3d_device = m_application.get_render_system().get_graphics_api().get_device();
+			GraphicsAPI& graphics_api = m_application.get_render_system().get_graphics_api();
 			D3DBuffer& current_constant_buffer = get_constant_buffer(constant_buffer);
+			CommandHandle& current_constant_buffer_handle = m_constant_buffer_handles[static_cast<size_t>(constant_buffer)];
 
 			switch (constant_buffer)
 			{
@@ -1201,28 +1334,33 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 				buffer_description.ByteWidth = sizeof(ForwardPlusParameters);
 
 				resource_data.pSysMem = &m_forward_plus_params;
-
-				return SUCCEEDED(d3d_device->CreateBuffer(&buffer_description, &resource_data, current_constant_buffer.ReleaseAndGetAddressOf()));
 			}
+			break;
 			case ForwardPlusConstantBuffer::CS_CONSTANTS:
 			{
 				buffer_description.ByteWidth = sizeof(ForwardPlusCSConstants);
 
 				resource_data.pSysMem = &m_cs_constants;
-
-				return SUCCEEDED(d3d_device->CreateBuffer(&buffer_description, &resource_data, current_constant_buffer.ReleaseAndGetAddressOf()));
 			}
-			case ForwardPlusConstantBuffer::Z_BINNING_CONSTANTS:
-			{
-				buffer_description.ByteWidth = sizeof(ZBinningConstants);
-
-				resource_data.pSysMem = &m_z_binning_constants;
+			break;
+			default:
+				return false;
+			}
 
-				return SUCCEEDED(d3d_device->CreateBuffer(&buffer_description, &resource_data, current_constant_buffer.ReleaseAndGetAddressOf()));
+			NullDevice* null_device = graphics_api.get_null_device();
+			if (null_device != nullptr)
+			{
+				current_constant_buffer_handle = null_device->create_buffer(buffer_description.ByteWidth, resource_data.pSysMem);
+				return true;
 			}
+
+			if (FAILED(graphics_api.get_device()->CreateBuffer(&buffer_description, &resource_data, current_constant_buffer.ReleaseAndGetAddressOf())))
+			{
+				return false;
 			}
 
-			return false;
+			current_constant_buffer_handle = current_constant_buffer.Get();
+			return true;
 		}
 
 		bool init_shader_resource(ForwardPlusShaderResource shader_resource)
@@ -1236,7 +1374,7 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 			D3D11_SUBRESOURCE_DATA resource_data;
 			ZeroMemory(&resource_data, sizeof(D3D11_SUBRESOURCE_DATA));
 
-			D3DDevice* d3d_device = m_application.get_render_system().get_graphics_api().get_device();
+			GraphicsAPI& graphics_api = m_application.get_render_system().get_graphics_api();
 			D3DBuffer& current_resource_buffer = get_shader_resource_buffer(shader_resource);
 			D3DShaderResourceView& current_resource_view = get_shader_resource_view(shader_resource);
 			D3DUnorderedAccessView& current_uav = get_unordered_access_view(shader_resource);
@@ -1305,11 +1443,46 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 				buffer_element_size = sizeof(ShaderLightData);
 			}
 			break;
+			case ForwardPlusShaderResource::GLOBAL_LIGHT_DATA:
+			{
+				buffer_description.Usage = D3D11_USAGE_DYNAMIC;
+				buffer_description.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+				buffer_capacity = c_max_global_light_count;
+				buffer_element_size = sizeof(ShaderLightData);
+			}
+			break;
+			case ForwardPlusShaderResource::OBJECT_LIGHT_INDICES:
+			{
+				buffer_description.Usage = D3D11_USAGE_DYNAMIC;
+				buffer_description.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+				buffer_capacity = c_max_object_light_index_count;
+				buffer_element_size = sizeof(uint32_t);
+			}
+			break;
 			}
 
 			buffer_description.ByteWidth = buffer_element_size * buffer_capacity;
 			buffer_description.StructureByteStride = buffer_element_size;
 
+			const size_t resource_index = static_cast<size_t>(shader_resource);
+			const bool has_uav = (buffer_description.BindFlags & D3D11_BIND_UNORDERED_ACCESS) != 0;
+
+			NullDevice* null_device = graphics_api.get_null_device();
+			if (null_device != nullptr)
+			{
+				// Views alias their buffer on the null device
+				const CommandHandle buffer_handle = null_device->create_buffer(buffer_description.ByteWidth);
+
+				m_shader_resource_buffer_handles[resource_index] = buffer_handle;
+				m_shader_resource_view_handles[resource_index] = buffer_handle;
+				m_unordered_access_view_handles[resource_index] = has_uav ? buffer_handle : nullptr;
+
+				return true;
+			}
+
+			D3DDevice* d3d_device = graphics_api.get_device();
 			if (FAILED(d3d_device->CreateBuffer(&buffer_description, nullptr, current_resource_buffer.ReleaseAndGetAddressOf())))
 			{
 				return false;
@@ -1331,7 +1504,7 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 			}
 
 			// Create UAV for RW buffers
-			if (buffer_description.BindFlags & D3D11_BIND_UNORDERED_ACCESS)
+			if (has_uav)
 			{
 				// Prepare UAV as well
 				D3D11_UNORDERED_ACCESS_VIEW_DESC uav_description;
@@ -1348,27 +1521,32 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 				}
 			}
 
+			m_shader_resource_buffer_handles[resource_index] = current_resource_buffer.Get();
+			m_shader_resource_view_handles[resource_index] = current_resource_view.Get();
+			m_unordered_access_view_handles[resource_index] = current_uav.Get();
+
 			return true;
 		}
 
-		void update()
+		// CPU side of a frame, fills m_frames[frame_index] from the current camera & lights without recording any commands
+		void prepare_frame(uint32_t frame_index)
 		{
-			// Update light data
-			update_lights();
+			FORWARDPLUSDEMO_PROFILE_SCOPE("LightSystem::prepare_frame");
 
-			m_debug_render.render();
+			LightFrame& frame = m_frames[frame_index];
 
 			// Update parameters
 			// FIXME: should not tie to window resolution, use separate RT!
+			RenderSystem& render_system = m_application.get_render_system();
 			{
 				UINT width, height;
-				m_application.get_render_system().get_graphics_api().get_window_resolution(width, height);
+				render_system.get_graphics_api().get_window_resolution(width, height);
 				m_forward_plus_params.resolution.x = width;
 				m_forward_plus_params.resolution.y = height;
 			}
 
 			// Update camera
-			RenderSystem& render_system = m_application.get_render_system();
+			const XMMatrix projection_matrix = render_system.get_camera_projection();
 			{
 				const CameraInfo camera_info = render_system.get_camera_info();
 
@@ -1377,10 +1555,13 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 
 				m_cs_constants.view = DirectX::XMMatrixTranspose(camera_info.view); // Have to transpose for the compute shader
 
-				const XMMatrix projection_matrix = render_system.get_camera_projection();
-				m_cs_constants.view_projection = DirectX::XMMatrixTranspose(DirectX::XMMatrixMultiply(camera_info.view, projection_matrix));
+				frame.debug_view_projection = DirectX::XMMatrixMultiply(camera_info.view, projection_matrix);
+				m_cs_constants.view_projection = DirectX::XMMatrixTranspose(frame.debug_view_projection);
 			}
 
+			// Update light data
+			update_lights(frame);
+
 			// Gather light counts
 			for (int light_type_index = static_cast<int>(LightType::POINT); light_type_index < static_cast<int>(LightType::TYPE_COUNT); ++light_type_index)
 			{
@@ -1388,8 +1569,12 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 				m_forward_plus_params.light_counts[light_type_index] = get_light_type_count(current_light_type);
 			}
 
+			m_forward_plus_params.light_counts[static_cast<size_t>(LightType::TYPE_COUNT)] = static_cast<uint32_t>(frame.global_light_data.size());
+
 			const uint32_t total_light_count = get_total_light_count();
 
+			update_light_culling_mode(frame);
+
 			// First we need to sort all the light info by the view Z coordinate
 			struct LightSortInfo
 			{
@@ -1414,39 +1599,90 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 				}
 			}
 
-			std::sort(light_sort_vec.begin(), light_sort_vec.end());
+			{
+				FORWARDPLUSDEMO_PROFILE_SCOPE("LightSystem::sort_lights");
+				std::sort(light_sort_vec.begin(), light_sort_vec.end());
+			}
 
 			// After sort, remap the info and data
-			std::vector<ShaderLightInfo> sorted_light_info(total_light_count);
-			ShaderLightDataVector sorted_light_data_vec(total_light_count);
+			frame.light_info.resize(total_light_count);
+			frame.light_data.resize(total_light_count);
+			frame.light_bounds.resize(total_light_count);
 			{
+				FORWARDPLUSDEMO_PROFILE_SCOPE("LightSystem::pack_lights");
+
 				const float z_distance = m_forward_plus_params.z_far - m_forward_plus_params.z_near;
 				const float z_step = z_distance / c_z_bin_count;
 
-				uint32_t current_light_index = 0;
-				for (const LightSortInfo& current_sort_info : light_sort_vec)
+				// Every sorted slot is written by exactly one job
+				render_system.get_job_system().parallel_for(total_light_count, c_min_light_job_size, [&](uint32_t begin, uint32_t end)
 				{
-					const Vector2i light_z_bin_range = get_light_z_bin_range(m_light_z_ranges[current_sort_info.index], z_step);
+					for (uint32_t current_light_index = begin; current_light_index < end; ++current_light_index)
+					{
+						const LightSortInfo& current_sort_info = light_sort_vec[current_light_index];
+						const Vector2i light_z_bin_range = get_light_z_bin_range(m_light_z_ranges[current_sort_info.index], z_step);
 
-					ShaderLightInfo& current_sorted_light_info = sorted_light_info[current_light_index];
-					ShaderLightData& current_sorted_light_data = sorted_light_data_vec[current_light_index];
+						ShaderLightInfo& current_sorted_light_info = frame.light_info[current_light_index];
+						ShaderLightData& current_sorted_light_data = frame.light_data[current_light_index];
 
-					current_sorted_light_info = m_light_info[current_sort_info.index];
+						current_sorted_light_info = m_light_info[current_sort_info.index];
 
-					// Get the vector for the light type, remap to combined sorted data buffer using the index in the info
-					const ShaderLightDataVector& light_type_data_vector = m_light_type_data[current_sorted_light_info.type];
-					current_sorted_light_data = light_type_data_vector[current_sorted_light_info.index];
+						// Get the vector for the light type, remap to combined sorted data buffer using the index in the info
+						const ShaderLightDataVector& light_type_data_vector = m_light_type_data[current_sorted_light_info.type];
+						current_sorted_light_data = light_type_data_vector[current_sorted_light_info.index];
 
-					current_sorted_light_info.z_range = convert_z_bin(light_z_bin_range);
-					current_sorted_light_data.light_info = current_sorted_light_info;
+						current_sorted_light_info.z_range = convert_z_bin(light_z_bin_range);
+						current_sorted_light_data.light_info = current_sorted_light_info;
 
-					++current_light_index;
-				}
+						frame.light_bounds[current_light_index] = m_visible_light_bounds[current_sort_info.index];
+					}
+				});
+			}
+
+			frame.forward_plus_params = m_forward_plus_params;
+			frame.cs_constants = m_cs_constants;
+
+			if (frame.use_object_light_lists)
+			{
+				update_light_tile_ranges(frame);
 			}
+		}
+
+		void update_light_tile_ranges(LightFrame& frame)
+		{
+			frame.light_tile_ranges.resize(frame.get_light_count());
+
+			for (uint32_t current_light_index = 0; current_light_index < frame.get_light_count(); ++current_light_index)
+			{
+				const DirectX::BoundingSphere& light_bounds = frame.light_bounds[current_light_index];
+				LightTileRange& tile_range = frame.light_tile_ranges[current_light_index];
+
+				tile_range.on_screen = get_sphere_tile_range(light_bounds, frame.debug_view_projection, tile_range.tile_min, tile_range.tile_max);
+				tile_range.z_range = get_view_z_range(frame, light_bounds);
+			}
+		}
+
+		Vector2 get_view_z_range(const LightFrame& frame, const DirectX::BoundingSphere& bounds) const
+		{
+			const XMVector center_offset = DirectX::XMLoadFloat3(&bounds.Center) - frame.cs_constants.camera_pos;
+			const float center_z = DirectX::XMVectorGetX(DirectX::XMVector3Dot(center_offset, frame.cs_constants.camera_front));
+
+			return Vector2(center_z - bounds.Radius, center_z + bounds.Radius);
+		}
+
+		// Uploads a prepared frame and records its light culling, only reads m_frames[frame_index]
+		void record_frame(uint32_t frame_index, CommandList& command_list)
+		{
+			FORWARDPLUSDEMO_PROFILE_SCOPE("LightSystem::record_frame");
+
+			const LightFrame& frame = m_frames[frame_index];
+			m_recorded_frame = &frame;
+
+			m_debug_render.render(command_list, frame.debug_vertices, frame.debug_view_projection);
 
 			// Update the data in the resource buffers used by the compute and pixel shaders
 			{
-				std::array<ForwardPlusShaderResource, 3> forward_plus_resources = { ForwardPlusShaderResource::LIGHT_INFO, ForwardPlusShaderResource::SPOT_LIGHT_MODELS, ForwardPlusShaderResource::LIGHT_DATA };
+				std::array<ForwardPlusShaderResource, 4> forward_plus_resources = { ForwardPlusShaderResource::LIGHT_INFO, ForwardPlusShaderResource::SPOT_LIGHT_MODELS, ForwardPlusShaderResource::LIGHT_DATA, ForwardPlusShaderResource::GLOBAL_LIGHT_DATA };
 
 				for (ForwardPlusShaderResource current_resource_type : forward_plus_resources)
 				{
@@ -1459,42 +1695,47 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 					case ForwardPlusShaderResource::LIGHT_INFO:
 					{
 						element_size = sizeof(ShaderLightInfo);
-						element_count = static_cast<uint32_t>(sorted_light_info.size());
-						data = sorted_light_info.data();
+						element_count = static_cast<uint32_t>(frame.light_info.size());
+						data = frame.light_info.data();
 					}
 					break;
 					case ForwardPlusShaderResource::SPOT_LIGHT_MODELS:
 					{
 						element_size = sizeof(XMMatrix);
-						element_count = static_cast<uint32_t>(m_spot_light_models.size());
-						data = m_spot_light_models.data();
+						element_count = static_cast<uint32_t>(frame.spot_light_models.size());
+						data = frame.spot_light_models.data();
 					}
 					break;
 					case ForwardPlusShaderResource::LIGHT_DATA:
 					{
 						element_size = sizeof(ShaderLightData);
-						element_count = static_cast<uint32_t>(sorted_light_data_vec.size());
-						data = sorted_light_data_vec.data();
+						element_count = static_cast<uint32_t>(frame.light_data.size());
+						data = frame.light_data.data();
+					}
+					break;
+					case ForwardPlusShaderResource::GLOBAL_LIGHT_DATA:
+					{
+						element_size = sizeof(ShaderLightData);
+						element_count = static_cast<uint32_t>(frame.global_light_data.size());
+						data = frame.global_light_data.data();
 					}
 					break;
 					}
 
-					update_buffer(get_shader_resource_buffer(current_resource_type), element_size, element_count, data);
+					update_buffer(command_list, get_shader_resource_buffer_handle(current_resource_type), element_size, element_count, data);
 				}
 			}
 
-			D3DDeviceContext* d3d_context = m_application.get_render_system().get_graphics_api().get_device_context();
-
 			// Unset resources used by pixel shader (they will need to be used by the compute shaders first)
 			{
-				ID3D11ShaderResourceView* null_srv[3] = { nullptr };
-				d3d_context->PSSetShaderResources(0, 3, null_srv);
+				const CommandHandle null_srv[3] = { nullptr, nullptr, nullptr };
+				command_list.set_shader_resources(ShaderStage::PIXEL, 0, 3, null_srv);
 			}
 
 			// Set light info resource (used in all cases)
 			{
-				D3DShaderResourceView& light_info_srv = get_shader_resource_view(ForwardPlusShaderResource::LIGHT_INFO);
-				d3d_context->CSSetShaderResources(0, 1, light_info_srv.GetAddressOf());
+				const CommandHandle light_info_srv = get_shader_resource_view_handle(ForwardPlusShaderResource::LIGHT_INFO);
+				command_list.set_shader_resources(ShaderStage::COMPUTE, 0, 1, &light_info_srv);
 			}
 
 			// Constant buffers
@@ -1508,68 +1749,68 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 					{
 					case ForwardPlusConstantBuffer::PARAMETERS:
 					{
-						update_buffer(get_constant_buffer(current_buffer_type), sizeof(ForwardPlusParameters), 1, &m_forward_plus_params);
+						update_buffer(command_list, get_constant_buffer_handle(current_buffer_type), sizeof(ForwardPlusParameters), 1, &frame.forward_plus_params);
 					}
 					break;
 					case ForwardPlusConstantBuffer::CS_CONSTANTS:
 					{
-						update_buffer(get_constant_buffer(current_buffer_type), sizeof(ForwardPlusCSConstants), 1, &m_cs_constants);
+						update_buffer(command_list, get_constant_buffer_handle(current_buffer_type), sizeof(ForwardPlusCSConstants), 1, &frame.cs_constants);
 					}
 					break;
 					}
 				}
 
 				// Set the params and CS constants cbuffers for the shaders
-				std::array<ID3D11Buffer*, 2> forward_plus_cbuffers = { get_constant_buffer(ForwardPlusConstantBuffer::PARAMETERS).Get(), get_constant_buffer(ForwardPlusConstantBuffer::CS_CONSTANTS).Get() };
-				d3d_context->CSSetConstantBuffers(0, 2, forward_plus_cbuffers.data());
+				std::array<CommandHandle, 2> forward_plus_cbuffers = { get_constant_buffer_handle(ForwardPlusConstantBuffer::PARAMETERS), get_constant_buffer_handle(ForwardPlusConstantBuffer::CS_CONSTANTS) };
+				command_list.set_constant_buffers(ShaderStage::COMPUTE, 0, 2, forward_plus_cbuffers.data());
 			}
 
-			// Run the compute shaders
-			for (int current_shader_index = 0; current_shader_index < static_cast<int>(ForwardPlusComputeShader::SHADER_COUNT); ++current_shader_index)
+			// Run the compute shaders (not needed when the objects have their own light lists)
+			if (frame.use_object_light_lists == false)
 			{
-				const ForwardPlusComputeShader current_shader_type = static_cast<ForwardPlusComputeShader>(current_shader_index);
-				run_compute_shader(current_shader_type);
+				for (int current_shader_index = 0; current_shader_index < static_cast<int>(ForwardPlusComputeShader::SHADER_COUNT); ++current_shader_index)
+				{
+					const ForwardPlusComputeShader current_shader_type = static_cast<ForwardPlusComputeShader>(current_shader_index);
+					run_compute_shader(command_list, frame, current_shader_type);
+				}
 			}
 
 			// Clean up after the compute shaders
-			d3d_context->CSSetShader(nullptr, nullptr, 0u);
+			command_list.set_shader(ShaderStage::COMPUTE, nullptr);
 
 			{
-				ID3D11ShaderResourceView* null_srv[3] = { nullptr };
-				d3d_context->CSSetShaderResources(0, 3, null_srv);
+				const CommandHandle null_srv[3] = { nullptr, nullptr, nullptr };
+				command_list.set_shader_resources(ShaderStage::COMPUTE, 0, 3, null_srv);
 			}
 
 			{
-				ID3D11UnorderedAccessView* null_uav[] = { nullptr };
-				d3d_context->CSSetUnorderedAccessViews(0, 1, null_uav, 0);
+				const CommandHandle null_uav[] = { nullptr };
+				command_list.set_unordered_access_views(0, 1, null_uav);
 			}
 
 			// Set the pixel shader resources (for the actual render pass)
-			set_pixel_shader_resources();
+			set_pixel_shader_resources(command_list);
 		}
 
-		void update_buffer(const D3DBuffer& buffer, uint32_t element_size, uint32_t element_count, const void* data)
+		void update_buffer(CommandList& command_list, CommandHandle buffer, uint32_t element_size, uint32_t element_count, const void* data)
 		{
-			D3DDeviceContext* d3d_context = m_application.get_render_system().get_graphics_api().get_device_context();
+			FORWARDPLUSDEMO_PROFILE_SCOPE("LightSystem::update_buffer");
 
-			D3D11_MAPPED_SUBRESOURCE mapped_subresource;
-			ZeroMemory(&mapped_subresource, sizeof(D3D11_MAPPED_SUBRESOURCE));
-
-			const HRESULT result = d3d_context->Map(buffer.Get(), 0, D3D11_MAP::D3D11_MAP_WRITE_DISCARD, 0, &mapped_subresource);
-			if (SUCCEEDED(result))
-			{
-				memcpy(mapped_subresource.pData, data, element_size * element_count);
-			}
-
-			d3d_context->Unmap(buffer.Get(), 0);
+			command_list.update_buffer(buffer, data, element_size * element_count);
 		}
 
-		void update_lights()
+		void update_lights(LightFrame& frame)
 		{
+			FORWARDPLUSDEMO_PROFILE_SCOPE("LightSystem::update_lights");
+
 			// Clean up previous data
 			m_light_z_ranges.clear();
 			m_light_info.clear();
-			m_spot_light_models.clear();
+			m_visible_light_bounds.clear();
+
+			frame.spot_light_models.clear();
+			frame.global_light_data.clear();
+			frame.debug_vertices.clear();
 
 			for (ShaderLightDataVector& light_data_vec : m_light_type_data)
 			{
@@ -1589,20 +1830,96 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 			const XMVector rotation = DirectX::XMQuaternionRotationRollPitchYaw(camera_info.rotation.x, camera_info.rotation.y, 0.0f);
 			bounding_frustum.Transform(bounding_frustum, 1.0f, rotation, camera_info.position);
 
-			// Gather visible lights				
-			for (const LightData& current_light : m_active_lights)
+			const XMMatrix projection = render_system.get_camera_projection();
+
+			// Test the lights in parallel, they are added in order afterwards since the buffer limits depend on it
+			const uint32_t scene_light_count = static_cast<uint32_t>(m_scene_lights.count);
+			m_light_visibility.resize(scene_light_count);
+			render_system.get_job_system().parallel_for(scene_light_count, c_min_light_job_size, [&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t light_index = begin; light_index < end; ++light_index)
+				{
+					m_light_visibility[light_index] = get_light_visibility(get_light_type(light_index), m_light_bounds[light_index], bounding_frustum, camera_info.position, projection,
+						[&render_system](const DirectX::BoundingSphere& light_bounds) { return render_system.is_occluded(light_bounds); });
+				}
+			});
+
+			// Gather visible lights
+			uint32_t dropped_light_count = 0;
+			uint32_t dropped_global_light_count = 0;
+			for (uint32_t light_index = 0; light_index < scene_light_count; ++light_index)
 			{
-				if (bounding_frustum.Intersects(current_light.bounding_sphere) == true)
+				const LightVisibility visibility = m_light_visibility[light_index];
+				if (visibility == LightVisibility::HIDDEN)
+				{
+					continue;
+				}
+
+				const LightVisibility placement = get_light_placement(visibility, static_cast<uint32_t>(frame.global_light_data.size()));
+				if (placement == LightVisibility::HIDDEN)
+				{
+					// Global buffer is full & a directional light has no culled fallback, drop the light
+					++dropped_global_light_count;
+					continue;
+				}
+
+				const LightData current_light = get_light_data(light_index);
+
+				if (placement == LightVisibility::GLOBAL)
+				{
+					add_global_light(frame, current_light);
+					continue;
+				}
+
+				if (get_total_light_count() >= c_max_light_count)
 				{
-					// Light is visible, add to the relevant caches
-					add_visible_light(current_light);
+					// GPU buffers are full, drop the light
+					// FIXME: prioritize by distance/contribution instead?
+					++dropped_light_count;
+					continue;
 				}
+
+				// Light is visible, add to the relevant caches
+				add_visible_light(frame, current_light);
+			}
+
+			if ((dropped_light_count > 0) && !m_light_limit_reported)
+			{
+				// Only the first time, this would otherwise repeat every frame the camera sees that many lights
+				char message[160];
+				std::snprintf(message, sizeof(message), "Light system: %u visible lights over the limit of %u were dropped from a frame\n", dropped_light_count, c_max_light_count);
+				OutputDebugStringA(message);
+
+				m_light_limit_reported = true;
+			}
+
+			if ((dropped_global_light_count > 0) && !m_global_light_limit_reported)
+			{
+				char message[160];
+				std::snprintf(message, sizeof(message), "Light system: %u directional lights over the global limit of %u were dropped from a frame\n", dropped_global_light_count, c_max_global_light_count);
+				OutputDebugStringA(message);
+
+				m_global_light_limit_reported = true;
 			}
+		}
+
+		void add_global_light(LightFrame& frame, const LightData& light)
+		{
+			ShaderLightInfo light_info;
+			light_info.init_from_light_data(light, static_cast<uint32_t>(frame.global_light_data.size()));
+
+			ShaderLightData shader_light_data;
+			shader_light_data.initialize(light, light_info);
+
+			frame.global_light_data.push_back(shader_light_data);
 
-			// TODO: global light?
+			if (m_debug_render.enabled)
+			{
+				m_debug_render.add_visible_light(frame.debug_vertices, light, shader_light_data);
+			}
 		}
 
-		void add_visible_light(const LightData& light)
+		void add_visible_light(LightFrame& frame, const LightData& light)
 		{
 			const uint32_t light_index = get_light_type_count(light.type);
 
@@ -1611,6 +1928,8 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 			light_info.init_from_light_data(light, light_index);
 			m_light_info.push_back(light_info);
 
+			m_visible_light_bounds.push_back(light.bounding_sphere);
+
 			// Shader light data
 			ShaderLightDataVector& light_data_vec = m_light_type_data[static_cast<size_t>(light.type)];
 
@@ -1621,7 +1940,7 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 
 			if (light.type == LightType::SPOT)
 			{
-				m_spot_light_models.push_back(light.build_spot_light_model_matrix());
+				frame.spot_light_models.push_back(light.build_spot_light_model_matrix());
 			}
 
 			// Light Z range
@@ -1643,13 +1962,130 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 
 			if (m_debug_render.enabled)
 			{
-				m_debug_render.add_visible_light(light, shader_light_data);
+				m_debug_render.add_visible_light(frame.debug_vertices, light, shader_light_data);
 			}
 		}
 
 		void toggle_debug_rendering()
 		{
-			m_debug_render.enabled = !m_debug_render.enabled;
+			m_debug_render.enabled = m_debug_render.available && !m_debug_render.enabled;
+		}
+
+		void update_light_culling_mode(LightFrame& frame)
+		{
+			const uint32_t visible_light_count = get_total_light_count();
+
+			if (m_use_object_light_lists)
+			{
+				// Also go back to tiled culling if the index buffer could not hold last frame's lists
+				if ((visible_light_count > c_object_light_list_exit_count) || m_object_light_indices_overflow)
+				{
+					m_use_object_light_lists = false;
+				}
+				else if (m_object_light_list_tile_count > m_tiled_light_tile_count)
+				{
+					// Tiled culling would have shaded fewer lights, stay with it for a while before trying again
+					m_use_object_light_lists = false;
+					m_object_light_list_retry_frames = c_object_light_list_retry_frame_count;
+				}
+			}
+			else if (m_object_light_list_retry_frames > 0)
+			{
+				--m_object_light_list_retry_frames;
+			}
+			else if (visible_light_count <= c_object_light_list_enter_count)
+			{
+				m_use_object_light_lists = true;
+			}
+
+			frame.use_object_light_lists = m_use_object_light_lists;
+			frame.object_light_indices.clear();
+			m_object_light_indices_overflow = false;
+			m_object_light_list_tile_count = 0;
+			m_tiled_light_tile_count = 0;
+		}
+
+		ObjectLightList add_object_light_list(LightFrame& frame, const DirectX::BoundingBox& bounds)
+		{
+			ObjectLightList light_list;
+			light_list.offset = static_cast<uint32_t>(frame.object_light_indices.size());
+			light_list.enabled = 1;
+
+			// Tiled culling would shade the object with every light whose tiles & depth range overlap it, not just the ones touching its box
+			const DirectX::BoundingSphere object_sphere(bounds.Center, DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMLoadFloat3(&bounds.Extents))));
+			Vector2i object_tile_min;
+			Vector2i object_tile_max;
+			const bool object_on_screen = get_sphere_tile_range(object_sphere, frame.debug_view_projection, object_tile_min, object_tile_max);
+			const Vector2 object_z_range = get_view_z_range(frame, object_sphere);
+
+			for (uint32_t current_light_index = 0; current_light_index < frame.get_light_count(); ++current_light_index)
+			{
+				const LightTileRange& light_tile_range = frame.light_tile_ranges[current_light_index];
+				if (object_on_screen && light_tile_range.on_screen && (light_tile_range.z_range.x <= object_z_range.y) && (light_tile_range.z_range.y >= object_z_range.x))
+				{
+					const int overlap_x = std::min(light_tile_range.tile_max.x, object_tile_max.x) - std::max(light_tile_range.tile_min.x, object_tile_min.x) + 1;
+					const int overlap_y = std::min(light_tile_range.tile_max.y, object_tile_max.y) - std::max(light_tile_range.tile_min.y, object_tile_min.y) + 1;
+					if ((overlap_x > 0) && (overlap_y > 0))
+					{
+						m_tiled_light_tile_count += static_cast<uint64_t>(overlap_x) * static_cast<uint64_t>(overlap_y);
+					}
+				}
+
+				if (frame.light_bounds[current_light_index].Intersects(bounds) == false)
+				{
+					continue;
+				}
+
+				if (frame.object_light_indices.size() >= c_max_object_light_index_count)
+				{
+					// Out of space, the remaining lights are dropped for this frame
+					m_object_light_indices_overflow = true;
+					break;
+				}
+
+				frame.object_light_indices.push_back(current_light_index);
+			}
+
+			light_list.count = static_cast<uint32_t>(frame.object_light_indices.size()) - light_list.offset;
+
+			if (object_on_screen)
+			{
+				const uint64_t object_tile_count = static_cast<uint64_t>(object_tile_max.x - object_tile_min.x + 1) * static_cast<uint64_t>(object_tile_max.y - object_tile_min.y + 1);
+				m_object_light_list_tile_count += object_tile_count * light_list.count;
+			}
+
+			return light_list;
+		}
+
+		void upload_object_light_lists(const LightFrame& frame, CommandList& command_list)
+		{
+			if (frame.object_light_indices.empty())
+			{
+				return;
+			}
+
+			update_buffer(command_list, get_shader_resource_buffer_handle(ForwardPlusShaderResource::OBJECT_LIGHT_INDICES), sizeof(uint32_t), static_cast<uint32_t>(frame.object_light_indices.size()), frame.object_light_indices.data());
+		}
+
+		void set_light_transform(uint32_t light_index, const XMMatrix& transform)
+		{
+			if (light_index >= m_scene_lights.count)
+			{
+				return;
+			}
+
+			// The scene columns stay read-only, moved lights keep their transform on the side
+			m_moved_light_transforms[light_index] = transform;
+
+			LightData light_data = get_light_data(light_index);
+			light_data.update_bounds();
+
+			m_light_bounds[light_index] = light_data.bounding_sphere;
+
+			if (light_data.type != LightType::DIRECTIONAL)
+			{
+				m_spatial_hash.update(light_index, light_data.bounding_sphere);
+			}
 		}
 	};
 
@@ -1661,18 +2097,63 @@ float4 pixel_shader(PS_INPUT input) : SV_Target
 
 	}
 
-	bool LightSystem::initialize()
+	bool LightSystem::initialize(const SceneLightView& scene_lights, uint32_t frame_count)
+	{
+		return m_internal->initialize(scene_lights, frame_count);
+	}
+
+	void LightSystem::prepare_frame(uint32_t frame_index)
 	{
-		return m_internal->initialize();
+		m_internal->prepare_frame(frame_index);
 	}
 
-	void LightSystem::update()
+	void LightSystem::record_frame(uint32_t frame_index, CommandList& command_list)
 	{
-		m_internal->update();
+		m_internal->record_frame(frame_index, command_list);
 	}
 
 	void LightSystem::toggle_debug_rendering()
 	{
 		m_internal->toggle_debug_rendering();
 	}
+
+	bool LightSystem::is_using_object_light_lists(uint32_t frame_index) const
+	{
+		return m_internal->m_frames[frame_index].use_object_light_lists;
+	}
+
+	ObjectLightList LightSystem::add_object_light_list(uint32_t frame_index, const DirectX::BoundingBox& bounds)
+	{
+		return m_internal->add_object_light_list(m_internal->m_frames[frame_index], bounds);
+	}
+
+	void LightSystem::upload_object_light_lists(uint32_t frame_index, CommandList& command_list)
+	{
+		m_internal->upload_object_light_lists(m_internal->m_frames[frame_index], command_list);
+	}
+
+	void LightSystem::set_light_transform(uint32_t light_index, const XMMatrix& transform)
+	{
+		m_internal->set_light_transform(light_index, transform);
+	}
+
+	void LightSystem::query_lights(const DirectX::BoundingBox& bounds, std::vector<uint32_t>& light_indices) const
+	{
+		m_internal->m_spatial_hash.query(bounds, light_indices);
+	}
+
+	void LightSystem::query_lights(const DirectX::BoundingSphere& bounds, std::vector<uint32_t>& light_indices) const
+	{
+		m_internal->m_spatial_hash.query(bounds, light_indices);
+	}
+
+	void LightSystem::query_lights(const Vector3& point, std::vector<uint32_t>& light_indices) const
+	{
+		m_internal->m_spatial_hash.query(point, light_indices);
+	}
+
+	size_t LightSystem::get_light_count() const
+	{
+		return m_internal->m_spatial_hash.get_light_count();
+	}
 }
\ No newline at end of file
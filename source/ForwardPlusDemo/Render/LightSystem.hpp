@@ -1,6 +1,16 @@
 #ifndef FORWARDPLUSDEMO_RENDER_LIGHTSYSTEM_HPP
 #define FORWARDPLUSDEMO_RENDER_LIGHTSYSTEM_HPP
+#include <ForwardPlusDemo/Render/Math.hpp>
+
 #include <memory>
+#include <vector>
+
+namespace DirectX
+{
+	struct BoundingBox;
+	struct BoundingSphere;
+}
+
 namespace ForwardPlusDemo
 {
 	enum class LightType
@@ -12,15 +22,52 @@ namespace ForwardPlusDemo
 	};
 
 	class Application;
+	class CommandList;
+	struct SceneLightView;
+
+	// Range of light indices used by a single object when per-object light lists are active (matches the shader layout)
+	struct alignas(16) ObjectLightList
+	{
+		uint32_t offset = 0;
+		uint32_t count = 0;
+		uint32_t enabled = 0; // Zero means the tiled light data should be used
+		uint32_t _padding = 0;
+	};
+
 	class LightSystem
 	{
 	public:
 		~LightSystem();
+
+		// Spatial queries against the light bounds, the spatial hash locks internally so they are safe from any thread
+		// A query racing set_light_transform sees a moved light either at its old or at its new position
+		// Results are appended as light indices (stable for the lifetime of the scene)
+		void query_lights(const DirectX::BoundingBox& bounds, std::vector<uint32_t>& light_indices) const;
+		void query_lights(const DirectX::BoundingSphere& bounds, std::vector<uint32_t>& light_indices) const;
+		void query_lights(const Vector3& point, std::vector<uint32_t>& light_indices) const;
+
+		size_t get_light_count() const;
 	private:
 		LightSystem(Application& application);
 
-		bool initialize();
-		void update();
+		// Frame count is the render pipeline depth, frame indices passed in below are below it
+		// The scene light columns are read in place, so the scene has to outlive the light system
+		bool initialize(const SceneLightView& scene_lights, uint32_t frame_count);
+
+		// Visibility tests, sorting & packing for the current camera, no commands are recorded
+		// Can run on a job while an older frame is being recorded, as long as the frame indices differ
+		void prepare_frame(uint32_t frame_index);
+		void record_frame(uint32_t frame_index, CommandList& command_list);
+
+		// With few visible lights, the tile & Z bin stages are skipped and each object gets a CPU built light list instead
+		// Lists are added while the frame is prepared, and uploaded when it is recorded
+		bool is_using_object_light_lists(uint32_t frame_index) const;
+		ObjectLightList add_object_light_list(uint32_t frame_index, const DirectX::BoundingBox& bounds);
+		void upload_object_light_lists(uint32_t frame_index, CommandList& command_list);
+
+		// Render thread only, while no frame is being prepared (the preparation reads the bounds & transforms without locking)
+		// Updates the light bounds & spatial hash incrementally, used for the moving lights (see RenderSystem)
+		void set_light_transform(uint32_t light_index, const XMMatrix& transform);
 
 		void toggle_debug_rendering();
 
@@ -0,0 +1,98 @@
+#ifndef FORWARDPLUSDEMO_RENDER_LIGHTVISIBILITY_HPP
+#define FORWARDPLUSDEMO_RENDER_LIGHTVISIBILITY_HPP
+#include <ForwardPlusDemo/Render/LightSystem.hpp>
+#include <ForwardPlusDemo/Render/Math.hpp>
+
+#include <DirectXCollision.h>
+
+#include <cmath>
+namespace ForwardPlusDemo
+{
+	constexpr uint32_t c_max_global_light_count = 64;
+	constexpr float c_global_light_screen_coverage = 0.5f; // Lights covering more of the screen than this skip the culling stages
+
+	// Result of the per-light visibility tests, how the light is added is decided afterwards
+	enum class LightVisibility : uint8_t
+	{
+		HIDDEN,
+		GLOBAL, // Directional, never culled
+		SCREEN_FILLING, // Shaded unculled while there is room for more global lights
+		LOCAL // Goes through the tile & Z bin culling
+	};
+
+	// Rough fraction of the screen covered by the projected bounding sphere
+	inline float get_screen_coverage(const DirectX::BoundingSphere& bounds, const XMVector& camera_position, const XMMatrix& projection)
+	{
+		const XMVector center = DirectX::XMLoadFloat3(&bounds.Center);
+		const float distance_sq = DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(center - camera_position));
+		const float radius_sq = bounds.Radius * bounds.Radius;
+
+		if (distance_sq <= radius_sq)
+		{
+			// Camera is inside the light volume
+			return 1.0f;
+		}
+
+		// Projected radius in NDC, using the distance to the tangent points
+		const float tangent_distance = std::sqrt(distance_sq - radius_sq);
+		const Matrix4 projection_matrix = to_matrix4(projection);
+
+		const float ndc_radius_x = bounds.Radius * projection_matrix.m[0][0] / tangent_distance;
+		const float ndc_radius_y = bounds.Radius * projection_matrix.m[1][1] / tangent_distance;
+
+		// NDC square has an area of 4
+		return std::fmin(1.0f, DirectX::XM_PI * ndc_radius_x * ndc_radius_y * 0.25f);
+	}
+
+	// IsOccludedFunc is bool(const DirectX::BoundingSphere&), only called for lights inside the frustum
+	template<typename IsOccludedFunc>
+	LightVisibility get_light_visibility(LightType type, const DirectX::BoundingSphere& bounds, const DirectX::BoundingFrustum& bounding_frustum,
+		const XMVector& camera_position, const XMMatrix& projection, IsOccludedFunc&& is_occluded)
+	{
+		if (type == LightType::DIRECTIONAL)
+		{
+			// Directional lights affect everything, no point in culling them
+			return LightVisibility::GLOBAL;
+		}
+
+		if (bounding_frustum.Intersects(bounds) == false)
+		{
+			return LightVisibility::HIDDEN;
+		}
+
+		// Lights only reach points inside their range, so nothing visible is lit by a light behind an occluder
+		if (is_occluded(bounds))
+		{
+			return LightVisibility::HIDDEN;
+		}
+
+		// Lights covering most of the screen would set a bit in (nearly) every tile and Z bin, so shade them unculled instead
+		if (get_screen_coverage(bounds, camera_position, projection) >= c_global_light_screen_coverage)
+		{
+			return LightVisibility::SCREEN_FILLING;
+		}
+
+		return LightVisibility::LOCAL;
+	}
+
+	// Where a visible light goes given how many global lights the frame already has:
+	// GLOBAL for the global list, LOCAL for the culled lights, or HIDDEN when a directional light finds the global list full
+	inline LightVisibility get_light_placement(LightVisibility visibility, uint32_t global_light_count)
+	{
+		const bool global_list_full = (global_light_count >= c_max_global_light_count);
+
+		switch (visibility)
+		{
+		case LightVisibility::GLOBAL:
+			return global_list_full ? LightVisibility::HIDDEN : LightVisibility::GLOBAL;
+		case LightVisibility::SCREEN_FILLING:
+			return global_list_full ? LightVisibility::LOCAL : LightVisibility::GLOBAL;
+		case LightVisibility::HIDDEN:
+		case LightVisibility::LOCAL:
+			break;
+		}
+
+		return visibility;
+	}
+}
+#endif
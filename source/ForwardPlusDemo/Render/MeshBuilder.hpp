@@ -0,0 +1,207 @@
+#ifndef FORWARDPLUSDEMO_RENDER_MESHBUILDER_HPP
+#define FORWARDPLUSDEMO_RENDER_MESHBUILDER_HPP
+#include <ForwardPlusDemo/GraphicsAPI/CommandList.hpp>
+#include <ForwardPlusDemo/Render/MeshOptimizer.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+namespace ForwardPlusDemo
+{
+	// Part of the shared vertex & index buffers, drawn with base_vertex since indices are mesh relative
+	struct MeshRange
+	{
+		uint32_t first_index = 0;
+		uint32_t index_count = 0;
+		uint32_t base_vertex = 0;
+		uint32_t vertex_count = 0;
+
+		uint32_t input_vertex_count = 0; // Before welding, one per triangle corner
+
+		// After welding, in the order the triangles were added & after the cache and overdraw reordering
+		float input_acmr = 0.0f;
+		float output_acmr = 0.0f;
+	};
+
+	// Builds indexed meshes from triangle lists, welding bitwise identical vertices and reordering for the post transform cache
+	// Vertices need a position member with x, y & z, every mesh gets its own vertex range so indices stay small
+	template<typename VertexType>
+	class MeshBuilder
+	{
+	public:
+		static_assert(std::is_trivially_copyable_v<VertexType>);
+
+		MeshBuilder()
+			: m_welded_vertices(0, VertexHash{ &m_mesh_vertices }, VertexEqual{ &m_mesh_vertices })
+		{
+		}
+
+		// The welding set points at the member vertex array
+		MeshBuilder(const MeshBuilder&) = delete;
+		MeshBuilder& operator=(const MeshBuilder&) = delete;
+
+		void begin_mesh()
+		{
+			m_mesh_vertices.clear();
+			m_mesh_indices.clear();
+			m_welded_vertices.clear();
+			m_input_vertex_count = 0;
+		}
+
+		void add_triangle(const VertexType& vertex0, const VertexType& vertex1, const VertexType& vertex2)
+		{
+			const uint32_t index0 = add_vertex(vertex0);
+			const uint32_t index1 = add_vertex(vertex1);
+			const uint32_t index2 = add_vertex(vertex2);
+
+			m_input_vertex_count += 3;
+
+			// Degenerate after welding, would never produce a pixel
+			if ((index0 == index1) || (index1 == index2) || (index0 == index2))
+			{
+				return;
+			}
+
+			m_mesh_indices.push_back(index0);
+			m_mesh_indices.push_back(index1);
+			m_mesh_indices.push_back(index2);
+		}
+
+		// Split along the 0-2 diagonal, same winding as the corners
+		void add_quad(const VertexType& vertex0, const VertexType& vertex1, const VertexType& vertex2, const VertexType& vertex3)
+		{
+			add_triangle(vertex0, vertex1, vertex2);
+			add_triangle(vertex0, vertex2, vertex3);
+		}
+
+		// Optimizes the mesh and appends it to the shared buffers
+		MeshRange end_mesh()
+		{
+			const uint32_t mesh_vertex_count = static_cast<uint32_t>(m_mesh_vertices.size());
+
+			MeshRange range;
+			range.input_vertex_count = m_input_vertex_count;
+			range.input_acmr = get_acmr(m_mesh_indices, mesh_vertex_count);
+
+			optimize_vertex_cache(m_mesh_indices, mesh_vertex_count);
+
+			std::vector<Vector3> positions;
+			positions.reserve(mesh_vertex_count);
+			for (const VertexType& current_vertex : m_mesh_vertices)
+			{
+				positions.push_back(Vector3(current_vertex.position.x, current_vertex.position.y, current_vertex.position.z));
+			}
+
+			optimize_overdraw(m_mesh_indices, positions);
+
+			// Vertex order last, it only renames vertices so the cache behaviour stays the same
+			std::vector<uint32_t> remap;
+			range.vertex_count = get_vertex_fetch_remap(m_mesh_indices, mesh_vertex_count, remap);
+			range.base_vertex = static_cast<uint32_t>(m_vertices.size());
+			range.first_index = static_cast<uint32_t>(m_indices.size());
+			range.index_count = static_cast<uint32_t>(m_mesh_indices.size());
+
+			m_vertices.resize(m_vertices.size() + range.vertex_count);
+			for (uint32_t current_vertex = 0; current_vertex < mesh_vertex_count; ++current_vertex)
+			{
+				if (remap[current_vertex] != UINT32_MAX)
+				{
+					m_vertices[range.base_vertex + remap[current_vertex]] = m_mesh_vertices[current_vertex];
+				}
+			}
+
+			for (uint32_t& current_index : m_mesh_indices)
+			{
+				current_index = remap[current_index];
+			}
+
+			range.output_acmr = get_acmr(m_mesh_indices, range.vertex_count);
+
+			m_indices.insert(m_indices.end(), m_mesh_indices.begin(), m_mesh_indices.end());
+			m_max_mesh_vertex_count = std::max(m_max_mesh_vertex_count, range.vertex_count);
+
+			return range;
+		}
+
+		const std::vector<VertexType>& get_vertices() const { return m_vertices; }
+
+		// 16 bit unless a single mesh has more vertices than that can address
+		IndexFormat get_index_format() const
+		{
+			return (m_max_mesh_vertex_count <= (UINT16_MAX + 1u)) ? IndexFormat::UINT16 : IndexFormat::UINT32;
+		}
+
+		// Index buffer contents in the above format
+		std::vector<uint8_t> get_index_data() const
+		{
+			std::vector<uint8_t> index_data;
+
+			if (get_index_format() == IndexFormat::UINT16)
+			{
+				index_data.resize(m_indices.size() * sizeof(uint16_t));
+
+				uint16_t* index_data_16 = reinterpret_cast<uint16_t*>(index_data.data());
+				for (size_t current_index = 0; current_index < m_indices.size(); ++current_index)
+				{
+					index_data_16[current_index] = static_cast<uint16_t>(m_indices[current_index]);
+				}
+			}
+			else
+			{
+				index_data.resize(m_indices.size() * sizeof(uint32_t));
+				std::memcpy(index_data.data(), m_indices.data(), index_data.size());
+			}
+
+			return index_data;
+		}
+	private:
+		// Hashes & compares the vertex bytes, the set only stores indices into the mesh vertices
+		struct VertexHash
+		{
+			const std::vector<VertexType>* vertices;
+
+			size_t operator()(uint32_t index) const
+			{
+				return std::hash<std::string_view>()(std::string_view(reinterpret_cast<const char*>(&(*vertices)[index]), sizeof(VertexType)));
+			}
+		};
+
+		struct VertexEqual
+		{
+			const std::vector<VertexType>* vertices;
+
+			bool operator()(uint32_t left, uint32_t right) const
+			{
+				return std::memcmp(&(*vertices)[left], &(*vertices)[right], sizeof(VertexType)) == 0;
+			}
+		};
+
+		uint32_t add_vertex(const VertexType& vertex)
+		{
+			// Added as a candidate first so the set can look it up by index, removed again if it already exists
+			const uint32_t candidate_index = static_cast<uint32_t>(m_mesh_vertices.size());
+			m_mesh_vertices.push_back(vertex);
+
+			const auto [vertex_it, inserted] = m_welded_vertices.insert(candidate_index);
+			if (inserted == false)
+			{
+				m_mesh_vertices.pop_back();
+			}
+
+			return *vertex_it;
+		}
+
+		std::vector<VertexType> m_mesh_vertices;
+		std::vector<uint32_t> m_mesh_indices;
+		std::unordered_set<uint32_t, VertexHash, VertexEqual> m_welded_vertices;
+		uint32_t m_input_vertex_count = 0;
+
+		std::vector<VertexType> m_vertices;
+		std::vector<uint32_t> m_indices;
+		uint32_t m_max_mesh_vertex_count = 0;
+	};
+}
+#endif
@@ -0,0 +1,366 @@
+#include <ForwardPlusDemo/Render/MeshOptimizer.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+
+namespace ForwardPlusDemo
+{
+	namespace
+	{
+		constexpr uint32_t c_invalid_index = UINT32_MAX;
+
+		// Cache model & scoring weights from Forsyth's "Linear-Speed Vertex Cache Optimisation"
+		constexpr uint32_t c_scoring_cache_size = 32;
+		constexpr float c_cache_decay_power = 1.5f;
+		constexpr float c_last_triangle_score = 0.75f;
+		constexpr float c_valence_boost_scale = 2.0f;
+		constexpr float c_valence_boost_power = 0.5f;
+
+		float get_vertex_score(int32_t cache_position, uint32_t remaining_valence)
+		{
+			if (remaining_valence == 0)
+			{
+				// No triangles left to use it
+				return -1.0f;
+			}
+
+			float score = 0.0f;
+			if (cache_position >= 0)
+			{
+				if (cache_position < 3)
+				{
+					// Used by the last triangle, fixed score so the next triangle doesn't just reuse the same edge
+					score = c_last_triangle_score;
+				}
+				else
+				{
+					const float scaled_position = 1.0f - static_cast<float>(cache_position - 3) / static_cast<float>(c_scoring_cache_size - 3);
+					score = std::pow(scaled_position, c_cache_decay_power);
+				}
+			}
+
+			// Vertices with few triangles left are finished first, so they don't linger as lone triangles
+			score += c_valence_boost_scale * std::pow(static_cast<float>(remaining_valence), -c_valence_boost_power);
+
+			return score;
+		}
+
+		// Triangles using each vertex, as ranges of one flat array
+		struct VertexAdjacency
+		{
+			std::vector<uint32_t> offsets; // vertex_count + 1 entries
+			std::vector<uint32_t> triangles;
+
+			VertexAdjacency(const std::vector<uint32_t>& indices, uint32_t vertex_count)
+				: offsets(static_cast<size_t>(vertex_count) + 1, 0), triangles(indices.size())
+			{
+				for (const uint32_t current_index : indices)
+				{
+					++offsets[current_index + 1];
+				}
+
+				for (uint32_t current_vertex = 0; current_vertex < vertex_count; ++current_vertex)
+				{
+					offsets[current_vertex + 1] += offsets[current_vertex];
+				}
+
+				std::vector<uint32_t> write_offsets(offsets.begin(), offsets.end() - 1);
+				for (size_t current_corner = 0; current_corner < indices.size(); ++current_corner)
+				{
+					triangles[write_offsets[indices[current_corner]]++] = static_cast<uint32_t>(current_corner / 3);
+				}
+			}
+
+			uint32_t get_count(uint32_t vertex) const { return offsets[vertex + 1] - offsets[vertex]; }
+		};
+	}
+
+	float get_acmr(const std::vector<uint32_t>& indices, uint32_t vertex_count, uint32_t cache_size)
+	{
+		if (indices.size() < 3)
+		{
+			return 0.0f;
+		}
+
+		// A vertex is in the FIFO if fewer than cache_size misses happened since it was loaded
+		std::vector<uint32_t> load_times(vertex_count, 0);
+		uint32_t miss_count = 0;
+		uint32_t time = cache_size + 1;
+
+		for (const uint32_t current_index : indices)
+		{
+			if ((time - load_times[current_index]) > cache_size)
+			{
+				load_times[current_index] = time++;
+				++miss_count;
+			}
+		}
+
+		return static_cast<float>(miss_count) / static_cast<float>(indices.size() / 3);
+	}
+
+	void optimize_vertex_cache(std::vector<uint32_t>& indices, uint32_t vertex_count)
+	{
+		const uint32_t triangle_count = static_cast<uint32_t>(indices.size() / 3);
+		if (triangle_count == 0)
+		{
+			return;
+		}
+
+		VertexAdjacency adjacency(indices, vertex_count);
+
+		// Emitted triangles are swapped out of the vertex's range, so the first remaining_valence entries are the live ones
+		std::vector<uint32_t> remaining_valence(vertex_count);
+		std::vector<int32_t> cache_positions(vertex_count, -1);
+		std::vector<float> vertex_scores(vertex_count);
+
+		for (uint32_t current_vertex = 0; current_vertex < vertex_count; ++current_vertex)
+		{
+			remaining_valence[current_vertex] = adjacency.get_count(current_vertex);
+			vertex_scores[current_vertex] = get_vertex_score(-1, remaining_valence[current_vertex]);
+		}
+
+		std::vector<float> triangle_scores(triangle_count);
+		std::vector<bool> emitted(triangle_count, false);
+
+		uint32_t best_triangle = 0;
+		for (uint32_t current_triangle = 0; current_triangle < triangle_count; ++current_triangle)
+		{
+			const uint32_t* corners = &indices[current_triangle * 3];
+			triangle_scores[current_triangle] = vertex_scores[corners[0]] + vertex_scores[corners[1]] + vertex_scores[corners[2]];
+
+			if (triangle_scores[current_triangle] > triangle_scores[best_triangle])
+			{
+				best_triangle = current_triangle;
+			}
+		}
+
+		std::vector<uint32_t> output;
+		output.reserve(indices.size());
+
+		std::array<uint32_t, c_scoring_cache_size + 3> cache;
+		std::array<uint32_t, c_scoring_cache_size + 3> new_cache;
+		uint32_t cache_count = 0;
+
+		uint32_t input_cursor = 0;
+
+		while (best_triangle != c_invalid_index)
+		{
+			const uint32_t* corners = &indices[best_triangle * 3];
+			emitted[best_triangle] = true;
+
+			uint32_t new_cache_count = 0;
+			for (uint32_t current_corner = 0; current_corner < 3; ++current_corner)
+			{
+				const uint32_t vertex = corners[current_corner];
+				output.push_back(vertex);
+				new_cache[new_cache_count++] = vertex;
+
+				// Drop the triangle from the vertex's live range
+				uint32_t* vertex_triangles = &adjacency.triangles[adjacency.offsets[vertex]];
+				uint32_t& valence = remaining_valence[vertex];
+				for (uint32_t current_entry = 0; current_entry < valence; ++current_entry)
+				{
+					if (vertex_triangles[current_entry] == best_triangle)
+					{
+						std::swap(vertex_triangles[current_entry], vertex_triangles[valence - 1]);
+						--valence;
+						break;
+					}
+				}
+			}
+
+			// Most recently used first, the old entries follow unless they were just used again
+			for (uint32_t current_entry = 0; current_entry < cache_count; ++current_entry)
+			{
+				const uint32_t vertex = cache[current_entry];
+				if ((vertex != corners[0]) && (vertex != corners[1]) && (vertex != corners[2]))
+				{
+					new_cache[new_cache_count++] = vertex;
+				}
+			}
+
+			// Rescore everything that moved in (or fell out of) the cache, the best candidate is among their triangles
+			best_triangle = c_invalid_index;
+			float best_score = -FLT_MAX;
+
+			for (uint32_t current_entry = 0; current_entry < new_cache_count; ++current_entry)
+			{
+				const uint32_t vertex = new_cache[current_entry];
+				cache_positions[vertex] = (current_entry < c_scoring_cache_size) ? static_cast<int32_t>(current_entry) : -1;
+				vertex_scores[vertex] = get_vertex_score(cache_positions[vertex], remaining_valence[vertex]);
+			}
+
+			for (uint32_t current_entry = 0; current_entry < new_cache_count; ++current_entry)
+			{
+				const uint32_t vertex = new_cache[current_entry];
+				const uint32_t* vertex_triangles = &adjacency.triangles[adjacency.offsets[vertex]];
+
+				for (uint32_t current_adjacent = 0; current_adjacent < remaining_valence[vertex]; ++current_adjacent)
+				{
+					const uint32_t triangle = vertex_triangles[current_adjacent];
+					const uint32_t* triangle_corners = &indices[triangle * 3];
+
+					triangle_scores[triangle] = vertex_scores[triangle_corners[0]] + vertex_scores[triangle_corners[1]] + vertex_scores[triangle_corners[2]];
+					if (triangle_scores[triangle] > best_score)
+					{
+						best_score = triangle_scores[triangle];
+						best_triangle = triangle;
+					}
+				}
+			}
+
+			cache_count = std::min(new_cache_count, c_scoring_cache_size);
+			std::copy(new_cache.begin(), new_cache.begin() + cache_count, cache.begin());
+
+			if (best_triangle == c_invalid_index)
+			{
+				// Nothing left around the cache, restart from the next unused triangle in input order
+				while ((input_cursor < triangle_count) && emitted[input_cursor])
+				{
+					++input_cursor;
+				}
+
+				if (input_cursor < triangle_count)
+				{
+					best_triangle = input_cursor;
+				}
+			}
+		}
+
+		indices = std::move(output);
+	}
+
+	void optimize_overdraw(std::vector<uint32_t>& indices, const std::vector<Vector3>& positions, uint32_t cache_size)
+	{
+		const uint32_t triangle_count = static_cast<uint32_t>(indices.size() / 3);
+		if (triangle_count == 0)
+		{
+			return;
+		}
+
+		// Cluster boundaries are triangles where every corner misses the cache, splitting there costs nothing in ACMR
+		std::vector<uint32_t> cluster_starts;
+		{
+			std::vector<uint32_t> load_times(positions.size(), 0);
+			uint32_t time = cache_size + 1;
+
+			for (uint32_t current_triangle = 0; current_triangle < triangle_count; ++current_triangle)
+			{
+				uint32_t triangle_misses = 0;
+				for (uint32_t current_corner = 0; current_corner < 3; ++current_corner)
+				{
+					const uint32_t vertex = indices[current_triangle * 3 + current_corner];
+					if ((time - load_times[vertex]) > cache_size)
+					{
+						load_times[vertex] = time++;
+						++triangle_misses;
+					}
+				}
+
+				if ((current_triangle == 0) || (triangle_misses == 3))
+				{
+					cluster_starts.push_back(current_triangle);
+				}
+			}
+		}
+
+		if (cluster_starts.size() < 2)
+		{
+			return;
+		}
+
+		struct Cluster
+		{
+			uint32_t first_triangle = 0;
+			uint32_t triangle_count = 0;
+			XMVector centroid;
+			XMVector normal;
+			float sort_key = 0.0f;
+		};
+
+		std::vector<Cluster> clusters(cluster_starts.size());
+
+		// Area weighted, so the mesh centroid is a sensible "inside" point for closed meshes
+		XMVector mesh_centroid = DirectX::XMVectorZero();
+		float mesh_area = 0.0f;
+
+		for (size_t current_cluster_index = 0; current_cluster_index < clusters.size(); ++current_cluster_index)
+		{
+			Cluster& current_cluster = clusters[current_cluster_index];
+			current_cluster.first_triangle = cluster_starts[current_cluster_index];
+			current_cluster.triangle_count = ((current_cluster_index + 1 < cluster_starts.size()) ? cluster_starts[current_cluster_index + 1] : triangle_count) - current_cluster.first_triangle;
+
+			XMVector centroid = DirectX::XMVectorZero();
+			XMVector normal = DirectX::XMVectorZero();
+			float area = 0.0f;
+
+			for (uint32_t current_triangle = current_cluster.first_triangle; current_triangle < current_cluster.first_triangle + current_cluster.triangle_count; ++current_triangle)
+			{
+				const XMVector p0 = to_xmvector(positions[indices[current_triangle * 3 + 0]]);
+				const XMVector p1 = to_xmvector(positions[indices[current_triangle * 3 + 1]]);
+				const XMVector p2 = to_xmvector(positions[indices[current_triangle * 3 + 2]]);
+
+				const XMVector triangle_normal = DirectX::XMVector3Cross(p1 - p0, p2 - p0);
+				const float triangle_area = DirectX::XMVectorGetX(DirectX::XMVector3Length(triangle_normal)) * 0.5f;
+
+				centroid += (p0 + p1 + p2) * (triangle_area / 3.0f);
+				normal += triangle_normal;
+				area += triangle_area;
+			}
+
+			mesh_centroid += centroid;
+			mesh_area += area;
+
+			current_cluster.centroid = (area > 0.0f) ? centroid / area : centroid;
+			current_cluster.normal = DirectX::XMVector3Normalize(normal);
+		}
+
+		if (mesh_area <= 0.0f)
+		{
+			return;
+		}
+
+		mesh_centroid = mesh_centroid / mesh_area;
+
+		// Clusters far out along their own normal are likely to occlude the rest of the mesh
+		for (Cluster& current_cluster : clusters)
+		{
+			current_cluster.sort_key = DirectX::XMVectorGetX(DirectX::XMVector3Dot(current_cluster.centroid - mesh_centroid, current_cluster.normal));
+		}
+
+		std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& left, const Cluster& right)
+		{
+			return left.sort_key > right.sort_key;
+		});
+
+		std::vector<uint32_t> output;
+		output.reserve(indices.size());
+
+		for (const Cluster& current_cluster : clusters)
+		{
+			const auto cluster_begin = indices.begin() + static_cast<size_t>(current_cluster.first_triangle) * 3;
+			output.insert(output.end(), cluster_begin, cluster_begin + static_cast<size_t>(current_cluster.triangle_count) * 3);
+		}
+
+		indices = std::move(output);
+	}
+
+	uint32_t get_vertex_fetch_remap(const std::vector<uint32_t>& indices, uint32_t vertex_count, std::vector<uint32_t>& remap)
+	{
+		remap.assign(vertex_count, c_invalid_index);
+
+		uint32_t next_vertex = 0;
+		for (const uint32_t current_index : indices)
+		{
+			if (remap[current_index] == c_invalid_index)
+			{
+				remap[current_index] = next_vertex++;
+			}
+		}
+
+		return next_vertex;
+	}
+}
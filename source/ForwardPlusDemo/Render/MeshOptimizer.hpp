@@ -0,0 +1,25 @@
+#ifndef FORWARDPLUSDEMO_RENDER_MESHOPTIMIZER_HPP
+#define FORWARDPLUSDEMO_RENDER_MESHOPTIMIZER_HPP
+#include <ForwardPlusDemo/Render/Math.hpp>
+
+#include <vector>
+namespace ForwardPlusDemo
+{
+	// FIFO size used to measure the post transform cache, small enough to be pessimistic on any GPU
+	constexpr uint32_t c_vertex_cache_size = 16;
+
+	// Average cache miss ratio, vertex shader invocations per triangle through a FIFO cache (0.5 is the best case, 3 the worst)
+	float get_acmr(const std::vector<uint32_t>& indices, uint32_t vertex_count, uint32_t cache_size = c_vertex_cache_size);
+
+	// Reorders triangles to reuse recently transformed vertices (Forsyth's linear speed vertex cache optimization)
+	void optimize_vertex_cache(std::vector<uint32_t>& indices, uint32_t vertex_count);
+
+	// Splits the (cache optimized) triangle order into clusters where the cache restarts, and draws the outward facing clusters first
+	// Keeps the cache friendly order within each cluster, the view independent part of Tipsify's overdraw pass
+	void optimize_overdraw(std::vector<uint32_t>& indices, const std::vector<Vector3>& positions, uint32_t cache_size = c_vertex_cache_size);
+
+	// Vertex order by first use, so vertex fetches walk the buffer linearly
+	// Fills remap[old index] = new index and returns the used vertex count, unused vertices map to UINT32_MAX
+	uint32_t get_vertex_fetch_remap(const std::vector<uint32_t>& indices, uint32_t vertex_count, std::vector<uint32_t>& remap);
+}
+#endif
@@ -0,0 +1,377 @@
+#include <ForwardPlusDemo/Render/ObjectBVH.hpp>
+
+#include <ForwardPlusDemo/Utilities/JobSystem.hpp>
+
+#include <algorithm>
+
+namespace ForwardPlusDemo
+{
+	namespace
+	{
+		// Below this, spreading the traversal over threads costs more than it saves
+		constexpr size_t c_min_parallel_object_count = 16384;
+
+		// Subtrees at this depth are the parallel tasks (up to 64 of them)
+		constexpr uint32_t c_task_depth = 3;
+
+		float get_axis(const Vector3& vector, uint32_t axis)
+		{
+			return (axis == 0) ? vector.x : ((axis == 1) ? vector.y : vector.z);
+		}
+
+		uint32_t get_lane_mask(const XMVector& comparison)
+		{
+#if defined(_XM_SSE_INTRINSICS_)
+			return static_cast<uint32_t>(_mm_movemask_ps(comparison));
+#else
+			uint32_t lanes[4];
+			DirectX::XMStoreInt4(lanes, comparison);
+
+			return (lanes[0] >> 31) | ((lanes[1] >> 31) << 1) | ((lanes[2] >> 31) << 2) | ((lanes[3] >> 31) << 3);
+#endif
+		}
+	}
+
+	void ObjectBVH::build(const std::vector<DirectX::BoundingBox>& object_bounds)
+	{
+		clear();
+
+		if (object_bounds.empty())
+		{
+			return;
+		}
+
+		const uint32_t object_count = static_cast<uint32_t>(object_bounds.size());
+
+		m_object_min.resize(object_count);
+		m_object_max.resize(object_count);
+
+		std::vector<Centroid> centroids(object_count);
+		for (uint32_t current_object = 0; current_object < object_count; ++current_object)
+		{
+			const DirectX::BoundingBox& bounds = object_bounds[current_object];
+
+			m_object_min[current_object] = Vector3(bounds.Center.x - bounds.Extents.x, bounds.Center.y - bounds.Extents.y, bounds.Center.z - bounds.Extents.z);
+			m_object_max[current_object] = Vector3(bounds.Center.x + bounds.Extents.x, bounds.Center.y + bounds.Extents.y, bounds.Center.z + bounds.Extents.z);
+
+			centroids[current_object] = Centroid{ bounds.Center, current_object };
+		}
+
+		// Roughly one node per three objects with four wide median splits
+		m_nodes.reserve((object_count / 2) + 1);
+		build_node(centroids, 0, object_count);
+
+		m_object_indices.resize(object_count);
+		for (uint32_t current_object = 0; current_object < object_count; ++current_object)
+		{
+			m_object_indices[current_object] = centroids[current_object].object_index;
+		}
+
+		collect_tasks(0, 0);
+	}
+
+	void ObjectBVH::clear()
+	{
+		m_nodes.clear();
+		m_object_indices.clear();
+		m_object_min.clear();
+		m_object_max.clear();
+		m_tasks.clear();
+	}
+
+	void ObjectBVH::cull(const DirectX::BoundingFrustum& frustum, std::vector<uint32_t>& visible_objects, JobSystem* job_system)
+	{
+		visible_objects.clear();
+
+		if (m_nodes.empty())
+		{
+			return;
+		}
+
+		const FrustumPlanes planes = get_frustum_planes(frustum);
+
+		if ((job_system == nullptr) || (job_system->get_thread_count() <= 1) || (m_object_indices.size() < c_min_parallel_object_count))
+		{
+			cull_node(0, planes, visible_objects);
+			return;
+		}
+
+		// NOTE: the nodes above the task depth are not tested, each task tests its own children instead
+		m_task_results.resize(m_tasks.size());
+
+		// Subtree sizes vary a lot, small ranges let idle threads steal the rest
+		job_system->parallel_for(static_cast<uint32_t>(m_tasks.size()), 1, [this, &planes](uint32_t first_task, uint32_t end_task)
+		{
+			for (uint32_t current_task = first_task; current_task < end_task; ++current_task)
+			{
+				m_task_results[current_task].clear();
+				cull_task(m_tasks[current_task], planes, m_task_results[current_task]);
+			}
+		});
+
+		// Tasks are in traversal order, so the result matches a serial traversal
+		size_t visible_count = 0;
+		for (const std::vector<uint32_t>& current_results : m_task_results)
+		{
+			visible_count += current_results.size();
+		}
+
+		visible_objects.reserve(visible_count);
+		for (const std::vector<uint32_t>& current_results : m_task_results)
+		{
+			visible_objects.insert(visible_objects.end(), current_results.begin(), current_results.end());
+		}
+	}
+
+	uint32_t ObjectBVH::build_node(std::vector<Centroid>& centroids, uint32_t first, uint32_t count)
+	{
+		const uint32_t node_index = static_cast<uint32_t>(m_nodes.size());
+		m_nodes.emplace_back();
+
+		std::array<std::pair<uint32_t, uint32_t>, c_node_width> ranges;
+		uint32_t range_count = 0;
+		if (count <= c_node_width)
+		{
+			// One object per child
+			for (uint32_t current_object = 0; current_object < count; ++current_object)
+			{
+				ranges[range_count++] = { first + current_object, 1 };
+			}
+		}
+		else
+		{
+			range_count = split_range(centroids, first, count, ranges);
+		}
+
+		// Children are built first, the node array can grow in the meantime
+		Node node;
+		std::array<Vector3, c_node_width> child_min = {};
+		std::array<Vector3, c_node_width> child_max = {};
+
+		for (uint32_t current_child = 0; current_child < range_count; ++current_child)
+		{
+			const uint32_t child_first = ranges[current_child].first;
+			const uint32_t child_count = ranges[current_child].second;
+
+			get_range_bounds(centroids, child_first, child_count, child_min[current_child], child_max[current_child]);
+
+			node.child_nodes[current_child] = (child_count > 1) ? build_node(centroids, child_first, child_count) : c_invalid_node;
+			node.first_objects[current_child] = child_first;
+			node.object_counts[current_child] = child_count;
+			node.child_mask |= (1 << current_child);
+		}
+
+		node.min_x = DirectX::XMVectorSet(child_min[0].x, child_min[1].x, child_min[2].x, child_min[3].x);
+		node.min_y = DirectX::XMVectorSet(child_min[0].y, child_min[1].y, child_min[2].y, child_min[3].y);
+		node.min_z = DirectX::XMVectorSet(child_min[0].z, child_min[1].z, child_min[2].z, child_min[3].z);
+		node.max_x = DirectX::XMVectorSet(child_max[0].x, child_max[1].x, child_max[2].x, child_max[3].x);
+		node.max_y = DirectX::XMVectorSet(child_max[0].y, child_max[1].y, child_max[2].y, child_max[3].y);
+		node.max_z = DirectX::XMVectorSet(child_max[0].z, child_max[1].z, child_max[2].z, child_max[3].z);
+
+		m_nodes[node_index] = node;
+		return node_index;
+	}
+
+	uint32_t ObjectBVH::split_range(std::vector<Centroid>& centroids, uint32_t first, uint32_t count, std::array<std::pair<uint32_t, uint32_t>, c_node_width>& ranges) const
+	{
+		// Median split on the longest centroid axis, returns the first index of the upper half
+		auto split = [&centroids](uint32_t split_first, uint32_t split_count)
+		{
+			Vector3 centroid_min = centroids[split_first].position;
+			Vector3 centroid_max = centroids[split_first].position;
+			for (uint32_t current_index = split_first + 1; current_index < (split_first + split_count); ++current_index)
+			{
+				const Vector3& position = centroids[current_index].position;
+				centroid_min = Vector3(std::min(centroid_min.x, position.x), std::min(centroid_min.y, position.y), std::min(centroid_min.z, position.z));
+				centroid_max = Vector3(std::max(centroid_max.x, position.x), std::max(centroid_max.y, position.y), std::max(centroid_max.z, position.z));
+			}
+
+			const Vector3 centroid_extent(centroid_max.x - centroid_min.x, centroid_max.y - centroid_min.y, centroid_max.z - centroid_min.z);
+			uint32_t axis = 0;
+			if (centroid_extent.y > get_axis(centroid_extent, axis))
+			{
+				axis = 1;
+			}
+			if (centroid_extent.z > get_axis(centroid_extent, axis))
+			{
+				axis = 2;
+			}
+
+			const uint32_t middle = split_first + (split_count / 2);
+			std::nth_element(centroids.begin() + split_first, centroids.begin() + middle, centroids.begin() + split_first + split_count, [axis](const Centroid& a, const Centroid& b)
+			{
+				return get_axis(a.position, axis) < get_axis(b.position, axis);
+			});
+
+			return middle;
+		};
+
+		// Split twice for four children, both halves have at least two objects here
+		uint32_t range_count = 0;
+
+		const uint32_t middle = split(first, count);
+		const std::array<std::pair<uint32_t, uint32_t>, 2> halves = { std::make_pair(first, middle - first), std::make_pair(middle, (first + count) - middle) };
+		for (const std::pair<uint32_t, uint32_t>& current_half : halves)
+		{
+			const uint32_t quarter = split(current_half.first, current_half.second);
+			ranges[range_count++] = { current_half.first, quarter - current_half.first };
+			ranges[range_count++] = { quarter, (current_half.first + current_half.second) - quarter };
+		}
+
+		return range_count;
+	}
+
+	void ObjectBVH::get_range_bounds(const std::vector<Centroid>& centroids, uint32_t first, uint32_t count, Vector3& bounds_min, Vector3& bounds_max) const
+	{
+		bounds_min = m_object_min[centroids[first].object_index];
+		bounds_max = m_object_max[centroids[first].object_index];
+
+		for (uint32_t current_index = first + 1; current_index < (first + count); ++current_index)
+		{
+			const Vector3& object_min = m_object_min[centroids[current_index].object_index];
+			const Vector3& object_max = m_object_max[centroids[current_index].object_index];
+
+			bounds_min = Vector3(std::min(bounds_min.x, object_min.x), std::min(bounds_min.y, object_min.y), std::min(bounds_min.z, object_min.z));
+			bounds_max = Vector3(std::max(bounds_max.x, object_max.x), std::max(bounds_max.y, object_max.y), std::max(bounds_max.z, object_max.z));
+		}
+	}
+
+	void ObjectBVH::collect_tasks(uint32_t node_index, uint32_t depth)
+	{
+		const Node& node = m_nodes[node_index];
+		for (uint32_t current_child = 0; current_child < c_node_width; ++current_child)
+		{
+			if ((node.child_mask & (1 << current_child)) == 0)
+			{
+				continue;
+			}
+
+			const uint32_t child_node = node.child_nodes[current_child];
+			if ((child_node == c_invalid_node) || ((depth + 1) == c_task_depth))
+			{
+				m_tasks.push_back(CullTask{ child_node, node.first_objects[current_child], node.object_counts[current_child] });
+			}
+			else
+			{
+				collect_tasks(child_node, depth + 1);
+			}
+		}
+	}
+
+	ObjectBVH::FrustumPlanes ObjectBVH::get_frustum_planes(const DirectX::BoundingFrustum& frustum)
+	{
+		std::array<XMVector, 6> frustum_planes;
+		frustum.GetPlanes(&frustum_planes[0], &frustum_planes[1], &frustum_planes[2], &frustum_planes[3], &frustum_planes[4], &frustum_planes[5]);
+
+		FrustumPlanes planes;
+		for (size_t current_plane = 0; current_plane < frustum_planes.size(); ++current_plane)
+		{
+			// DirectXCollision planes face outward
+			const XMVector plane = DirectX::XMVectorNegate(frustum_planes[current_plane]);
+
+			planes.x[current_plane] = DirectX::XMVectorSplatX(plane);
+			planes.y[current_plane] = DirectX::XMVectorSplatY(plane);
+			planes.z[current_plane] = DirectX::XMVectorSplatZ(plane);
+			planes.w[current_plane] = DirectX::XMVectorSplatW(plane);
+
+			planes.positive[current_plane] = { DirectX::XMVectorGetX(plane) >= 0.0f, DirectX::XMVectorGetY(plane) >= 0.0f, DirectX::XMVectorGetZ(plane) >= 0.0f };
+		}
+
+		return planes;
+	}
+
+	void ObjectBVH::cull_task(const CullTask& task, const FrustumPlanes& planes, std::vector<uint32_t>& visible_objects) const
+	{
+		if (task.node != c_invalid_node)
+		{
+			cull_node(task.node, planes, visible_objects);
+		}
+		else if (is_object_visible(m_object_indices[task.first_object], planes))
+		{
+			visible_objects.push_back(m_object_indices[task.first_object]);
+		}
+	}
+
+	void ObjectBVH::cull_node(uint32_t node_index, const FrustumPlanes& planes, std::vector<uint32_t>& visible_objects) const
+	{
+		const Node& node = m_nodes[node_index];
+
+		const XMVector zero = DirectX::XMVectorZero();
+		XMVector outside = DirectX::XMVectorFalseInt();
+		XMVector intersecting = DirectX::XMVectorFalseInt();
+
+		for (size_t current_plane = 0; current_plane < planes.x.size(); ++current_plane)
+		{
+			// The corner furthest along the normal decides if a box is outside, the nearest one if it crosses the plane
+			const std::array<bool, 3>& positive = planes.positive[current_plane];
+
+			const XMVector far_x = positive[0] ? node.max_x : node.min_x;
+			const XMVector far_y = positive[1] ? node.max_y : node.min_y;
+			const XMVector far_z = positive[2] ? node.max_z : node.min_z;
+			const XMVector near_x = positive[0] ? node.min_x : node.max_x;
+			const XMVector near_y = positive[1] ? node.min_y : node.max_y;
+			const XMVector near_z = positive[2] ? node.min_z : node.max_z;
+
+			XMVector far_distance = DirectX::XMVectorMultiplyAdd(far_x, planes.x[current_plane], planes.w[current_plane]);
+			far_distance = DirectX::XMVectorMultiplyAdd(far_y, planes.y[current_plane], far_distance);
+			far_distance = DirectX::XMVectorMultiplyAdd(far_z, planes.z[current_plane], far_distance);
+
+			XMVector near_distance = DirectX::XMVectorMultiplyAdd(near_x, planes.x[current_plane], planes.w[current_plane]);
+			near_distance = DirectX::XMVectorMultiplyAdd(near_y, planes.y[current_plane], near_distance);
+			near_distance = DirectX::XMVectorMultiplyAdd(near_z, planes.z[current_plane], near_distance);
+
+			outside = DirectX::XMVectorOrInt(outside, DirectX::XMVectorLess(far_distance, zero));
+			intersecting = DirectX::XMVectorOrInt(intersecting, DirectX::XMVectorLess(near_distance, zero));
+		}
+
+		const uint32_t visible_mask = node.child_mask & ~get_lane_mask(outside);
+		const uint32_t intersecting_mask = get_lane_mask(intersecting);
+
+		for (uint32_t current_child = 0; current_child < c_node_width; ++current_child)
+		{
+			const uint32_t child_bit = (1 << current_child);
+			if ((visible_mask & child_bit) == 0)
+			{
+				continue;
+			}
+
+			const uint32_t first_object = node.first_objects[current_child];
+			if (node.child_nodes[current_child] == c_invalid_node)
+			{
+				visible_objects.push_back(m_object_indices[first_object]);
+			}
+			else if ((intersecting_mask & child_bit) == 0)
+			{
+				// Fully inside, the whole subtree is visible
+				visible_objects.insert(visible_objects.end(), m_object_indices.begin() + first_object, m_object_indices.begin() + first_object + node.object_counts[current_child]);
+			}
+			else
+			{
+				cull_node(node.child_nodes[current_child], planes, visible_objects);
+			}
+		}
+	}
+
+	bool ObjectBVH::is_object_visible(uint32_t object_index, const FrustumPlanes& planes) const
+	{
+		const Vector3& object_min = m_object_min[object_index];
+		const Vector3& object_max = m_object_max[object_index];
+
+		for (size_t current_plane = 0; current_plane < planes.x.size(); ++current_plane)
+		{
+			const std::array<bool, 3>& positive = planes.positive[current_plane];
+
+			const float far_distance = (DirectX::XMVectorGetX(planes.x[current_plane]) * (positive[0] ? object_max.x : object_min.x))
+				+ (DirectX::XMVectorGetX(planes.y[current_plane]) * (positive[1] ? object_max.y : object_min.y))
+				+ (DirectX::XMVectorGetX(planes.z[current_plane]) * (positive[2] ? object_max.z : object_min.z))
+				+ DirectX::XMVectorGetX(planes.w[current_plane]);
+
+			if (far_distance < 0.0f)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,95 @@
+#ifndef FORWARDPLUSDEMO_RENDER_OBJECTBVH_HPP
+#define FORWARDPLUSDEMO_RENDER_OBJECTBVH_HPP
+#include <ForwardPlusDemo/Render/Math.hpp>
+
+#include <DirectXCollision.h>
+
+#include <array>
+#include <utility>
+#include <vector>
+namespace ForwardPlusDemo
+{
+	class JobSystem;
+
+	// Static 4-wide BVH over object bounding boxes, for frustum culling large scenes
+	// Child bounds are kept in SoA layout, so every plane test covers the four children of a node at once
+	class ObjectBVH
+	{
+	public:
+		// Object indices are positions in the given array, rebuild when objects are added or moved
+		void build(const std::vector<DirectX::BoundingBox>& object_bounds);
+		void clear();
+
+		// Visible object indices, in the same order regardless of the thread count
+		// Without a job system, or for small scenes, the tree is culled on the calling thread
+		void cull(const DirectX::BoundingFrustum& frustum, std::vector<uint32_t>& visible_objects, JobSystem* job_system = nullptr);
+
+		uint32_t get_object_count() const { return static_cast<uint32_t>(m_object_indices.size()); }
+	private:
+		static constexpr uint32_t c_node_width = 4;
+		static constexpr uint32_t c_invalid_node = UINT32_MAX;
+
+		struct alignas(16) Node
+		{
+			XMVector min_x;
+			XMVector min_y;
+			XMVector min_z;
+			XMVector max_x;
+			XMVector max_y;
+			XMVector max_z;
+
+			// Children cover contiguous ranges of m_object_indices, single object children have no node
+			std::array<uint32_t, c_node_width> child_nodes;
+			std::array<uint32_t, c_node_width> first_objects;
+			std::array<uint32_t, c_node_width> object_counts;
+			uint32_t child_mask = 0; // Bit per used child slot
+		};
+
+		// Inward facing planes, each component splatted so they can be applied to four boxes
+		struct FrustumPlanes
+		{
+			std::array<XMVector, 6> x;
+			std::array<XMVector, 6> y;
+			std::array<XMVector, 6> z;
+			std::array<XMVector, 6> w;
+			std::array<std::array<bool, 3>, 6> positive; // Sign of the normal components, picks the box corners to test
+		};
+
+		// Unit of parallel work, a subtree (or a single object) from the top of the tree
+		struct CullTask
+		{
+			uint32_t node;
+			uint32_t first_object;
+			uint32_t object_count;
+		};
+
+		struct Centroid
+		{
+			Vector3 position;
+			uint32_t object_index;
+		};
+
+		uint32_t build_node(std::vector<Centroid>& centroids, uint32_t first, uint32_t count);
+		uint32_t split_range(std::vector<Centroid>& centroids, uint32_t first, uint32_t count, std::array<std::pair<uint32_t, uint32_t>, c_node_width>& ranges) const;
+		void get_range_bounds(const std::vector<Centroid>& centroids, uint32_t first, uint32_t count, Vector3& bounds_min, Vector3& bounds_max) const;
+
+		void collect_tasks(uint32_t node_index, uint32_t depth);
+
+		static FrustumPlanes get_frustum_planes(const DirectX::BoundingFrustum& frustum);
+
+		void cull_task(const CullTask& task, const FrustumPlanes& planes, std::vector<uint32_t>& visible_objects) const;
+		void cull_node(uint32_t node_index, const FrustumPlanes& planes, std::vector<uint32_t>& visible_objects) const;
+		bool is_object_visible(uint32_t object_index, const FrustumPlanes& planes) const;
+
+		std::vector<Node> m_nodes; // Root first
+		std::vector<uint32_t> m_object_indices; // Grouped by leaf
+
+		// Per object bounds, in build order
+		std::vector<Vector3> m_object_min;
+		std::vector<Vector3> m_object_max;
+
+		std::vector<CullTask> m_tasks;
+		std::vector<std::vector<uint32_t>> m_task_results;
+	};
+}
+#endif
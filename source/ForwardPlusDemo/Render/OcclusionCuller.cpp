@@ -0,0 +1,384 @@
+#include <ForwardPlusDemo/Render/OcclusionCuller.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+
+namespace ForwardPlusDemo
+{
+	namespace
+	{
+		// Unit box corners, bit 0 is X, bit 1 is Y and bit 2 is Z
+		constexpr std::array<std::array<uint32_t, 4>, 6> c_box_faces = { {
+			{ 0, 2, 6, 4 },
+			{ 1, 5, 7, 3 },
+			{ 0, 4, 5, 1 },
+			{ 2, 3, 7, 6 },
+			{ 0, 1, 3, 2 },
+			{ 4, 6, 7, 5 }
+		} };
+
+		// Quad clipped by the near plane gains at most one vertex
+		constexpr uint32_t c_max_polygon_vertices = 5;
+
+		// Polygons smaller than this (in texels squared) can't fully cover a texel
+		constexpr float c_min_polygon_area = 0.5f;
+
+		XMVector get_box_corner(uint32_t corner_index)
+		{
+			return DirectX::XMVectorSet(
+				(corner_index & 1) ? 0.5f : -0.5f,
+				(corner_index & 2) ? 0.5f : -0.5f,
+				(corner_index & 4) ? 0.5f : -0.5f,
+				1.0f);
+		}
+
+		// Keeps the part of the polygon in front of the near plane (clip space Z >= 0)
+		uint32_t clip_near_plane(const std::array<Vector4, 4>& input, std::array<Vector4, c_max_polygon_vertices>& output)
+		{
+			uint32_t output_count = 0;
+
+			for (uint32_t current_index = 0; current_index < input.size(); ++current_index)
+			{
+				const Vector4& current = input[current_index];
+				const Vector4& next = input[(current_index + 1) % input.size()];
+
+				const bool current_inside = current.z >= 0.0f;
+				const bool next_inside = next.z >= 0.0f;
+
+				if (current_inside)
+				{
+					output[output_count++] = current;
+				}
+
+				if (current_inside != next_inside)
+				{
+					const float t = current.z / (current.z - next.z);
+					output[output_count++] = Vector4(
+						current.x + (next.x - current.x) * t,
+						current.y + (next.y - current.y) * t,
+						0.0f,
+						current.w + (next.w - current.w) * t);
+				}
+			}
+
+			return output_count;
+		}
+	}
+
+	OcclusionCuller::OcclusionCuller(uint32_t width, uint32_t height)
+	{
+		uint32_t level_width = std::max(width, 1u);
+		uint32_t level_height = std::max(height, 1u);
+
+		while (true)
+		{
+			DepthLevel& level = m_levels.emplace_back();
+			level.width = level_width;
+			level.height = level_height;
+			level.depth.resize(static_cast<size_t>(level_width) * level_height, 1.0f);
+
+			if (level_width == 1 && level_height == 1)
+			{
+				break;
+			}
+
+			level_width = std::max((level_width + 1) / 2, 1u);
+			level_height = std::max((level_height + 1) / 2, 1u);
+		}
+
+		m_view_projection = DirectX::XMMatrixIdentity();
+	}
+
+	void OcclusionCuller::begin(const XMMatrix& view_projection)
+	{
+		m_view_projection = view_projection;
+		m_occluder_count = 0;
+		m_ready = false;
+
+		std::fill(m_levels[0].depth.begin(), m_levels[0].depth.end(), 1.0f);
+	}
+
+	void OcclusionCuller::add_box_occluder(const XMMatrix& box_transform)
+	{
+		const XMMatrix transform = box_transform * m_view_projection;
+
+		std::array<Vector4, 8> clip_corners;
+		for (uint32_t corner_index = 0; corner_index < clip_corners.size(); ++corner_index)
+		{
+			DirectX::XMStoreFloat4(&clip_corners[corner_index], DirectX::XMVector4Transform(get_box_corner(corner_index), transform));
+		}
+
+		const DepthLevel& level = m_levels[0];
+		const float half_width = static_cast<float>(level.width) * 0.5f;
+		const float half_height = static_cast<float>(level.height) * 0.5f;
+
+		// Every face is drawn, the nearest depth wins so back faces never matter
+		for (const std::array<uint32_t, 4>& face : c_box_faces)
+		{
+			const std::array<Vector4, 4> face_corners = {
+				clip_corners[face[0]],
+				clip_corners[face[1]],
+				clip_corners[face[2]],
+				clip_corners[face[3]]
+			};
+
+			std::array<Vector4, c_max_polygon_vertices> clipped;
+			const uint32_t clipped_count = clip_near_plane(face_corners, clipped);
+			if (clipped_count < 3)
+			{
+				continue;
+			}
+
+			std::array<Vector3, c_max_polygon_vertices> screen;
+			for (uint32_t vertex_index = 0; vertex_index < clipped_count; ++vertex_index)
+			{
+				const Vector4& vertex = clipped[vertex_index];
+				const float inv_w = 1.0f / vertex.w;
+
+				screen[vertex_index] = Vector3(
+					(vertex.x * inv_w + 1.0f) * half_width,
+					(1.0f - vertex.y * inv_w) * half_height,
+					vertex.z * inv_w);
+			}
+
+			rasterize_polygon(screen.data(), clipped_count);
+		}
+
+		++m_occluder_count;
+	}
+
+	void OcclusionCuller::rasterize_polygon(const Vector3* vertices, uint32_t vertex_count)
+	{
+		DepthLevel& level = m_levels[0];
+
+		// Depth plane from the polygon normal (Newell's method), robust against collinear vertices from clipping
+		float normal_x = 0.0f;
+		float normal_y = 0.0f;
+		float normal_z = 0.0f;
+
+		Vector3 center(0.0f, 0.0f, 0.0f);
+		float min_x = FLT_MAX;
+		float min_y = FLT_MAX;
+		float max_x = -FLT_MAX;
+		float max_y = -FLT_MAX;
+
+		for (uint32_t vertex_index = 0; vertex_index < vertex_count; ++vertex_index)
+		{
+			const Vector3& current = vertices[vertex_index];
+			const Vector3& next = vertices[(vertex_index + 1) % vertex_count];
+
+			normal_x += (current.y - next.y) * (current.z + next.z);
+			normal_y += (current.z - next.z) * (current.x + next.x);
+			normal_z += (current.x - next.x) * (current.y + next.y);
+
+			center.x += current.x;
+			center.y += current.y;
+			center.z += current.z;
+
+			min_x = std::min(min_x, current.x);
+			min_y = std::min(min_y, current.y);
+			max_x = std::max(max_x, current.x);
+			max_y = std::max(max_y, current.y);
+		}
+
+		// Normal Z is twice the signed screen area
+		if (std::abs(normal_z) < c_min_polygon_area * 2.0f)
+		{
+			return;
+		}
+
+		const float inv_count = 1.0f / static_cast<float>(vertex_count);
+		center.x *= inv_count;
+		center.y *= inv_count;
+		center.z *= inv_count;
+
+		const float depth_dx = -normal_x / normal_z;
+		const float depth_dy = -normal_y / normal_z;
+
+		// Edge functions are positive inside, whatever the winding
+		const float orientation = (normal_z > 0.0f) ? 1.0f : -1.0f;
+
+		struct Edge
+		{
+			float a;
+			float b;
+			float c;
+		};
+
+		std::array<Edge, c_max_polygon_vertices> edges;
+		for (uint32_t vertex_index = 0; vertex_index < vertex_count; ++vertex_index)
+		{
+			const Vector3& current = vertices[vertex_index];
+			const Vector3& next = vertices[(vertex_index + 1) % vertex_count];
+
+			const float edge_x = next.x - current.x;
+			const float edge_y = next.y - current.y;
+
+			edges[vertex_index].a = -orientation * edge_y;
+			edges[vertex_index].b = orientation * edge_x;
+			edges[vertex_index].c = orientation * (edge_y * current.x - edge_x * current.y);
+		}
+
+		const float level_width = static_cast<float>(level.width);
+		const float level_height = static_cast<float>(level.height);
+
+		const int32_t first_x = static_cast<int32_t>(std::floor(std::clamp(min_x, 0.0f, level_width)));
+		const int32_t first_y = static_cast<int32_t>(std::floor(std::clamp(min_y, 0.0f, level_height)));
+		const int32_t last_x = static_cast<int32_t>(std::ceil(std::clamp(max_x, 0.0f, level_width))) - 1;
+		const int32_t last_y = static_cast<int32_t>(std::ceil(std::clamp(max_y, 0.0f, level_height))) - 1;
+
+		// The texel corner farthest along the depth gradient gives the texel's farthest depth
+		const float depth_corner_offset = std::max(depth_dx, 0.0f) + std::max(depth_dy, 0.0f);
+
+		for (int32_t y = first_y; y <= last_y; ++y)
+		{
+			for (int32_t x = first_x; x <= last_x; ++x)
+			{
+				const float texel_x = static_cast<float>(x);
+				const float texel_y = static_cast<float>(y);
+
+				// Conservative coverage, the worst texel corner of every edge has to be inside
+				bool covered = true;
+				for (uint32_t edge_index = 0; edge_index < vertex_count; ++edge_index)
+				{
+					const Edge& edge = edges[edge_index];
+					const float worst_value = edge.a * texel_x + edge.b * texel_y + edge.c + std::min(edge.a, 0.0f) + std::min(edge.b, 0.0f);
+
+					if (worst_value < 0.0f)
+					{
+						covered = false;
+						break;
+					}
+				}
+
+				if (!covered)
+				{
+					continue;
+				}
+
+				const float depth = center.z + depth_dx * (texel_x - center.x) + depth_dy * (texel_y - center.y) + depth_corner_offset;
+
+				float& stored_depth = level.depth[static_cast<size_t>(y) * level.width + x];
+				stored_depth = std::min(stored_depth, std::max(depth, 0.0f));
+			}
+		}
+	}
+
+	void OcclusionCuller::finish()
+	{
+		for (size_t level_index = 1; level_index < m_levels.size(); ++level_index)
+		{
+			const DepthLevel& source = m_levels[level_index - 1];
+			DepthLevel& destination = m_levels[level_index];
+
+			for (uint32_t y = 0; y < destination.height; ++y)
+			{
+				const uint32_t source_y0 = std::min(y * 2, source.height - 1);
+				const uint32_t source_y1 = std::min(y * 2 + 1, source.height - 1);
+
+				for (uint32_t x = 0; x < destination.width; ++x)
+				{
+					const uint32_t source_x0 = std::min(x * 2, source.width - 1);
+					const uint32_t source_x1 = std::min(x * 2 + 1, source.width - 1);
+
+					const float max_depth = std::max(
+						std::max(source.depth[source_y0 * source.width + source_x0], source.depth[source_y0 * source.width + source_x1]),
+						std::max(source.depth[source_y1 * source.width + source_x0], source.depth[source_y1 * source.width + source_x1]));
+
+					destination.depth[y * destination.width + x] = max_depth;
+				}
+			}
+		}
+
+		m_ready = m_occluder_count > 0;
+	}
+
+	bool OcclusionCuller::is_occluded(const DirectX::BoundingBox& bounds) const
+	{
+		if (!m_ready)
+		{
+			return false;
+		}
+
+		const DepthLevel& base_level = m_levels[0];
+		const float half_width = static_cast<float>(base_level.width) * 0.5f;
+		const float half_height = static_cast<float>(base_level.height) * 0.5f;
+
+		XMFLOAT3 corners[DirectX::BoundingBox::CORNER_COUNT];
+		bounds.GetCorners(corners);
+
+		float min_x = FLT_MAX;
+		float min_y = FLT_MAX;
+		float max_x = -FLT_MAX;
+		float max_y = -FLT_MAX;
+		float min_depth = FLT_MAX;
+
+		for (const XMFLOAT3& corner : corners)
+		{
+			Vector4 clip_corner;
+			DirectX::XMStoreFloat4(&clip_corner, DirectX::XMVector4Transform(DirectX::XMVectorSet(corner.x, corner.y, corner.z, 1.0f), m_view_projection));
+
+			// Crossing the near plane, too close to reason about
+			if (clip_corner.z < 0.0f)
+			{
+				return false;
+			}
+
+			const float inv_w = 1.0f / clip_corner.w;
+			const float screen_x = (clip_corner.x * inv_w + 1.0f) * half_width;
+			const float screen_y = (1.0f - clip_corner.y * inv_w) * half_height;
+
+			min_x = std::min(min_x, screen_x);
+			min_y = std::min(min_y, screen_y);
+			max_x = std::max(max_x, screen_x);
+			max_y = std::max(max_y, screen_y);
+			min_depth = std::min(min_depth, clip_corner.z * inv_w);
+		}
+
+		// Off screen bounds are left to the frustum culling
+		if (max_x < 0.0f || max_y < 0.0f || min_x >= static_cast<float>(base_level.width) || min_y >= static_cast<float>(base_level.height))
+		{
+			return false;
+		}
+
+		// Clamped before converting, bounds close to the camera can project far outside the buffer
+		const float max_texel_x = static_cast<float>(base_level.width - 1);
+		const float max_texel_y = static_cast<float>(base_level.height - 1);
+
+		int32_t first_x = static_cast<int32_t>(std::floor(std::clamp(min_x, 0.0f, max_texel_x)));
+		int32_t first_y = static_cast<int32_t>(std::floor(std::clamp(min_y, 0.0f, max_texel_y)));
+		int32_t last_x = static_cast<int32_t>(std::floor(std::clamp(max_x, 0.0f, max_texel_x)));
+		int32_t last_y = static_cast<int32_t>(std::floor(std::clamp(max_y, 0.0f, max_texel_y)));
+
+		// Coarsest level needed so the rectangle touches at most 2x2 texels
+		size_t level_index = 0;
+		while ((last_x - first_x > 1 || last_y - first_y > 1) && level_index + 1 < m_levels.size())
+		{
+			first_x >>= 1;
+			first_y >>= 1;
+			last_x >>= 1;
+			last_y >>= 1;
+			++level_index;
+		}
+
+		const DepthLevel& level = m_levels[level_index];
+
+		float max_depth = 0.0f;
+		for (int32_t y = first_y; y <= last_y; ++y)
+		{
+			for (int32_t x = first_x; x <= last_x; ++x)
+			{
+				max_depth = std::max(max_depth, level.depth[static_cast<size_t>(y) * level.width + x]);
+			}
+		}
+
+		return min_depth > max_depth;
+	}
+
+	bool OcclusionCuller::is_occluded(const DirectX::BoundingSphere& bounds) const
+	{
+		return is_occluded(DirectX::BoundingBox(bounds.Center, XMFLOAT3(bounds.Radius, bounds.Radius, bounds.Radius)));
+	}
+}
@@ -0,0 +1,48 @@
+#ifndef FORWARDPLUSDEMO_RENDER_OCCLUSIONCULLER_HPP
+#define FORWARDPLUSDEMO_RENDER_OCCLUSIONCULLER_HPP
+#include <ForwardPlusDemo/Render/Math.hpp>
+
+#include <DirectXCollision.h>
+
+#include <vector>
+namespace ForwardPlusDemo
+{
+	// Low resolution CPU depth buffer with a max depth (HiZ) mip chain, rendered from a few large occluders every frame
+	// Occluders only write fully covered texels with the farthest depth inside the texel, so queries never reject visible bounds
+	class OcclusionCuller
+	{
+	public:
+		OcclusionCuller(uint32_t width = 256, uint32_t height = 128);
+
+		// Clears the depth buffer, occluders & queries use the same view projection
+		void begin(const XMMatrix& view_projection);
+
+		// Solid unit box (-0.5 to 0.5 on each axis) transformed by the matrix, boxes flattened on an axis work for planes
+		void add_box_occluder(const XMMatrix& box_transform);
+
+		// Builds the mip chain, queries are valid (and thread safe) until the next begin
+		void finish();
+
+		bool is_occluded(const DirectX::BoundingBox& bounds) const;
+		bool is_occluded(const DirectX::BoundingSphere& bounds) const;
+
+		uint32_t get_occluder_count() const { return m_occluder_count; }
+	private:
+		struct DepthLevel
+		{
+			uint32_t width = 0;
+			uint32_t height = 0;
+			std::vector<float> depth;
+		};
+
+		// Convex polygon in texel coordinates (X, Y) with depth in Z
+		void rasterize_polygon(const Vector3* vertices, uint32_t vertex_count);
+
+		std::vector<DepthLevel> m_levels; // Level 0 is the full resolution buffer
+
+		XMMatrix m_view_projection;
+		uint32_t m_occluder_count = 0;
+		bool m_ready = false;
+	};
+}
+#endif
@@ -1,18 +1,45 @@
 #include <ForwardPlusDemo/Render/RenderSystem.hpp>
 
 #include <ForwardPlusDemo/Application/Application.hpp>
+#include <ForwardPlusDemo/GraphicsAPI/CommandList.hpp>
+#include <ForwardPlusDemo/GraphicsAPI/ConstantBufferRing.hpp>
 #include <ForwardPlusDemo/GraphicsAPI/GraphicsAPI.hpp>
+#include <ForwardPlusDemo/GraphicsAPI/NullDevice.hpp>
 
+#include <ForwardPlusDemo/Render/DrawListBuilder.hpp>
 #include <ForwardPlusDemo/Render/LightSystem.hpp>
+#include <ForwardPlusDemo/Render/MeshBuilder.hpp>
+#include <ForwardPlusDemo/Render/ObjectBVH.hpp>
+#include <ForwardPlusDemo/Render/OcclusionCuller.hpp>
+#include <ForwardPlusDemo/Render/SoftwareRasterizer.hpp>
+#include <ForwardPlusDemo/Render/VertexFormat.hpp>
+
+#include <ForwardPlusDemo/Scene/ScenarioGenerator.hpp>
+#include <ForwardPlusDemo/Scene/SceneFile.hpp>
 
 #include <ForwardPlusDemo/Utilities/EventQueue.hpp>
+#include <ForwardPlusDemo/Utilities/EventRegistry.hpp>
+#include <ForwardPlusDemo/Utilities/EventRing.hpp>
 #include <ForwardPlusDemo/Utilities/Fence.hpp>
+#include <ForwardPlusDemo/Utilities/FramePipeline.hpp>
+#include <ForwardPlusDemo/Utilities/JobSystem.hpp>
+#include <ForwardPlusDemo/Utilities/Mailbox.hpp>
+#include <ForwardPlusDemo/Utilities/Profiler.hpp>
+#include <ForwardPlusDemo/Utilities/ThreadParker.hpp>
 
 #include <d3dcompiler.h>
 
 #include <DirectXCollision.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
 #include <thread>
+#include <utility>
 
 namespace ForwardPlusDemo
 {
@@ -55,20 +82,6 @@ namespace ForwardPlusDemo
 			Vector3{ 0.0f, 0.5f, -0.5f },
 		};
 
-		enum class ObjectType
-		{
-			CUBE,
-			PYRAMID,
-			PLANE,
-			TYPE_COUNT
-		};
-
-		struct ObjectInfo
-		{
-			uint32_t vertex_offset;
-			uint32_t vertex_count;
-		};
-
 		struct alignas(16) Material
 		{
 			Vector4 diffuse = { 0, 0, 0, 0 };
@@ -80,6 +93,35 @@ namespace ForwardPlusDemo
 			XMMatrix model = DirectX::XMMatrixIdentity();
 			XMMatrix inv_model = DirectX::XMMatrixIdentity();
 			Material material;
+			ObjectLightList light_list; // Filled in every frame
+		};
+
+		struct alignas(16) DrawBatchData
+		{
+			uint32_t first_instance = 0;
+			Vector3i _padding = { 0, 0, 0 };
+		};
+
+		constexpr uint32_t c_initial_instance_capacity = 1024;
+
+		// Per-draw & per-dispatch constants of the frames in flight, every allocation takes at least 256 bytes
+		constexpr uint32_t c_constant_buffer_ring_capacity = 1024 * 1024;
+
+		// Events from the main thread not yet read by the render thread, a frame usually needs a few hundred bytes
+		constexpr uint32_t c_event_ring_capacity = 64 * 1024;
+
+		// Occluders rasterized per frame, a few big ones hide almost as much as all of them
+		constexpr size_t c_max_occluder_count = 32;
+
+		// Visible objects per culling & draw list job, each one only takes a few hundred nanoseconds
+		constexpr uint32_t c_min_object_job_size = 256;
+
+		// Totals over the whole run, logged at shutdown when headless
+		struct DrawOrderStatistics
+		{
+			uint64_t frame_count = 0;
+			uint64_t batch_count = 0;
+			uint64_t state_change_count = 0;
 		};
 
 		struct ObjectInstanceInfo
@@ -122,33 +164,105 @@ namespace ForwardPlusDemo
 			XMMatrix view_projection = DirectX::XMMatrixIdentity();
 		};
 
+		// What the recorded commands refer to, either the D3D objects or their null device counterparts
+		struct SceneResourceHandles
+		{
+			CommandHandle vertex_shader = nullptr;
+			CommandHandle input_layout = nullptr;
+			CommandHandle pixel_shader = nullptr;
+
+			CommandHandle vertex_buffer = nullptr;
+			CommandHandle index_buffer = nullptr;
+			CommandHandle camera_buffer = nullptr;
+
+			CommandHandle instance_buffer = nullptr;
+			CommandHandle instance_buffer_srv = nullptr;
+		};
+
 		struct Vertex
 		{
 			Vector4 position = { 0, 0, 0, 0 };
 			Vector4 normal = { 0, 0, 0, 0 };
 		};
 
-		enum class RenderEventType : uint32_t
+		// Events from the main thread, handled in order by RenderSystem::Internal::handle_event
+		// Camera transform & window size go through mailboxes instead, only their newest value matters
+		struct PauseEvent
 		{
-			UPDATE_CAMERA_TRANSFORM,
-			FENCE,
-			PAUSE,
-			RESIZE_WINDOW,
-			SET_WINDOW_FULLSCREEN_STATE,
-			TOGGLE_LIGHT_DEBUG_RENDERING
+			bool paused;
 		};
 
+		struct SetFullscreenStateEvent
+		{
+			bool fullscreen;
+		};
+
+		struct ToggleLightDebugRenderingEvent
+		{
+		};
+
+		using RenderEvents = EventRegistry<PauseEvent, SetFullscreenStateEvent, ToggleLightDebugRenderingEvent>;
+
 		struct WindowSizeInfo
 		{
 			UINT width;
 			UINT height;
 		};
+
+		struct CameraMailboxData
+		{
+			CameraTransformUpdate transform;
+			std::chrono::steady_clock::time_point write_time; // For the input to present latency
+		};
+
+		// Circles around its scene position, phases are spread so the lights don't all move in lockstep
+		struct MovingLight
+		{
+			uint32_t light_index;
+			XMMatrix scene_transform;
+			float phase;
+		};
+
+		constexpr float c_moving_light_radius = 2.0f;
+		constexpr float c_moving_light_speed = 1.0f; // Radians per second
+
+		// Time from the main thread writing a camera transform to the Present of the first frame drawn with it
+		struct CameraLatencyStatistics
+		{
+			uint64_t frame_count = 0;
+			std::chrono::steady_clock::duration total_latency = std::chrono::steady_clock::duration::zero();
+			std::chrono::steady_clock::duration max_latency = std::chrono::steady_clock::duration::zero();
+		};
+
+		// Everything a prepared frame hands over to its recording, one per pipeline slot
+		struct FrameSnapshot
+		{
+			Camera shader_camera;
+			DrawListBuilder<PerDrawData> draw_list;
+
+			// Camera transform written by the main thread that this frame is the first to use, if any
+			bool camera_latency_pending = false;
+			std::chrono::steady_clock::time_point camera_write_time;
+		};
+
+		// Totals over the whole run, logged at shutdown when headless
+		struct PipelineStatistics
+		{
+			uint64_t frame_count = 0;
+			std::chrono::steady_clock::time_point first_frame_end;
+			std::chrono::steady_clock::time_point last_frame_end;
+			std::chrono::steady_clock::duration total_prepare_time = std::chrono::steady_clock::duration::zero();
+			std::chrono::steady_clock::duration total_record_time = std::chrono::steady_clock::duration::zero();
+		};
 	}
 
 	struct RenderSystem::Internal 
 	{
 		Application& m_application;
 
+		// Workers for the per-frame CPU stages, declared first so it outlives everything that submits jobs
+		JobSystem m_job_system;
+
 		GraphicsAPI m_graphics_api;
 
 		LightSystem m_light_system;
@@ -156,21 +270,80 @@ namespace ForwardPlusDemo
 		Shader m_shader;
 
 		D3DBuffer m_vertex_buffer;
+		uint32_t m_vertex_stride = sizeof(Vertex);
+		D3DBuffer m_index_buffer;
+		IndexFormat m_index_format = IndexFormat::UINT16;
 
 		D3DBuffer m_forward_plus_cbuffer;
 		D3DBuffer m_camera_buffer;
-		D3DBuffer m_per_draw_cbuffer;
 
-		std::array<ObjectInfo, static_cast<size_t>(ObjectType::TYPE_COUNT)> m_object_info;
+		// Per-instance PerDrawData for the instanced draws, grown as needed
+		D3DBuffer m_instance_buffer;
+		D3DShaderResourceView m_instance_buffer_srv;
+		uint32_t m_instance_capacity = 0;
+
+		SceneResourceHandles m_handles;
+
+		std::array<MeshRange, static_cast<size_t>(ObjectType::TYPE_COUNT)> m_object_info;
 		std::vector<ObjectInstanceInfo> m_object_instances;
+		DrawOrderStatistics m_draw_order_statistics;
+
+		// Objects never move, so the BVH is built once after loading
+		ObjectBVH m_object_bvh;
+		std::vector<uint32_t> m_visible_objects;
+		std::vector<uint8_t> m_object_occluded; // Per visible object, written by the culling jobs
+
+		// Rebuilt every frame from the biggest visible cubes & planes, also used for the light culling
+		OcclusionCuller m_occlusion_culler;
+		std::vector<std::pair<float, uint32_t>> m_occluder_candidates; // Screen size metric & object index
+
+		SceneFile m_scene_file;
+		SceneDescription m_scene_description; // Generated scenario or a text scene, used when no binary scene is mapped
 		
 		CameraState m_camera;
 		XMMatrix m_projection_matrix;
+		Camera m_shader_camera;
+
+		// Frame commands are recorded first, then replayed by the graphics backend
+		CommandList m_command_list;
+
+		// Filled while recording, the upload is replayed ahead of the frame commands
+		ConstantBufferRing m_constant_buffer_ring;
+		CommandList m_upload_command_list;
+
+		// Draws for the null backend when a reference image is requested
+		std::unique_ptr<SoftwareRasterizer> m_software_rasterizer;
 
 		std::thread m_render_thread;
-		bool m_running = true;
+		std::atomic<bool> m_running = true;
 		bool m_paused = false;
-		EventDoubleBuffer m_event_buffer;
+
+		// The render thread sleeps here while paused, woken by new events, mailbox values & shutdown
+		ThreadParker m_render_thread_parker;
+		// Written on the main thread, handed over to the render thread through the ring in dispatch_events
+		EventQueue m_event_queue;
+		EventRing m_event_ring{ c_event_ring_capacity };
+
+		Mailbox<CameraMailboxData> m_camera_mailbox;
+		Mailbox<WindowSizeInfo> m_window_size_mailbox;
+		Mailbox<float> m_simulation_time_mailbox;
+
+		// Moved from read_mailboxes, before the next frame is prepared
+		std::vector<MovingLight> m_moving_lights;
+
+		// Signaled by the render thread, see RenderSystem::get_frame_fence
+		Fence m_frame_fence;
+
+		// Set when a new camera transform is applied, cleared once the frame using it is presented
+		bool m_camera_latency_pending = false;
+		std::chrono::steady_clock::time_point m_camera_write_time;
+		CameraLatencyStatistics m_camera_latency_statistics;
+
+		// Frame N is prepared (culling, light prep & draw list) on a job while frame N - (depth - 1) is recorded & presented on the render thread
+		// One snapshot per pipeline slot, a depth of one runs both stages back to back
+		FramePipeline m_frame_pipeline;
+		std::vector<FrameSnapshot> m_frames;
+		PipelineStatistics m_pipeline_statistics;
 
 		Internal(Application& application)
 			: m_application(application)
@@ -181,7 +354,18 @@ namespace ForwardPlusDemo
 
 		bool initialize()
 		{
-			if (!m_graphics_api.initialize())
+			const GraphicsBackend backend = m_application.is_headless() ? GraphicsBackend::NULL_DEVICE : GraphicsBackend::D3D11;
+			if (!m_graphics_api.initialize(backend))
+			{
+				return false;
+			}
+
+			if (!m_application.get_software_image_path().empty())
+			{
+				create_software_rasterizer();
+			}
+
+			if (!load_scene())
 			{
 				return false;
 			}
@@ -196,11 +380,16 @@ namespace ForwardPlusDemo
 				return false;
 			}
 
-			if (!m_light_system.initialize())
+			m_frame_pipeline.reset(m_application.get_pipeline_depth());
+			m_frames.resize(m_frame_pipeline.get_depth());
+
+			if (!m_light_system.initialize(get_scene_light_view(), m_frame_pipeline.get_depth()))
 			{
 				return false;
 			}
 
+			select_moving_lights();
+
 			// Start up render thread
 			m_render_thread = std::thread([this] { this->render_loop(); });
 
@@ -210,79 +399,410 @@ namespace ForwardPlusDemo
 		void shutdown()
 		{
 			m_running = false;
+			m_render_thread_parker.wake();
 			m_render_thread.join();
+
+			// Nothing is presented from here on, so nobody is left waiting on the fence
+			m_frame_fence.signal(UINT64_MAX);
+
+			log_camera_statistics();
+
+			if (m_application.is_headless())
+			{
+				log_draw_order_statistics();
+				log_event_ring_statistics();
+				log_pipeline_statistics();
+			}
+
+			if (m_software_rasterizer != nullptr)
+			{
+				write_software_images();
+			}
+		}
+
+		void create_software_rasterizer()
+		{
+			NullDevice* null_device = m_graphics_api.get_null_device();
+			if (null_device == nullptr)
+			{
+				return;
+			}
+
+			UINT width = 0;
+			UINT height = 0;
+			m_graphics_api.get_window_resolution(width, height);
+
+			m_software_rasterizer = std::make_unique<SoftwareRasterizer>(width, height, m_job_system);
+			m_software_rasterizer->set_vertex_format(m_application.get_vertex_format());
+			null_device->set_graphics_pipeline(m_software_rasterizer.get());
+		}
+
+		void write_software_images()
+		{
+			m_graphics_api.get_null_device()->set_graphics_pipeline(nullptr);
+
+			// Last rendered frame, plus the lights evaluated per pixel next to it
+			const std::filesystem::path image_path = m_application.get_software_image_path();
+			std::filesystem::path light_count_path = image_path;
+			light_count_path.replace_filename(image_path.stem().string() + "_lights.pgm");
+
+			if (!m_software_rasterizer->write_color_image(image_path) || !m_software_rasterizer->write_light_count_image(light_count_path))
+			{
+				OutputDebugStringA("Failed to write software rasterizer images\n");
+				return;
+			}
+
+			const SoftwareRasterizerStatistics& statistics = m_software_rasterizer->get_statistics();
+			const std::string summary = "Software rasterizer: " + std::to_string(statistics.triangle_count) + " triangles, "
+				+ std::to_string(statistics.shaded_pixel_count) + " pixels shaded, "
+				+ std::to_string(statistics.lights_evaluated) + " lights evaluated (max " + std::to_string(statistics.max_lights_per_pixel) + " per pixel)\n";
+			OutputDebugStringA(summary.c_str());
+
+			// Pixels passing the depth test in draw order over the visible ones, the pixel shader work an early Z GPU would do
+			if (statistics.shaded_pixel_count > 0)
+			{
+				char overdraw_summary[128];
+				std::snprintf(overdraw_summary, sizeof(overdraw_summary), "Software rasterizer: %llu depth test passes, overdraw estimate %.3f\n",
+					static_cast<unsigned long long>(statistics.depth_passed_pixel_count), static_cast<double>(statistics.depth_passed_pixel_count) / statistics.shaded_pixel_count);
+				OutputDebugStringA(overdraw_summary);
+			}
+		}
+
+		void log_camera_statistics() const
+		{
+			if (m_camera_latency_statistics.frame_count == 0)
+			{
+				return;
+			}
+
+			using Milliseconds = std::chrono::duration<double, std::milli>;
+			const double average_latency = Milliseconds(m_camera_latency_statistics.total_latency).count() / m_camera_latency_statistics.frame_count;
+			const double max_latency = Milliseconds(m_camera_latency_statistics.max_latency).count();
+
+			char summary[192];
+			std::snprintf(summary, sizeof(summary), "Camera: input to present latency %.3f ms average, %.3f ms max, %llu of %llu updates replaced before being drawn\n",
+				average_latency, max_latency, static_cast<unsigned long long>(m_camera_mailbox.get_write_count() - m_camera_mailbox.get_read_count()),
+				static_cast<unsigned long long>(m_camera_mailbox.get_write_count()));
+			OutputDebugStringA(summary);
+		}
+
+		void log_event_ring_statistics() const
+		{
+			char summary[160];
+			std::snprintf(summary, sizeof(summary), "Event ring: high water mark %u of %u bytes, full %llu times\n",
+				m_event_ring.get_high_water_mark(), m_event_ring.get_capacity(), static_cast<unsigned long long>(m_event_ring.get_full_count()));
+			OutputDebugStringA(summary);
+		}
+
+		void dispatch_events()
+		{
+			if (m_event_queue.is_empty())
+			{
+				return;
+			}
+
+			if (!m_event_ring.try_write(m_event_queue))
+			{
+				// The render thread can need the main thread to pump window messages (e.g fullscreen switches), so the events stay queued for the next dispatch
+				// Headless runs, or a queue that would stop fitting into the ring, wait for the render thread instead
+				const bool wait_for_render_thread = m_application.is_headless() || (m_event_queue.get_size() > (m_event_ring.get_capacity() / 4));
+				if (!wait_for_render_thread)
+				{
+					return;
+				}
+
+				// Written in pieces, a queue larger than the ring would never fit at once
+				// The render thread may be parked while paused, it only frees space once woken
+				EventQueue::Iterator event_it = m_event_queue.get_iterator();
+				while (!m_event_ring.try_write_partial(event_it))
+				{
+					m_render_thread_parker.wake();
+					m_event_ring.wait_for_space();
+				}
+			}
+
+			m_event_queue.clear();
+			m_render_thread_parker.wake();
+		}
+
+		void log_draw_order_statistics() const
+		{
+			if (m_draw_order_statistics.frame_count == 0)
+			{
+				return;
+			}
+
+			const double frame_count = static_cast<double>(m_draw_order_statistics.frame_count);
+
+			char summary[160];
+			std::snprintf(summary, sizeof(summary), "Draw order: %.2f batches and %.2f state changes per frame over %llu frames\n",
+				m_draw_order_statistics.batch_count / frame_count, m_draw_order_statistics.state_change_count / frame_count, static_cast<unsigned long long>(m_draw_order_statistics.frame_count));
+			OutputDebugStringA(summary);
+		}
+
+		void log_mesh_statistics() const
+		{
+			constexpr std::array<const char*, static_cast<size_t>(ObjectType::TYPE_COUNT)> c_mesh_names = { "Cube", "Pyramid", "Plane" };
+
+			for (size_t current_type_index = 0; current_type_index < m_object_info.size(); ++current_type_index)
+			{
+				const MeshRange& mesh = m_object_info[current_type_index];
+
+				char summary[256];
+				std::snprintf(summary, sizeof(summary), "%s mesh: %u triangles, %u vertices (%u before welding), ACMR %.3f -> %.3f\n",
+					c_mesh_names[current_type_index], mesh.index_count / 3, mesh.vertex_count, mesh.input_vertex_count, mesh.input_acmr, mesh.output_acmr);
+				OutputDebugStringA(summary);
+			}
+		}
+
+		void log_pipeline_statistics() const
+		{
+			if (m_pipeline_statistics.frame_count < 2)
+			{
+				return;
+			}
+
+			using Milliseconds = std::chrono::duration<double, std::milli>;
+			const double frame_count = static_cast<double>(m_pipeline_statistics.frame_count);
+			const double frame_time = Milliseconds(m_pipeline_statistics.last_frame_end - m_pipeline_statistics.first_frame_end).count() / (frame_count - 1.0);
+			const double prepare_time = Milliseconds(m_pipeline_statistics.total_prepare_time).count() / frame_count;
+			const double record_time = Milliseconds(m_pipeline_statistics.total_record_time).count() / frame_count;
+
+			// Throughput half of the report, the latency half is the camera line
+			char summary[192];
+			std::snprintf(summary, sizeof(summary), "Pipeline: depth %u, %llu frames, %.3f ms per frame (%.1f fps), prepare %.3f ms, record %.3f ms average\n",
+				m_frame_pipeline.get_depth(), static_cast<unsigned long long>(m_pipeline_statistics.frame_count), frame_time, (frame_time > 0.0) ? (1000.0 / frame_time) : 0.0,
+				prepare_time, record_time);
+			OutputDebugStringA(summary);
 		}
 
 		void render_loop()
 		{
+			auto run_prepare_frame = [](void* data, uint32_t frame_index)
+			{
+				static_cast<Internal*>(data)->prepare_frame(frame_index);
+			};
+
+			auto run_record_frame = [](void* data, uint32_t frame_index)
+			{
+				static_cast<Internal*>(data)->record_frame(frame_index);
+			};
+
+			FORWARDPLUSDEMO_PROFILE_THREAD_NAME("Render");
+
 			while (m_running == true)
 			{
+				// Taken before looking for work, so anything sent after this point wakes the thread from park() right away
+				const uint32_t park_token = m_render_thread_parker.get_token();
+
 				// Check for any new events from main thread
-				EventQueue* read_queue = m_event_buffer.get_read_queue();
-				if (read_queue != nullptr)
+				// Nothing is being prepared at this point, so the events & mailboxes can change anything the next prepared frame reads
 				{
-					EventQueue::Iterator event_it = read_queue->get_iterator();
-					while (event_it.is_valid() == true)
-					{
-						const RenderEventType event_type = static_cast<RenderEventType>(event_it.get_header().event_id);
-						switch (event_type)
-						{
-						case RenderEventType::UPDATE_CAMERA_TRANSFORM:
-							update_camera(*event_it.get_event<CameraTransformUpdate>());
-							break;
-						case RenderEventType::FENCE:
-							wait_fence(*event_it.get_event<Fence*>());
-							break;
-						case RenderEventType::PAUSE:
-							m_paused = *event_it.get_event<bool>();
-							break;
-						case RenderEventType::RESIZE_WINDOW:
-						{
-							const WindowSizeInfo* size_info = event_it.get_event<WindowSizeInfo>();
-							if (m_graphics_api.resize_window(size_info->width, size_info->height) == false)
-							{
-								assert(false);
-							}
-						}
-							break;
-						case RenderEventType::SET_WINDOW_FULLSCREEN_STATE:
-						{
-							if (m_graphics_api.set_fullscreen_state(*event_it.get_event<bool>()) == false)
-							{
-								assert(false);
-							}
-						}
-							break;
-						case RenderEventType::TOGGLE_LIGHT_DEBUG_RENDERING:
-							m_light_system.toggle_debug_rendering();
-							break;
-						}
-
-						event_it.advance();
-					}
+					FORWARDPLUSDEMO_PROFILE_SCOPE("RenderSystem::dispatch_events");
+
+					EventRing::Iterator event_it = m_event_ring.get_read_iterator();
+					RenderEvents::dispatch(event_it, *this);
 
-					m_event_buffer.finish_read();
+					m_event_ring.finish_read();
 				}
 
+				read_mailboxes();
+
 				if (m_paused)
 				{
-					// TODO: use atomic wait to pause/unpause?
-					std::this_thread::yield();
+					// Time spent paused isn't latency, and frames prepared before the pause would show a stale camera once it ends
+					m_camera_latency_pending = false;
+					m_frame_pipeline.drop_prepared_frames();
+					m_frame_fence.signal(m_frame_pipeline.get_recorded_frame_count());
+
+					// Nothing to do until the main thread sends something (unpausing included)
+					m_render_thread_parker.park(park_token);
 					continue;
 				}
 
-				// Start a new render frame
+				// Snapshot what the main thread sent for the frame about to be prepared
+				{
+					FrameSnapshot& frame = m_frames[m_frame_pipeline.get_prepare_slot()];
+					frame.shader_camera = m_shader_camera;
+					frame.camera_latency_pending = m_camera_latency_pending;
+					frame.camera_write_time = m_camera_write_time;
+
+					m_camera_latency_pending = false;
+				}
+
+				// Records the oldest prepared frame while this one is being prepared
+				m_frame_pipeline.run_frame(m_job_system, run_prepare_frame, run_record_frame, this);
+			}
+		}
+
+		// CPU side of a frame, runs on a job while the render thread records an older one
+		// Only touches the culling results, the light system's preparation state & its own snapshot
+		void prepare_frame(uint32_t frame_index)
+		{
+			FORWARDPLUSDEMO_PROFILE_SCOPE("RenderSystem::prepare_frame");
+
+			const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+			// Visible objects & the occlusion buffer are needed by both the light system and the scene
+			cull_objects();
+
+			// Visibility tests, sorting & packing of the lights
+			m_light_system.prepare_frame(frame_index);
+
+			// Sorted draws, along with the object light lists
+			build_draw_list(frame_index);
+
+			m_pipeline_statistics.total_prepare_time += std::chrono::steady_clock::now() - start_time;
+		}
+
+		// Records, replays & presents the oldest prepared frame
+		void record_frame(uint32_t frame_index)
+		{
+			FORWARDPLUSDEMO_PROFILE_SCOPE("RenderSystem::record_frame");
+
+			FrameSnapshot& frame = m_frames[frame_index];
+
+			const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+			// Start a new render frame
+			{
+				FORWARDPLUSDEMO_PROFILE_SCOPE("RenderSystem::begin_frame");
 				m_graphics_api.begin_frame();
+			}
 
-				// Update lighting system
-				m_light_system.update();
+			m_command_list.clear();
+			m_upload_command_list.clear();
+			m_constant_buffer_ring.begin_frame(m_graphics_api.get_completed_fence_value());
 
-				// Render scene contents
-				render_scene();
+			// Light uploads & culling dispatches
+			m_light_system.record_frame(frame_index, m_command_list);
 
-				// End render frame
+			// Render scene contents
+			render_scene(m_command_list, frame_index);
+
+			// Execute the recorded commands, after uploading the constants they use
+			m_constant_buffer_ring.end_frame(m_upload_command_list, m_graphics_api.get_frame_fence_value());
+			{
+				FORWARDPLUSDEMO_PROFILE_SCOPE("RenderSystem::replay_commands");
+				m_graphics_api.get_command_replayer().replay(m_upload_command_list);
+				m_graphics_api.get_command_replayer().replay(m_command_list);
+			}
+
+			// End render frame
+			{
+				FORWARDPLUSDEMO_PROFILE_SCOPE("RenderSystem::present");
 				m_graphics_api.end_frame();
 			}
+
+			const std::chrono::steady_clock::time_point end_time = std::chrono::steady_clock::now();
+
+			if (frame.camera_latency_pending)
+			{
+				const std::chrono::steady_clock::duration latency = end_time - frame.camera_write_time;
+
+				++m_camera_latency_statistics.frame_count;
+				m_camera_latency_statistics.total_latency += latency;
+				m_camera_latency_statistics.max_latency = std::max(m_camera_latency_statistics.max_latency, latency);
+
+				frame.camera_latency_pending = false;
+			}
+
+			if (m_pipeline_statistics.frame_count == 0)
+			{
+				m_pipeline_statistics.first_frame_end = end_time;
+			}
+
+			++m_pipeline_statistics.frame_count;
+			m_pipeline_statistics.last_frame_end = end_time;
+			m_pipeline_statistics.total_record_time += end_time - start_time;
+
+			// The pipeline counts this frame once it returns
+			m_frame_fence.signal(m_frame_pipeline.get_recorded_frame_count() + 1);
+		}
+
+		void handle_event(const PauseEvent& event)
+		{
+			m_paused = event.paused;
+		}
+
+		void handle_event(const SetFullscreenStateEvent& event)
+		{
+			if (m_graphics_api.set_fullscreen_state(event.fullscreen) == false)
+			{
+				assert(false);
+			}
+		}
+
+		void handle_event(const ToggleLightDebugRenderingEvent& /*event*/)
+		{
+			m_light_system.toggle_debug_rendering();
+		}
+
+		// Values written since the last read replace each other, so at most one resize & one camera update are applied per frame
+		void read_mailboxes()
+		{
+			WindowSizeInfo size_info;
+			if (m_window_size_mailbox.read(size_info))
+			{
+				if (m_graphics_api.resize_window(size_info.width, size_info.height) == false)
+				{
+					assert(false);
+				}
+			}
+
+			CameraMailboxData camera_data;
+			if (m_camera_mailbox.read(camera_data))
+			{
+				update_camera(camera_data.transform);
+
+				m_camera_write_time = camera_data.write_time;
+				m_camera_latency_pending = true;
+			}
+
+			float simulation_time;
+			if (m_simulation_time_mailbox.read(simulation_time))
+			{
+				move_lights(simulation_time);
+			}
+		}
+
+		// The first point & spot lights of the scene, directional lights have no position to move around
+		void select_moving_lights()
+		{
+			const SceneLightView light_view = get_scene_light_view();
+			const uint32_t moving_light_count = m_application.get_moving_light_count();
+
+			for (uint32_t current_light_index = 0; (current_light_index < light_view.count) && (m_moving_lights.size() < moving_light_count); ++current_light_index)
+			{
+				if (static_cast<LightType>(light_view.types[current_light_index]) == LightType::DIRECTIONAL)
+				{
+					continue;
+				}
+
+				const Vector3& rotation = light_view.rotations[current_light_index];
+				const Vector3& position = light_view.positions[current_light_index];
+
+				MovingLight moving_light;
+				moving_light.light_index = current_light_index;
+				moving_light.scene_transform = DirectX::XMMatrixRotationRollPitchYaw(rotation.x, rotation.y, rotation.z) * DirectX::XMMatrixTranslation(position.x, position.y, position.z);
+				moving_light.phase = static_cast<float>(m_moving_lights.size()) * 0.618f * DirectX::XM_2PI;
+
+				m_moving_lights.push_back(moving_light);
+			}
+		}
+
+		// Updates the light bounds & spatial hash incrementally, so only valid while no frame is being prepared
+		void move_lights(float simulation_time)
+		{
+			FORWARDPLUSDEMO_PROFILE_SCOPE("RenderSystem::move_lights");
+
+			for (const MovingLight& current_light : m_moving_lights)
+			{
+				const float angle = (simulation_time * c_moving_light_speed) + current_light.phase;
+				const XMMatrix offset = DirectX::XMMatrixTranslation(std::cos(angle) * c_moving_light_radius, 0.0f, std::sin(angle) * c_moving_light_radius);
+
+				m_light_system.set_light_transform(current_light.light_index, current_light.scene_transform * offset);
+			}
 		}
 
 		Vector2 get_z_near_far() const
@@ -296,6 +816,17 @@ namespace ForwardPlusDemo
 
 		bool create_shaders()
 		{
+			NullDevice* null_device = m_graphics_api.get_null_device();
+			if (null_device != nullptr)
+			{
+				// Nothing to compile, the software rasterizer (if any) runs its own port of Main.hlsl
+				m_handles.vertex_shader = null_device->create_object();
+				m_handles.input_layout = null_device->create_object();
+				m_handles.pixel_shader = null_device->create_object();
+
+				return true;
+			}
+
 			ID3D11Device* d3d_device = m_graphics_api.get_device();
 
 			// FIXME: revise paths, implement file lookup system so we don't hardcode source tree paths?
@@ -310,8 +841,11 @@ namespace ForwardPlusDemo
 #ifndef NDEBUG
 				compile_flags |= D3DCOMPILE_DEBUG;
 #endif				
+				const bool packed_vertices = (m_application.get_vertex_format() == VertexFormat::PACKED);
+				constexpr D3D_SHADER_MACRO c_packed_vertex_defines[] = { { "PACKED_VERTICES", "1" }, { nullptr, nullptr } };
+
 				D3DBlob vshader_blob;
-				if (FAILED(D3DCompileFromFile(c_shader_path, nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE, c_vshader_entrypoint, "vs_4_0", compile_flags, 0, vshader_blob.ReleaseAndGetAddressOf(), error_blob.ReleaseAndGetAddressOf())))
+				if (FAILED(D3DCompileFromFile(c_shader_path, packed_vertices ? c_packed_vertex_defines : nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE, c_vshader_entrypoint, "vs_4_0", compile_flags, 0, vshader_blob.ReleaseAndGetAddressOf(), error_blob.ReleaseAndGetAddressOf())))
 				{
 					if (error_blob)
 					{
@@ -338,7 +872,7 @@ namespace ForwardPlusDemo
 
 						position_desc.SemanticName = "POSITION";
 						position_desc.SemanticIndex = 0;
-						position_desc.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+						position_desc.Format = packed_vertices ? DXGI_FORMAT_R16G16B16A16_FLOAT : DXGI_FORMAT_R32G32B32A32_FLOAT;
 						position_desc.InputSlot = 0;
 						position_desc.AlignedByteOffset = 0;
 						position_desc.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
@@ -351,7 +885,8 @@ namespace ForwardPlusDemo
 
 						normal_desc.SemanticName = "NORMAL";
 						normal_desc.SemanticIndex = 0;
-						normal_desc.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+						// Octahedral encoding, decoded to a float3 in the vertex shader
+						normal_desc.Format = packed_vertices ? DXGI_FORMAT_R16G16_SNORM : DXGI_FORMAT_R32G32B32A32_FLOAT;
 						normal_desc.InputSlot = 0;
 						normal_desc.AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
 						normal_desc.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
@@ -389,25 +924,139 @@ namespace ForwardPlusDemo
 				}
 			}
 
+			m_handles.vertex_shader = m_shader.vertex_shader.Get();
+			m_handles.input_layout = m_shader.input_layout.Get();
+			m_handles.pixel_shader = m_shader.pixel_shader.Get();
+
 			return true;
 		}
 
+		bool load_scene()
+		{
+			const std::filesystem::path scene_path = m_application.get_scene_path();
+			if (scene_path.empty())
+			{
+				// No scene file, generate the requested scenario instead
+				generate_scenario(m_application.get_scenario_parameters(), m_scene_description);
+			}
+			else if (scene_path.extension() == ".txt")
+			{
+				// Text scenes are parsed into memory, the source directory may not be writable
+				if (!m_scene_description.load_text(scene_path))
+				{
+					return false;
+				}
+			}
+			else
+			{
+				return m_scene_file.open(scene_path);
+			}
+
+			// Optional conversion to the binary format, so later runs can map the scene instead
+			const std::string& scene_output_path = m_application.get_scene_output_path();
+			if (!scene_output_path.empty() && !m_scene_description.write_binary(scene_output_path))
+			{
+				return false;
+			}
+
+			return true;
+		}
+
+		SceneLightView get_scene_light_view() const
+		{
+			return m_scene_file.is_open() ? m_scene_file.get_light_view() : m_scene_description.get_light_view();
+		}
+
+		SceneObjectView get_scene_object_view() const
+		{
+			return m_scene_file.is_open() ? m_scene_file.get_object_view() : m_scene_description.get_object_view();
+		}
+
 		bool generate_objects()
 		{
-			std::vector<Vertex> vertices;
+			MeshBuilder<Vertex> mesh_builder;
+
+			init_cube_info(mesh_builder);
+			init_pyramid_info(mesh_builder);
+			init_plane_info(mesh_builder);
 
-			generate_cubes(vertices);
-			generate_pyramids(vertices);
-			generate_plane(vertices);
+			if (m_application.is_headless())
+			{
+				log_mesh_statistics();
+			}
+
+			const SceneObjectView scene_objects = get_scene_object_view();
+			if (scene_objects.count > 0)
+			{
+				add_scene_objects(scene_objects);
+			}
+			else
+			{
+				generate_cubes();
+				generate_pyramids();
+				generate_plane();
+			}
 
-			return create_buffers(vertices);
+			build_object_bvh();
+
+			return create_buffers(mesh_builder);
+		}
+
+		void build_object_bvh()
+		{
+			std::vector<DirectX::BoundingBox> object_bounds;
+			object_bounds.reserve(m_object_instances.size());
+
+			for (const ObjectInstanceInfo& current_object : m_object_instances)
+			{
+				object_bounds.push_back(current_object.bounding_volume);
+			}
+
+			m_object_bvh.build(object_bounds);
+		}
+
+		static DirectX::BoundingBox get_default_bounding_box(ObjectType type)
+		{
+			if (type == ObjectType::PLANE)
+			{
+				// Allow for tiny extent on Y axis so the collision detection doesn't freak out
+				return DirectX::BoundingBox(Vector3(0, 0, 0), Vector3(0.5f, 0.001f, 0.5f));
+			}
+
+			return DirectX::BoundingBox(Vector3(0, 0, 0), Vector3(0.5f, 0.5f, 0.5f));
 		}
 
-		void generate_cubes(std::vector<Vertex>& vertices)
+		void add_scene_objects(const SceneObjectView& scene_objects)
 		{
-			init_cube_info(vertices);
+			m_object_instances.reserve(m_object_instances.size() + scene_objects.count);
 
-			const DirectX::BoundingBox default_box(Vector3(0, 0, 0), Vector3(0.5f, 0.5f, 0.5f));
+			for (size_t current_object_index = 0; current_object_index < scene_objects.count; ++current_object_index)
+			{
+				const SceneObjectRecord& current_record = scene_objects.records[current_object_index];
+				if (current_record.type >= static_cast<uint32_t>(ObjectType::TYPE_COUNT))
+				{
+					// Unknown object type, skip
+					continue;
+				}
+
+				ObjectInstanceInfo instance_info;
+				instance_info.type = static_cast<ObjectType>(current_record.type);
+
+				instance_info.per_draw_data.model = DirectX::XMLoadFloat4x4(&current_record.model);
+				instance_info.per_draw_data.inv_model = DirectX::XMMatrixInverse(nullptr, instance_info.per_draw_data.model);
+
+				instance_info.per_draw_data.material.diffuse = current_record.diffuse;
+				instance_info.per_draw_data.material.ambient = current_record.ambient;
+
+				get_default_bounding_box(instance_info.type).Transform(instance_info.bounding_volume, instance_info.per_draw_data.model);
+
+				m_object_instances.push_back(instance_info);
+			}
+		}
+
+		void generate_cubes()
+		{
+			const DirectX::BoundingBox default_box = get_default_bounding_box(ObjectType::CUBE);
 
 			ObjectInstanceInfo cube_info;
 			cube_info.type = ObjectType::CUBE;
@@ -424,13 +1073,11 @@ namespace ForwardPlusDemo
 			m_object_instances.push_back(cube_info);
 		}
 
-		void init_cube_info(std::vector<Vertex>& vertices)
+		void init_cube_info(MeshBuilder<Vertex>& mesh_builder)
 		{
-			ObjectInfo& cube_info = m_object_info[static_cast<size_t>(ObjectType::CUBE)];
-						
-			cube_info.vertex_offset = static_cast<uint32_t>(vertices.size());
+			mesh_builder.begin_mesh();
 
-			auto generate_cube_face = [&vertices](const std::array<size_t, 4>& corners, const Vector3& normal)
+			auto generate_cube_face = [&mesh_builder](const std::array<size_t, 4>& corners, const Vector3& normal)
 			{
 				std::array<Vertex, 4> template_vertices;
 
@@ -446,13 +1093,7 @@ namespace ForwardPlusDemo
 					}
 				}
 
-				vertices.push_back(template_vertices[0]);
-				vertices.push_back(template_vertices[1]);
-				vertices.push_back(template_vertices[2]);
-
-				vertices.push_back(template_vertices[0]);
-				vertices.push_back(template_vertices[2]);
-				vertices.push_back(template_vertices[3]);
+				mesh_builder.add_quad(template_vertices[0], template_vertices[1], template_vertices[2], template_vertices[3]);
 			};
 
 			// Bottom
@@ -479,14 +1120,12 @@ namespace ForwardPlusDemo
 			corner_indices = { 5, 4, 7, 6 };
 			generate_cube_face(corner_indices, c_cube_normals[5]);
 
-			cube_info.vertex_count = static_cast<uint32_t>(vertices.size()) - cube_info.vertex_offset;
+			m_object_info[static_cast<size_t>(ObjectType::CUBE)] = mesh_builder.end_mesh();
 		}
 
-		void generate_pyramids(std::vector<Vertex>& vertices)
+		void generate_pyramids()
 		{
-			init_pyramid_info(vertices);
-
-			const DirectX::BoundingBox default_box(Vector3(0, 0, 0), Vector3(0.5f, 0.5f, 0.5f));
+			const DirectX::BoundingBox default_box = get_default_bounding_box(ObjectType::PYRAMID);
 
 			ObjectInstanceInfo pyramid_info;
 			pyramid_info.type = ObjectType::PYRAMID;
@@ -503,13 +1142,11 @@ namespace ForwardPlusDemo
 			m_object_instances.push_back(pyramid_info);
 		}
 
-		void init_pyramid_info(std::vector<Vertex>& vertices)
+		void init_pyramid_info(MeshBuilder<Vertex>& mesh_builder)
 		{
-			ObjectInfo& pyramid_info = m_object_info[static_cast<size_t>(ObjectType::PYRAMID)];
-			
-			pyramid_info.vertex_offset = static_cast<uint32_t>(vertices.size());
+			mesh_builder.begin_mesh();
 
-			auto generate_pyramid_face = [&vertices](const std::array<size_t, 3>& corners, const Vector3& normal)
+			auto generate_pyramid_face = [&mesh_builder](const std::array<size_t, 3>& corners, const Vector3& normal)
 			{
 				std::array<Vertex, 3> template_vertices;
 
@@ -525,9 +1162,7 @@ namespace ForwardPlusDemo
 					}
 				}
 
-				vertices.push_back(template_vertices[0]);
-				vertices.push_back(template_vertices[1]);
-				vertices.push_back(template_vertices[2]);
+				mesh_builder.add_triangle(template_vertices[0], template_vertices[1], template_vertices[2]);
 			};
 
 			// Create base
@@ -546,13 +1181,7 @@ namespace ForwardPlusDemo
 					}
 				}
 
-				vertices.push_back(template_vertices[0]);
-				vertices.push_back(template_vertices[1]);
-				vertices.push_back(template_vertices[2]);
-
-				vertices.push_back(template_vertices[0]);
-				vertices.push_back(template_vertices[2]);
-				vertices.push_back(template_vertices[3]);
+				mesh_builder.add_quad(template_vertices[0], template_vertices[1], template_vertices[2], template_vertices[3]);
 			}
 
 			// Right
@@ -571,51 +1200,44 @@ namespace ForwardPlusDemo
 			side_indices = { 3, 2, 4 };
 			generate_pyramid_face(side_indices, c_pyramid_normals[4]);
 
-			pyramid_info.vertex_count = static_cast<uint32_t>(vertices.size()) - pyramid_info.vertex_offset;
+			m_object_info[static_cast<size_t>(ObjectType::PYRAMID)] = mesh_builder.end_mesh();
 		}
 
-		void generate_plane(std::vector<Vertex>& vertices)
+		void init_plane_info(MeshBuilder<Vertex>& mesh_builder)
 		{
-			// Allow for tiny extent on Y axis so the collision detection doesn't freak out
-			const DirectX::BoundingBox default_box(Vector3(0, 0, 0), Vector3(0.5f, 0.001f, 0.5f));
-
-			{
-				ObjectInfo& plane_info = m_object_info[static_cast<size_t>(ObjectType::PLANE)];
-
-				plane_info.vertex_offset = static_cast<uint32_t>(vertices.size());
+			mesh_builder.begin_mesh();
 
-				constexpr size_t c_plane_resolution = 32;
-				constexpr float c_plane_step = 1.0f / c_plane_resolution;
+			constexpr size_t c_plane_resolution = 32;
+			constexpr float c_plane_step = 1.0f / c_plane_resolution;
 
-				float z_offset = 0.5f;
-				for (size_t current_z = 0; current_z < c_plane_resolution; ++current_z)
+			float z_offset = 0.5f;
+			for (size_t current_z = 0; current_z < c_plane_resolution; ++current_z)
+			{
+				float x_offset = -0.5f;
+				for (size_t current_x = 0; current_x < c_plane_resolution; ++current_x)
 				{
-					float x_offset = -0.5f;
-					for (size_t current_x = 0; current_x < c_plane_resolution; ++current_x)
-					{
-						const Vector4 top_left(x_offset, 0.0f, z_offset, 1.0f);
-						const Vector4 top_right(x_offset + c_plane_step, 0.0f, z_offset, 1.0f);
-						const Vector4 bottom_left(x_offset, 0.0f, z_offset - c_plane_step, 1.0f);
-						const Vector4 bottom_right(x_offset + c_plane_step, 0.0f, z_offset - c_plane_step, 1.0f);
+					const Vector4 top_left(x_offset, 0.0f, z_offset, 1.0f);
+					const Vector4 top_right(x_offset + c_plane_step, 0.0f, z_offset, 1.0f);
+					const Vector4 bottom_left(x_offset, 0.0f, z_offset - c_plane_step, 1.0f);
+					const Vector4 bottom_right(x_offset + c_plane_step, 0.0f, z_offset - c_plane_step, 1.0f);
 
-						const Vector4 normal(0.0f, 1.0f, 0.0f, 0.0f);
+					const Vector4 normal(0.0f, 1.0f, 0.0f, 0.0f);
 
-						vertices.push_back(Vertex{ top_left, normal });
-						vertices.push_back(Vertex{ top_right, normal });
-						vertices.push_back(Vertex{ bottom_left, normal });
+					mesh_builder.add_triangle(Vertex{ top_left, normal }, Vertex{ top_right, normal }, Vertex{ bottom_left, normal });
+					mesh_builder.add_triangle(Vertex{ top_right, normal }, Vertex{ bottom_right, normal }, Vertex{ bottom_left, normal });
 
-						vertices.push_back(Vertex{ top_right, normal });
-						vertices.push_back(Vertex{ bottom_right, normal });
-						vertices.push_back(Vertex{ bottom_left, normal });
-
-						x_offset += c_plane_step;
-					}
-					z_offset -= c_plane_step;
+					x_offset += c_plane_step;
 				}
-
-				plane_info.vertex_count = static_cast<uint32_t>(vertices.size()) - plane_info.vertex_offset;
+				z_offset -= c_plane_step;
 			}
 
+			m_object_info[static_cast<size_t>(ObjectType::PLANE)] = mesh_builder.end_mesh();
+		}
+
+		void generate_plane()
+		{
+			const DirectX::BoundingBox default_box = get_default_bounding_box(ObjectType::PLANE);
+
 			ObjectInstanceInfo plane_instance_info;
 			plane_instance_info.type = ObjectType::PLANE;
 
@@ -631,8 +1253,73 @@ namespace ForwardPlusDemo
 			m_object_instances.push_back(plane_instance_info);
 		}
 
-		bool create_buffers(const std::vector<Vertex>& vertices)
+		// Vertex buffer contents in the format selected on the command line
+		std::vector<uint8_t> get_vertex_data(const std::vector<Vertex>& vertices)
+		{
+			std::vector<uint8_t> vertex_data;
+
+			if (m_application.get_vertex_format() == VertexFormat::FULL)
+			{
+				m_vertex_stride = sizeof(Vertex);
+
+				vertex_data.resize(vertices.size() * sizeof(Vertex));
+				std::memcpy(vertex_data.data(), vertices.data(), vertex_data.size());
+
+				return vertex_data;
+			}
+
+			m_vertex_stride = sizeof(PackedVertex);
+
+			vertex_data.resize(vertices.size() * sizeof(PackedVertex));
+			PackedVertex* packed_vertices = reinterpret_cast<PackedVertex*>(vertex_data.data());
+			pack_vertices(&vertices[0].position, &vertices[0].normal, sizeof(Vertex), vertices.size(), packed_vertices);
+
+			if (m_application.is_headless())
+			{
+				const VertexPackingError error = get_vertex_packing_error(&vertices[0].position, &vertices[0].normal, sizeof(Vertex), vertices.size(), packed_vertices);
+
+				char summary[256];
+				std::snprintf(summary, sizeof(summary), "Packed vertices: %zu bytes per vertex (was %zu), max position error %g, max normal error %.4f degrees\n",
+					sizeof(PackedVertex), sizeof(Vertex), error.position, error.normal_degrees);
+				OutputDebugStringA(summary);
+			}
+
+			return vertex_data;
+		}
+
+		bool create_buffers(const MeshBuilder<Vertex>& mesh_builder)
 		{
+			const std::vector<uint8_t> vertex_data = get_vertex_data(mesh_builder.get_vertices());
+			const std::vector<uint8_t> index_data = mesh_builder.get_index_data();
+			m_index_format = mesh_builder.get_index_format();
+
+			// Prepare projection matrix
+			{
+				UINT width, height;
+				m_graphics_api.get_window_resolution(width, height);
+
+				const Vector2 z_near_far = get_z_near_far();
+				constexpr float c_fov_y = DirectX::XMConvertToRadians(70.0f);
+				m_projection_matrix = get_perspective_matrix(c_fov_y, static_cast<float>(width), static_cast<float>(height), z_near_far.x, z_near_far.y);
+			}
+
+			if (!m_constant_buffer_ring.initialize(m_graphics_api, c_constant_buffer_ring_capacity))
+			{
+				return false;
+			}
+
+			NullDevice* null_device = m_graphics_api.get_null_device();
+			if (null_device != nullptr)
+			{
+				const Camera init_camera;
+
+				m_handles.vertex_buffer = null_device->create_buffer(static_cast<uint32_t>(vertex_data.size()), vertex_data.data());
+				m_handles.index_buffer = null_device->create_buffer(static_cast<uint32_t>(index_data.size()), index_data.data());
+				m_handles.camera_buffer = null_device->create_buffer(sizeof(Camera), &init_camera);
+
+				return create_instance_buffer(c_initial_instance_capacity);
+			}
+
 			ID3D11Device* d3d_device = m_graphics_api.get_device();
 
 			// Create vertex buffer
@@ -640,14 +1327,14 @@ namespace ForwardPlusDemo
 				D3D11_BUFFER_DESC buffer_description;
 				ZeroMemory(&buffer_description, sizeof(D3D11_BUFFER_DESC));
 
-				buffer_description.ByteWidth = static_cast<uint32_t>(vertices.size() * sizeof(Vertex));
+				buffer_description.ByteWidth = static_cast<uint32_t>(vertex_data.size());
 				buffer_description.Usage = D3D11_USAGE_DEFAULT;
 				buffer_description.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 				buffer_description.MiscFlags = 0;
 
 				D3D11_SUBRESOURCE_DATA subresource_data;
 				ZeroMemory(&subresource_data, sizeof(D3D11_SUBRESOURCE_DATA));
-				subresource_data.pSysMem = vertices.data();
+				subresource_data.pSysMem = vertex_data.data();
 
 				HRESULT result = d3d_device->CreateBuffer(&buffer_description, &subresource_data, m_vertex_buffer.ReleaseAndGetAddressOf());
 				if (FAILED(result))
@@ -657,49 +1344,35 @@ namespace ForwardPlusDemo
 				}
 			}
 
-			// Create camera cbuffer
+			// Create index buffer
 			{
-				// Prepare projection matrix
-				{
-					UINT width, height;
-					m_graphics_api.get_window_resolution(width, height);
-
-					const Vector2 z_near_far = get_z_near_far();
-					constexpr float c_fov_y = DirectX::XMConvertToRadians(70.0f);
-					m_projection_matrix = get_perspective_matrix(c_fov_y, static_cast<float>(width), static_cast<float>(height), z_near_far.x, z_near_far.y);
-				}
-
-				Camera init_camera;
-
 				D3D11_BUFFER_DESC buffer_description;
 				ZeroMemory(&buffer_description, sizeof(D3D11_BUFFER_DESC));
 
-				buffer_description.ByteWidth = sizeof(Camera);
-				buffer_description.Usage = D3D11_USAGE_DYNAMIC;
-				buffer_description.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+				buffer_description.ByteWidth = static_cast<uint32_t>(index_data.size());
+				buffer_description.Usage = D3D11_USAGE_IMMUTABLE;
+				buffer_description.BindFlags = D3D11_BIND_INDEX_BUFFER;
 				buffer_description.MiscFlags = 0;
-				buffer_description.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
 
 				D3D11_SUBRESOURCE_DATA subresource_data;
 				ZeroMemory(&subresource_data, sizeof(D3D11_SUBRESOURCE_DATA));
-				subresource_data.pSysMem = &init_camera;
+				subresource_data.pSysMem = index_data.data();
 
-				HRESULT result = d3d_device->CreateBuffer(&buffer_description, &subresource_data, m_camera_buffer.ReleaseAndGetAddressOf());
+				HRESULT result = d3d_device->CreateBuffer(&buffer_description, &subresource_data, m_index_buffer.ReleaseAndGetAddressOf());
 				if (FAILED(result))
 				{
-					// TODO: error handling?
 					return false;
 				}
 			}
 
-			// Create per-draw cbuffer
+			// Create camera cbuffer
 			{
-				PerDrawData init_data;
+				Camera init_camera;
 
 				D3D11_BUFFER_DESC buffer_description;
 				ZeroMemory(&buffer_description, sizeof(D3D11_BUFFER_DESC));
 
-				buffer_description.ByteWidth = sizeof(PerDrawData);
+				buffer_description.ByteWidth = sizeof(Camera);
 				buffer_description.Usage = D3D11_USAGE_DYNAMIC;
 				buffer_description.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
 				buffer_description.MiscFlags = 0;
@@ -707,9 +1380,9 @@ namespace ForwardPlusDemo
 
 				D3D11_SUBRESOURCE_DATA subresource_data;
 				ZeroMemory(&subresource_data, sizeof(D3D11_SUBRESOURCE_DATA));
-				subresource_data.pSysMem = &init_data;
+				subresource_data.pSysMem = &init_camera;
 
-				HRESULT result = d3d_device->CreateBuffer(&buffer_description, &subresource_data, m_per_draw_cbuffer.ReleaseAndGetAddressOf());
+				HRESULT result = d3d_device->CreateBuffer(&buffer_description, &subresource_data, m_camera_buffer.ReleaseAndGetAddressOf());
 				if (FAILED(result))
 				{
 					// TODO: error handling?
@@ -717,6 +1390,62 @@ namespace ForwardPlusDemo
 				}
 			}
 
+			m_handles.vertex_buffer = m_vertex_buffer.Get();
+			m_handles.index_buffer = m_index_buffer.Get();
+			m_handles.camera_buffer = m_camera_buffer.Get();
+
+			return create_instance_buffer(c_initial_instance_capacity);
+		}
+
+		bool create_instance_buffer(uint32_t capacity)
+		{
+			NullDevice* null_device = m_graphics_api.get_null_device();
+			if (null_device != nullptr)
+			{
+				null_device->release(m_handles.instance_buffer);
+
+				// Views alias their buffer on the null device
+				m_handles.instance_buffer = null_device->create_buffer(capacity * sizeof(PerDrawData));
+				m_handles.instance_buffer_srv = m_handles.instance_buffer;
+				m_instance_capacity = capacity;
+
+				return true;
+			}
+
+			ID3D11Device* d3d_device = m_graphics_api.get_device();
+
+			D3D11_BUFFER_DESC buffer_description;
+			ZeroMemory(&buffer_description, sizeof(D3D11_BUFFER_DESC));
+
+			buffer_description.ByteWidth = capacity * sizeof(PerDrawData);
+			buffer_description.Usage = D3D11_USAGE_DYNAMIC;
+			buffer_description.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+			buffer_description.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+			buffer_description.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+			buffer_description.StructureByteStride = sizeof(PerDrawData);
+
+			if (FAILED(d3d_device->CreateBuffer(&buffer_description, nullptr, m_instance_buffer.ReleaseAndGetAddressOf())))
+			{
+				return false;
+			}
+
+			D3D11_SHADER_RESOURCE_VIEW_DESC srv_description;
+			ZeroMemory(&srv_description, sizeof(D3D11_SHADER_RESOURCE_VIEW_DESC));
+
+			srv_description.Format = DXGI_FORMAT_UNKNOWN;
+			srv_description.ViewDimension = D3D11_SRV_DIMENSION_BUFFEREX;
+			srv_description.BufferEx.FirstElement = 0;
+			srv_description.BufferEx.NumElements = capacity;
+
+			if (FAILED(d3d_device->CreateShaderResourceView(m_instance_buffer.Get(), &srv_description, m_instance_buffer_srv.ReleaseAndGetAddressOf())))
+			{
+				return false;
+			}
+
+			m_handles.instance_buffer = m_instance_buffer.Get();
+			m_handles.instance_buffer_srv = m_instance_buffer_srv.Get();
+			m_instance_capacity = capacity;
+
 			return true;
 		}
 
@@ -724,93 +1453,220 @@ namespace ForwardPlusDemo
 		{
 			m_camera.update_transform(transform_update);
 
-			Camera shader_camera;
-			shader_camera.world_position = m_camera.position;
+			m_shader_camera.world_position = m_camera.position;
 
-			shader_camera.view = m_camera.view;
-			shader_camera.view_projection = shader_camera.view * m_projection_matrix;
+			m_shader_camera.view = m_camera.view;
+			m_shader_camera.view_projection = m_shader_camera.view * m_projection_matrix;
 
-			D3D11_MAPPED_SUBRESOURCE mapped_subresource;
-			ZeroMemory(&mapped_subresource, sizeof(D3D11_MAPPED_SUBRESOURCE));
+			// Copied into the snapshot of the next prepared frame
+		}
+
+		void cull_objects()
+		{
+			FORWARDPLUSDEMO_PROFILE_SCOPE("RenderSystem::cull_objects");
 
-			ID3D11DeviceContext* device_context = m_graphics_api.get_device_context();
-			const HRESULT result = device_context->Map(m_camera_buffer.Get(), 0, D3D11_MAP::D3D11_MAP_WRITE_DISCARD, 0, &mapped_subresource);
-			if (SUCCEEDED(result))
+			// Create camera frustum (from projection matrix)
+			DirectX::BoundingFrustum bounding_frustum(m_projection_matrix);
 			{
-				memcpy(mapped_subresource.pData, &shader_camera, sizeof(Camera));
+				const XMVector camera_rotation = DirectX::XMQuaternionRotationRollPitchYaw(m_camera.rotation.x, m_camera.rotation.y, 0.0f);
+				bounding_frustum.Transform(bounding_frustum, 1.0f, camera_rotation, m_camera.position);
+			}
+
+			m_object_bvh.cull(bounding_frustum, m_visible_objects, &m_job_system);
+
+			render_occluders();
+
+			// Occluders pass too, their farthest depth is behind their own front faces
+			const uint32_t visible_count = static_cast<uint32_t>(m_visible_objects.size());
+			m_object_occluded.resize(visible_count);
+			m_job_system.parallel_for(visible_count, c_min_object_job_size, [this](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t visible_index = begin; visible_index < end; ++visible_index)
+				{
+					m_object_occluded[visible_index] = m_occlusion_culler.is_occluded(m_object_instances[m_visible_objects[visible_index]].bounding_volume);
+				}
+			});
+
+			uint32_t kept_count = 0;
+			for (uint32_t visible_index = 0; visible_index < visible_count; ++visible_index)
+			{
+				if (!m_object_occluded[visible_index])
+				{
+					m_visible_objects[kept_count++] = m_visible_objects[visible_index];
+				}
 			}
 
-			device_context->Unmap(m_camera_buffer.Get(), 0);
+			m_visible_objects.resize(kept_count);
 		}
 
-		void wait_fence(Fence* fence)
+		void render_occluders()
 		{
-			fence->signal(static_cast<uint64_t>(FenceState::WAIT_MAIN));
-			fence->wait_until(static_cast<uint64_t>(FenceState::DONE));
+			FORWARDPLUSDEMO_PROFILE_SCOPE("RenderSystem::render_occluders");
+
+			m_occlusion_culler.begin(m_shader_camera.view_projection);
+
+			// Projected size is roughly proportional to radius over distance, so compare the squares of that
+			m_occluder_candidates.clear();
+			for (const uint32_t current_object_index : m_visible_objects)
+			{
+				const ObjectInstanceInfo& current_object = m_object_instances[current_object_index];
+				if (current_object.type == ObjectType::PYRAMID)
+				{
+					// Doesn't fill its bounding box, would need its own shape
+					continue;
+				}
+
+				const XMVector center = DirectX::XMLoadFloat3(&current_object.bounding_volume.Center);
+				const float radius_squared = DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(DirectX::XMLoadFloat3(&current_object.bounding_volume.Extents)));
+				const float distance_squared = DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(center - m_camera.position));
+
+				m_occluder_candidates.emplace_back(radius_squared / std::max(distance_squared, 0.01f), current_object_index);
+			}
+
+			const size_t occluder_count = std::min(m_occluder_candidates.size(), c_max_occluder_count);
+			std::partial_sort(m_occluder_candidates.begin(), m_occluder_candidates.begin() + occluder_count, m_occluder_candidates.end(), std::greater<>());
+
+			for (size_t occluder_index = 0; occluder_index < occluder_count; ++occluder_index)
+			{
+				const ObjectInstanceInfo& current_object = m_object_instances[m_occluder_candidates[occluder_index].second];
+
+				// Planes are the unit box flattened to Y = 0
+				const XMMatrix& model = current_object.per_draw_data.model;
+				m_occlusion_culler.add_box_occluder((current_object.type == ObjectType::PLANE) ? DirectX::XMMatrixScaling(1.0f, 0.0f, 1.0f) * model : model);
+			}
+
+			m_occlusion_culler.finish();
 		}
 
-		void render_scene()
+		// Sorted instances & batches of the frame being prepared, along with the object light lists when those are used
+		void build_draw_list(uint32_t frame_index)
 		{
-			ID3D11DeviceContext* device_context = m_graphics_api.get_device_context();
+			FORWARDPLUSDEMO_PROFILE_SCOPE("RenderSystem::build_draw_list");
 
-			// Set primitive topology
-			device_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			DrawListBuilder<PerDrawData>& draw_list = m_frames[frame_index].draw_list;
+
+			const bool use_object_light_lists = m_light_system.is_using_object_light_lists(frame_index);
+
+			draw_list.begin();
+
+			const uint32_t visible_count = static_cast<uint32_t>(m_visible_objects.size());
+			const uint32_t first_instance = draw_list.add_instances(visible_count);
 
-			// Set shaders and constant buffers
+			auto add_draws = [this, &draw_list, frame_index, use_object_light_lists, first_instance](uint32_t begin, uint32_t end)
 			{
-				ID3D11Buffer* constant_buffers[] = {
-					m_camera_buffer.Get(),
-					m_per_draw_cbuffer.Get()
-				};
+				for (uint32_t visible_index = begin; visible_index < end; ++visible_index)
+				{
+					const ObjectInstanceInfo& current_object = m_object_instances[m_visible_objects[visible_index]];
+
+					PerDrawData per_draw_data = current_object.per_draw_data;
+					if (use_object_light_lists)
+					{
+						per_draw_data.light_list = m_light_system.add_object_light_list(frame_index, current_object.bounding_volume);
+					}
 
-				device_context->VSSetShader(m_shader.vertex_shader.Get(), nullptr, 0);
-				device_context->IASetInputLayout(m_shader.input_layout.Get());
-				device_context->VSSetConstantBuffers(1, ARRAYSIZE(constant_buffers), constant_buffers);
+					// Sorted front to back by bounding box center, pixel shading is the expensive part (every pixel loops over light batches)
+					const XMVector center = DirectX::XMLoadFloat3(&current_object.bounding_volume.Center);
+					const float view_depth = DirectX::XMVectorGetX(DirectX::XMVector3Dot(center - m_camera.position, m_camera.forward));
 
-				device_context->PSSetShader(m_shader.pixel_shader.Get(), nullptr, 0);
-				device_context->PSSetConstantBuffers(1, ARRAYSIZE(constant_buffers), constant_buffers);
+					draw_list.set_instance(first_instance + visible_index, current_object.type, view_depth, per_draw_data);
+				}
+			};
+
+			// Object light lists are appended to one shared buffer, so those stay on this thread
+			if (use_object_light_lists)
+			{
+				add_draws(0, visible_count);
 			}
+			else
+			{
+				m_job_system.parallel_for(visible_count, c_min_object_job_size, add_draws);
+			}
+
+			draw_list.build();
 
-			// Set vertex buffer
+			++m_draw_order_statistics.frame_count;
+			m_draw_order_statistics.batch_count += draw_list.get_batches().size();
+			m_draw_order_statistics.state_change_count += draw_list.get_state_change_count();
+		}
+
+		void render_scene(CommandList& command_list, uint32_t frame_index)
+		{
+			FORWARDPLUSDEMO_PROFILE_SCOPE("RenderSystem::render_scene");
+
+			const FrameSnapshot& frame = m_frames[frame_index];
+
+			// Frames in flight can have different cameras, so it is uploaded every time
+			command_list.update_buffer(m_handles.camera_buffer, &frame.shader_camera, sizeof(Camera));
+
+			// Set primitive topology
+			command_list.set_primitive_topology(PrimitiveTopology::TRIANGLE_LIST);
+
+			// Set shaders and the camera, the draw batch constants are bound per draw
 			{
-				constexpr UINT c_vertex_stride = sizeof(Vertex);
-				constexpr UINT c_null_offset = 0;
-				device_context->IASetVertexBuffers(0, 1, m_vertex_buffer.GetAddressOf(), &c_vertex_stride, &c_null_offset);
+				command_list.set_shader(ShaderStage::VERTEX, m_handles.vertex_shader);
+				command_list.set_input_layout(m_handles.input_layout);
+				command_list.set_constant_buffers(ShaderStage::VERTEX, 1, 1, &m_handles.camera_buffer);
+
+				command_list.set_shader(ShaderStage::PIXEL, m_handles.pixel_shader);
+				command_list.set_constant_buffers(ShaderStage::PIXEL, 1, 1, &m_handles.camera_buffer);
 			}
 
-			// Create camera frustum (from projection matrix)
-			DirectX::BoundingFrustum bounding_frustum(m_projection_matrix);
+			// Set vertex & index buffers
+			command_list.set_vertex_buffer(0, m_handles.vertex_buffer, m_vertex_stride, 0);
+			command_list.set_index_buffer(m_handles.index_buffer, m_index_format, 0);
+
+			// Light lists and instance data have to be uploaded before any draws
+			if (m_light_system.is_using_object_light_lists(frame_index))
 			{
-				const XMVector camera_rotation = DirectX::XMQuaternionRotationRollPitchYaw(m_camera.rotation.x, m_camera.rotation.y, 0.0f);
-				bounding_frustum.Transform(bounding_frustum, 1.0f, camera_rotation, m_camera.position);
+				m_light_system.upload_object_light_lists(frame_index, command_list);
 			}
 
-			// FIXME: optimize via instancing?
-			for (const ObjectInstanceInfo& current_object : m_object_instances)
+			const std::vector<PerDrawData>& instances = frame.draw_list.get_instances();
+			if (instances.empty())
 			{
-				if (bounding_frustum.Intersects(current_object.bounding_volume) == false)
+				return;
+			}
+
+			// Upload all instances at once
+			if (instances.size() > m_instance_capacity)
+			{
+				uint32_t new_capacity = m_instance_capacity;
+				while (new_capacity < instances.size())
 				{
-					// Object not visible, skip
-					continue;
+					new_capacity *= 2;
 				}
 
-				// Update per-draw const buffer
+				if (!create_instance_buffer(new_capacity))
 				{
-					D3D11_MAPPED_SUBRESOURCE mapped_subresource;
-					ZeroMemory(&mapped_subresource, sizeof(D3D11_MAPPED_SUBRESOURCE));
+					assert(false);
+					return;
+				}
+			}
 
-					const HRESULT result = device_context->Map(m_per_draw_cbuffer.Get(), 0, D3D11_MAP::D3D11_MAP_WRITE_DISCARD, 0, &mapped_subresource);
-					if (SUCCEEDED(result))
-					{
-						memcpy(mapped_subresource.pData, &current_object.per_draw_data, sizeof(PerDrawData));
-					}
+			command_list.update_buffer(m_handles.instance_buffer, instances.data(), static_cast<uint32_t>(sizeof(PerDrawData) * instances.size()));
 
-					device_context->Unmap(m_per_draw_cbuffer.Get(), 0);
+			const CommandHandle instance_buffer_srv = m_handles.instance_buffer_srv;
+			command_list.set_shader_resources(ShaderStage::VERTEX, 5, 1, &instance_buffer_srv);
+			command_list.set_shader_resources(ShaderStage::PIXEL, 5, 1, &instance_buffer_srv);
+
+			// One instanced draw per object type
+			for (const DrawBatch& current_batch : frame.draw_list.get_batches())
+			{
+				// Only the vertex shader reads the draw batch constants
+				DrawBatchData batch_data;
+				batch_data.first_instance = current_batch.first_instance;
+
+				ConstantBufferRange batch_range;
+				if (!m_constant_buffer_ring.allocate(batch_data, batch_range))
+				{
+					assert(false);
+					return;
 				}
 
-				// Add draw call at the relevant offset
-				const ObjectInfo& object_info = m_object_info[static_cast<size_t>(current_object.type)];
-				device_context->Draw(object_info.vertex_count, object_info.vertex_offset);
+				batch_range.bind(command_list, ShaderStage::VERTEX, 2);
+
+				const MeshRange& mesh = m_object_info[static_cast<size_t>(current_batch.type)];
+				command_list.draw_indexed_instanced(mesh.index_count, current_batch.instance_count, mesh.first_index, static_cast<int32_t>(mesh.base_vertex), 0);
 			}
 		}
 	};
@@ -822,46 +1678,60 @@ namespace ForwardPlusDemo
 		return m_internal->m_graphics_api;
 	}
 
+	LightSystem& RenderSystem::get_light_system()
+	{
+		return m_internal->m_light_system;
+	}
+
+	ConstantBufferRing& RenderSystem::get_constant_buffer_ring()
+	{
+		return m_internal->m_constant_buffer_ring;
+	}
+
+	JobSystem& RenderSystem::get_job_system()
+	{
+		return m_internal->m_job_system;
+	}
+
 	void RenderSystem::dispatch_events()
 	{
-		m_internal->m_event_buffer.dispatch_write();
+		m_internal->dispatch_events();
 	}
 
 	void RenderSystem::update_camera_transform(const CameraTransformUpdate& transform_update)
 	{
-		EventQueue* write_queue = m_internal->m_event_buffer.get_write_queue();
-		write_queue->write_event(static_cast<uint32_t>(RenderEventType::UPDATE_CAMERA_TRANSFORM), transform_update);
+		m_internal->m_camera_mailbox.write(CameraMailboxData{ transform_update, std::chrono::steady_clock::now() });
+		m_internal->m_render_thread_parker.wake();
+	}
+
+	void RenderSystem::update_simulation_time(float simulation_time)
+	{
+		// Read along with the camera transform, which wakes the render thread
+		m_internal->m_simulation_time_mailbox.write(simulation_time);
 	}
 
 	void RenderSystem::toggle_light_debug_rendering()
 	{
-		EventQueue* write_queue = m_internal->m_event_buffer.get_write_queue();
-		write_queue->write_event(static_cast<uint32_t>(RenderEventType::TOGGLE_LIGHT_DEBUG_RENDERING), 0);
+		RenderEvents::write_event(m_internal->m_event_queue, ToggleLightDebugRenderingEvent());
 	}
 
 	void RenderSystem::set_paused(bool paused)
 	{
-		EventQueue* write_queue = m_internal->m_event_buffer.get_write_queue();
-		write_queue->write_event(static_cast<uint32_t>(RenderEventType::PAUSE), paused);
+		RenderEvents::write_event(m_internal->m_event_queue, PauseEvent{ paused });
 	}
 
 	void RenderSystem::resize_window(uint32_t width, uint32_t height)
 	{
-		EventQueue* write_queue = m_internal->m_event_buffer.get_write_queue();
 		WindowSizeInfo size_info;
 		size_info.width = width;
 		size_info.height = height;
-		write_queue->write_event(static_cast<uint32_t>(RenderEventType::RESIZE_WINDOW), size_info);
+		m_internal->m_window_size_mailbox.write(size_info);
+		m_internal->m_render_thread_parker.wake();
 	}
 
-	Fence* RenderSystem::create_fence()
+	Fence& RenderSystem::get_frame_fence()
 	{
-		Fence* fence = new Fence(static_cast<uint64_t>(FenceState::WAIT_RENDERER));
-
-		EventQueue* write_queue = m_internal->m_event_buffer.get_write_queue();
-		write_queue->write_event(static_cast<uint32_t>(RenderEventType::FENCE), fence);
-
-		return fence;
+		return m_internal->m_frame_fence;
 	}
 
 	CameraInfo RenderSystem::get_camera_info() const
@@ -879,6 +1749,11 @@ namespace ForwardPlusDemo
 		return m_internal->m_projection_matrix;
 	}
 
+	bool RenderSystem::is_occluded(const DirectX::BoundingSphere& bounds) const
+	{
+		return m_internal->m_occlusion_culler.is_occluded(bounds);
+	}
+
 	RenderSystem::RenderSystem(Application& application)
 		: m_internal(std::make_unique<Internal>(application))
 	{
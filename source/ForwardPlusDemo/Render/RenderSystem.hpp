@@ -2,8 +2,21 @@
 #define FORWARDPLUSDEMO_RENDER_RENDERSYSTEM_HPP
 #include <ForwardPlusDemo/Render/Math.hpp>
 #include <memory>
+namespace DirectX
+{
+	struct BoundingSphere;
+}
+
 namespace ForwardPlusDemo
 {
+	enum class ObjectType
+	{
+		CUBE,
+		PYRAMID,
+		PLANE,
+		TYPE_COUNT
+	};
+
 	struct CameraInfo
 	{
 		XMVector position;
@@ -19,35 +32,45 @@ namespace ForwardPlusDemo
 	};
 
 	class Application;
+	class ConstantBufferRing;
 	class Fence;
 	class GraphicsAPI;
+	class JobSystem;
+	class LightSystem;
 
 	class RenderSystem
 	{
 	public:
-		enum class FenceState : uint64_t
-		{
-			WAIT_RENDERER,
-			WAIT_MAIN,
-			DONE
-		};
-
 		~RenderSystem();
 
 		GraphicsAPI& get_graphics_api();
+		LightSystem& get_light_system();
+
+		// Per-draw & per-dispatch constants of the frame being recorded, only valid on the render thread
+		ConstantBufferRing& get_constant_buffer_ring();
+
+		// Shared by the render thread stages, see JobSystem
+		JobSystem& get_job_system();
 
 		void dispatch_events();
 
 		void update_camera_transform(const CameraTransformUpdate& transform_update);
+		void update_simulation_time(float simulation_time); // Drives the moving lights, see Application::get_moving_light_count
 		void set_paused(bool paused);
 		void resize_window(uint32_t width, uint32_t height);
 		void toggle_light_debug_rendering();
 
-		Fence* create_fence();
+		// Frames the render thread is done with (presented, or dropped by a pause), headless runs step in time with it
+		// The GPU has its own frame fences, see GraphicsAPI
+		Fence& get_frame_fence();
 
+		// Camera of the frame being prepared
 		CameraInfo get_camera_info() const;
 		Vector2 get_z_near_far() const;
 		XMMatrix get_camera_projection() const;
+
+		// Against the occluders of the last culled frame, only valid while a frame is being prepared
+		bool is_occluded(const DirectX::BoundingSphere& bounds) const;
 	private:
 		RenderSystem(Application& application);
 
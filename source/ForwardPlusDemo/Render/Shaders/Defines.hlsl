@@ -69,7 +69,7 @@ cbuffer ForwardPlusParameters : register(b0)
     {
         LightData global_light;
 
-        uint4 light_counts; // In same order as light types
+        uint4 light_counts; // Culled light counts in same order as light types, W is the global (unculled) light count
 
         float z_near;
         float z_far;
@@ -88,9 +88,9 @@ uint get_total_light_count()
     return ForwardPlusParameters.light_counts.x + ForwardPlusParameters.light_counts.y + ForwardPlusParameters.light_counts.z;
 }
 
-bool have_visible_lights()
+uint get_global_light_count()
 {
-    return any(ForwardPlusParameters.light_counts);
+    return ForwardPlusParameters.light_counts.w;
 }
 
 uint integer_division_ceil(uint numerator, uint denominator)
@@ -3,7 +3,12 @@
 struct VertexInput
 {
     float4 pos : POSITION;
+#ifdef PACKED_VERTICES
+    float2 oct_norm : NORMAL; // Octahedral, see VertexFormat.hpp
+#else
     float4 norm : NORMAL;
+#endif
+    uint instance_id : SV_InstanceID;
 };
 
 struct VertexOutput
@@ -12,6 +17,7 @@ struct VertexOutput
     float4 world_pos : WORLDPOS;
     float4 view_pos : VIEWPOS;
     float4 norm : NORMAL;
+    nointerpolation uint instance_index : INSTANCE;
 };
 
 cbuffer Camera : register(b1)
@@ -30,21 +36,40 @@ struct Material
     float4 ambient;
 };
 
-cbuffer PerDrawData : register(b2)
+struct ObjectLightList
+{
+    uint offset; // Into ObjectLightIndices
+    uint count;
+    uint enabled; // When zero, the Z bins & tile bitmasks are used instead
+    uint _padding;
+};
+
+struct PerDrawData
+{
+    float4x4 model;
+    float4x4 inv_model;
+    Material material;
+    ObjectLightList light_list;
+};
+
+// One instanced draw per object type, SV_InstanceID does not include the start instance so it's passed here
+cbuffer DrawBatch : register(b2)
 {
     struct
     {
-        float4x4 model;
-        float4x4 inv_model;
-        Material material;
-    } PerDrawData;
+        uint first_instance;
+        uint3 _padding;
+    } DrawBatch;
 };
 
 StructuredBuffer<uint> ZBins : register(t0);
 StructuredBuffer<uint> TileBitmasks : register(t1);
 StructuredBuffer<LightData> LightDataBuffer : register(t2);
+StructuredBuffer<LightData> GlobalLightDataBuffer : register(t3);
+StructuredBuffer<uint> ObjectLightIndices : register(t4);
+StructuredBuffer<PerDrawData> InstanceDataBuffer : register(t5);
 
-float3 process_light(uniform LightData light_data, VertexOutput pixel, float3 view_direction)
+float3 process_light(uniform LightData light_data, VertexOutput pixel, float3 view_direction, Material material)
 {
     const float3 pixel_to_light = light_data.position - pixel.world_pos.xyz;
     const float3 pixel_to_camera = Camera.world_position.xyz - pixel.world_pos.xyz;
@@ -52,13 +77,18 @@ float3 process_light(uniform LightData light_data, VertexOutput pixel, float3 vi
     const float light_distance = length(pixel_to_light);
     
     // Phong diffuse
-    const float3 pixel_to_light_norm = pixel_to_light / light_distance;
+    float3 pixel_to_light_norm = pixel_to_light / light_distance;
+    if (light_data.info.type == LIGHT_TYPE_DIRECTIONAL)
+    {
+        pixel_to_light_norm = -light_data.direction;
+    }
+    
     const float diffuse_intensity = saturate(dot(pixel_to_light_norm, pixel.norm.xyz));
     
-    const float3 diffuse = diffuse_intensity * light_data.diffuse * PerDrawData.material.diffuse.xyz;
+    const float3 diffuse = diffuse_intensity * light_data.diffuse * material.diffuse.xyz;
     
     // Ambient
-    const float3 ambient = light_data.ambient * PerDrawData.material.ambient.xyz;
+    const float3 ambient = light_data.ambient * material.ambient.xyz;
     
     // Attenuation
     // TODO: allow for higher intensity, or more complex attenuation calculations?
@@ -67,6 +97,12 @@ float3 process_light(uniform LightData light_data, VertexOutput pixel, float3 vi
     
     switch (light_data.info.type)
     {
+        case LIGHT_TYPE_DIRECTIONAL:
+        {
+            // No falloff
+            attenuation = 1.0;
+        }
+            break;
         case LIGHT_TYPE_SPOT:
         {
             // Cone attenuation
@@ -82,14 +118,35 @@ float3 process_light(uniform LightData light_data, VertexOutput pixel, float3 vi
 
 float3 compute_lighting(VertexOutput pixel, float3 view_direction)
 {
+    const PerDrawData per_draw_data = InstanceDataBuffer[pixel.instance_index];
+
     // Start from global light ambient
     float3 lighting = ForwardPlusParameters.global_light.ambient;
 
-	// Make sure there are visible lights to process
-    if (have_visible_lights() == false)
+    // Global lights skip the binning & culling entirely, every pixel runs the same loop
+    const uint global_light_count = get_global_light_count();
+    for (uint current_global_light = 0; current_global_light < global_light_count; ++current_global_light)
+    {
+        lighting += process_light(GlobalLightDataBuffer[current_global_light], pixel, view_direction, per_draw_data.material);
+    }
+
+	// Make sure there are culled lights to process
+    if (get_total_light_count() == 0)
     {
         return lighting;
     }
+    
+    // Few visible lights, the CPU already gathered the ones touching this object
+    if (per_draw_data.light_list.enabled != 0)
+    {
+        const uint light_list_end = per_draw_data.light_list.offset + per_draw_data.light_list.count;
+        for (uint current_list_index = per_draw_data.light_list.offset; current_list_index < light_list_end; ++current_list_index)
+        {
+            lighting += process_light(LightDataBuffer[ObjectLightIndices[current_list_index]], pixel, view_direction, per_draw_data.material);
+        }
+        
+        return lighting;
+    }
      
     const LightCullingDataIndex culling_data_index = get_light_culling_data_index(pixel.clip_pos.xy, pixel.view_pos.z);
     const ZBin z_bin = read_z_bin(ZBins[culling_data_index.z_bin]);
@@ -142,22 +199,41 @@ float3 compute_lighting(VertexOutput pixel, float3 view_direction)
                 continue;
             }
             
-            lighting += process_light(current_light_data, pixel, view_direction);
+            lighting += process_light(current_light_data, pixel, view_direction, per_draw_data.material);
         }
     }			
 
     return lighting;
 }
 
+// Matches decode_octahedral_normal in VertexFormat.cpp
+float3 decode_octahedral_normal(float2 encoded)
+{
+    float3 normal = float3(encoded.x, encoded.y, 1.0f - abs(encoded.x) - abs(encoded.y));
+    
+    const float fold = max(-normal.z, 0.0f);
+    normal.x += (normal.x >= 0.0f) ? -fold : fold;
+    normal.y += (normal.y >= 0.0f) ? -fold : fold;
+    
+    return normalize(normal);
+}
+
 VertexOutput vertex_shader(VertexInput input)
 {
     VertexOutput output;
     
-    output.world_pos = mul(input.pos, PerDrawData.model);
+    output.instance_index = DrawBatch.first_instance + input.instance_id;
+    const PerDrawData per_draw_data = InstanceDataBuffer[output.instance_index];
+    
+    output.world_pos = mul(input.pos, per_draw_data.model);
     
     output.clip_pos = mul(output.world_pos, Camera.view_projection);
     output.view_pos = mul(output.world_pos, Camera.view);
-    output.norm = mul(normalize(input.norm), PerDrawData.inv_model);
+#ifdef PACKED_VERTICES
+    output.norm = mul(float4(decode_octahedral_normal(input.oct_norm), 0.0f), per_draw_data.inv_model);
+#else
+    output.norm = mul(normalize(input.norm), per_draw_data.inv_model);
+#endif
     
     return output;
 }
@@ -0,0 +1,880 @@
+#include <ForwardPlusDemo/Render/SoftwareRasterizer.hpp>
+
+#include <ForwardPlusDemo/Render/LightSystem.hpp>
+#include <ForwardPlusDemo/Render/Math.hpp>
+#include <ForwardPlusDemo/Render/VertexFormat.hpp>
+
+#include <ForwardPlusDemo/Utilities/JobSystem.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace ForwardPlusDemo
+{
+	namespace
+	{
+		// NOTE: must match Defines.hlsl
+		constexpr uint32_t c_tile_x_dim = 32;
+		constexpr uint32_t c_tile_y_dim = 24;
+		constexpr uint32_t c_z_bin_count = 1024;
+		constexpr uint32_t c_z_bin_min_mask = (1 << 16) - 1;
+		constexpr uint32_t c_light_batch_size = 32;
+
+		// Screen is split into square bins, each one is rasterized & shaded by a single thread
+		constexpr uint32_t c_bin_size = 32;
+
+		constexpr uint32_t c_no_triangle = UINT32_MAX;
+
+		// Same as the back buffer clear in GraphicsAPI
+		constexpr Vector3 c_clear_color = { 0.0f, 0.0f, 1.0f };
+
+		// Register slots from Main.hlsl
+		constexpr uint32_t c_forward_plus_parameters_slot = 0;
+		constexpr uint32_t c_camera_slot = 1;
+		constexpr uint32_t c_draw_batch_slot = 2;
+
+		constexpr uint32_t c_z_bins_slot = 0;
+		constexpr uint32_t c_tile_bitmasks_slot = 1;
+		constexpr uint32_t c_light_data_slot = 2;
+		constexpr uint32_t c_global_light_data_slot = 3;
+		constexpr uint32_t c_object_light_indices_slot = 4;
+		constexpr uint32_t c_instance_data_slot = 5;
+
+		// Shader side structs, same layouts as in Main.hlsl & Defines.hlsl
+		struct alignas(16) ShaderLightInfo
+		{
+			uint32_t type;
+			uint32_t index;
+			uint32_t z_range;
+			uint32_t _padding;
+		};
+
+		struct alignas(16) ShaderLightData
+		{
+			Vector3 position;
+			float inv_range;
+
+			Vector3 direction;
+			float cos_outer_angle;
+
+			Vector3 diffuse;
+			float inv_cos_inner_angle;
+
+			Vector3 ambient;
+			float linear_attenuation;
+
+			ShaderLightInfo light_info;
+		};
+
+		struct alignas(16) ForwardPlusParameters
+		{
+			ShaderLightData global_light;
+
+			std::array<uint32_t, 4> light_counts;
+
+			float z_near;
+			float z_far;
+
+			Vector2i resolution;
+		};
+
+		struct alignas(16) Camera
+		{
+			XMVector world_position;
+			XMMatrix view;
+			XMMatrix view_projection;
+		};
+
+		struct alignas(16) Material
+		{
+			Vector4 diffuse;
+			Vector4 ambient;
+		};
+
+		struct alignas(16) PerDrawData
+		{
+			XMMatrix model;
+			XMMatrix inv_model;
+			Material material;
+			ObjectLightList light_list;
+		};
+
+		struct alignas(16) DrawBatchData
+		{
+			uint32_t first_instance;
+			Vector3i _padding;
+		};
+
+		struct Vertex
+		{
+			Vector4 position;
+			Vector4 normal;
+		};
+
+		struct VertexOutput
+		{
+			XMVector clip_pos;
+			XMVector world_pos;
+			XMVector view_pos;
+			XMVector norm;
+		};
+
+		// Interpolated pixel shader input
+		struct PixelInput
+		{
+			Vector2 pixel_pos;
+			XMVector world_pos;
+			float view_z;
+			XMVector norm;
+		};
+
+		// Everything the pixel stage of a draw reads, captured when the draw is replayed
+		// NOTE: the light culling buffers are only referenced, they are not updated again until the next frame
+		struct DrawState
+		{
+			Camera camera;
+			ForwardPlusParameters parameters;
+
+			NullBufferView z_bins;
+			NullBufferView tile_bitmasks;
+			NullBufferView light_data;
+			NullBufferView global_light_data;
+			NullBufferView object_light_indices;
+		};
+
+		struct InstanceState
+		{
+			PerDrawData per_draw_data;
+			uint32_t draw_state_index;
+		};
+
+		// Screen space triangle, attributes are divided by W for perspective correct interpolation
+		struct Triangle
+		{
+			std::array<Vector2, 3> screen_pos;
+			std::array<float, 3> depth;
+			std::array<float, 3> inv_w;
+
+			std::array<Vector3, 3> world_pos;
+			std::array<Vector3, 3> norm;
+			std::array<float, 3> view_z;
+
+			std::array<bool, 3> top_left_edge; // Edges are opposite to the vertex with the same index
+			float inv_area;
+
+			Vector2i pixel_min;
+			Vector2i pixel_max; // Inclusive
+
+			uint32_t instance_index;
+		};
+
+		struct ZBin
+		{
+			uint32_t min;
+			uint32_t max;
+		};
+
+		template<typename T>
+		const T* read_element(const NullBufferView& view, uint32_t index)
+		{
+			return (index < view.get_element_count<T>()) ? (view.as<const T>() + index) : nullptr;
+		}
+
+		float saturate(float value)
+		{
+			return std::clamp(value, 0.0f, 1.0f);
+		}
+
+		// Positive for clockwise triangles on screen (Y down), which are the front faces with the default D3D rasterizer state
+		float edge_function(const Vector2& a, const Vector2& b, const Vector2& point)
+		{
+			return ((b.x - a.x) * (point.y - a.y)) - ((b.y - a.y) * (point.x - a.x));
+		}
+
+		bool is_top_left_edge(const Vector2& a, const Vector2& b)
+		{
+			const bool top_edge = (a.y == b.y) && (b.x > a.x);
+			const bool left_edge = (b.y < a.y);
+
+			return top_edge || left_edge;
+		}
+
+		bool is_inside_edge(float edge_value, bool top_left_edge)
+		{
+			return (edge_value > 0.0f) || ((edge_value == 0.0f) && top_left_edge);
+		}
+
+		VertexOutput lerp_vertex(const VertexOutput& a, const VertexOutput& b, float t)
+		{
+			VertexOutput output;
+			output.clip_pos = DirectX::XMVectorLerp(a.clip_pos, b.clip_pos, t);
+			output.world_pos = DirectX::XMVectorLerp(a.world_pos, b.world_pos, t);
+			output.view_pos = DirectX::XMVectorLerp(a.view_pos, b.view_pos, t);
+			output.norm = DirectX::XMVectorLerp(a.norm, b.norm, t);
+
+			return output;
+		}
+
+		// Main.hlsl vertex_shader
+		VertexOutput vertex_shader(const Vertex& input, const Camera& camera, const PerDrawData& per_draw_data)
+		{
+			VertexOutput output;
+			output.world_pos = DirectX::XMVector4Transform(to_xmvector(input.position), per_draw_data.model);
+
+			output.clip_pos = DirectX::XMVector4Transform(output.world_pos, camera.view_projection);
+			output.view_pos = DirectX::XMVector4Transform(output.world_pos, camera.view);
+			output.norm = DirectX::XMVector4Transform(DirectX::XMVector4Normalize(to_xmvector(input.normal)), per_draw_data.inv_model);
+
+			return output;
+		}
+
+		ZBin read_z_bin(uint32_t z_bin_data)
+		{
+			return ZBin{ z_bin_data & c_z_bin_min_mask, z_bin_data >> 16 };
+		}
+
+		uint32_t find_z_bin(const ForwardPlusParameters& parameters, float view_z)
+		{
+			const float z_offset = view_z - parameters.z_near;
+			const float z_step = (parameters.z_far - parameters.z_near) / c_z_bin_count;
+
+			return static_cast<uint32_t>(std::clamp(static_cast<int>(z_offset / z_step), 0, static_cast<int>(c_z_bin_count - 1)));
+		}
+
+		// Tile index from the bottom left corner, as the culling stage assumes
+		uint32_t find_tile_flat_index(const ForwardPlusParameters& parameters, const Vector2& pixel_pos)
+		{
+			const float tile_step_x = static_cast<float>(parameters.resolution.x) / c_tile_x_dim;
+			const float tile_step_y = static_cast<float>(parameters.resolution.y) / c_tile_y_dim;
+
+			const uint32_t tile_x = static_cast<uint32_t>(std::clamp(static_cast<int>(pixel_pos.x / tile_step_x), 0, static_cast<int>(c_tile_x_dim - 1)));
+			const uint32_t top_left_tile_y = static_cast<uint32_t>(std::clamp(static_cast<int>(pixel_pos.y / tile_step_y), 0, static_cast<int>(c_tile_y_dim - 1)));
+			const uint32_t tile_y = (c_tile_y_dim - 1) - top_left_tile_y;
+
+			return (tile_y * c_tile_x_dim) + tile_x;
+		}
+
+		// Main.hlsl process_light
+		XMVector process_light(const ShaderLightData& light_data, const PixelInput& pixel, const Material& material)
+		{
+			const XMVector pixel_to_light = to_xmvector(light_data.position) - pixel.world_pos;
+			const float light_distance = DirectX::XMVectorGetX(DirectX::XMVector3Length(pixel_to_light));
+
+			// Phong diffuse
+			XMVector pixel_to_light_norm = pixel_to_light / light_distance;
+			if (light_data.light_info.type == static_cast<uint32_t>(LightType::DIRECTIONAL))
+			{
+				pixel_to_light_norm = -to_xmvector(light_data.direction);
+			}
+
+			const float diffuse_intensity = saturate(DirectX::XMVectorGetX(DirectX::XMVector3Dot(pixel_to_light_norm, pixel.norm)));
+
+			const XMVector diffuse = diffuse_intensity * to_xmvector(light_data.diffuse) * to_xmvector(material.diffuse);
+
+			// Ambient
+			const XMVector ambient = to_xmvector(light_data.ambient) * to_xmvector(material.ambient);
+
+			// Attenuation
+			const float light_distance_norm = 1.0f - saturate(light_distance * light_data.inv_range);
+			float attenuation = light_distance_norm * light_distance_norm;
+
+			switch (light_data.light_info.type)
+			{
+			case static_cast<uint32_t>(LightType::DIRECTIONAL):
+				attenuation = 1.0f;
+				break;
+			case static_cast<uint32_t>(LightType::SPOT):
+			{
+				const float cos_light_angle = DirectX::XMVectorGetX(DirectX::XMVector3Dot(-pixel_to_light_norm, DirectX::XMVector3Normalize(to_xmvector(light_data.direction))));
+				attenuation *= saturate((cos_light_angle - light_data.cos_outer_angle) * light_data.inv_cos_inner_angle);
+			}
+				break;
+			}
+
+			return attenuation * (diffuse + ambient);
+		}
+
+		// Main.hlsl compute_lighting, also counts the lights processed for this pixel
+		XMVector compute_lighting(const PixelInput& pixel, const DrawState& draw_state, const PerDrawData& per_draw_data, uint32_t& lights_evaluated)
+		{
+			const ForwardPlusParameters& parameters = draw_state.parameters;
+
+			// Start from global light ambient
+			XMVector lighting = to_xmvector(parameters.global_light.ambient);
+
+			const uint32_t global_light_count = std::min(parameters.light_counts[3], draw_state.global_light_data.get_element_count<ShaderLightData>());
+			for (uint32_t current_global_light = 0; current_global_light < global_light_count; ++current_global_light)
+			{
+				lighting += process_light(draw_state.global_light_data.as<const ShaderLightData>()[current_global_light], pixel, per_draw_data.material);
+				++lights_evaluated;
+			}
+
+			const uint32_t total_light_count = parameters.light_counts[0] + parameters.light_counts[1] + parameters.light_counts[2];
+			if (total_light_count == 0)
+			{
+				return lighting;
+			}
+
+			// Few visible lights, the CPU already gathered the ones touching this object
+			if (per_draw_data.light_list.enabled != 0)
+			{
+				const uint32_t light_list_end = per_draw_data.light_list.offset + per_draw_data.light_list.count;
+				for (uint32_t current_list_index = per_draw_data.light_list.offset; current_list_index < light_list_end; ++current_list_index)
+				{
+					const uint32_t* light_index = read_element<uint32_t>(draw_state.object_light_indices, current_list_index);
+					const ShaderLightData* light_data = (light_index != nullptr) ? read_element<ShaderLightData>(draw_state.light_data, *light_index) : nullptr;
+					if (light_data == nullptr)
+					{
+						continue;
+					}
+
+					lighting += process_light(*light_data, pixel, per_draw_data.material);
+					++lights_evaluated;
+				}
+
+				return lighting;
+			}
+
+			const uint32_t z_bin_index = find_z_bin(parameters, pixel.view_z);
+			const uint32_t* z_bin_data = read_element<uint32_t>(draw_state.z_bins, z_bin_index);
+			if (z_bin_data == nullptr)
+			{
+				return lighting;
+			}
+
+			const ZBin z_bin = read_z_bin(*z_bin_data);
+			if (z_bin.min > z_bin.max)
+			{
+				return lighting;
+			}
+
+			const uint32_t light_batch_min = z_bin.min / c_light_batch_size;
+			const uint32_t light_batch_max = (z_bin.max / c_light_batch_size) + 1;
+			const uint32_t batches_per_tile = (total_light_count + (c_light_batch_size - 1)) / c_light_batch_size;
+
+			const uint32_t light_batch_start_index = find_tile_flat_index(parameters, pixel.pixel_pos) * batches_per_tile;
+
+			for (uint32_t current_light_batch = light_batch_min; current_light_batch < light_batch_max; ++current_light_batch)
+			{
+				const uint32_t* tile_bitmask = read_element<uint32_t>(draw_state.tile_bitmasks, light_batch_start_index + current_light_batch);
+				if (tile_bitmask == nullptr)
+				{
+					break;
+				}
+
+				uint32_t current_light_mask = *tile_bitmask;
+				const uint32_t light_batch_offset = current_light_batch * c_light_batch_size;
+
+				const uint32_t min_index_in_batch = z_bin.min - light_batch_offset;
+				const uint32_t max_index_in_batch = z_bin.max - light_batch_offset;
+				if (min_index_in_batch < c_light_batch_size)
+				{
+					current_light_mask &= ~((1u << min_index_in_batch) - 1);
+				}
+				if (max_index_in_batch < (c_light_batch_size - 1))
+				{
+					current_light_mask &= ((1u << (max_index_in_batch + 1)) - 1);
+				}
+
+				while (current_light_mask != 0)
+				{
+					const uint32_t local_light_index = static_cast<uint32_t>(std::countr_zero(current_light_mask));
+					current_light_mask ^= (1u << local_light_index);
+
+					const ShaderLightData* light_data = read_element<ShaderLightData>(draw_state.light_data, light_batch_offset + local_light_index);
+					if (light_data == nullptr)
+					{
+						continue;
+					}
+
+					// Make sure the light actually affects this Z bin
+					const ZBin light_z_range = read_z_bin(light_data->light_info.z_range);
+					if ((z_bin_index < light_z_range.min) || (z_bin_index > light_z_range.max))
+					{
+						continue;
+					}
+
+					lighting += process_light(*light_data, pixel, per_draw_data.material);
+					++lights_evaluated;
+				}
+			}
+
+			return lighting;
+		}
+	}
+
+	struct SoftwareRasterizer::Internal
+	{
+		uint32_t m_width = 0;
+		uint32_t m_height = 0;
+		JobSystem& m_job_system;
+
+		VertexFormat m_vertex_format = VertexFormat::FULL;
+
+		uint32_t m_bin_count_x = 0;
+		uint32_t m_bin_count_y = 0;
+
+		// Frame data, reset in begin_frame
+		std::vector<DrawState> m_draw_states;
+		std::vector<InstanceState> m_instances;
+		std::vector<Triangle> m_triangles;
+		std::vector<std::vector<uint32_t>> m_bins; // Triangle indices in submission order
+		std::vector<SoftwareRasterizerStatistics> m_bin_statistics;
+
+		// Render targets
+		std::vector<float> m_depth;
+		std::vector<uint32_t> m_pixel_triangles;
+		std::vector<Vector3> m_color;
+		std::vector<uint32_t> m_light_counts;
+
+		SoftwareRasterizerStatistics m_statistics;
+
+		Internal(uint32_t width, uint32_t height, JobSystem& job_system)
+			: m_width(std::max(width, 1u))
+			, m_height(std::max(height, 1u))
+			, m_job_system(job_system)
+		{
+			m_bin_count_x = (m_width + (c_bin_size - 1)) / c_bin_size;
+			m_bin_count_y = (m_height + (c_bin_size - 1)) / c_bin_size;
+			m_bins.resize(m_bin_count_x * m_bin_count_y);
+			m_bin_statistics.resize(m_bins.size());
+
+			const size_t pixel_count = static_cast<size_t>(m_width) * m_height;
+			m_depth.resize(pixel_count, 1.0f);
+			m_pixel_triangles.resize(pixel_count, c_no_triangle);
+			m_color.resize(pixel_count, c_clear_color);
+			m_light_counts.resize(pixel_count, 0);
+		}
+
+		void begin_frame()
+		{
+			m_draw_states.clear();
+			m_instances.clear();
+			m_triangles.clear();
+
+			for (std::vector<uint32_t>& current_bin : m_bins)
+			{
+				current_bin.clear();
+			}
+		}
+
+		void draw(const NullDrawContext& context)
+		{
+			// Only the scene pass
+			if (context.topology != PrimitiveTopology::TRIANGLE_LIST)
+			{
+				return;
+			}
+
+			const NullBufferView& camera_buffer = context.vertex_constant_buffers[c_camera_slot];
+			const NullBufferView& draw_batch_buffer = context.vertex_constant_buffers[c_draw_batch_slot];
+			const NullBufferView& parameters_buffer = context.pixel_constant_buffers[c_forward_plus_parameters_slot];
+			const NullBufferView& instance_buffer = context.vertex_shader_resources[c_instance_data_slot];
+			if ((camera_buffer.size < sizeof(Camera)) || (draw_batch_buffer.size < sizeof(DrawBatchData)) || (parameters_buffer.size < sizeof(ForwardPlusParameters)) || (context.vertex_stride < get_vertex_size()))
+			{
+				return;
+			}
+
+			DrawState draw_state;
+			draw_state.camera = *camera_buffer.as<const Camera>();
+			draw_state.parameters = *parameters_buffer.as<const ForwardPlusParameters>();
+			draw_state.z_bins = context.pixel_shader_resources[c_z_bins_slot];
+			draw_state.tile_bitmasks = context.pixel_shader_resources[c_tile_bitmasks_slot];
+			draw_state.light_data = context.pixel_shader_resources[c_light_data_slot];
+			draw_state.global_light_data = context.pixel_shader_resources[c_global_light_data_slot];
+			draw_state.object_light_indices = context.pixel_shader_resources[c_object_light_indices_slot];
+
+			const uint32_t draw_state_index = static_cast<uint32_t>(m_draw_states.size());
+			m_draw_states.push_back(draw_state);
+
+			// SV_InstanceID does not include the start instance, the shader offsets it with DrawBatch.first_instance instead
+			const uint32_t first_instance = draw_batch_buffer.as<const DrawBatchData>()->first_instance;
+			for (uint32_t current_instance_id = 0; current_instance_id < context.instance_count; ++current_instance_id)
+			{
+				const PerDrawData* per_draw_data = read_element<PerDrawData>(instance_buffer, first_instance + current_instance_id);
+				if (per_draw_data == nullptr)
+				{
+					break;
+				}
+
+				const uint32_t instance_index = static_cast<uint32_t>(m_instances.size());
+				m_instances.push_back(InstanceState{ *per_draw_data, draw_state_index });
+
+				for (uint32_t current_vertex = 0; (current_vertex + 2) < context.vertex_count; current_vertex += 3)
+				{
+					std::array<VertexOutput, 3> triangle_vertices;
+					for (uint32_t current_corner = 0; current_corner < 3; ++current_corner)
+					{
+						Vertex vertex;
+						if (!fetch_vertex(context, current_vertex + current_corner, vertex))
+						{
+							return;
+						}
+
+						triangle_vertices[current_corner] = vertex_shader(vertex, draw_state.camera, *per_draw_data);
+					}
+
+					add_triangle(triangle_vertices, instance_index);
+				}
+			}
+		}
+
+		size_t get_vertex_size() const
+		{
+			return (m_vertex_format == VertexFormat::PACKED) ? sizeof(PackedVertex) : sizeof(Vertex);
+		}
+
+		// Packed vertices are expanded the same way as the input assembler & PACKED_VERTICES vertex shader would
+		bool fetch_vertex(const NullDrawContext& context, uint32_t draw_vertex, Vertex& vertex) const
+		{
+			uint32_t vertex_index = 0;
+			if (context.get_vertex_index(draw_vertex, vertex_index) == false)
+			{
+				return false;
+			}
+
+			const size_t offset = context.vertex_offset + (static_cast<size_t>(vertex_index) * context.vertex_stride);
+			if ((offset + get_vertex_size()) > context.vertex_buffer.size)
+			{
+				return false;
+			}
+
+			const char* vertex_data = context.vertex_buffer.as<const char>() + offset;
+			if (m_vertex_format == VertexFormat::PACKED)
+			{
+				PackedVertex packed_vertex;
+				std::memcpy(&packed_vertex, vertex_data, sizeof(PackedVertex));
+				unpack_vertex(packed_vertex, vertex.position, vertex.normal);
+			}
+			else
+			{
+				std::memcpy(&vertex, vertex_data, sizeof(Vertex));
+			}
+
+			return true;
+		}
+
+		void add_triangle(const std::array<VertexOutput, 3>& vertices, uint32_t instance_index)
+		{
+			// Clip against the near plane (Z >= 0 in D3D clip space), the other planes are handled by the screen bounds & depth test
+			std::array<VertexOutput, 4> clipped_vertices;
+			uint32_t clipped_vertex_count = 0;
+
+			for (uint32_t current_corner = 0; current_corner < 3; ++current_corner)
+			{
+				const VertexOutput& current_vertex = vertices[current_corner];
+				const VertexOutput& next_vertex = vertices[(current_corner + 1) % 3];
+
+				const float current_z = DirectX::XMVectorGetZ(current_vertex.clip_pos);
+				const float next_z = DirectX::XMVectorGetZ(next_vertex.clip_pos);
+				if (current_z >= 0.0f)
+				{
+					clipped_vertices[clipped_vertex_count++] = current_vertex;
+				}
+
+				if ((current_z >= 0.0f) != (next_z >= 0.0f))
+				{
+					clipped_vertices[clipped_vertex_count++] = lerp_vertex(current_vertex, next_vertex, current_z / (current_z - next_z));
+				}
+			}
+
+			for (uint32_t current_fan_vertex = 2; current_fan_vertex < clipped_vertex_count; ++current_fan_vertex)
+			{
+				setup_triangle(clipped_vertices[0], clipped_vertices[current_fan_vertex - 1], clipped_vertices[current_fan_vertex], instance_index);
+			}
+		}
+
+		void setup_triangle(const VertexOutput& vertex0, const VertexOutput& vertex1, const VertexOutput& vertex2, uint32_t instance_index)
+		{
+			const std::array<const VertexOutput*, 3> vertices = { &vertex0, &vertex1, &vertex2 };
+
+			Triangle triangle;
+			triangle.instance_index = instance_index;
+
+			for (uint32_t current_corner = 0; current_corner < 3; ++current_corner)
+			{
+				const VertexOutput& vertex = *vertices[current_corner];
+
+				const float inv_w = 1.0f / DirectX::XMVectorGetW(vertex.clip_pos);
+				const float ndc_x = DirectX::XMVectorGetX(vertex.clip_pos) * inv_w;
+				const float ndc_y = DirectX::XMVectorGetY(vertex.clip_pos) * inv_w;
+
+				triangle.screen_pos[current_corner] = Vector2((ndc_x * 0.5f + 0.5f) * m_width, (0.5f - ndc_y * 0.5f) * m_height);
+				triangle.depth[current_corner] = DirectX::XMVectorGetZ(vertex.clip_pos) * inv_w;
+				triangle.inv_w[current_corner] = inv_w;
+
+				triangle.world_pos[current_corner] = to_vector3(vertex.world_pos * inv_w);
+				triangle.norm[current_corner] = to_vector3(vertex.norm * inv_w);
+				triangle.view_z[current_corner] = DirectX::XMVectorGetZ(vertex.view_pos) * inv_w;
+			}
+
+			// Back facing or degenerate
+			const float area = edge_function(triangle.screen_pos[0], triangle.screen_pos[1], triangle.screen_pos[2]);
+			if ((area > 0.0f) == false)
+			{
+				return;
+			}
+
+			triangle.inv_area = 1.0f / area;
+			for (uint32_t current_edge = 0; current_edge < 3; ++current_edge)
+			{
+				triangle.top_left_edge[current_edge] = is_top_left_edge(triangle.screen_pos[(current_edge + 1) % 3], triangle.screen_pos[(current_edge + 2) % 3]);
+			}
+
+			// Pixels whose centers can be covered
+			const float min_x = std::min({ triangle.screen_pos[0].x, triangle.screen_pos[1].x, triangle.screen_pos[2].x });
+			const float min_y = std::min({ triangle.screen_pos[0].y, triangle.screen_pos[1].y, triangle.screen_pos[2].y });
+			const float max_x = std::max({ triangle.screen_pos[0].x, triangle.screen_pos[1].x, triangle.screen_pos[2].x });
+			const float max_y = std::max({ triangle.screen_pos[0].y, triangle.screen_pos[1].y, triangle.screen_pos[2].y });
+
+			const float max_pixel_x = static_cast<float>(m_width - 1);
+			const float max_pixel_y = static_cast<float>(m_height - 1);
+			triangle.pixel_min = Vector2i(static_cast<int>(std::clamp(std::ceil(min_x - 0.5f), 0.0f, max_pixel_x)), static_cast<int>(std::clamp(std::ceil(min_y - 0.5f), 0.0f, max_pixel_y)));
+			triangle.pixel_max = Vector2i(static_cast<int>(std::clamp(std::floor(max_x - 0.5f), -1.0f, max_pixel_x)), static_cast<int>(std::clamp(std::floor(max_y - 0.5f), -1.0f, max_pixel_y)));
+			if ((triangle.pixel_min.x > triangle.pixel_max.x) || (triangle.pixel_min.y > triangle.pixel_max.y))
+			{
+				return;
+			}
+
+			const uint32_t triangle_index = static_cast<uint32_t>(m_triangles.size());
+			m_triangles.push_back(triangle);
+
+			for (int bin_y = triangle.pixel_min.y / c_bin_size; bin_y <= (triangle.pixel_max.y / static_cast<int>(c_bin_size)); ++bin_y)
+			{
+				for (int bin_x = triangle.pixel_min.x / c_bin_size; bin_x <= (triangle.pixel_max.x / static_cast<int>(c_bin_size)); ++bin_x)
+				{
+					m_bins[(bin_y * m_bin_count_x) + bin_x].push_back(triangle_index);
+				}
+			}
+		}
+
+		void end_frame()
+		{
+			const uint32_t bin_count = static_cast<uint32_t>(m_bins.size());
+
+			// Bins touch disjoint pixels, so any thread can take any of them
+			m_job_system.parallel_for(bin_count, 1, [this](uint32_t first_bin, uint32_t end_bin)
+			{
+				for (uint32_t current_bin = first_bin; current_bin < end_bin; ++current_bin)
+				{
+					m_bin_statistics[current_bin] = SoftwareRasterizerStatistics();
+					rasterize_bin(current_bin, m_bin_statistics[current_bin]);
+				}
+			});
+
+			m_statistics = SoftwareRasterizerStatistics();
+			m_statistics.triangle_count = m_triangles.size();
+			for (const SoftwareRasterizerStatistics& current_statistics : m_bin_statistics)
+			{
+				m_statistics.shaded_pixel_count += current_statistics.shaded_pixel_count;
+				m_statistics.depth_passed_pixel_count += current_statistics.depth_passed_pixel_count;
+				m_statistics.lights_evaluated += current_statistics.lights_evaluated;
+				m_statistics.max_lights_per_pixel = std::max(m_statistics.max_lights_per_pixel, current_statistics.max_lights_per_pixel);
+			}
+		}
+
+		void rasterize_bin(uint32_t bin_index, SoftwareRasterizerStatistics& statistics)
+		{
+			const uint32_t bin_min_x = (bin_index % m_bin_count_x) * c_bin_size;
+			const uint32_t bin_min_y = (bin_index / m_bin_count_x) * c_bin_size;
+			const uint32_t bin_max_x = std::min(bin_min_x + c_bin_size, m_width);
+			const uint32_t bin_max_y = std::min(bin_min_y + c_bin_size, m_height);
+
+			for (uint32_t pixel_y = bin_min_y; pixel_y < bin_max_y; ++pixel_y)
+			{
+				const size_t row_offset = static_cast<size_t>(pixel_y) * m_width;
+				std::fill(m_depth.begin() + row_offset + bin_min_x, m_depth.begin() + row_offset + bin_max_x, 1.0f);
+				std::fill(m_pixel_triangles.begin() + row_offset + bin_min_x, m_pixel_triangles.begin() + row_offset + bin_max_x, c_no_triangle);
+				std::fill(m_color.begin() + row_offset + bin_min_x, m_color.begin() + row_offset + bin_max_x, c_clear_color);
+				std::fill(m_light_counts.begin() + row_offset + bin_min_x, m_light_counts.begin() + row_offset + bin_max_x, 0);
+			}
+
+			// Visibility first (depth test is LESS like the D3D default), so every pixel is only shaded once
+			for (const uint32_t triangle_index : m_bins[bin_index])
+			{
+				const Triangle& triangle = m_triangles[triangle_index];
+
+				const uint32_t min_x = std::max(static_cast<uint32_t>(triangle.pixel_min.x), bin_min_x);
+				const uint32_t min_y = std::max(static_cast<uint32_t>(triangle.pixel_min.y), bin_min_y);
+				const uint32_t max_x = std::min(static_cast<uint32_t>(triangle.pixel_max.x) + 1, bin_max_x);
+				const uint32_t max_y = std::min(static_cast<uint32_t>(triangle.pixel_max.y) + 1, bin_max_y);
+
+				for (uint32_t pixel_y = min_y; pixel_y < max_y; ++pixel_y)
+				{
+					for (uint32_t pixel_x = min_x; pixel_x < max_x; ++pixel_x)
+					{
+						std::array<float, 3> barycentrics;
+						if (!get_barycentrics(triangle, pixel_x, pixel_y, barycentrics))
+						{
+							continue;
+						}
+
+						const float depth = (barycentrics[0] * triangle.depth[0]) + (barycentrics[1] * triangle.depth[1]) + (barycentrics[2] * triangle.depth[2]);
+
+						const size_t pixel_index = (static_cast<size_t>(pixel_y) * m_width) + pixel_x;
+						if ((depth < 0.0f) || (depth >= m_depth[pixel_index]))
+						{
+							continue;
+						}
+
+						m_depth[pixel_index] = depth;
+						m_pixel_triangles[pixel_index] = triangle_index;
+						++statistics.depth_passed_pixel_count;
+					}
+				}
+			}
+
+			for (uint32_t pixel_y = bin_min_y; pixel_y < bin_max_y; ++pixel_y)
+			{
+				for (uint32_t pixel_x = bin_min_x; pixel_x < bin_max_x; ++pixel_x)
+				{
+					const size_t pixel_index = (static_cast<size_t>(pixel_y) * m_width) + pixel_x;
+					if (m_pixel_triangles[pixel_index] != c_no_triangle)
+					{
+						shade_pixel(pixel_x, pixel_y, m_triangles[m_pixel_triangles[pixel_index]], statistics);
+					}
+				}
+			}
+		}
+
+		bool get_barycentrics(const Triangle& triangle, uint32_t pixel_x, uint32_t pixel_y, std::array<float, 3>& barycentrics) const
+		{
+			const Vector2 pixel_center(pixel_x + 0.5f, pixel_y + 0.5f);
+			for (uint32_t current_edge = 0; current_edge < 3; ++current_edge)
+			{
+				const float edge_value = edge_function(triangle.screen_pos[(current_edge + 1) % 3], triangle.screen_pos[(current_edge + 2) % 3], pixel_center);
+				if (!is_inside_edge(edge_value, triangle.top_left_edge[current_edge]))
+				{
+					return false;
+				}
+
+				barycentrics[current_edge] = edge_value * triangle.inv_area;
+			}
+
+			return true;
+		}
+
+		void shade_pixel(uint32_t pixel_x, uint32_t pixel_y, const Triangle& triangle, SoftwareRasterizerStatistics& statistics)
+		{
+			std::array<float, 3> barycentrics;
+			if (!get_barycentrics(triangle, pixel_x, pixel_y, barycentrics))
+			{
+				return;
+			}
+
+			// Perspective correct weights
+			const float inv_w = (barycentrics[0] * triangle.inv_w[0]) + (barycentrics[1] * triangle.inv_w[1]) + (barycentrics[2] * triangle.inv_w[2]);
+			const float w = 1.0f / inv_w;
+
+			PixelInput pixel;
+			pixel.pixel_pos = Vector2(pixel_x + 0.5f, pixel_y + 0.5f);
+			pixel.world_pos = DirectX::XMVectorZero();
+			pixel.norm = DirectX::XMVectorZero();
+			pixel.view_z = 0.0f;
+
+			for (uint32_t current_corner = 0; current_corner < 3; ++current_corner)
+			{
+				const float weight = barycentrics[current_corner] * w;
+				pixel.world_pos += to_xmvector(triangle.world_pos[current_corner]) * weight;
+				pixel.norm += to_xmvector(triangle.norm[current_corner]) * weight;
+				pixel.view_z += triangle.view_z[current_corner] * weight;
+			}
+
+			const InstanceState& instance = m_instances[triangle.instance_index];
+
+			uint32_t lights_evaluated = 0;
+			const XMVector lighting = compute_lighting(pixel, m_draw_states[instance.draw_state_index], instance.per_draw_data, lights_evaluated);
+
+			const size_t pixel_index = (static_cast<size_t>(pixel_y) * m_width) + pixel_x;
+			m_color[pixel_index] = to_vector3(lighting);
+			m_light_counts[pixel_index] = lights_evaluated;
+
+			++statistics.shaded_pixel_count;
+			statistics.lights_evaluated += lights_evaluated;
+			statistics.max_lights_per_pixel = std::max(statistics.max_lights_per_pixel, lights_evaluated);
+		}
+	};
+
+	SoftwareRasterizer::SoftwareRasterizer(uint32_t width, uint32_t height, JobSystem& job_system)
+		: m_internal(std::make_unique<Internal>(width, height, job_system))
+	{
+	}
+
+	SoftwareRasterizer::~SoftwareRasterizer() = default;
+
+	void SoftwareRasterizer::set_vertex_format(VertexFormat format)
+	{
+		m_internal->m_vertex_format = format;
+	}
+
+	void SoftwareRasterizer::begin_frame()
+	{
+		m_internal->begin_frame();
+	}
+
+	void SoftwareRasterizer::draw(const NullDrawContext& context)
+	{
+		m_internal->draw(context);
+	}
+
+	void SoftwareRasterizer::end_frame()
+	{
+		m_internal->end_frame();
+	}
+
+	bool SoftwareRasterizer::write_color_image(const std::filesystem::path& file_path) const
+	{
+		std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			return false;
+		}
+
+		file << "P6\n" << m_internal->m_width << " " << m_internal->m_height << "\n255\n";
+
+		std::vector<uint8_t> pixel_data;
+		pixel_data.reserve(m_internal->m_color.size() * 3);
+		for (const Vector3& current_color : m_internal->m_color)
+		{
+			pixel_data.push_back(static_cast<uint8_t>(saturate(current_color.x) * 255.0f + 0.5f));
+			pixel_data.push_back(static_cast<uint8_t>(saturate(current_color.y) * 255.0f + 0.5f));
+			pixel_data.push_back(static_cast<uint8_t>(saturate(current_color.z) * 255.0f + 0.5f));
+		}
+
+		file.write(reinterpret_cast<const char*>(pixel_data.data()), pixel_data.size());
+		return file.good();
+	}
+
+	bool SoftwareRasterizer::write_light_count_image(const std::filesystem::path& file_path) const
+	{
+		std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			return false;
+		}
+
+		file << "P5\n" << m_internal->m_width << " " << m_internal->m_height << "\n65535\n";
+
+		// PGM stores 16 bit samples as big endian
+		std::vector<uint8_t> pixel_data;
+		pixel_data.reserve(m_internal->m_light_counts.size() * 2);
+		for (const uint32_t current_count : m_internal->m_light_counts)
+		{
+			const uint32_t clamped_count = std::min(current_count, 0xFFFFu);
+			pixel_data.push_back(static_cast<uint8_t>(clamped_count >> 8));
+			pixel_data.push_back(static_cast<uint8_t>(clamped_count & 0xFF));
+		}
+
+		file.write(reinterpret_cast<const char*>(pixel_data.data()), pixel_data.size());
+		return file.good();
+	}
+
+	const SoftwareRasterizerStatistics& SoftwareRasterizer::get_statistics() const
+	{
+		return m_internal->m_statistics;
+	}
+}
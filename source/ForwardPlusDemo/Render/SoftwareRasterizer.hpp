@@ -0,0 +1,51 @@
+#ifndef FORWARDPLUSDEMO_RENDER_SOFTWARERASTERIZER_HPP
+#define FORWARDPLUSDEMO_RENDER_SOFTWARERASTERIZER_HPP
+#include <ForwardPlusDemo/GraphicsAPI/NullDevice.hpp>
+#include <ForwardPlusDemo/Render/VertexFormat.hpp>
+
+#include <filesystem>
+#include <memory>
+namespace ForwardPlusDemo
+{
+	class JobSystem;
+
+	// Totals for the last finished frame
+	struct SoftwareRasterizerStatistics
+	{
+		uint64_t triangle_count = 0; // After clipping & back face culling
+		uint64_t shaded_pixel_count = 0;
+		uint64_t depth_passed_pixel_count = 0; // In submission order, what a GPU with early depth testing would shade
+		uint64_t lights_evaluated = 0; // process_light calls, global lights included
+		uint32_t max_lights_per_pixel = 0;
+	};
+
+	// Tile binned CPU rasterizer for the null device, running a C++ port of Main.hlsl on the same light culling buffers as the GPU
+	// Vertices are shaded as draws are replayed, screen tiles are rasterized & shaded in parallel at the end of the frame
+	// Only the scene pass is supported (triangle lists with the Main.hlsl bindings), anything else is ignored
+	class SoftwareRasterizer : public NullGraphicsPipeline
+	{
+	public:
+		// Bins are rasterized as jobs on the given system, which has to outlive the rasterizer
+		SoftwareRasterizer(uint32_t width, uint32_t height, JobSystem& job_system);
+		~SoftwareRasterizer();
+
+		// Layout of the bound vertex buffer, full float vertices by default
+		void set_vertex_format(VertexFormat format);
+
+		void begin_frame() override;
+		void draw(const NullDrawContext& context) override;
+		void end_frame() override;
+
+		// Binary PPM of the last finished frame
+		bool write_color_image(const std::filesystem::path& file_path) const;
+
+		// 16 bit binary PGM with the number of lights evaluated per pixel
+		bool write_light_count_image(const std::filesystem::path& file_path) const;
+
+		const SoftwareRasterizerStatistics& get_statistics() const;
+	private:
+		struct Internal;
+		std::unique_ptr<Internal> m_internal;
+	};
+}
+#endif
@@ -0,0 +1,103 @@
+#ifndef FORWARDPLUSDEMO_RENDER_TILECULLING_HPP
+#define FORWARDPLUSDEMO_RENDER_TILECULLING_HPP
+#include <ForwardPlusDemo/Render/Math.hpp>
+
+#include <DirectXCollision.h>
+
+#include <algorithm>
+#include <limits>
+namespace ForwardPlusDemo
+{
+	// Screen tile grid & light batching of the tiled culling shaders (TILE_X_DIM, TILE_Y_DIM & LIGHT_BATCH_SIZE)
+	constexpr uint32_t c_tile_x_dim = 32;
+	constexpr uint32_t c_tile_y_dim = 24;
+	constexpr uint32_t c_light_batch_size = 32;
+
+	// Tile the pixel shader reads for a pixel (get_light_culling_data_index in Defines.hlsl), pixel rows go down from the top
+	inline Vector2i get_pixel_tile(const Vector2& pixel_position, const Vector2i& resolution)
+	{
+		const int32_t top_left_x = static_cast<int32_t>(pixel_position.x * c_tile_x_dim / static_cast<float>(resolution.x));
+		const int32_t top_left_y = static_cast<int32_t>(pixel_position.y * c_tile_y_dim / static_cast<float>(resolution.y));
+
+		return Vector2i(std::clamp<int32_t>(top_left_x, 0, c_tile_x_dim - 1), (c_tile_y_dim - 1) - std::clamp<int32_t>(top_left_y, 0, c_tile_y_dim - 1));
+	}
+
+	// Conservative range of screen tiles covered by a bounding sphere, false if it is entirely off screen
+	inline bool get_sphere_tile_range(const DirectX::BoundingSphere& bounds, const XMMatrix& view_projection, Vector2i& tile_min, Vector2i& tile_max)
+	{
+		Vector2 ndc_min(std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity());
+		Vector2 ndc_max(-ndc_min.x, -ndc_min.y);
+
+		// Project the corners of the box around the sphere
+		for (uint32_t current_corner_index = 0; current_corner_index < 8; ++current_corner_index)
+		{
+			const float x = bounds.Center.x + ((current_corner_index & 1) ? bounds.Radius : -bounds.Radius);
+			const float y = bounds.Center.y + ((current_corner_index & 2) ? bounds.Radius : -bounds.Radius);
+			const float z = bounds.Center.z + ((current_corner_index & 4) ? bounds.Radius : -bounds.Radius);
+
+			const XMVector clip_position = DirectX::XMVector4Transform(DirectX::XMVectorSet(x, y, z, 1.0f), view_projection);
+			const float w = DirectX::XMVectorGetW(clip_position);
+			if (w <= 0.0f)
+			{
+				// Crosses the camera plane, assume the whole screen
+				tile_min = Vector2i(0, 0);
+				tile_max = Vector2i(c_tile_x_dim - 1, c_tile_y_dim - 1);
+				return true;
+			}
+
+			const float ndc_x = DirectX::XMVectorGetX(clip_position) / w;
+			const float ndc_y = DirectX::XMVectorGetY(clip_position) / w;
+
+			ndc_min.x = std::fmin(ndc_min.x, ndc_x);
+			ndc_min.y = std::fmin(ndc_min.y, ndc_y);
+			ndc_max.x = std::fmax(ndc_max.x, ndc_x);
+			ndc_max.y = std::fmax(ndc_max.y, ndc_y);
+		}
+
+		if ((ndc_max.x < -1.0f) || (ndc_min.x > 1.0f) || (ndc_max.y < -1.0f) || (ndc_min.y > 1.0f))
+		{
+			return false;
+		}
+
+		// Tiles are indexed from the bottom left corner, same as NDC
+		tile_min.x = std::clamp<int32_t>(static_cast<int32_t>((ndc_min.x * 0.5f + 0.5f) * c_tile_x_dim), 0, c_tile_x_dim - 1);
+		tile_max.x = std::clamp<int32_t>(static_cast<int32_t>((ndc_max.x * 0.5f + 0.5f) * c_tile_x_dim), 0, c_tile_x_dim - 1);
+		tile_min.y = std::clamp<int32_t>(static_cast<int32_t>((ndc_min.y * 0.5f + 0.5f) * c_tile_y_dim), 0, c_tile_y_dim - 1);
+		tile_max.y = std::clamp<int32_t>(static_cast<int32_t>((ndc_max.y * 0.5f + 0.5f) * c_tile_y_dim), 0, c_tile_y_dim - 1);
+
+		return true;
+	}
+
+	// CPU version of TileCulling.hlsl for the light batches [first_batch, end_batch), tests the projected light bounds instead of the tile setup data
+	// Bitmasks are laid out like the shader's, batch_count words per tile, and have to be cleared beforehand
+	// A light batch owns its own bitmask words, so batch ranges can be culled concurrently
+	inline void cull_light_tiles(const DirectX::BoundingSphere* light_bounds, uint32_t light_count, const XMMatrix& view_projection,
+		uint32_t first_batch, uint32_t end_batch, uint32_t* tile_bitmasks)
+	{
+		const uint32_t batch_count = (light_count + c_light_batch_size - 1) / c_light_batch_size;
+
+		const uint32_t light_end = std::min(end_batch * c_light_batch_size, light_count);
+		for (uint32_t current_light_index = first_batch * c_light_batch_size; current_light_index < light_end; ++current_light_index)
+		{
+			Vector2i tile_min;
+			Vector2i tile_max;
+			if (get_sphere_tile_range(light_bounds[current_light_index], view_projection, tile_min, tile_max) == false)
+			{
+				continue;
+			}
+
+			const uint32_t light_batch = current_light_index / c_light_batch_size;
+			const uint32_t light_bit = 1u << (current_light_index % c_light_batch_size);
+
+			for (int32_t tile_y = tile_min.y; tile_y <= tile_max.y; ++tile_y)
+			{
+				for (int32_t tile_x = tile_min.x; tile_x <= tile_max.x; ++tile_x)
+				{
+					const uint32_t tile_flat_index = static_cast<uint32_t>(tile_y) * c_tile_x_dim + static_cast<uint32_t>(tile_x);
+					tile_bitmasks[tile_flat_index * batch_count + light_batch] |= light_bit;
+				}
+			}
+		}
+	}
+}
+#endif
@@ -0,0 +1,198 @@
+#include <ForwardPlusDemo/Render/VertexFormat.hpp>
+
+#include <DirectXPackedVector.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ForwardPlusDemo
+{
+	namespace
+	{
+		constexpr float c_snorm16_scale = 32767.0f;
+
+		template<typename T>
+		const T& get_strided(const T* base, size_t stride, size_t index)
+		{
+			return *reinterpret_cast<const T*>(reinterpret_cast<const char*>(base) + stride * index);
+		}
+
+		// Four normals at once, as X, Y & Z lanes
+		void encode_octahedral_normals(const XMVector& x, const XMVector& y, const XMVector& z, XMVector& encoded_x, XMVector& encoded_y)
+		{
+			const XMVector zero = DirectX::XMVectorZero();
+			const XMVector one = DirectX::XMVectorSplatOne();
+
+			// Project onto the octahedron |x| + |y| + |z| = 1, zero vectors end up as +Z
+			const XMVector abs_sum = DirectX::XMVectorAbs(x) + DirectX::XMVectorAbs(y) + DirectX::XMVectorAbs(z);
+			const XMVector inv_sum = DirectX::XMVectorReciprocal(DirectX::XMVectorMax(abs_sum, DirectX::XMVectorReplicate(1e-20f)));
+
+			const XMVector projected_x = x * inv_sum;
+			const XMVector projected_y = y * inv_sum;
+			const XMVector projected_z = z * inv_sum;
+
+			const XMVector sign_x = DirectX::XMVectorSelect(-one, one, DirectX::XMVectorGreaterOrEqual(projected_x, zero));
+			const XMVector sign_y = DirectX::XMVectorSelect(-one, one, DirectX::XMVectorGreaterOrEqual(projected_y, zero));
+
+			const XMVector folded_x = (one - DirectX::XMVectorAbs(projected_y)) * sign_x;
+			const XMVector folded_y = (one - DirectX::XMVectorAbs(projected_x)) * sign_y;
+
+			const XMVector lower_hemisphere = DirectX::XMVectorLess(projected_z, zero);
+			encoded_x = DirectX::XMVectorSelect(projected_x, folded_x, lower_hemisphere);
+			encoded_y = DirectX::XMVectorSelect(projected_y, folded_y, lower_hemisphere);
+		}
+
+		// Ties to even like the scalar encode_snorm16
+		XMVector to_snorm16(const XMVector& value)
+		{
+			const XMVector clamped = DirectX::XMVectorClamp(value, DirectX::XMVectorNegate(DirectX::XMVectorSplatOne()), DirectX::XMVectorSplatOne());
+			return DirectX::XMVectorRound(clamped * c_snorm16_scale);
+		}
+	}
+
+	bool parse_vertex_format(std::string_view name, VertexFormat& format)
+	{
+		if (name == "full")
+		{
+			format = VertexFormat::FULL;
+		}
+		else if (name == "packed")
+		{
+			format = VertexFormat::PACKED;
+		}
+		else
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	Vector2 encode_octahedral_normal(const XMVector& normal)
+	{
+		XMVector encoded_x;
+		XMVector encoded_y;
+		encode_octahedral_normals(DirectX::XMVectorSplatX(normal), DirectX::XMVectorSplatY(normal), DirectX::XMVectorSplatZ(normal), encoded_x, encoded_y);
+
+		return Vector2(DirectX::XMVectorGetX(encoded_x), DirectX::XMVectorGetX(encoded_y));
+	}
+
+	XMVector decode_octahedral_normal(const Vector2& encoded)
+	{
+		// Matches decode_octahedral_normal in Main.hlsl
+		float x = encoded.x;
+		float y = encoded.y;
+		const float z = 1.0f - std::abs(x) - std::abs(y);
+
+		const float fold = std::max(-z, 0.0f);
+		x += (x >= 0.0f) ? -fold : fold;
+		y += (y >= 0.0f) ? -fold : fold;
+
+		return DirectX::XMVector3Normalize(DirectX::XMVectorSet(x, y, z, 0.0f));
+	}
+
+	int16_t encode_snorm16(float value)
+	{
+		// Default rounding mode, ties to even like XMVectorRound
+		return static_cast<int16_t>(std::nearbyint(std::clamp(value, -1.0f, 1.0f) * c_snorm16_scale));
+	}
+
+	float decode_snorm16(int16_t value)
+	{
+		// Both -32768 and -32767 are -1
+		return std::max(static_cast<float>(value) / c_snorm16_scale, -1.0f);
+	}
+
+	void pack_vertices(const Vector4* positions, const Vector4* normals, size_t stride, size_t count, PackedVertex* output)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		// One stream per component, W is constant
+		for (size_t current_component = 0; current_component < 3; ++current_component)
+		{
+			DirectX::PackedVector::XMConvertFloatToHalfStream(&output[0].position[current_component], sizeof(PackedVertex),
+				&positions[0].x + current_component, stride, count);
+		}
+
+		const DirectX::PackedVector::HALF half_one = DirectX::PackedVector::XMConvertFloatToHalf(1.0f);
+
+		size_t current_vertex = 0;
+		for (; (current_vertex + 4) <= count; current_vertex += 4)
+		{
+			// Transposed so every lane is one normal
+			const XMMatrix normal_rows(
+				DirectX::XMLoadFloat4(&get_strided(normals, stride, current_vertex + 0)),
+				DirectX::XMLoadFloat4(&get_strided(normals, stride, current_vertex + 1)),
+				DirectX::XMLoadFloat4(&get_strided(normals, stride, current_vertex + 2)),
+				DirectX::XMLoadFloat4(&get_strided(normals, stride, current_vertex + 3)));
+			const XMMatrix normal_columns = DirectX::XMMatrixTranspose(normal_rows);
+
+			XMVector encoded_x;
+			XMVector encoded_y;
+			encode_octahedral_normals(normal_columns.r[0], normal_columns.r[1], normal_columns.r[2], encoded_x, encoded_y);
+
+			Vector4 snorm_x;
+			Vector4 snorm_y;
+			DirectX::XMStoreFloat4(&snorm_x, to_snorm16(encoded_x));
+			DirectX::XMStoreFloat4(&snorm_y, to_snorm16(encoded_y));
+
+			const std::array<float, 4> lanes_x = { snorm_x.x, snorm_x.y, snorm_x.z, snorm_x.w };
+			const std::array<float, 4> lanes_y = { snorm_y.x, snorm_y.y, snorm_y.z, snorm_y.w };
+
+			for (size_t current_lane = 0; current_lane < 4; ++current_lane)
+			{
+				PackedVertex& packed = output[current_vertex + current_lane];
+				packed.position[3] = half_one;
+				packed.normal = { static_cast<int16_t>(lanes_x[current_lane]), static_cast<int16_t>(lanes_y[current_lane]) };
+			}
+		}
+
+		for (; current_vertex < count; ++current_vertex)
+		{
+			const Vector2 encoded = encode_octahedral_normal(DirectX::XMLoadFloat4(&get_strided(normals, stride, current_vertex)));
+
+			PackedVertex& packed = output[current_vertex];
+			packed.position[3] = half_one;
+			packed.normal = { encode_snorm16(encoded.x), encode_snorm16(encoded.y) };
+		}
+	}
+
+	void unpack_vertex(const PackedVertex& vertex, Vector4& position, Vector4& normal)
+	{
+		position = Vector4(
+			DirectX::PackedVector::XMConvertHalfToFloat(vertex.position[0]),
+			DirectX::PackedVector::XMConvertHalfToFloat(vertex.position[1]),
+			DirectX::PackedVector::XMConvertHalfToFloat(vertex.position[2]),
+			DirectX::PackedVector::XMConvertHalfToFloat(vertex.position[3]));
+
+		const XMVector decoded_normal = decode_octahedral_normal(Vector2(decode_snorm16(vertex.normal[0]), decode_snorm16(vertex.normal[1])));
+		normal = to_vector4(DirectX::XMVectorSetW(decoded_normal, 0.0f));
+	}
+
+	VertexPackingError get_vertex_packing_error(const Vector4* positions, const Vector4* normals, size_t stride, size_t count, const PackedVertex* packed)
+	{
+		VertexPackingError error;
+
+		for (size_t current_vertex = 0; current_vertex < count; ++current_vertex)
+		{
+			Vector4 position;
+			Vector4 normal;
+			unpack_vertex(packed[current_vertex], position, normal);
+
+			const XMVector position_difference = DirectX::XMLoadFloat4(&position) - DirectX::XMLoadFloat4(&get_strided(positions, stride, current_vertex));
+			error.position = std::max(error.position, DirectX::XMVectorGetX(DirectX::XMVector3Length(position_difference)));
+
+			// atan2 rather than acos of the dot product, which can't resolve angles below ~0.03 degrees in float
+			const XMVector source_normal = DirectX::XMVector3Normalize(DirectX::XMLoadFloat4(&get_strided(normals, stride, current_vertex)));
+			const XMVector packed_normal = DirectX::XMLoadFloat4(&normal);
+			const float sin_angle = DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMVector3Cross(source_normal, packed_normal)));
+			const float cos_angle = DirectX::XMVectorGetX(DirectX::XMVector3Dot(source_normal, packed_normal));
+			error.normal_degrees = std::max(error.normal_degrees, DirectX::XMConvertToDegrees(std::atan2(sin_angle, cos_angle)));
+		}
+
+		return error;
+	}
+}
@@ -0,0 +1,49 @@
+#ifndef FORWARDPLUSDEMO_RENDER_VERTEXFORMAT_HPP
+#define FORWARDPLUSDEMO_RENDER_VERTEXFORMAT_HPP
+#include <ForwardPlusDemo/Render/Math.hpp>
+
+#include <array>
+#include <string_view>
+namespace ForwardPlusDemo
+{
+	enum class VertexFormat : uint32_t
+	{
+		FULL, // Float4 position & normal, 32 bytes
+		PACKED // PackedVertex, 12 bytes
+	};
+
+	bool parse_vertex_format(std::string_view name, VertexFormat& format);
+
+	// Half float position (W is always 1) and an octahedral normal in two SNORM16s, read by the input assembler as
+	// R16G16B16A16_FLOAT & R16G16_SNORM, only the octahedral decode is left to the shader (PACKED_VERTICES in Main.hlsl)
+	struct PackedVertex
+	{
+		std::array<uint16_t, 4> position;
+		std::array<int16_t, 2> normal;
+	};
+
+	static_assert(sizeof(PackedVertex) == 12);
+
+	// Largest differences between the packed vertices and their source
+	struct VertexPackingError
+	{
+		float position = 0.0f;
+		float normal_degrees = 0.0f;
+	};
+
+	// Unit vector to the [-1, 1] square, the lower hemisphere is folded over the diagonals
+	Vector2 encode_octahedral_normal(const XMVector& normal);
+	XMVector decode_octahedral_normal(const Vector2& encoded);
+
+	// Same rounding & decode as D3D SNORM formats
+	int16_t encode_snorm16(float value);
+	float decode_snorm16(int16_t value);
+
+	// Positions & normals are read with the given byte stride, so interleaved vertices can be packed in place
+	// Positions go through DirectXMath's half stream conversion (F16C where available), normals are encoded four lanes wide
+	void pack_vertices(const Vector4* positions, const Vector4* normals, size_t stride, size_t count, PackedVertex* output);
+	void unpack_vertex(const PackedVertex& vertex, Vector4& position, Vector4& normal);
+
+	VertexPackingError get_vertex_packing_error(const Vector4* positions, const Vector4* normals, size_t stride, size_t count, const PackedVertex* packed);
+}
+#endif
@@ -0,0 +1,109 @@
+#include <ForwardPlusDemo/Scene/CameraPath.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace ForwardPlusDemo
+{
+	void CameraPath::add_keyframe(const CameraKeyframe& keyframe)
+	{
+		m_keyframes.push_back(keyframe);
+	}
+
+	CameraKeyframe CameraPath::sample(float time) const
+	{
+		if (m_keyframes.empty())
+		{
+			return CameraKeyframe();
+		}
+
+		if (time <= m_keyframes.front().time)
+		{
+			return m_keyframes.front();
+		}
+
+		if (time >= m_keyframes.back().time)
+		{
+			return m_keyframes.back();
+		}
+
+		// Find the first keyframe after the sample time
+		const auto next_it = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), time, [](float sample_time, const CameraKeyframe& keyframe) { return sample_time < keyframe.time; });
+		const auto prev_it = next_it - 1;
+
+		const float interval = next_it->time - prev_it->time;
+		const float t = (interval > 0.0f) ? ((time - prev_it->time) / interval) : 0.0f;
+
+		CameraKeyframe result;
+		result.time = time;
+		result.position = to_vector3(DirectX::XMVectorLerp(to_xmvector(prev_it->position), to_xmvector(next_it->position), t));
+
+		// Pitch is clamped, so plain lerp is fine, yaw needs to take the shortest path around
+		result.rotation.x = prev_it->rotation.x + (next_it->rotation.x - prev_it->rotation.x) * t;
+		result.rotation.y = clamp_angle(prev_it->rotation.y + clamp_angle(next_it->rotation.y - prev_it->rotation.y) * t);
+
+		return result;
+	}
+
+	bool CameraPath::load(const std::filesystem::path& path)
+	{
+		std::ifstream file(path);
+		if (!file)
+		{
+			return false;
+		}
+
+		clear();
+
+		std::string line;
+		while (std::getline(file, line))
+		{
+			if (line.find_first_not_of(" \t\r") == std::string::npos)
+			{
+				// Empty line
+				continue;
+			}
+
+			// A whole keyframe per line, so a file cut off mid keyframe doesn't load as a shorter path
+			std::istringstream line_stream(line);
+
+			CameraKeyframe keyframe;
+			line_stream >> keyframe.time >> keyframe.position.x >> keyframe.position.y >> keyframe.position.z >> keyframe.rotation.x >> keyframe.rotation.y;
+
+			// sample() searches the times, which only works when they increase (NaN fails the comparison too)
+			if (line_stream.fail() || !std::isfinite(keyframe.time) || (!m_keyframes.empty() && !(keyframe.time > m_keyframes.back().time)))
+			{
+				clear();
+				return false;
+			}
+
+			add_keyframe(keyframe);
+		}
+
+		return true;
+	}
+
+	bool CameraPath::save(const std::filesystem::path& path) const
+	{
+		std::ofstream file(path, std::ios::trunc);
+		if (!file)
+		{
+			return false;
+		}
+
+		// Make sure we can round-trip the floats exactly
+		file.precision(9);
+
+		for (const CameraKeyframe& current_keyframe : m_keyframes)
+		{
+			file << current_keyframe.time << ' '
+				<< current_keyframe.position.x << ' ' << current_keyframe.position.y << ' ' << current_keyframe.position.z << ' '
+				<< current_keyframe.rotation.x << ' ' << current_keyframe.rotation.y << '\n';
+		}
+
+		return file.good();
+	}
+}
\ No newline at end of file
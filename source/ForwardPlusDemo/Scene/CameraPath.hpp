@@ -0,0 +1,38 @@
+#ifndef FORWARDPLUSDEMO_SCENE_CAMERAPATH_HPP
+#define FORWARDPLUSDEMO_SCENE_CAMERAPATH_HPP
+#include <ForwardPlusDemo/Render/Math.hpp>
+
+#include <filesystem>
+#include <vector>
+namespace ForwardPlusDemo
+{
+	struct CameraKeyframe
+	{
+		float time = 0.0f; // Seconds since the start of the path
+		Vector3 position = { 0, 0, 0 };
+		Vector2 rotation = { 0, 0 }; // Pitch & yaw
+	};
+
+	// Recorded camera movement, so benchmark runs can replay the exact same views
+	class CameraPath
+	{
+	public:
+		void clear() { m_keyframes.clear(); }
+		bool is_empty() const { return m_keyframes.empty(); }
+
+		// Keyframes must be added in increasing time order
+		void add_keyframe(const CameraKeyframe& keyframe);
+
+		float get_duration() const { return m_keyframes.empty() ? 0.0f : m_keyframes.back().time; }
+
+		// Interpolates between the surrounding keyframes, clamps outside the recorded range
+		CameraKeyframe sample(float time) const;
+
+		// Text format, one "<time> <x> <y> <z> <pitch> <yaw>" keyframe per line, loading fails unless the times increase
+		bool load(const std::filesystem::path& path);
+		bool save(const std::filesystem::path& path) const;
+	private:
+		std::vector<CameraKeyframe> m_keyframes;
+	};
+}
+#endif
\ No newline at end of file
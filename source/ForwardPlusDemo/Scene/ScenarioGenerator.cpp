@@ -0,0 +1,307 @@
+#include <ForwardPlusDemo/Scene/ScenarioGenerator.hpp>
+
+#include <ForwardPlusDemo/Utilities/Random.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace ForwardPlusDemo
+{
+	namespace
+	{
+		constexpr const char* c_scenario_names[] = {
+			"demo",
+			"grid",
+			"streetlights",
+			"corridor",
+			"behind_camera",
+			"near_plane"
+		};
+
+		static_assert(std::size(c_scenario_names) == static_cast<size_t>(ScenarioType::TYPE_COUNT));
+
+		// Matches the default camera in the render system
+		const Vector3 c_default_camera_position(0.0f, 0.0f, 1.0f);
+
+		Vector3 random_light_color(Random& random)
+		{
+			const float red_component = 1.0f / (1.0f + static_cast<float>(random.next_uint32(10)));
+			const float green_component = 1.0f / (1.0f + static_cast<float>(random.next_uint32(10)));
+			const float blue_component = 1.0f / (1.0f + static_cast<float>(random.next_uint32(10)));
+
+			return Vector3(red_component, green_component, std::max(1.0f - red_component, blue_component));
+		}
+
+		SceneLight make_point_light(Random& random, const Vector3& position, float range)
+		{
+			SceneLight light;
+			light.type = LightType::POINT;
+			light.position = position;
+			light.range = range;
+
+			light.diffuse = random_light_color(random);
+			light.ambient = Vector3(light.diffuse.x * 0.3f, light.diffuse.y * 0.3f, light.diffuse.z * 0.3f);
+
+			return light;
+		}
+
+		SceneLight make_spot_light(Random& random, const Vector3& position, float pitch, float range)
+		{
+			SceneLight light;
+			light.type = LightType::SPOT;
+			light.position = position;
+			light.rotation = Vector3(pitch, 0.0f, 0.0f);
+			light.range = range;
+
+			light.outer_angle = DirectX::XMConvertToRadians(random.next_float(10.0f, 45.0f));
+			light.inner_angle = light.outer_angle * 0.25f;
+
+			light.diffuse = random_light_color(random);
+			light.ambient = Vector3(light.diffuse.x * 0.3f, light.diffuse.y * 0.3f, light.diffuse.z * 0.3f);
+
+			return light;
+		}
+
+		SceneLight make_directional_light(Random& random)
+		{
+			SceneLight light;
+			light.type = LightType::DIRECTIONAL;
+			light.rotation = Vector3(DirectX::XMConvertToRadians(random.next_float(-80.0f, -30.0f)), random.next_float(-DirectX::XM_PI, DirectX::XM_PI), 0.0f);
+
+			// Keep these dim, they light the whole scene
+			const Vector3 color = random_light_color(random);
+			light.diffuse = Vector3(color.x * 0.25f, color.y * 0.25f, color.z * 0.25f);
+
+			return light;
+		}
+
+		// Spot lights point roughly downward, as in the original demo
+		float random_spot_pitch(Random& random)
+		{
+			return random.next_float(DirectX::XMConvertToRadians(-120.0f), DirectX::XMConvertToRadians(-60.0f));
+		}
+
+		SceneLight make_mixed_light(Random& random, const ScenarioParameters& parameters, const Vector3& position, float range)
+		{
+			if (random.next_bool(parameters.spot_ratio))
+			{
+				return make_spot_light(random, position, random_spot_pitch(random), range);
+			}
+
+			return make_point_light(random, position, range);
+		}
+
+		void generate_demo(Random& random, SceneDescription& scene)
+		{
+			constexpr size_t c_light_row_count = 10;
+
+			for (size_t current_row = 0; current_row < c_light_row_count; ++current_row)
+			{
+				const float z = static_cast<float>(current_row) * 10.0f - 50.0f;
+
+				const Vector3 point_position(static_cast<float>(random.next_uint32(10)) * 10.0f - 50.0f, 5.0f, z);
+				scene.add_light(make_point_light(random, point_position, 25.0f));
+
+				const Vector3 spot_position(random.next_float(-50.0f, 50.0f), 5.0f, z);
+				scene.add_light(make_spot_light(random, spot_position, random_spot_pitch(random), 20.0f));
+			}
+		}
+
+		void generate_uniform_grid(Random& random, const ScenarioParameters& parameters, SceneDescription& scene)
+		{
+			const uint32_t side_count = std::max(1u, static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(parameters.light_count)))));
+			const float spacing = parameters.extent / static_cast<float>(side_count);
+			const float half_extent = parameters.extent * 0.5f;
+
+			// Ranges overlap the neighboring cells a bit
+			const float range = std::max(1.0f, spacing * 1.5f);
+
+			for (uint32_t current_light_index = 0; current_light_index < parameters.light_count; ++current_light_index)
+			{
+				const uint32_t x_index = current_light_index % side_count;
+				const uint32_t z_index = current_light_index / side_count;
+
+				const Vector3 position(-half_extent + (static_cast<float>(x_index) + 0.5f) * spacing, 5.0f, -half_extent + (static_cast<float>(z_index) + 0.5f) * spacing);
+				scene.add_light(make_mixed_light(random, parameters, position, range));
+			}
+		}
+
+		void generate_clustered_streetlights(Random& random, const ScenarioParameters& parameters, SceneDescription& scene)
+		{
+			constexpr float c_street_spacing = 20.0f;
+			constexpr uint32_t c_lights_per_pole = 4;
+			constexpr float c_pole_height = 6.0f;
+			constexpr float c_cluster_radius = 1.5f;
+
+			const float half_extent = parameters.extent * 0.5f;
+			const uint32_t street_count = std::max(1u, static_cast<uint32_t>(parameters.extent / c_street_spacing));
+
+			uint32_t remaining_lights = parameters.light_count;
+			while (remaining_lights > 0)
+			{
+				// Place a pole on a random street (alternating between X and Z aligned streets)
+				const float street_offset = -half_extent + (static_cast<float>(random.next_uint32(street_count)) + 0.5f) * c_street_spacing;
+				const float along_street = random.next_float(-half_extent, half_extent);
+				const bool x_aligned = random.next_bool(0.5f);
+
+				const Vector3 pole_position = x_aligned ? Vector3(along_street, c_pole_height, street_offset) : Vector3(street_offset, c_pole_height, along_street);
+
+				const uint32_t cluster_size = std::min(remaining_lights, c_lights_per_pole);
+				for (uint32_t current_light_index = 0; current_light_index < cluster_size; ++current_light_index)
+				{
+					const Vector3 position(pole_position.x + random.next_float(-c_cluster_radius, c_cluster_radius), pole_position.y + random.next_float(-0.5f, 0.5f), pole_position.z + random.next_float(-c_cluster_radius, c_cluster_radius));
+					const float range = random.next_float(10.0f, 15.0f);
+
+					if (random.next_bool(parameters.spot_ratio))
+					{
+						// Streetlights shine (almost) straight down
+						const float pitch = DirectX::XMConvertToRadians(random.next_float(-105.0f, -75.0f));
+						scene.add_light(make_spot_light(random, position, pitch, range));
+					}
+					else
+					{
+						scene.add_light(make_point_light(random, position, range));
+					}
+				}
+
+				remaining_lights -= cluster_size;
+			}
+		}
+
+		void generate_dense_corridor(Random& random, const ScenarioParameters& parameters, SceneDescription& scene)
+		{
+			constexpr float c_corridor_half_width = 2.0f;
+			constexpr float c_corridor_height = 4.0f;
+
+			const float half_extent = parameters.extent * 0.5f;
+
+			for (uint32_t current_light_index = 0; current_light_index < parameters.light_count; ++current_light_index)
+			{
+				const Vector3 position(random.next_float(-c_corridor_half_width, c_corridor_half_width), random.next_float(0.0f, c_corridor_height), random.next_float(-half_extent, half_extent));
+				scene.add_light(make_mixed_light(random, parameters, position, random.next_float(2.0f, 4.0f)));
+			}
+		}
+
+		void generate_behind_camera(Random& random, const ScenarioParameters& parameters, SceneDescription& scene)
+		{
+			constexpr float c_behind_ratio = 0.9f;
+
+			const float half_extent = parameters.extent * 0.5f;
+
+			for (uint32_t current_light_index = 0; current_light_index < parameters.light_count; ++current_light_index)
+			{
+				// Default camera looks down +Z, so "behind" means smaller Z than the camera
+				const bool behind = random.next_bool(c_behind_ratio);
+				const float z = behind ? random.next_float(-half_extent, c_default_camera_position.z) : random.next_float(c_default_camera_position.z, half_extent);
+
+				const Vector3 position(random.next_float(-half_extent, half_extent), random.next_float(1.0f, 10.0f), z);
+				scene.add_light(make_mixed_light(random, parameters, position, random.next_float(5.0f, 15.0f)));
+			}
+		}
+
+		void generate_near_plane(Random& random, const ScenarioParameters& parameters, SceneDescription& scene)
+		{
+			constexpr float c_spread = 1.0f;
+
+			for (uint32_t current_light_index = 0; current_light_index < parameters.light_count; ++current_light_index)
+			{
+				// Cluster around the camera position, with ranges large enough to always cross the near plane
+				const Vector3 position(c_default_camera_position.x + random.next_float(-c_spread, c_spread), c_default_camera_position.y + random.next_float(-c_spread, c_spread), c_default_camera_position.z + random.next_float(-c_spread, c_spread));
+				const float range = random.next_float(c_spread * 1.8f, c_spread * 3.0f);
+
+				if (random.next_bool(parameters.spot_ratio))
+				{
+					SceneLight light = make_spot_light(random, position, random.next_float(-DirectX::XM_PI, DirectX::XM_PI), range);
+					light.rotation.y = random.next_float(-DirectX::XM_PI, DirectX::XM_PI);
+
+					scene.add_light(light);
+				}
+				else
+				{
+					scene.add_light(make_point_light(random, position, range));
+				}
+			}
+		}
+
+		void generate_objects(Random& random, const ScenarioParameters& parameters, SceneDescription& scene)
+		{
+			const float half_extent = parameters.extent * 0.5f;
+
+			for (uint32_t current_object_index = 0; current_object_index < parameters.object_count; ++current_object_index)
+			{
+				const ObjectType type = random.next_bool(0.5f) ? ObjectType::CUBE : ObjectType::PYRAMID;
+				const float scale = random.next_float(0.5f, 3.0f);
+				const float yaw = random.next_float(-DirectX::XM_PI, DirectX::XM_PI);
+
+				// Resting on the ground plane
+				const XMMatrix model = DirectX::XMMatrixScaling(scale, scale, scale)
+					* DirectX::XMMatrixRotationRollPitchYaw(0.0f, yaw, 0.0f)
+					* DirectX::XMMatrixTranslation(random.next_float(-half_extent, half_extent), scale * 0.5f, random.next_float(-half_extent, half_extent));
+
+				const Vector4 diffuse(random.next_float(), random.next_float(), random.next_float(), 1.0f);
+				scene.add_object(type, to_matrix4(model), diffuse, Vector4(1.0f, 1.0f, 1.0f, 1.0f));
+			}
+		}
+	}
+
+	void generate_scenario(const ScenarioParameters& parameters, SceneDescription& scene)
+	{
+		Random random(parameters.seed, static_cast<uint64_t>(parameters.type));
+
+		scene.reserve_lights(scene.get_light_count() + parameters.light_count + parameters.directional_light_count);
+
+		switch (parameters.type)
+		{
+		case ScenarioType::DEMO:
+			generate_demo(random, scene);
+			break;
+		case ScenarioType::UNIFORM_GRID:
+			generate_uniform_grid(random, parameters, scene);
+			break;
+		case ScenarioType::CLUSTERED_STREETLIGHTS:
+			generate_clustered_streetlights(random, parameters, scene);
+			break;
+		case ScenarioType::DENSE_CORRIDOR:
+			generate_dense_corridor(random, parameters, scene);
+			break;
+		case ScenarioType::BEHIND_CAMERA:
+			generate_behind_camera(random, parameters, scene);
+			break;
+		case ScenarioType::NEAR_PLANE:
+			generate_near_plane(random, parameters, scene);
+			break;
+		case ScenarioType::TYPE_COUNT:
+			// Not a scenario, listed so a new scenario without a case still warns
+			break;
+		}
+
+		for (uint32_t current_light_index = 0; current_light_index < parameters.directional_light_count; ++current_light_index)
+		{
+			scene.add_light(make_directional_light(random));
+		}
+
+		// Generated last, so the lights stay the same with or without objects
+		scene.reserve_objects(scene.get_object_count() + parameters.object_count);
+		generate_objects(random, parameters, scene);
+	}
+
+	const char* get_scenario_name(ScenarioType type)
+	{
+		return c_scenario_names[static_cast<size_t>(type)];
+	}
+
+	bool parse_scenario_type(std::string_view name, ScenarioType& type)
+	{
+		for (size_t current_type_index = 0; current_type_index < static_cast<size_t>(ScenarioType::TYPE_COUNT); ++current_type_index)
+		{
+			if (name == c_scenario_names[current_type_index])
+			{
+				type = static_cast<ScenarioType>(current_type_index);
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef FORWARDPLUSDEMO_SCENE_SCENARIOGENERATOR_HPP
+#define FORWARDPLUSDEMO_SCENE_SCENARIOGENERATOR_HPP
+#include <ForwardPlusDemo/Scene/SceneDescription.hpp>
+
+#include <string_view>
+namespace ForwardPlusDemo
+{
+	enum class ScenarioType
+	{
+		DEMO, // The original demo layout (10 point and 10 spot lights)
+		UNIFORM_GRID,
+		CLUSTERED_STREETLIGHTS,
+		DENSE_CORRIDOR,
+		BEHIND_CAMERA, // Most lights behind the default camera
+		NEAR_PLANE, // Lights intersecting the near plane of the default camera
+		TYPE_COUNT
+	};
+
+	struct ScenarioParameters
+	{
+		ScenarioType type = ScenarioType::DEMO;
+		uint64_t seed = 1;
+
+		uint32_t light_count = 20; // Ignored by the demo scenario
+		float spot_ratio = 0.5f; // Fraction of spot lights, the rest are point lights
+		float extent = 100.0f; // Size of the square area (centered on the origin) the lights are placed in
+		uint32_t directional_light_count = 0; // Added on top of the scenario lights
+		uint32_t object_count = 0; // Cubes & pyramids scattered over the same area, replacing the built-in objects when non-zero
+	};
+
+	// Same parameters always give the same scene, regardless of platform
+	void generate_scenario(const ScenarioParameters& parameters, SceneDescription& scene);
+
+	const char* get_scenario_name(ScenarioType type);
+	bool parse_scenario_type(std::string_view name, ScenarioType& type);
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,360 @@
+#include <ForwardPlusDemo/Scene/SceneDescription.hpp>
+
+#include <ForwardPlusDemo/Scene/SceneFile.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace ForwardPlusDemo
+{
+	namespace
+	{
+		Vector3 get_default_light_ambient(const Vector3& diffuse)
+		{
+			return Vector3(diffuse.x * 0.3f, diffuse.y * 0.3f, diffuse.z * 0.3f);
+		}
+
+		bool parse_object_type(const std::string& name, ObjectType& type)
+		{
+			if (name == "cube")
+			{
+				type = ObjectType::CUBE;
+			}
+			else if (name == "pyramid")
+			{
+				type = ObjectType::PYRAMID;
+			}
+			else if (name == "plane")
+			{
+				type = ObjectType::PLANE;
+			}
+			else
+			{
+				return false;
+			}
+
+			return true;
+		}
+
+		bool parse_light(std::istringstream& line_stream, SceneLight& light)
+		{
+			std::string type_name;
+			line_stream >> type_name;
+
+			if (type_name == "point")
+			{
+				light.type = LightType::POINT;
+				line_stream >> light.position.x >> light.position.y >> light.position.z >> light.range;
+			}
+			else if (type_name == "spot")
+			{
+				light.type = LightType::SPOT;
+
+				Vector3 rotation_degrees;
+				float outer_angle_degrees;
+				float inner_angle_degrees;
+				line_stream >> light.position.x >> light.position.y >> light.position.z;
+				line_stream >> rotation_degrees.x >> rotation_degrees.y >> rotation_degrees.z;
+				line_stream >> light.range >> outer_angle_degrees >> inner_angle_degrees;
+
+				light.rotation = Vector3(DirectX::XMConvertToRadians(rotation_degrees.x), DirectX::XMConvertToRadians(rotation_degrees.y), DirectX::XMConvertToRadians(rotation_degrees.z));
+				light.outer_angle = DirectX::XMConvertToRadians(outer_angle_degrees);
+				light.inner_angle = DirectX::XMConvertToRadians(inner_angle_degrees);
+			}
+			else if (type_name == "directional")
+			{
+				light.type = LightType::DIRECTIONAL;
+
+				Vector3 rotation_degrees;
+				line_stream >> rotation_degrees.x >> rotation_degrees.y >> rotation_degrees.z;
+				light.rotation = Vector3(DirectX::XMConvertToRadians(rotation_degrees.x), DirectX::XMConvertToRadians(rotation_degrees.y), DirectX::XMConvertToRadians(rotation_degrees.z));
+			}
+			else
+			{
+				return false;
+			}
+
+			line_stream >> light.diffuse.x >> light.diffuse.y >> light.diffuse.z;
+			light.ambient = get_default_light_ambient(light.diffuse);
+
+			return !line_stream.fail();
+		}
+
+		bool parse_object(std::istringstream& line_stream, SceneDescription& scene)
+		{
+			std::string type_name;
+			line_stream >> type_name;
+
+			ObjectType type;
+			if (!parse_object_type(type_name, type))
+			{
+				return false;
+			}
+
+			Vector3 position;
+			Vector3 rotation_degrees;
+			Vector3 scale;
+			Vector3 color;
+			line_stream >> position.x >> position.y >> position.z;
+			line_stream >> rotation_degrees.x >> rotation_degrees.y >> rotation_degrees.z;
+			line_stream >> scale.x >> scale.y >> scale.z;
+			line_stream >> color.x >> color.y >> color.z;
+
+			if (line_stream.fail())
+			{
+				return false;
+			}
+
+			const XMMatrix model = DirectX::XMMatrixScaling(scale.x, scale.y, scale.z)
+				* DirectX::XMMatrixRotationRollPitchYaw(DirectX::XMConvertToRadians(rotation_degrees.x), DirectX::XMConvertToRadians(rotation_degrees.y), DirectX::XMConvertToRadians(rotation_degrees.z))
+				* DirectX::XMMatrixTranslation(position.x, position.y, position.z);
+
+			scene.add_object(type, to_matrix4(model), Vector4(color.x, color.y, color.z, 1.0f), Vector4(1.0f, 1.0f, 1.0f, 1.0f));
+			return true;
+		}
+
+		template<typename T>
+		SceneFileFormat::SectionEntry make_section(SceneFileFormat::SectionId id, const std::vector<T>& column)
+		{
+			SceneFileFormat::SectionEntry section;
+			section.id = static_cast<uint32_t>(id);
+			section.element_size = sizeof(T);
+			section.size = static_cast<uint64_t>(column.size()) * sizeof(T);
+
+			return section;
+		}
+
+		uint64_t align_offset(uint64_t offset)
+		{
+			constexpr uint64_t c_alignment = SceneFileFormat::c_section_alignment;
+			return (offset + (c_alignment - 1)) & ~(c_alignment - 1);
+		}
+	}
+
+	SceneLight SceneLightView::get_light(size_t index) const
+	{
+		SceneLight light;
+		light.type = static_cast<LightType>(types[index]);
+		light.position = positions[index];
+		light.rotation = rotations[index];
+		light.range = ranges[index];
+		light.outer_angle = outer_angles[index];
+		light.inner_angle = inner_angles[index];
+		light.linear_attenuation = linear_attenuations[index];
+		light.diffuse = diffuse[index];
+		light.ambient = ambient[index];
+
+		return light;
+	}
+
+	void SceneDescription::clear()
+	{
+		m_light_types.clear();
+		m_light_positions.clear();
+		m_light_rotations.clear();
+		m_light_ranges.clear();
+		m_light_outer_angles.clear();
+		m_light_inner_angles.clear();
+		m_light_linear_attenuations.clear();
+		m_light_diffuse.clear();
+		m_light_ambient.clear();
+
+		m_objects.clear();
+	}
+
+	void SceneDescription::reserve_lights(size_t count)
+	{
+		m_light_types.reserve(count);
+		m_light_positions.reserve(count);
+		m_light_rotations.reserve(count);
+		m_light_ranges.reserve(count);
+		m_light_outer_angles.reserve(count);
+		m_light_inner_angles.reserve(count);
+		m_light_linear_attenuations.reserve(count);
+		m_light_diffuse.reserve(count);
+		m_light_ambient.reserve(count);
+	}
+
+	void SceneDescription::add_light(const SceneLight& light)
+	{
+		m_light_types.push_back(static_cast<uint32_t>(light.type));
+		m_light_positions.push_back(light.position);
+		m_light_rotations.push_back(light.rotation);
+		m_light_ranges.push_back(light.range);
+		m_light_outer_angles.push_back(light.outer_angle);
+		m_light_inner_angles.push_back(light.inner_angle);
+		m_light_linear_attenuations.push_back(light.linear_attenuation);
+		m_light_diffuse.push_back(light.diffuse);
+		m_light_ambient.push_back(light.ambient);
+	}
+
+	void SceneDescription::reserve_objects(size_t count)
+	{
+		m_objects.reserve(count);
+	}
+
+	void SceneDescription::add_object(ObjectType type, const Matrix4& model, const Vector4& diffuse, const Vector4& ambient)
+	{
+		SceneObjectRecord record;
+		record.type = static_cast<uint32_t>(type);
+		record.model = model;
+		record.diffuse = diffuse;
+		record.ambient = ambient;
+
+		m_objects.push_back(record);
+	}
+
+	SceneLightView SceneDescription::get_light_view() const
+	{
+		SceneLightView view;
+		view.count = m_light_types.size();
+		view.types = m_light_types.data();
+		view.positions = m_light_positions.data();
+		view.rotations = m_light_rotations.data();
+		view.ranges = m_light_ranges.data();
+		view.outer_angles = m_light_outer_angles.data();
+		view.inner_angles = m_light_inner_angles.data();
+		view.linear_attenuations = m_light_linear_attenuations.data();
+		view.diffuse = m_light_diffuse.data();
+		view.ambient = m_light_ambient.data();
+
+		return view;
+	}
+
+	SceneObjectView SceneDescription::get_object_view() const
+	{
+		SceneObjectView view;
+		view.count = m_objects.size();
+		view.records = m_objects.data();
+
+		return view;
+	}
+
+	// Syntax (one entry per line, angles in degrees, '#' starts a comment):
+	// light point <x> <y> <z> <range> <r> <g> <b>
+	// light spot <x> <y> <z> <pitch> <yaw> <roll> <range> <outer angle> <inner angle> <r> <g> <b>
+	// light directional <pitch> <yaw> <roll> <r> <g> <b>
+	// object <cube|pyramid|plane> <x> <y> <z> <pitch> <yaw> <roll> <scale x> <scale y> <scale z> <r> <g> <b>
+	bool SceneDescription::load_text(const std::filesystem::path& path)
+	{
+		std::ifstream file(path);
+		if (!file)
+		{
+			return false;
+		}
+
+		clear();
+
+		std::string line;
+		while (std::getline(file, line))
+		{
+			const size_t comment_start = line.find('#');
+			if (comment_start != std::string::npos)
+			{
+				line.resize(comment_start);
+			}
+
+			std::istringstream line_stream(line);
+
+			std::string entry_type;
+			if (!(line_stream >> entry_type))
+			{
+				// Empty line
+				continue;
+			}
+
+			if (entry_type == "light")
+			{
+				SceneLight light;
+				if (!parse_light(line_stream, light))
+				{
+					return false;
+				}
+
+				add_light(light);
+			}
+			else if (entry_type == "object")
+			{
+				if (!parse_object(line_stream, *this))
+				{
+					return false;
+				}
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool SceneDescription::write_binary(const std::filesystem::path& path) const
+	{
+		using namespace SceneFileFormat;
+
+		std::vector<SectionEntry> sections;
+		std::vector<const void*> section_data;
+
+		auto add_section = [&sections, &section_data](SectionId id, const auto& column)
+		{
+			if (column.empty())
+			{
+				return;
+			}
+
+			sections.push_back(make_section(id, column));
+			section_data.push_back(column.data());
+		};
+
+		add_section(SectionId::LIGHT_TYPES, m_light_types);
+		add_section(SectionId::LIGHT_POSITIONS, m_light_positions);
+		add_section(SectionId::LIGHT_ROTATIONS, m_light_rotations);
+		add_section(SectionId::LIGHT_RANGES, m_light_ranges);
+		add_section(SectionId::LIGHT_OUTER_ANGLES, m_light_outer_angles);
+		add_section(SectionId::LIGHT_INNER_ANGLES, m_light_inner_angles);
+		add_section(SectionId::LIGHT_LINEAR_ATTENUATIONS, m_light_linear_attenuations);
+		add_section(SectionId::LIGHT_DIFFUSE, m_light_diffuse);
+		add_section(SectionId::LIGHT_AMBIENT, m_light_ambient);
+		add_section(SectionId::OBJECT_RECORDS, m_objects);
+
+		Header header;
+		header.section_count = static_cast<uint32_t>(sections.size());
+		header.light_count = m_light_types.size();
+		header.object_count = m_objects.size();
+
+		// Lay out the sections after the header and section table
+		uint64_t current_offset = sizeof(Header) + (sections.size() * sizeof(SectionEntry));
+		for (SectionEntry& current_section : sections)
+		{
+			current_offset = align_offset(current_offset);
+			current_section.offset = current_offset;
+			current_offset += current_section.size;
+		}
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			return false;
+		}
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		file.write(reinterpret_cast<const char*>(sections.data()), sections.size() * sizeof(SectionEntry));
+
+		constexpr char c_padding[c_section_alignment] = {};
+		uint64_t written_size = sizeof(Header) + (sections.size() * sizeof(SectionEntry));
+
+		auto data_it = section_data.begin();
+		for (const SectionEntry& current_section : sections)
+		{
+			file.write(c_padding, static_cast<std::streamsize>(current_section.offset - written_size));
+			file.write(static_cast<const char*>(*data_it), static_cast<std::streamsize>(current_section.size));
+
+			written_size = current_section.offset + current_section.size;
+			++data_it;
+		}
+
+		return file.good();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#ifndef FORWARDPLUSDEMO_SCENE_SCENEDESCRIPTION_HPP
+#define FORWARDPLUSDEMO_SCENE_SCENEDESCRIPTION_HPP
+#include <ForwardPlusDemo/Render/LightSystem.hpp>
+#include <ForwardPlusDemo/Render/RenderSystem.hpp>
+#include <ForwardPlusDemo/Render/Math.hpp>
+
+#include <filesystem>
+#include <vector>
+namespace ForwardPlusDemo
+{
+	struct SceneLight
+	{
+		LightType type = LightType::POINT;
+
+		Vector3 position = { 0, 0, 0 };
+		Vector3 rotation = { 0, 0, 0 }; // Pitch, yaw & roll (radians)
+
+		float range = 0.0f;
+		float outer_angle = 0.0f;
+		float inner_angle = 0.0f;
+		float linear_attenuation = 0.0f;
+
+		Vector3 diffuse = { 0, 0, 0 };
+		Vector3 ambient = { 0, 0, 0 };
+	};
+
+	// NOTE: stored as-is in the binary scene file, so the layout must stay fixed (see SceneFile.hpp)
+	struct alignas(16) SceneObjectRecord
+	{
+		uint32_t type = static_cast<uint32_t>(ObjectType::CUBE);
+		uint32_t _padding[3] = { 0, 0, 0 };
+
+		Matrix4 model;
+
+		Vector4 diffuse = { 0, 0, 0, 0 };
+		Vector4 ambient = { 0, 0, 0, 0 };
+	};
+
+	static_assert(sizeof(SceneObjectRecord) == 112);
+
+	// Non-owning SoA view over the light columns (either from a SceneDescription or a mapped SceneFile)
+	struct SceneLightView
+	{
+		size_t count = 0;
+
+		const uint32_t* types = nullptr;
+		const Vector3* positions = nullptr;
+		const Vector3* rotations = nullptr;
+		const float* ranges = nullptr;
+		const float* outer_angles = nullptr;
+		const float* inner_angles = nullptr;
+		const float* linear_attenuations = nullptr;
+		const Vector3* diffuse = nullptr;
+		const Vector3* ambient = nullptr;
+
+		SceneLight get_light(size_t index) const;
+	};
+
+	struct SceneObjectView
+	{
+		size_t count = 0;
+		const SceneObjectRecord* records = nullptr;
+	};
+
+	// Owning, editable scene contents (used to build scenes and write the binary format)
+	class SceneDescription
+	{
+	public:
+		void clear();
+		void reserve_lights(size_t count);
+		void reserve_objects(size_t count);
+
+		void add_light(const SceneLight& light);
+		void add_object(ObjectType type, const Matrix4& model, const Vector4& diffuse, const Vector4& ambient);
+
+		size_t get_light_count() const { return m_light_types.size(); }
+		size_t get_object_count() const { return m_objects.size(); }
+
+		SceneLightView get_light_view() const;
+		SceneObjectView get_object_view() const;
+
+		// Line-based text description, see SceneDescription.cpp for the syntax
+		bool load_text(const std::filesystem::path& path);
+		bool write_binary(const std::filesystem::path& path) const;
+	private:
+		std::vector<uint32_t> m_light_types;
+		std::vector<Vector3> m_light_positions;
+		std::vector<Vector3> m_light_rotations;
+		std::vector<float> m_light_ranges;
+		std::vector<float> m_light_outer_angles;
+		std::vector<float> m_light_inner_angles;
+		std::vector<float> m_light_linear_attenuations;
+		std::vector<Vector3> m_light_diffuse;
+		std::vector<Vector3> m_light_ambient;
+
+		std::vector<SceneObjectRecord> m_objects;
+	};
+}
+#endif
\ No newline at end of file
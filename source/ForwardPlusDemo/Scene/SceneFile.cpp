@@ -0,0 +1,153 @@
+#include <ForwardPlusDemo/Scene/SceneFile.hpp>
+
+#include <array>
+#include <bit>
+
+namespace ForwardPlusDemo
+{
+	static_assert(std::endian::native == std::endian::little, "Scene files are mapped in place, which requires a little-endian host");
+
+	bool SceneFile::open(const std::filesystem::path& path)
+	{
+		using namespace SceneFileFormat;
+
+		close();
+
+		if (!m_file.open(path))
+		{
+			return false;
+		}
+
+		if (m_file.get_size() < sizeof(Header))
+		{
+			close();
+			return false;
+		}
+
+		const Header* header = reinterpret_cast<const Header*>(m_file.get_data());
+		if ((header->magic != c_magic) || (header->version != c_version) || (header->endian_tag != c_endian_tag))
+		{
+			close();
+			return false;
+		}
+
+		const uint64_t section_table_end = sizeof(Header) + (static_cast<uint64_t>(header->section_count) * sizeof(SectionEntry));
+		if (section_table_end > m_file.get_size())
+		{
+			close();
+			return false;
+		}
+
+		// Gather the sections we know about (unknown ones are skipped so newer writers can append data)
+		std::array<const SectionEntry*, static_cast<size_t>(SectionId::SECTION_COUNT)> sections = {};
+
+		const SectionEntry* section_table = reinterpret_cast<const SectionEntry*>(m_file.get_data() + sizeof(Header));
+		for (uint32_t section_index = 0; section_index < header->section_count; ++section_index)
+		{
+			const SectionEntry& current_section = section_table[section_index];
+			if (current_section.id < static_cast<uint32_t>(SectionId::SECTION_COUNT))
+			{
+				sections[current_section.id] = &current_section;
+			}
+		}
+
+		auto get_column = [this, &sections](SectionId id, uint32_t element_size, uint64_t element_count) -> const void*
+		{
+			const SectionEntry* section = sections[static_cast<size_t>(id)];
+			if (section == nullptr)
+			{
+				return nullptr;
+			}
+
+			return get_section_data(*section, element_size, element_count);
+		};
+
+		// Lights
+		if (header->light_count > 0)
+		{
+			const uint64_t light_count = header->light_count;
+
+			m_lights.count = static_cast<size_t>(light_count);
+			m_lights.types = static_cast<const uint32_t*>(get_column(SectionId::LIGHT_TYPES, sizeof(uint32_t), light_count));
+			m_lights.positions = static_cast<const Vector3*>(get_column(SectionId::LIGHT_POSITIONS, sizeof(Vector3), light_count));
+			m_lights.rotations = static_cast<const Vector3*>(get_column(SectionId::LIGHT_ROTATIONS, sizeof(Vector3), light_count));
+			m_lights.ranges = static_cast<const float*>(get_column(SectionId::LIGHT_RANGES, sizeof(float), light_count));
+			m_lights.outer_angles = static_cast<const float*>(get_column(SectionId::LIGHT_OUTER_ANGLES, sizeof(float), light_count));
+			m_lights.inner_angles = static_cast<const float*>(get_column(SectionId::LIGHT_INNER_ANGLES, sizeof(float), light_count));
+			m_lights.linear_attenuations = static_cast<const float*>(get_column(SectionId::LIGHT_LINEAR_ATTENUATIONS, sizeof(float), light_count));
+			m_lights.diffuse = static_cast<const Vector3*>(get_column(SectionId::LIGHT_DIFFUSE, sizeof(Vector3), light_count));
+			m_lights.ambient = static_cast<const Vector3*>(get_column(SectionId::LIGHT_AMBIENT, sizeof(Vector3), light_count));
+
+			if (!m_lights.types || !m_lights.positions || !m_lights.rotations || !m_lights.ranges || !m_lights.outer_angles
+				|| !m_lights.inner_angles || !m_lights.linear_attenuations || !m_lights.diffuse || !m_lights.ambient)
+			{
+				close();
+				return false;
+			}
+
+			// The types index per type arrays in the light system, so a corrupt file must not get past here
+			for (size_t current_light_index = 0; current_light_index < m_lights.count; ++current_light_index)
+			{
+				if (m_lights.types[current_light_index] >= static_cast<uint32_t>(LightType::TYPE_COUNT))
+				{
+					close();
+					return false;
+				}
+			}
+		}
+
+		// Objects
+		if (header->object_count > 0)
+		{
+			m_objects.count = static_cast<size_t>(header->object_count);
+			m_objects.records = static_cast<const SceneObjectRecord*>(get_column(SectionId::OBJECT_RECORDS, sizeof(SceneObjectRecord), header->object_count));
+			if (!m_objects.records)
+			{
+				close();
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void SceneFile::close()
+	{
+		m_file.close();
+
+		m_lights = SceneLightView();
+		m_objects = SceneObjectView();
+	}
+
+	const void* SceneFile::get_section_data(const SceneFileFormat::SectionEntry& section, uint32_t element_size, uint64_t element_count) const
+	{
+		// Validate against the layout we expect, so a malformed file cannot make us read past the mapping
+		if (section.element_size != element_size)
+		{
+			return nullptr;
+		}
+
+		if ((section.offset % SceneFileFormat::c_section_alignment) != 0)
+		{
+			return nullptr;
+		}
+
+		// Checked before the multiplication below, which could otherwise wrap around for huge counts
+		if (element_count > (m_file.get_size() / element_size))
+		{
+			return nullptr;
+		}
+
+		if (section.size != (static_cast<uint64_t>(element_size) * element_count))
+		{
+			return nullptr;
+		}
+
+		if ((section.offset > m_file.get_size()) || (section.size > (m_file.get_size() - section.offset)))
+		{
+			return nullptr;
+		}
+
+		return m_file.get_data() + section.offset;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef FORWARDPLUSDEMO_SCENE_SCENEFILE_HPP
+#define FORWARDPLUSDEMO_SCENE_SCENEFILE_HPP
+#include <ForwardPlusDemo/Scene/SceneDescription.hpp>
+#include <ForwardPlusDemo/Utilities/MappedFile.hpp>
+namespace ForwardPlusDemo
+{
+	// Binary scene layout (little-endian):
+	// [Header][SectionEntry * section_count][padding][section data, each starting on a c_section_alignment boundary]
+	// Each light attribute is its own section (SoA), so the columns can be used directly from the mapped file
+	namespace SceneFileFormat
+	{
+		constexpr uint32_t c_magic = 0x43535046; // "FPSC"
+		constexpr uint32_t c_version = 1;
+		constexpr uint32_t c_endian_tag = 0x01020304;
+		constexpr uint64_t c_section_alignment = 64;
+
+		enum class SectionId : uint32_t
+		{
+			LIGHT_TYPES,
+			LIGHT_POSITIONS,
+			LIGHT_ROTATIONS,
+			LIGHT_RANGES,
+			LIGHT_OUTER_ANGLES,
+			LIGHT_INNER_ANGLES,
+			LIGHT_LINEAR_ATTENUATIONS,
+			LIGHT_DIFFUSE,
+			LIGHT_AMBIENT,
+			OBJECT_RECORDS,
+			SECTION_COUNT
+		};
+
+		struct Header
+		{
+			uint32_t magic = c_magic;
+			uint32_t version = c_version;
+			uint32_t endian_tag = c_endian_tag;
+			uint32_t section_count = 0;
+
+			uint64_t light_count = 0;
+			uint64_t object_count = 0;
+		};
+
+		struct SectionEntry
+		{
+			uint32_t id = 0;
+			uint32_t element_size = 0;
+			uint64_t offset = 0; // From the start of the file
+			uint64_t size = 0; // In bytes
+		};
+
+		static_assert(sizeof(Header) == 32);
+		static_assert(sizeof(SectionEntry) == 24);
+	}
+
+	// Read-only scene backed by a memory mapped binary scene file
+	class SceneFile
+	{
+	public:
+		bool open(const std::filesystem::path& path);
+		void close();
+
+		bool is_open() const { return m_file.is_open(); }
+
+		const SceneLightView& get_light_view() const { return m_lights; }
+		const SceneObjectView& get_object_view() const { return m_objects; }
+	private:
+		const void* get_section_data(const SceneFileFormat::SectionEntry& section, uint32_t element_size, uint64_t element_count) const;
+
+		MappedFile m_file;
+
+		SceneLightView m_lights;
+		SceneObjectView m_objects;
+	};
+}
+#endif
\ No newline at end of file
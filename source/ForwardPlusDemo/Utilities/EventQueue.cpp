@@ -1,60 +1,67 @@
 #include <ForwardPlusDemo/Utilities/EventQueue.hpp>
 
+#include <cstring>
+
 namespace ForwardPlusDemo
 {
-	char* EventQueue::allocate_raw_data(uint32_t id, size_t size)
+	void EventQueue::clear()
 	{
+		for (size_t current_chunk = 0; current_chunk < m_chunk_count; ++current_chunk)
 		{
-			Header event_header;
-			event_header.event_id = id;
-			event_header.data_size = static_cast<uint32_t>(size);
-
-			const char* header_begin = reinterpret_cast<const char*>(&event_header);
-			const char* header_end = header_begin + sizeof(Header);
-			m_data.insert(m_data.end(), header_begin, header_end);
+			m_chunks[current_chunk].used_size = 0;
 		}
 
-		const size_t data_offset = m_data.size();
-		m_data.insert(m_data.end(), size, char(0));
-		return m_data.data() + data_offset;
+		m_chunk_count = 0;
+		m_size = 0;
 	}
 
-	EventDoubleBuffer::EventDoubleBuffer()
+	char* EventQueue::allocate_raw_data(uint32_t id, size_t size)
 	{
-		m_read_queue = &m_queues[0];
-		m_write_queue = &m_queues[1];
+		char* data_ptr = allocate_record(id, size, c_event_alignment);
+		std::memset(data_ptr, 0, size);
+		return data_ptr;
 	}
 
-	void EventDoubleBuffer::dispatch_write()
+	char* EventQueue::allocate_record_in_next_chunk(uint32_t id, size_t size, size_t alignment)
 	{
-		if (m_signal == true)
-		{
-			// Read thread still reading
-			return;
-		}
-
-		if (m_write_queue->is_empty() == true)
+		// Reuse the next spare chunk when it is big enough, events bigger than a chunk get one of their own
+		const size_t data_offset = get_data_offset(0, alignment);
+		const size_t required_size = data_offset + size;
+		if ((m_chunk_count == m_chunks.size()) || (m_chunks[m_chunk_count].get_capacity() < required_size))
 		{
-			// Nothing to dispatch
-			return;
+			Chunk new_chunk;
+			new_chunk.blocks.resize(align_up(std::max(required_size, c_chunk_size), sizeof(Block)) / sizeof(Block));
+			m_chunks.insert(m_chunks.begin() + m_chunk_count, std::move(new_chunk));
 		}
 
-		// Swap buffers
-		EventQueue* read_queue = m_read_queue;
-		m_read_queue = m_write_queue;
-		m_write_queue = read_queue;
+		Chunk& chunk = m_chunks[m_chunk_count];
+		++m_chunk_count;
 
-		m_write_queue->clear();
+		return write_record(chunk, id, size, data_offset);
+	}
 
-		// Set the signal
-		m_signal = true;
+	EventQueue::Iterator::Iterator(const EventQueue& queue)
+		: m_queue(&queue)
+	{
+		skip_empty_chunks();
 	}
 
-	void EventDoubleBuffer::finish_read()
+	void EventQueue::Iterator::skip_empty_chunks()
 	{
-		if (m_signal == true)
+		while ((m_chunk_index < m_queue->m_chunk_count) && (m_queue->m_chunks[m_chunk_index].used_size == 0))
+		{
+			++m_chunk_index;
+		}
+
+		if (m_chunk_index == m_queue->m_chunk_count)
 		{
-			m_signal = false;
+			m_record = nullptr;
+			m_chunk_end = nullptr;
+			return;
 		}
+
+		const Chunk& chunk = m_queue->m_chunks[m_chunk_index];
+		m_record = chunk.get_data();
+		m_chunk_end = m_record + chunk.used_size;
 	}
-}
\ No newline at end of file
+}
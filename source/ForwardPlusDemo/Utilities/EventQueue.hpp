@@ -1,94 +1,154 @@
 #ifndef FORWARDPLUSDEMO_UTILITIES_EVENTQUEUE_HPP
 #define FORWARDPLUSDEMO_UTILITIES_EVENTQUEUE_HPP
-#include <array>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
 #include <vector>
-#include <atomic>
 namespace ForwardPlusDemo
 {
+	// Events are written into fixed size chunks, so they never move once allocated (unlike a growing vector)
+	// clear() keeps the chunks for the next batch of events, nothing is allocated once the queue has warmed up
 	class EventQueue
 	{
 	public:
-		using Buffer = std::vector<char>;
-		using BufferIterator = Buffer::const_iterator;
+		// Event data is at least this aligned, events with XMVECTOR members can be used in place
+		static constexpr size_t c_event_alignment = 16;
+		static constexpr size_t c_max_event_alignment = 64;
 
 		struct Header
 		{
 			uint32_t event_id;
 			uint32_t data_size;
-			// TODO: anything else?
+			uint32_t data_offset; // From the start of the header, depends on the alignment of the event
 		};
 
-		bool is_empty() const { return m_data.empty(); }
-		size_t get_size() const { return m_data.size(); }
+		bool is_empty() const { return m_size == 0; }
+		size_t get_size() const { return m_size; } // Bytes used, headers & alignment included
 
-		void clear() { m_data.clear(); }
+		void clear();
 
 		template<typename T>
 		T* allocate_event(uint32_t id)
 		{
 			static_assert(std::is_trivially_copyable_v<T>);
-			char* data_ptr = allocate_raw_data(id, sizeof(T));
-			return new(data_ptr)T;
+			static_assert(alignof(T) <= c_max_event_alignment);
+			char* data_ptr = allocate_record(id, sizeof(T), std::max(alignof(T), c_event_alignment));
+			return new(data_ptr)T();
 		}
 
+		// Zero filled
 		char* allocate_raw_data(uint32_t id, size_t size);
 
 		template<typename T>
 		void write_event(uint32_t id, const T& event)
 		{
-			T* event_ptr = allocate_event<T>(id);
-			*event_ptr = event;
+			static_assert(std::is_trivially_copyable_v<T>);
+			static_assert(alignof(T) <= c_max_event_alignment);
+			char* data_ptr = allocate_record(id, sizeof(T), std::max(alignof(T), c_event_alignment));
+			new(data_ptr)T(event);
 		}
 
 		class Iterator
 		{
 		public:
-			bool is_valid() const { return m_data_it != m_data_end; }
-
-			void advance() { m_data_it += get_header().data_size + sizeof(Header); }
+			bool is_valid() const { return m_record != nullptr; }
 
-			const Header& get_header() const { return *reinterpret_cast<const Header*>(&(*m_data_it)); }
-			const char* get_event_data() const
+			void advance()
 			{
-				// TODO: assert if invalid!
-				return &(*m_data_it) + sizeof(Header);
+				const Header& event_header = get_header();
+				m_record += align_up(event_header.data_offset + event_header.data_size, c_event_alignment);
+				if (m_record == m_chunk_end)
+				{
+					++m_chunk_index;
+					skip_empty_chunks();
+				}
 			}
 
+			const Header& get_header() const { return *reinterpret_cast<const Header*>(m_record); }
+			const char* get_event_data() const { return m_record + get_header().data_offset; }
+
 			template<typename T>
 			const T* get_event() const
 			{
-				// FIXME: could this be static_cast?
 				return reinterpret_cast<const T*>(get_event_data());
 			}
 		private:
-			Iterator(const EventQueue& queue, size_t start_offset) : m_data_it(queue.m_data.cbegin() + start_offset), m_data_end(queue.m_data.cend()) {}
-			BufferIterator m_data_it;
-			BufferIterator m_data_end;
+			Iterator(const EventQueue& queue);
+
+			// Moves to the first event of the next chunk that has any, or past the end
+			void skip_empty_chunks();
+
+			const EventQueue* m_queue;
+			size_t m_chunk_index = 0;
+			const char* m_record = nullptr;
+			const char* m_chunk_end = nullptr;
 
 			friend EventQueue;
 		};
 
-		Iterator get_iterator(size_t start_offset = 0) const { return Iterator(*this, start_offset); }
+		Iterator get_iterator() const { return Iterator(*this); }
 	private:
-		Buffer m_data;
-	};
+		static constexpr size_t c_chunk_size = 4096;
 
-	// Extremely naive "lock-free" double buffer for simplicity
-	class EventDoubleBuffer
-	{
-	public:
-		EventDoubleBuffer();
+		struct alignas(c_max_event_alignment) Block
+		{
+			char bytes[c_max_event_alignment];
+		};
 
-		EventQueue* get_read_queue() { return m_signal ? m_read_queue : nullptr; }
-		EventQueue* get_write_queue() { return m_write_queue; }
+		struct Chunk
+		{
+			std::vector<Block> blocks; // Never resized, so the events stay where they are
+			size_t used_size = 0;
 
-		void dispatch_write();
-		void finish_read();
-	private:
-		std::array<EventQueue, 2> m_queues;
-		EventQueue* m_read_queue;
-		EventQueue* m_write_queue;
-		std::atomic<bool> m_signal;
+			char* get_data() { return reinterpret_cast<char*>(blocks.data()); }
+			const char* get_data() const { return reinterpret_cast<const char*>(blocks.data()); }
+			size_t get_capacity() const { return blocks.size() * sizeof(Block); }
+		};
+
+		static constexpr size_t align_up(size_t value, size_t alignment) { return (value + (alignment - 1)) & ~(alignment - 1); }
+
+		// Headers follow each other at the default alignment, only the event data is aligned further
+		static constexpr size_t get_data_offset(size_t record_offset, size_t alignment) { return align_up(record_offset + sizeof(Header), alignment) - record_offset; }
+
+		// Inline while the current chunk has room, which is almost always
+		char* allocate_record(uint32_t id, size_t size, size_t alignment)
+		{
+			if (m_chunk_count > 0)
+			{
+				Chunk& chunk = m_chunks[m_chunk_count - 1];
+				const size_t data_offset = get_data_offset(chunk.used_size, alignment);
+				if ((chunk.used_size + data_offset + size) <= chunk.get_capacity())
+				{
+					return write_record(chunk, id, size, data_offset);
+				}
+			}
+
+			return allocate_record_in_next_chunk(id, size, alignment);
+		}
+
+		char* allocate_record_in_next_chunk(uint32_t id, size_t size, size_t alignment);
+
+		char* write_record(Chunk& chunk, uint32_t id, size_t size, size_t data_offset)
+		{
+			char* record = chunk.get_data() + chunk.used_size;
+
+			const Header event_header = { id, static_cast<uint32_t>(size), static_cast<uint32_t>(data_offset) };
+			std::memcpy(record, &event_header, sizeof(Header));
+
+			const size_t record_size = align_up(data_offset + size, c_event_alignment);
+			chunk.used_size += record_size;
+			m_size += record_size;
+
+			return record + data_offset;
+		}
+
+		// Chunks past m_chunk_count are empty & kept for reuse
+		std::vector<Chunk> m_chunks;
+		size_t m_chunk_count = 0;
+		size_t m_size = 0;
 	};
 }
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,79 @@
+#ifndef FORWARDPLUSDEMO_UTILITIES_EVENTREGISTRY_HPP
+#define FORWARDPLUSDEMO_UTILITIES_EVENTREGISTRY_HPP
+#include <ForwardPlusDemo/Utilities/EventQueue.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+namespace ForwardPlusDemo
+{
+	// Compile time list of the event types a queue can hold, the event id is the index of the type in the list
+	// Events are written by type and dispatched to Handler::handle_event(const T&) through a table generated from the list,
+	// so a missing handler or an unknown event type is a compile error instead of a silently ignored switch case
+	template<typename... Events>
+	class EventRegistry
+	{
+	public:
+		static constexpr uint32_t c_event_count = sizeof...(Events);
+
+		template<typename T>
+		static constexpr uint32_t get_event_id()
+		{
+			static_assert((std::is_same_v<T, Events> + ...) == 1, "Event type has to be in the registry exactly once");
+
+			constexpr std::array<bool, c_event_count> c_matches = { std::is_same_v<T, Events>... };
+			uint32_t event_id = 0;
+			while (!c_matches[event_id])
+			{
+				++event_id;
+			}
+
+			return event_id;
+		}
+
+		template<typename T>
+		static void write_event(EventQueue& queue, const T& event)
+		{
+			queue.write_event(get_event_id<T>(), event);
+		}
+
+		// Runs of the same event type are handled in one loop, without going through the table again
+		template<typename Handler, typename Iterator>
+		static void dispatch(Iterator& event_it, Handler& handler)
+		{
+			using HandlerFunction = void(*)(Handler&, const char*);
+			static constexpr std::array<HandlerFunction, c_event_count> c_handlers = { &handle_event<Handler, Events>... };
+			[[maybe_unused]] static constexpr std::array<uint32_t, c_event_count> c_event_sizes = { static_cast<uint32_t>(sizeof(Events))... };
+
+			while (event_it.is_valid())
+			{
+				const uint32_t event_id = event_it.get_header().event_id;
+				if (event_id >= c_event_count)
+				{
+					assert(false);
+					event_it.advance();
+					continue;
+				}
+
+				const HandlerFunction handler_function = c_handlers[event_id];
+				do
+				{
+					assert(event_it.get_header().data_size == c_event_sizes[event_id]);
+					handler_function(handler, event_it.get_event_data());
+					event_it.advance();
+				} while (event_it.is_valid() && (event_it.get_header().event_id == event_id));
+			}
+		}
+	private:
+		template<typename Handler, typename T>
+		static void handle_event(Handler& handler, const char* event_data)
+		{
+			handler.handle_event(*reinterpret_cast<const T*>(event_data));
+		}
+
+		static_assert((std::is_trivially_copyable_v<Events> && ...), "Events are copied around as bytes");
+		static_assert(((alignof(Events) <= EventQueue::c_event_alignment) && ...), "Event data is only aligned to EventQueue::c_event_alignment");
+	};
+}
+#endif
@@ -0,0 +1,163 @@
+#include <ForwardPlusDemo/Utilities/EventRing.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+
+namespace ForwardPlusDemo
+{
+	EventRing::EventRing(uint32_t capacity)
+	{
+		const uint32_t block_count = std::bit_ceil(std::max(capacity, c_event_alignment * 2) / c_event_alignment);
+		m_data.resize(block_count);
+		m_position_mask = get_capacity() - 1;
+	}
+
+	uint32_t EventRing::get_record_size(uint32_t data_size)
+	{
+		return c_header_size + ((data_size + (c_event_alignment - 1)) & ~(c_event_alignment - 1));
+	}
+
+	bool EventRing::try_write(const EventQueue& queue)
+	{
+		EventQueue::Iterator event_it = queue.get_iterator();
+		return write_events(event_it, false);
+	}
+
+	bool EventRing::try_write_partial(EventQueue::Iterator& event_it)
+	{
+		return write_events(event_it, true);
+	}
+
+	bool EventRing::write_events(EventQueue::Iterator& event_it, bool partial)
+	{
+		if (!event_it.is_valid())
+		{
+			return true;
+		}
+
+		const uint64_t start_position = m_write_position.load(std::memory_order_relaxed);
+		uint64_t write_position = start_position;
+
+		// Nothing is visible to the consumer before the release below, so giving up halfway needs no undo
+		auto reserve = [this, &write_position](uint32_t size)
+		{
+			if ((write_position + size - m_cached_read_position) > get_capacity())
+			{
+				m_cached_read_position = m_read_position.load(std::memory_order_acquire);
+				if ((write_position + size - m_cached_read_position) > get_capacity())
+				{
+					return false;
+				}
+			}
+
+			return true;
+		};
+
+		// A partial write keeps the events written so far
+		auto publish = [this, &write_position, start_position]()
+		{
+			if (write_position == start_position)
+			{
+				return;
+			}
+
+			m_high_water_mark = std::max(m_high_water_mark, static_cast<uint32_t>(write_position - m_cached_read_position));
+
+			m_write_position.store(write_position, std::memory_order_release);
+		};
+
+		while (event_it.is_valid())
+		{
+			const Header& event_header = event_it.get_header();
+			const uint32_t record_size = get_record_size(event_header.data_size);
+
+			// Larger records may need more than the whole ring once the padding is added
+			assert(!partial || (record_size <= (get_capacity() / 2)));
+
+			// Events never wrap around, the space up to the end is skipped instead
+			const uint32_t contiguous_size = get_contiguous_size(write_position);
+			const uint32_t padding_size = (record_size > contiguous_size) ? contiguous_size : 0;
+			if (!reserve(padding_size + record_size))
+			{
+				++m_full_count;
+				if (partial)
+				{
+					publish();
+				}
+
+				return false;
+			}
+
+			if (padding_size > 0)
+			{
+				const Header padding_header = { .event_id = c_padding_event_id, .data_size = padding_size - c_header_size, .data_offset = c_header_size };
+				std::memcpy(get_data(write_position), &padding_header, sizeof(Header));
+				write_position += padding_size;
+			}
+
+			// The data moves to the start of the record, whatever its offset in the queue
+			const Header record_header = { .event_id = event_header.event_id, .data_size = event_header.data_size, .data_offset = c_header_size };
+			char* record = get_data(write_position);
+			std::memcpy(record, &record_header, sizeof(Header));
+			std::memcpy(record + c_header_size, event_it.get_event_data(), event_header.data_size);
+			write_position += record_size;
+
+			event_it.advance();
+		}
+
+		publish();
+
+		return true;
+	}
+
+	void EventRing::wait_for_space()
+	{
+		m_read_position.wait(m_cached_read_position, std::memory_order_acquire);
+		m_cached_read_position = m_read_position.load(std::memory_order_acquire);
+	}
+
+	EventRing::Iterator::Iterator(const EventRing& ring, uint64_t position, uint64_t end)
+		: m_ring(&ring)
+		, m_position(position)
+		, m_end(end)
+	{
+		skip_padding();
+	}
+
+	void EventRing::Iterator::advance()
+	{
+		assert(is_valid());
+
+		m_position += get_record_size(get_header().data_size);
+		skip_padding();
+	}
+
+	void EventRing::Iterator::skip_padding()
+	{
+		if (is_valid() && (get_header().event_id == c_padding_event_id))
+		{
+			m_position += get_record_size(get_header().data_size);
+		}
+	}
+
+	EventRing::Iterator EventRing::get_read_iterator()
+	{
+		const uint64_t read_position = m_read_position.load(std::memory_order_relaxed);
+		m_read_end = m_write_position.load(std::memory_order_acquire);
+
+		return Iterator(*this, read_position, m_read_end);
+	}
+
+	void EventRing::finish_read()
+	{
+		if (m_read_end == m_read_position.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		m_read_position.store(m_read_end, std::memory_order_release);
+		m_read_position.notify_one();
+	}
+}
@@ -0,0 +1,110 @@
+#ifndef FORWARDPLUSDEMO_UTILITIES_EVENTRING_HPP
+#define FORWARDPLUSDEMO_UTILITIES_EVENTRING_HPP
+#include <ForwardPlusDemo/Utilities/EventQueue.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+namespace ForwardPlusDemo
+{
+	// Fixed size single producer / single consumer ring of events, the producer hands over whole EventQueues
+	// Nothing grows or reallocates after construction, a full ring is reported to the producer instead
+	class EventRing
+	{
+	public:
+		using Header = EventQueue::Header;
+
+		static constexpr uint32_t c_cache_line_size = 64;
+
+		// Event data starts at this alignment, so events with XMVECTOR members can be read in place
+		static constexpr uint32_t c_event_alignment = 16;
+
+		// Capacity is rounded up to a power of two
+		explicit EventRing(uint32_t capacity);
+
+		// Producer
+		// Copies & publishes every event of the queue, or nothing when they don't all fit
+		bool try_write(const EventQueue& queue);
+
+		// Publishes whole events from event_it on until the ring is full, event_it is left on the first one that didn't fit
+		// Lets a queue larger than the ring go through in pieces, events must fit into half the ring so they always fit eventually
+		bool try_write_partial(EventQueue::Iterator& event_it);
+
+		// Blocks until the consumer has freed some space since the last failed try_write
+		void wait_for_space();
+
+		uint32_t get_capacity() const { return static_cast<uint32_t>(m_data.size() * sizeof(Block)); }
+		uint32_t get_high_water_mark() const { return m_high_water_mark; } // Most bytes in use at once, as seen by the producer
+		uint64_t get_full_count() const { return m_full_count; } // try_write calls that failed
+
+		// Consumer
+		class Iterator
+		{
+		public:
+			bool is_valid() const { return m_position != m_end; }
+
+			void advance();
+
+			const Header& get_header() const { return *reinterpret_cast<const Header*>(m_ring->get_data(m_position)); }
+			const char* get_event_data() const { return m_ring->get_data(m_position) + c_header_size; }
+
+			template<typename T>
+			const T* get_event() const
+			{
+				static_assert(alignof(T) <= c_event_alignment);
+				return reinterpret_cast<const T*>(get_event_data());
+			}
+		private:
+			Iterator(const EventRing& ring, uint64_t position, uint64_t end);
+
+			void skip_padding();
+
+			const EventRing* m_ring;
+			uint64_t m_position;
+			uint64_t m_end;
+
+			friend EventRing;
+		};
+
+		// Events published so far, they stay valid until finish_read()
+		Iterator get_read_iterator();
+		void finish_read();
+	private:
+		struct alignas(c_event_alignment) Block
+		{
+			char bytes[c_event_alignment];
+		};
+
+		static constexpr uint32_t c_header_size = c_event_alignment;
+		static_assert(sizeof(Header) <= c_header_size);
+
+		// Fills the rest of the ring when an event doesn't fit before the end
+		static constexpr uint32_t c_padding_event_id = UINT32_MAX;
+
+		static uint32_t get_record_size(uint32_t data_size);
+
+		bool write_events(EventQueue::Iterator& event_it, bool partial);
+
+		char* get_data(uint64_t position) { return reinterpret_cast<char*>(m_data.data()) + (position & m_position_mask); }
+		const char* get_data(uint64_t position) const { return reinterpret_cast<const char*>(m_data.data()) + (position & m_position_mask); }
+
+		uint32_t get_contiguous_size(uint64_t position) const { return get_capacity() - static_cast<uint32_t>(position & m_position_mask); }
+
+		// Positions only ever increase, the offset in the ring is position & m_position_mask
+		// Each side writes its own position & only reads the other one, kept on separate cache lines
+		alignas(c_cache_line_size) std::atomic<uint64_t> m_write_position = 0;
+		alignas(c_cache_line_size) std::atomic<uint64_t> m_read_position = 0;
+
+		// Producer only
+		alignas(c_cache_line_size) uint64_t m_cached_read_position = 0;
+		uint32_t m_high_water_mark = 0;
+		uint64_t m_full_count = 0;
+
+		// Consumer only
+		alignas(c_cache_line_size) uint64_t m_read_end = 0;
+
+		std::vector<Block> m_data;
+		uint64_t m_position_mask = 0;
+	};
+}
+#endif
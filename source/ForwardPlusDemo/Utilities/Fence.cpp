@@ -0,0 +1,66 @@
+#include <ForwardPlusDemo/Utilities/Fence.hpp>
+
+#include <algorithm>
+
+namespace ForwardPlusDemo
+{
+	void Fence::signal(uint64_t value)
+	{
+		uint64_t old_value = m_value.load(std::memory_order_relaxed);
+		do
+		{
+			if (value <= old_value)
+			{
+				return;
+			}
+		} while (!m_value.compare_exchange_weak(old_value, value, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+		// Taking the lock after the store means a timed waiter either saw the new value, or is already waiting on the condition
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			const auto first_pending = std::find_if(m_callbacks.begin(), m_callbacks.end(), [value](const PendingCallback& pending) { return pending.value > value; });
+			m_completed_callbacks.assign(m_callbacks.begin(), first_pending);
+			m_callbacks.erase(m_callbacks.begin(), first_pending);
+		}
+
+		m_condition.notify_all();
+		m_value.notify_all();
+
+		// Outside the lock, so callbacks can poll & wait on the fence
+		for (const PendingCallback& completed : m_completed_callbacks)
+		{
+			completed.callback(completed.data, completed.value);
+		}
+
+		m_completed_callbacks.clear();
+	}
+
+	bool Fence::wait_until_for(uint64_t value, std::chrono::steady_clock::duration timeout) const
+	{
+		if (is_completed(value))
+		{
+			return true;
+		}
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_condition.wait_for(lock, timeout, [this, value] { return is_completed(value); });
+	}
+
+	void Fence::add_completion_callback(uint64_t value, FenceCallback callback, void* data)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			// Checked under the lock, a signal reaching the value afterwards finds the callback in the list
+			if (!is_completed(value))
+			{
+				const auto insert_position = std::upper_bound(m_callbacks.begin(), m_callbacks.end(), value, [](uint64_t new_value, const PendingCallback& pending) { return new_value < pending.value; });
+				m_callbacks.insert(insert_position, PendingCallback{ value, callback, data });
+				return;
+			}
+		}
+
+		callback(data, value);
+	}
+}
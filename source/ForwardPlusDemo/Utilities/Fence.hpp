@@ -1,33 +1,63 @@
 #ifndef FORWARDPLUSDEMO_UTILITIES_FENCE_HPP
 #define FORWARDPLUSDEMO_UTILITIES_FENCE_HPP
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
 namespace ForwardPlusDemo
 {
+	// Runs on the signaling thread once the fence reaches the value it was added for
+	using FenceCallback = void(*)(void* data, uint64_t value);
+
+	// Timeline of a thread's progress (e.g one value per frame), the value only ever increases
+	// Other threads poll it, wait for a specific value (optionally with a timeout) or attach callbacks, rather than stopping both sides
 	class Fence
 	{
 	public:
-		Fence(uint64_t value) : m_value(value) {}
-
-		void signal(uint64_t value) 
-		{ 
-			if (value < m_value) 
-				return; 
-			
-			m_value = value; 
-			m_value.notify_all(); 
-		}
+		Fence(uint64_t value = 0) : m_value(value) {}
+
+		Fence(const Fence&) = delete;
+		Fence& operator=(const Fence&) = delete;
+
+		// From one thread at a time, values below the current one are ignored
+		void signal(uint64_t value);
+
+		uint64_t get_value() const { return m_value.load(std::memory_order_acquire); }
+		bool is_completed(uint64_t value) const { return get_value() >= value; }
 
 		void wait_until(uint64_t value) const
 		{
-			uint64_t old_value = m_value.load();
+			uint64_t old_value = m_value.load(std::memory_order_acquire);
 			while (old_value < value)
 			{
-				m_value.wait(old_value);
-				old_value = m_value.load();
+				m_value.wait(old_value, std::memory_order_acquire);
+				old_value = m_value.load(std::memory_order_acquire);
 			}
 		}
+
+		// False when the timeout ran out first
+		bool wait_until_for(uint64_t value, std::chrono::steady_clock::duration timeout) const;
+
+		// Runs right away on the calling thread when the value was already reached
+		// Callbacks for the same signal run in value order, they must not add callbacks to or signal this fence
+		void add_completion_callback(uint64_t value, FenceCallback callback, void* data);
 	private:
+		struct PendingCallback
+		{
+			uint64_t value;
+			FenceCallback callback;
+			void* data;
+		};
+
 		std::atomic<uint64_t> m_value;
+
+		// Timed waits & callbacks only, untimed waits go through the atomic
+		mutable std::mutex m_mutex;
+		mutable std::condition_variable m_condition;
+		std::vector<PendingCallback> m_callbacks; // Sorted by value
+		std::vector<PendingCallback> m_completed_callbacks; // Signaling thread only, reused between signals
 	};
 }
-#endif
\ No newline at end of file
+#endif
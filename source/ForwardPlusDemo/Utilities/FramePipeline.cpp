@@ -0,0 +1,67 @@
+#include <ForwardPlusDemo/Utilities/FramePipeline.hpp>
+
+#include <ForwardPlusDemo/Utilities/JobSystem.hpp>
+#include <ForwardPlusDemo/Utilities/Profiler.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace ForwardPlusDemo
+{
+	FramePipeline::FramePipeline(uint32_t depth)
+	{
+		reset(depth);
+	}
+
+	void FramePipeline::reset(uint32_t depth)
+	{
+		assert(depth > 0);
+
+		m_depth = std::max(depth, 1u);
+		m_prepared_frame_count = 0;
+		m_recorded_frame_count = 0;
+	}
+
+	void FramePipeline::run_frame(JobSystem& job_system, StageFunction prepare_function, StageFunction record_function, void* data)
+	{
+		auto run_prepare_function = [](void* pipeline_data, uint32_t begin, uint32_t /*end*/)
+		{
+			const FramePipeline& pipeline = *static_cast<const FramePipeline*>(pipeline_data);
+			pipeline.m_prepare_function(pipeline.m_prepare_data, begin);
+		};
+
+		m_prepare_function = prepare_function;
+		m_prepare_data = data;
+
+		const uint32_t prepare_slot = get_prepare_slot();
+
+		JobCounter prepare_counter;
+		job_system.run(run_prepare_function, this, prepare_slot, prepare_slot + 1, prepare_counter);
+
+		// Recording the oldest prepared frame overlaps the preparation of the newest one
+		if ((m_prepared_frame_count - m_recorded_frame_count) >= std::max(m_depth - 1, 1u))
+		{
+			record_frame(record_function, data);
+		}
+
+		{
+			FORWARDPLUSDEMO_PROFILE_SCOPE("FramePipeline::wait_for_prepare");
+			job_system.wait(prepare_counter);
+		}
+
+		++m_prepared_frame_count;
+
+		if (m_depth == 1)
+		{
+			record_frame(record_function, data);
+		}
+	}
+
+	void FramePipeline::record_frame(StageFunction record_function, void* data)
+	{
+		assert(m_recorded_frame_count < m_prepared_frame_count);
+
+		record_function(data, static_cast<uint32_t>(m_recorded_frame_count % m_depth));
+		++m_recorded_frame_count;
+	}
+}
@@ -0,0 +1,47 @@
+#ifndef FORWARDPLUSDEMO_UTILITIES_FRAMEPIPELINE_HPP
+#define FORWARDPLUSDEMO_UTILITIES_FRAMEPIPELINE_HPP
+#include <cstdint>
+namespace ForwardPlusDemo
+{
+	class JobSystem;
+
+	// Two stage frame pipeline: frame N is prepared on a job while the calling thread records frame N - (depth - 1)
+	// Each frame lives in a slot (its number modulo the depth) from preparation to recording, so the stages never share one
+	// A depth of one runs the stages back to back, every extra slot adds a frame of latency for the overlap
+	class FramePipeline
+	{
+	public:
+		using StageFunction = void(*)(void* data, uint32_t slot_index);
+
+		FramePipeline(uint32_t depth = 1);
+
+		// Drops every frame in flight
+		void reset(uint32_t depth);
+
+		uint32_t get_depth() const { return m_depth; }
+
+		// Slot of the frame the next run_frame prepares, for snapshotting what that frame needs
+		uint32_t get_prepare_slot() const { return static_cast<uint32_t>(m_prepared_frame_count % m_depth); }
+
+		// Prepares the next frame on a job & records the oldest prepared one meanwhile, once enough frames are in flight
+		// Returns when the preparation is done, with a depth of one after recording the frame as well
+		void run_frame(JobSystem& job_system, StageFunction prepare_function, StageFunction record_function, void* data);
+
+		// Forgets the frames prepared but not recorded yet (e.g on pause, they would show stale input later)
+		void drop_prepared_frames() { m_recorded_frame_count = m_prepared_frame_count; }
+
+		uint64_t get_prepared_frame_count() const { return m_prepared_frame_count; }
+		uint64_t get_recorded_frame_count() const { return m_recorded_frame_count; } // The frame being recorded counts once its stage returns
+	private:
+		void record_frame(StageFunction record_function, void* data);
+
+		uint32_t m_depth = 1;
+		uint64_t m_prepared_frame_count = 0;
+		uint64_t m_recorded_frame_count = 0;
+
+		// Handed to the prepare job
+		StageFunction m_prepare_function = nullptr;
+		void* m_prepare_data = nullptr;
+	};
+}
+#endif
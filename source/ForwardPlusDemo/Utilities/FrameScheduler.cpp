@@ -0,0 +1,249 @@
+#include <ForwardPlusDemo/Utilities/FrameScheduler.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <thread>
+
+namespace ForwardPlusDemo
+{
+	namespace
+	{
+		using Seconds = std::chrono::duration<double>;
+
+		// Longer frames (breakpoints, window drags) are simulated as this long, rather than in a burst of steps
+		constexpr double c_max_frame_time = 0.25;
+		constexpr uint32_t c_max_steps_per_frame = 8;
+
+		// Each sleep asks for this long, short enough to stop close to the deadline with a fine grained timer
+		constexpr std::chrono::milliseconds c_sleep_request(1);
+		constexpr uint32_t c_max_sleep_sample_count = 64;
+
+		// Frames kept for the percentile, a few seconds at usual rates
+		constexpr size_t c_recent_interval_count = 1024;
+
+		double to_seconds(FrameScheduler::Clock::duration duration)
+		{
+			return Seconds(duration).count();
+		}
+	}
+
+	FrameScheduler::FrameScheduler(double frame_rate, double step_rate)
+	{
+		set_frame_rate(frame_rate);
+		set_step_rate(step_rate);
+
+		m_recent_intervals.reserve(c_recent_interval_count);
+		reset(Clock::now());
+	}
+
+	void FrameScheduler::set_frame_rate(double frame_rate)
+	{
+		assert(frame_rate >= 0.0);
+
+		m_frame_rate = frame_rate;
+		m_frame_interval = (frame_rate > 0.0) ? std::chrono::duration_cast<Clock::duration>(Seconds(1.0 / frame_rate)) : Clock::duration::zero();
+	}
+
+	void FrameScheduler::set_step_rate(double step_rate)
+	{
+		assert(step_rate > 0.0);
+
+		m_step_rate = step_rate;
+	}
+
+	void FrameScheduler::reset(Clock::time_point now)
+	{
+		m_next_frame_time = now;
+		m_last_frame_begin = now;
+		m_has_last_frame = false;
+		m_step_accumulator = 0.0;
+	}
+
+	FrameTiming FrameScheduler::begin_frame(Clock::time_point now)
+	{
+		FrameTiming timing;
+
+		if (m_has_last_frame)
+		{
+			timing.delta_time = to_seconds(now - m_last_frame_begin);
+			add_interval(timing.delta_time);
+		}
+
+		m_last_frame_begin = now;
+		m_has_last_frame = true;
+
+		// Deadlines follow each other by exactly one interval, so a late frame doesn't push back the ones after it
+		// Once a whole interval behind, the schedule starts over from now instead of running frames back to back to catch up
+		if (m_frame_interval > Clock::duration::zero())
+		{
+			const Clock::duration lateness = now - m_next_frame_time;
+			if (lateness > (m_frame_interval / 2))
+			{
+				++m_late_frame_count;
+			}
+
+			m_next_frame_time = (lateness > m_frame_interval) ? (now + m_frame_interval) : (m_next_frame_time + m_frame_interval);
+		}
+
+		// Fixed steps, the remainder carries over to the next frame
+		const double step_time = get_step_time();
+		m_step_accumulator += std::min(timing.delta_time, c_max_frame_time);
+
+		uint64_t step_count = static_cast<uint64_t>(m_step_accumulator / step_time);
+		m_step_accumulator -= static_cast<double>(step_count) * step_time;
+
+		if (step_count > c_max_steps_per_frame)
+		{
+			m_dropped_step_count += step_count - c_max_steps_per_frame;
+			step_count = c_max_steps_per_frame;
+		}
+
+		timing.step_count = static_cast<uint32_t>(step_count);
+		timing.interpolation = std::clamp(m_step_accumulator / step_time, 0.0, 1.0);
+
+		return timing;
+	}
+
+	void FrameScheduler::wait_for_next_frame()
+	{
+		if (m_frame_interval == Clock::duration::zero())
+		{
+			return;
+		}
+
+		wait_until(m_next_frame_time);
+	}
+
+	FrameTimeStatistics FrameScheduler::get_statistics() const
+	{
+		FrameTimeStatistics statistics;
+		statistics.frame_count = m_frame_count;
+		statistics.late_frame_count = m_late_frame_count;
+		statistics.dropped_step_count = m_dropped_step_count;
+		statistics.sleep_time = m_total_sleep_time * 1000.0;
+		statistics.spin_time = m_total_spin_time * 1000.0;
+
+		if (m_frame_count > 0)
+		{
+			statistics.average_interval = m_interval_mean * 1000.0;
+			statistics.min_interval = m_min_interval * 1000.0;
+			statistics.max_interval = m_max_interval * 1000.0;
+			statistics.interval_deviation = (m_frame_count > 1) ? (std::sqrt(m_interval_m2 / static_cast<double>(m_frame_count - 1)) * 1000.0) : 0.0;
+
+			std::vector<double> sorted_intervals = m_recent_intervals;
+			const size_t p99_index = std::min(sorted_intervals.size() - 1, (sorted_intervals.size() * 99) / 100);
+			std::nth_element(sorted_intervals.begin(), sorted_intervals.begin() + p99_index, sorted_intervals.end());
+			statistics.p99_interval = sorted_intervals[p99_index] * 1000.0;
+		}
+
+		if (m_wait_count > 0)
+		{
+			statistics.average_wake_delay = (m_total_wake_delay / static_cast<double>(m_wait_count)) * 1000.0;
+			statistics.max_wake_delay = m_max_wake_delay * 1000.0;
+		}
+
+		return statistics;
+	}
+
+	void FrameScheduler::reset_statistics()
+	{
+		m_frame_count = 0;
+		m_interval_mean = 0.0;
+		m_interval_m2 = 0.0;
+		m_min_interval = 0.0;
+		m_max_interval = 0.0;
+		m_recent_intervals.clear();
+		m_recent_interval_index = 0;
+
+		m_wait_count = 0;
+		m_total_wake_delay = 0.0;
+		m_max_wake_delay = 0.0;
+		m_total_sleep_time = 0.0;
+		m_total_spin_time = 0.0;
+
+		m_late_frame_count = 0;
+		m_dropped_step_count = 0;
+	}
+
+	void FrameScheduler::wait_until(Clock::time_point deadline)
+	{
+		Clock::time_point now = Clock::now();
+		if (now >= deadline)
+		{
+			// The frame overran, begin_frame counts it as late
+			return;
+		}
+
+		// Sleep while even a sleep that overshoots as much as usual would end before the deadline
+		while (to_seconds(deadline - now) > get_sleep_estimate())
+		{
+			const Clock::time_point sleep_start = now;
+			std::this_thread::sleep_for(c_sleep_request);
+			now = Clock::now();
+
+			const double sleep_time = to_seconds(now - sleep_start);
+			m_total_sleep_time += sleep_time;
+			add_sleep_sample(sleep_time);
+		}
+
+		// Yielding rather than a pause loop, another thread on the same core may be what the frame is waiting for
+		const Clock::time_point spin_start = now;
+		while (now < deadline)
+		{
+			std::this_thread::yield();
+			now = Clock::now();
+		}
+
+		m_total_spin_time += to_seconds(now - spin_start);
+
+		const double wake_delay = to_seconds(now - deadline);
+		++m_wait_count;
+		m_total_wake_delay += wake_delay;
+		m_max_wake_delay = std::max(m_max_wake_delay, wake_delay);
+	}
+
+	void FrameScheduler::add_sleep_sample(double sleep_time)
+	{
+		// Exact mean & variance for the first samples, an exponential moving average after that
+		m_sleep_sample_count = std::min(m_sleep_sample_count + 1, c_max_sleep_sample_count);
+		const double weight = 1.0 / m_sleep_sample_count;
+
+		const double delta = sleep_time - m_sleep_mean;
+		m_sleep_mean += weight * delta;
+		m_sleep_variance = (1.0 - weight) * (m_sleep_variance + weight * delta * delta);
+	}
+
+	double FrameScheduler::get_sleep_estimate() const
+	{
+		// One standard deviation of margin, rare longer sleeps are caught by the late frame count
+		return m_sleep_mean + std::sqrt(m_sleep_variance);
+	}
+
+	void FrameScheduler::add_interval(double interval)
+	{
+		if (m_frame_count == 0)
+		{
+			m_min_interval = interval;
+			m_max_interval = interval;
+		}
+
+		++m_frame_count;
+		m_min_interval = std::min(m_min_interval, interval);
+		m_max_interval = std::max(m_max_interval, interval);
+
+		const double delta = interval - m_interval_mean;
+		m_interval_mean += delta / static_cast<double>(m_frame_count);
+		m_interval_m2 += delta * (interval - m_interval_mean);
+
+		if (m_recent_intervals.size() < c_recent_interval_count)
+		{
+			m_recent_intervals.push_back(interval);
+		}
+		else
+		{
+			m_recent_intervals[m_recent_interval_index] = interval;
+			m_recent_interval_index = (m_recent_interval_index + 1) % c_recent_interval_count;
+		}
+	}
+}
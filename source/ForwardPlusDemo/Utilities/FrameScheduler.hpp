@@ -0,0 +1,110 @@
+#ifndef FORWARDPLUSDEMO_UTILITIES_FRAMESCHEDULER_HPP
+#define FORWARDPLUSDEMO_UTILITIES_FRAMESCHEDULER_HPP
+#include <chrono>
+#include <cstdint>
+#include <vector>
+namespace ForwardPlusDemo
+{
+	// What the main loop has to do this frame, from FrameScheduler::begin_frame
+	struct FrameTiming
+	{
+		double delta_time = 0.0; // Measured since the previous frame began, in seconds
+		uint32_t step_count = 0; // Fixed simulation steps due
+
+		// Time left over after the steps, as a fraction of a step: draw the simulation this far between the last two steps
+		double interpolation = 0.0;
+	};
+
+	// Frame intervals since the last reset of the statistics, in milliseconds
+	struct FrameTimeStatistics
+	{
+		uint64_t frame_count = 0;
+		double average_interval = 0.0;
+		double min_interval = 0.0;
+		double max_interval = 0.0;
+		double interval_deviation = 0.0; // Jitter
+		double p99_interval = 0.0; // Over the most recent frames only
+
+		// How far past the deadline the waits woke up
+		double average_wake_delay = 0.0;
+		double max_wake_delay = 0.0;
+
+		// Where the waits went, sleeping costs no CPU time while spinning takes a whole core
+		double sleep_time = 0.0;
+		double spin_time = 0.0;
+
+		uint64_t late_frame_count = 0; // Frames that began over half an interval past their deadline
+		uint64_t dropped_step_count = 0; // Simulation steps skipped to catch up after a long frame
+	};
+
+	// Paces a loop to a target frame rate and runs its simulation at a fixed step rate, independent of the frame rate
+	// Waits sleep until the remaining time gets close to how long a sleep overshoots (learned as it goes), then spin the rest of the way,
+	// so the loop neither burns a core nor wakes up late by a whole timer tick
+	class FrameScheduler
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		// Zero frame rate runs unlimited, step rate has to be above zero
+		FrameScheduler(double frame_rate = 60.0, double step_rate = 60.0);
+
+		void set_frame_rate(double frame_rate);
+		void set_step_rate(double step_rate);
+
+		double get_frame_rate() const { return m_frame_rate; }
+		double get_step_rate() const { return m_step_rate; }
+		double get_step_time() const { return 1.0 / m_step_rate; }
+
+		// Starts over from now, e.g after a pause, so the time in between is neither simulated nor counted as a frame interval
+		void reset(Clock::time_point now);
+
+		FrameTiming begin_frame(Clock::time_point now);
+
+		// Returns once the next frame is due, right away when unlimited or already late
+		void wait_for_next_frame();
+
+		FrameTimeStatistics get_statistics() const;
+		void reset_statistics();
+	private:
+		void wait_until(Clock::time_point deadline);
+		void add_sleep_sample(double sleep_time);
+		double get_sleep_estimate() const;
+
+		void add_interval(double interval);
+
+		double m_frame_rate = 0.0;
+		double m_step_rate = 0.0;
+
+		Clock::duration m_frame_interval = Clock::duration::zero();
+		Clock::time_point m_next_frame_time;
+		Clock::time_point m_last_frame_begin;
+		bool m_has_last_frame = false;
+
+		// Simulation time not yet stepped, in seconds
+		double m_step_accumulator = 0.0;
+
+		// Mean & variance of single sleeps in seconds, averaged over a capped sample count so the estimate follows changes in timer resolution
+		double m_sleep_mean = 0.001;
+		double m_sleep_variance = 0.0;
+		uint32_t m_sleep_sample_count = 0;
+
+		// Totals in seconds, the recent intervals are kept for the percentile
+		uint64_t m_frame_count = 0;
+		double m_interval_mean = 0.0;
+		double m_interval_m2 = 0.0;
+		double m_min_interval = 0.0;
+		double m_max_interval = 0.0;
+		std::vector<double> m_recent_intervals;
+		size_t m_recent_interval_index = 0;
+
+		uint64_t m_wait_count = 0;
+		double m_total_wake_delay = 0.0;
+		double m_max_wake_delay = 0.0;
+		double m_total_sleep_time = 0.0;
+		double m_total_spin_time = 0.0;
+
+		uint64_t m_late_frame_count = 0;
+		uint64_t m_dropped_step_count = 0;
+	};
+}
+#endif
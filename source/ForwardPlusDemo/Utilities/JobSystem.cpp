@@ -0,0 +1,254 @@
+#include <ForwardPlusDemo/Utilities/JobSystem.hpp>
+
+#include <ForwardPlusDemo/Utilities/Profiler.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <mutex>
+
+namespace ForwardPlusDemo
+{
+	namespace
+	{
+		// Enough ranges to even out uneven work, few enough to keep the queue traffic down
+		constexpr uint32_t c_batches_per_thread = 4;
+
+		// Rounds of stealing attempts before an idle worker goes to sleep
+		constexpr uint32_t c_idle_spin_count = 64;
+
+		// Set on the worker threads, so jobs submitted from a job go to the worker's own deque
+		thread_local const JobSystem* t_job_system = nullptr;
+		thread_local uint32_t t_queue_index = 0;
+	}
+
+	struct alignas(64) JobSystem::JobQueue
+	{
+		std::mutex mutex;
+		std::deque<Job> jobs;
+
+		// Lets thieves skip empty queues without taking the lock
+		std::atomic<uint32_t> job_count = 0;
+	};
+
+	JobSystem::JobSystem(uint32_t thread_count)
+	{
+		if (thread_count == 0)
+		{
+			thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+
+		const uint32_t worker_count = thread_count - 1;
+
+		m_queue_count = worker_count + 1;
+		m_queues = std::make_unique<JobQueue[]>(m_queue_count);
+
+		m_workers.reserve(worker_count);
+		for (uint32_t worker_index = 0; worker_index < worker_count; ++worker_index)
+		{
+			m_workers.emplace_back([this, worker_index] { worker_loop(worker_index); });
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		m_running.store(false, std::memory_order_release);
+		m_work_parker.wake_all();
+
+		for (std::thread& current_worker : m_workers)
+		{
+			current_worker.join();
+		}
+	}
+
+	void JobSystem::run(JobFunction function, void* data, uint32_t begin, uint32_t end, JobCounter& counter)
+	{
+		counter.m_pending_count.fetch_add(1, std::memory_order_relaxed);
+
+		const Job job{ function, data, begin, end, &counter };
+		push_jobs(&job, 1);
+
+		m_work_parker.wake();
+	}
+
+	void JobSystem::run_batches(JobFunction function, void* data, uint32_t count, uint32_t batch_size, JobCounter& counter)
+	{
+		assert(batch_size > 0);
+
+		const uint32_t job_count = (count + batch_size - 1) / batch_size;
+		if (job_count == 0)
+		{
+			return;
+		}
+
+		counter.m_pending_count.fetch_add(job_count, std::memory_order_relaxed);
+
+		std::vector<Job> jobs;
+		jobs.reserve(job_count);
+		for (uint32_t begin = 0; begin < count; begin += batch_size)
+		{
+			jobs.push_back(Job{ function, data, begin, std::min(begin + batch_size, count), &counter });
+		}
+
+		push_jobs(jobs.data(), job_count);
+
+		if (job_count > 1)
+		{
+			m_work_parker.wake_all();
+		}
+		else
+		{
+			m_work_parker.wake();
+		}
+	}
+
+	void JobSystem::wait(JobCounter& counter)
+	{
+		const uint32_t queue_index = get_queue_index();
+
+		while (!counter.is_done())
+		{
+			if (try_run_job(queue_index))
+			{
+				continue;
+			}
+
+			// Nothing left to help with, the remaining jobs are running on other threads
+			const uint32_t park_token = m_completion_parker.get_token();
+			if (counter.is_done())
+			{
+				break;
+			}
+
+			m_completion_parker.park(park_token);
+		}
+	}
+
+	uint32_t JobSystem::get_batch_size(uint32_t count, uint32_t min_batch_size) const
+	{
+		const uint32_t max_batch_count = get_thread_count() * c_batches_per_thread;
+		const uint32_t batch_size = (count + max_batch_count - 1) / max_batch_count;
+
+		return std::max({ batch_size, min_batch_size, 1u });
+	}
+
+	uint32_t JobSystem::get_queue_index() const
+	{
+		return (t_job_system == this) ? t_queue_index : (m_queue_count - 1);
+	}
+
+	void JobSystem::push_jobs(const Job* jobs, uint32_t job_count)
+	{
+		JobQueue& queue = m_queues[get_queue_index()];
+
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.insert(queue.jobs.end(), jobs, jobs + job_count);
+		queue.job_count.store(static_cast<uint32_t>(queue.jobs.size()), std::memory_order_release);
+	}
+
+	bool JobSystem::try_run_job(uint32_t queue_index)
+	{
+		Job job;
+		if (!try_pop_job(queue_index, job) && !try_steal_job(queue_index, job))
+		{
+			return false;
+		}
+
+		job.function(job.data, job.begin, job.end);
+
+		// The waiter may return (and free the counter) as soon as this reaches zero
+		if (job.counter->m_pending_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			m_completion_parker.wake_all();
+		}
+
+		return true;
+	}
+
+	bool JobSystem::try_pop_job(uint32_t queue_index, Job& job)
+	{
+		JobQueue& queue = m_queues[queue_index];
+		if (queue.job_count.load(std::memory_order_acquire) == 0)
+		{
+			return false;
+		}
+
+		// Newest first, its data is most likely still in the cache
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.jobs.empty())
+		{
+			return false;
+		}
+
+		job = queue.jobs.back();
+		queue.jobs.pop_back();
+		queue.job_count.store(static_cast<uint32_t>(queue.jobs.size()), std::memory_order_release);
+
+		return true;
+	}
+
+	bool JobSystem::try_steal_job(uint32_t queue_index, Job& job)
+	{
+		// Starting after our own queue, so the thieves spread over the victims
+		for (uint32_t offset = 1; offset < m_queue_count; ++offset)
+		{
+			JobQueue& queue = m_queues[(queue_index + offset) % m_queue_count];
+			if (queue.job_count.load(std::memory_order_acquire) == 0)
+			{
+				continue;
+			}
+
+			// Oldest first, usually the biggest share of what is left
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.jobs.empty())
+			{
+				continue;
+			}
+
+			job = queue.jobs.front();
+			queue.jobs.pop_front();
+			queue.job_count.store(static_cast<uint32_t>(queue.jobs.size()), std::memory_order_release);
+
+			return true;
+		}
+
+		return false;
+	}
+
+	void JobSystem::worker_loop(uint32_t queue_index)
+	{
+		t_job_system = this;
+		t_queue_index = queue_index;
+
+		FORWARDPLUSDEMO_PROFILE_THREAD_NAME("Job worker " + std::to_string(queue_index));
+
+		uint32_t idle_count = 0;
+		while (true)
+		{
+			// Taken before looking for work, so jobs pushed after this point wake the worker from park() right away
+			const uint32_t park_token = m_work_parker.get_token();
+
+			if (try_run_job(queue_index))
+			{
+				idle_count = 0;
+				continue;
+			}
+
+			if (!m_running.load(std::memory_order_acquire))
+			{
+				break;
+			}
+
+			// Stages come in quick succession within a frame, so stay awake for a little while first
+			if (idle_count < c_idle_spin_count)
+			{
+				++idle_count;
+				std::this_thread::yield();
+				continue;
+			}
+
+			m_work_parker.park(park_token);
+			idle_count = 0;
+		}
+	}
+}
@@ -0,0 +1,110 @@
+#ifndef FORWARDPLUSDEMO_UTILITIES_JOBSYSTEM_HPP
+#define FORWARDPLUSDEMO_UTILITIES_JOBSYSTEM_HPP
+#include <ForwardPlusDemo/Utilities/ThreadParker.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+namespace ForwardPlusDemo
+{
+	// Runs the jobs over [begin, end), data is whatever the submitter passed along
+	using JobFunction = void(*)(void* data, uint32_t begin, uint32_t end);
+
+	// Jobs still running for a group, later stages wait on it before reading the results
+	// Has to outlive the wait, nothing touches the counter once it reaches zero
+	// There are no continuations: dependent stages are chained by the thread that waits, which runs queued jobs meanwhile
+	class JobCounter
+	{
+	public:
+		bool is_done() const { return m_pending_count.load(std::memory_order_acquire) == 0; }
+	private:
+		std::atomic<uint32_t> m_pending_count = 0;
+
+		friend class JobSystem;
+	};
+
+	// Work stealing scheduler shared by the per-frame CPU stages
+	// Every worker has its own deque: it runs its newest jobs first and idle workers steal the oldest ones from the others
+	// Threads outside the system submit to a shared deque, and run jobs themselves while they wait
+	class JobSystem
+	{
+	public:
+		// Thread count includes the thread waiting on the jobs, zero means one per hardware thread
+		JobSystem(uint32_t thread_count = 0);
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		uint32_t get_thread_count() const { return static_cast<uint32_t>(m_workers.size() + 1); }
+
+		void run(JobFunction function, void* data, uint32_t begin, uint32_t end, JobCounter& counter);
+
+		// Splits [0, count) into jobs of batch_size elements, queued all at once
+		void run_batches(JobFunction function, void* data, uint32_t count, uint32_t batch_size, JobCounter& counter);
+
+		// Runs queued jobs (from any group) until the counter reaches zero, then sleeps if the last ones are still running elsewhere
+		void wait(JobCounter& counter);
+
+		// Calls function(begin, end) over [0, count) and returns when every range is done
+		// Ranges have at least min_batch_size elements, small counts stay on the calling thread
+		template<typename Function>
+		void parallel_for(uint32_t count, uint32_t min_batch_size, const Function& function)
+		{
+			const uint32_t batch_size = get_batch_size(count, min_batch_size);
+			if (batch_size >= count)
+			{
+				if (count > 0)
+				{
+					function(0u, count);
+				}
+
+				return;
+			}
+
+			auto run_function = [](void* data, uint32_t begin, uint32_t end)
+			{
+				(*static_cast<const Function*>(data))(begin, end);
+			};
+
+			JobCounter counter;
+			run_batches(run_function, const_cast<Function*>(&function), count, batch_size, counter);
+			wait(counter);
+		}
+	private:
+		struct Job
+		{
+			JobFunction function;
+			void* data;
+			uint32_t begin;
+			uint32_t end;
+			JobCounter* counter;
+		};
+
+		struct JobQueue;
+
+		uint32_t get_batch_size(uint32_t count, uint32_t min_batch_size) const;
+		uint32_t get_queue_index() const;
+
+		void push_jobs(const Job* jobs, uint32_t job_count);
+		bool try_run_job(uint32_t queue_index);
+		bool try_pop_job(uint32_t queue_index, Job& job);
+		bool try_steal_job(uint32_t queue_index, Job& job);
+
+		void worker_loop(uint32_t queue_index);
+
+		// One per worker, the last one is shared by every other thread
+		std::unique_ptr<JobQueue[]> m_queues;
+		uint32_t m_queue_count = 0;
+
+		std::vector<std::thread> m_workers;
+		std::atomic<bool> m_running = true;
+
+		// Idle workers sleep on the first, threads waiting on a counter on the second
+		ThreadParker m_work_parker;
+		ThreadParker m_completion_parker;
+	};
+}
+#endif
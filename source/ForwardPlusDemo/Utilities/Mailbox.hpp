@@ -0,0 +1,71 @@
+#ifndef FORWARDPLUSDEMO_UTILITIES_MAILBOX_HPP
+#define FORWARDPLUSDEMO_UTILITIES_MAILBOX_HPP
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+namespace ForwardPlusDemo
+{
+	// Single producer / single consumer channel for state where only the newest value matters (camera, window size, ...)
+	// Triple buffered: the writer & reader each own a slot and swap it with the shared one, so neither side ever waits
+	template<typename T>
+	class Mailbox
+	{
+	public:
+		static_assert(std::is_trivially_copyable_v<T>);
+
+		// Producer, replaces the value if the consumer didn't get to it yet
+		void write(const T& value)
+		{
+			m_slots[m_write_index].value = value;
+
+			const uint32_t previous_shared = m_shared.exchange(m_write_index | c_new_value_flag, std::memory_order_acq_rel);
+			m_write_index = previous_shared & c_index_mask;
+
+			++m_write_count;
+		}
+
+		// Consumer, false when nothing was written since the last read
+		bool read(T& value)
+		{
+			if ((m_shared.load(std::memory_order_relaxed) & c_new_value_flag) == 0)
+			{
+				return false;
+			}
+
+			const uint32_t previous_shared = m_shared.exchange(m_read_index, std::memory_order_acq_rel);
+			m_read_index = previous_shared & c_index_mask;
+
+			value = m_slots[m_read_index].value;
+			++m_read_count;
+
+			return true;
+		}
+
+		// Written values the consumer never saw = write count - read count, once both sides are done
+		uint64_t get_write_count() const { return m_write_count; }
+		uint64_t get_read_count() const { return m_read_count; }
+	private:
+		static constexpr uint32_t c_index_mask = 0x3;
+		static constexpr uint32_t c_new_value_flag = 0x4;
+
+		struct alignas(64) Slot
+		{
+			T value;
+		};
+
+		std::array<Slot, 3> m_slots = {};
+
+		// Index of the slot neither side owns, plus whether it holds a value the consumer hasn't read
+		alignas(64) std::atomic<uint32_t> m_shared = 1;
+
+		// Producer only
+		alignas(64) uint32_t m_write_index = 0;
+		uint64_t m_write_count = 0;
+
+		// Consumer only
+		alignas(64) uint32_t m_read_index = 2;
+		uint64_t m_read_count = 0;
+	};
+}
+#endif
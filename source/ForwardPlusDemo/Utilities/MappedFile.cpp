@@ -0,0 +1,107 @@
+#include <ForwardPlusDemo/Utilities/MappedFile.hpp>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ForwardPlusDemo
+{
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+	bool MappedFile::open(const std::filesystem::path& path)
+	{
+		close();
+#ifdef _WIN32
+		HANDLE file_handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file_handle == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER file_size;
+		if ((GetFileSizeEx(file_handle, &file_size) == FALSE) || (file_size.QuadPart == 0))
+		{
+			CloseHandle(file_handle);
+			return false;
+		}
+
+		HANDLE mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping_handle == nullptr)
+		{
+			CloseHandle(file_handle);
+			return false;
+		}
+
+		void* view = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+		if (view == nullptr)
+		{
+			CloseHandle(mapping_handle);
+			CloseHandle(file_handle);
+			return false;
+		}
+
+		m_file_handle = file_handle;
+		m_mapping_handle = mapping_handle;
+		m_data = static_cast<const char*>(view);
+		m_size = static_cast<size_t>(file_size.QuadPart);
+#else
+		const int file_descriptor = ::open(path.c_str(), O_RDONLY);
+		if (file_descriptor < 0)
+		{
+			return false;
+		}
+
+		struct stat file_stat;
+		if ((fstat(file_descriptor, &file_stat) != 0) || (file_stat.st_size == 0))
+		{
+			::close(file_descriptor);
+			return false;
+		}
+
+		void* view = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+		if (view == MAP_FAILED)
+		{
+			::close(file_descriptor);
+			return false;
+		}
+
+		m_file_descriptor = file_descriptor;
+		m_data = static_cast<const char*>(view);
+		m_size = static_cast<size_t>(file_stat.st_size);
+#endif
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (m_data == nullptr)
+		{
+			return;
+		}
+#ifdef _WIN32
+		UnmapViewOfFile(m_data);
+		CloseHandle(static_cast<HANDLE>(m_mapping_handle));
+		CloseHandle(static_cast<HANDLE>(m_file_handle));
+
+		m_file_handle = nullptr;
+		m_mapping_handle = nullptr;
+#else
+		munmap(const_cast<char*>(m_data), m_size);
+		::close(m_file_descriptor);
+
+		m_file_descriptor = -1;
+#endif
+		m_data = nullptr;
+		m_size = 0;
+	}
+}
\ No newline at end of file
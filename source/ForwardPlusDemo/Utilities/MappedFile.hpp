@@ -0,0 +1,34 @@
+#ifndef FORWARDPLUSDEMO_UTILITIES_MAPPEDFILE_HPP
+#define FORWARDPLUSDEMO_UTILITIES_MAPPEDFILE_HPP
+#include <filesystem>
+namespace ForwardPlusDemo
+{
+	// Read-only memory mapping of an entire file
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool open(const std::filesystem::path& path);
+		void close();
+
+		bool is_open() const { return m_data != nullptr; }
+
+		const char* get_data() const { return m_data; }
+		size_t get_size() const { return m_size; }
+	private:
+		const char* m_data = nullptr;
+		size_t m_size = 0;
+#ifdef _WIN32
+		void* m_file_handle = nullptr;
+		void* m_mapping_handle = nullptr;
+#else
+		int m_file_descriptor = -1;
+#endif
+	};
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include <ForwardPlusDemo/Utilities/Profiler.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace ForwardPlusDemo
+{
+	namespace
+	{
+		// Events kept per thread (a power of two), a few thousand frames worth for the instrumented stages
+		constexpr uint64_t c_thread_event_capacity = 64 * 1024;
+
+		// Atomics only so the readers' copy isn't a data race, on x86 the relaxed stores are plain moves
+		struct ProfileEventSlot
+		{
+			std::atomic<const char*> name = nullptr;
+			std::atomic<uint64_t> begin_timestamp = 0;
+			std::atomic<uint64_t> end_timestamp = 0;
+		};
+
+		struct ProfileEvent
+		{
+			const char* name;
+			uint64_t begin_timestamp;
+			uint64_t end_timestamp;
+		};
+
+		// Written by its own thread only, which publishes every event through the write count
+		struct ThreadEvents
+		{
+			std::unique_ptr<ProfileEventSlot[]> slots = std::make_unique<ProfileEventSlot[]>(c_thread_event_capacity);
+			alignas(64) std::atomic<uint64_t> write_count = 0;
+
+			uint32_t thread_index = 0;
+			std::string name; // Under the profiler mutex
+		};
+
+		struct ThreadEventCopy
+		{
+			uint32_t thread_index = 0;
+			std::string name;
+			std::vector<ProfileEvent> events;
+		};
+
+		struct ProfilerState
+		{
+			std::mutex mutex;
+			std::vector<std::unique_ptr<ThreadEvents>> threads; // Kept after their threads exit, so the events stay readable
+
+			// The same moment on both clocks, timestamps are converted relative to it
+			uint64_t start_timestamp = Profiler::get_timestamp();
+			std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+		};
+
+		ProfilerState& get_state()
+		{
+			static ProfilerState state;
+			return state;
+		}
+
+		thread_local ThreadEvents* t_thread_events = nullptr;
+
+		ThreadEvents& get_thread_events()
+		{
+			if (t_thread_events == nullptr)
+			{
+				ProfilerState& state = get_state();
+				std::lock_guard<std::mutex> lock(state.mutex);
+
+				std::unique_ptr<ThreadEvents> thread_events = std::make_unique<ThreadEvents>();
+				thread_events->thread_index = static_cast<uint32_t>(state.threads.size());
+				thread_events->name = "Thread " + std::to_string(thread_events->thread_index);
+
+				t_thread_events = thread_events.get();
+				state.threads.push_back(std::move(thread_events));
+			}
+
+			return *t_thread_events;
+		}
+
+		std::vector<ThreadEventCopy> copy_thread_events()
+		{
+			ProfilerState& state = get_state();
+			std::lock_guard<std::mutex> lock(state.mutex);
+
+			std::vector<ThreadEventCopy> thread_copies;
+			thread_copies.reserve(state.threads.size());
+
+			for (const std::unique_ptr<ThreadEvents>& current_thread : state.threads)
+			{
+				ThreadEventCopy& thread_copy = thread_copies.emplace_back();
+				thread_copy.thread_index = current_thread->thread_index;
+				thread_copy.name = current_thread->name;
+
+				const uint64_t write_count = current_thread->write_count.load(std::memory_order_acquire);
+				const uint64_t first_index = (write_count > c_thread_event_capacity) ? (write_count - c_thread_event_capacity) : 0;
+
+				thread_copy.events.reserve(write_count - first_index);
+				for (uint64_t event_index = first_index; event_index < write_count; ++event_index)
+				{
+					const ProfileEventSlot& slot = current_thread->slots[event_index & (c_thread_event_capacity - 1)];
+					thread_copy.events.push_back(ProfileEvent{ slot.name.load(std::memory_order_relaxed), slot.begin_timestamp.load(std::memory_order_relaxed), slot.end_timestamp.load(std::memory_order_relaxed) });
+				}
+
+				// The thread may have wrapped around while we copied, its next event goes where index (new count - capacity) was
+				std::atomic_thread_fence(std::memory_order_acquire);
+				const uint64_t new_write_count = current_thread->write_count.load(std::memory_order_relaxed);
+				const uint64_t first_valid_index = (new_write_count >= c_thread_event_capacity) ? (new_write_count - c_thread_event_capacity + 1) : 0;
+				if (first_valid_index > first_index)
+				{
+					const uint64_t overwritten_count = std::min(first_valid_index - first_index, static_cast<uint64_t>(thread_copy.events.size()));
+					thread_copy.events.erase(thread_copy.events.begin(), thread_copy.events.begin() + overwritten_count);
+				}
+			}
+
+			return thread_copies;
+		}
+
+		double get_ticks_per_microsecond()
+		{
+#if FORWARDPLUSDEMO_PROFILER_RDTSC
+			// Measured against steady_clock since startup, long enough to be precise by the time anything is exported
+			const ProfilerState& state = get_state();
+
+			uint64_t timestamp = 0;
+			std::chrono::steady_clock::duration elapsed_time;
+			do
+			{
+				timestamp = Profiler::get_timestamp();
+				elapsed_time = std::chrono::steady_clock::now() - state.start_time;
+			} while (elapsed_time < std::chrono::milliseconds(10));
+
+			return static_cast<double>(timestamp - state.start_timestamp) / std::chrono::duration<double, std::micro>(elapsed_time).count();
+#else
+			using Period = std::chrono::steady_clock::period;
+			return static_cast<double>(Period::den) / (static_cast<double>(Period::num) * 1000000.0);
+#endif
+		}
+
+		void write_json_string(std::ofstream& file, std::string_view text)
+		{
+			file << '"';
+			for (const char current_char : text)
+			{
+				if ((current_char == '"') || (current_char == '\\'))
+				{
+					file << '\\';
+				}
+
+				file << current_char;
+			}
+			file << '"';
+		}
+	}
+
+	void Profiler::add_event(const char* name, uint64_t begin_timestamp, uint64_t end_timestamp)
+	{
+		ThreadEvents& thread_events = get_thread_events();
+
+		const uint64_t write_count = thread_events.write_count.load(std::memory_order_relaxed);
+		ProfileEventSlot& slot = thread_events.slots[write_count & (c_thread_event_capacity - 1)];
+		slot.name.store(name, std::memory_order_relaxed);
+		slot.begin_timestamp.store(begin_timestamp, std::memory_order_relaxed);
+		slot.end_timestamp.store(end_timestamp, std::memory_order_relaxed);
+
+		thread_events.write_count.store(write_count + 1, std::memory_order_release);
+	}
+
+	void Profiler::set_thread_name(std::string_view name)
+	{
+		ThreadEvents& thread_events = get_thread_events();
+
+		std::lock_guard<std::mutex> lock(get_state().mutex);
+		thread_events.name = name;
+	}
+
+	bool Profiler::write_chrome_trace(const std::filesystem::path& path)
+	{
+		const std::vector<ThreadEventCopy> thread_copies = copy_thread_events();
+		const double ticks_per_microsecond = get_ticks_per_microsecond();
+		const uint64_t start_timestamp = get_state().start_timestamp;
+
+		std::ofstream file(path, std::ios::trunc);
+		if (!file)
+		{
+			return false;
+		}
+
+		file.setf(std::ios::fixed);
+		file.precision(3);
+
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+		bool first_event = true;
+		for (const ThreadEventCopy& current_thread : thread_copies)
+		{
+			file << (first_event ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << current_thread.thread_index << ",\"args\":{\"name\":";
+			write_json_string(file, current_thread.name);
+			file << "}}";
+			first_event = false;
+
+			for (const ProfileEvent& current_event : current_thread.events)
+			{
+				// Complete events, begin & duration in microseconds
+				const double begin_time = static_cast<double>(current_event.begin_timestamp - start_timestamp) / ticks_per_microsecond;
+				const double duration = static_cast<double>(current_event.end_timestamp - current_event.begin_timestamp) / ticks_per_microsecond;
+
+				file << ",\n{\"name\":";
+				write_json_string(file, current_event.name);
+				file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << current_thread.thread_index << ",\"ts\":" << begin_time << ",\"dur\":" << duration << '}';
+			}
+		}
+
+		file << "\n]}\n";
+
+		return file.good();
+	}
+
+	std::vector<ProfileStageSummary> Profiler::get_summary()
+	{
+		const std::vector<ThreadEventCopy> thread_copies = copy_thread_events();
+		const double ticks_per_millisecond = get_ticks_per_microsecond() * 1000.0;
+
+		// Same literal can have a different address in every translation unit, so scopes are told apart by name
+		std::unordered_map<std::string_view, std::vector<double>> stage_times;
+		for (const ThreadEventCopy& current_thread : thread_copies)
+		{
+			for (const ProfileEvent& current_event : current_thread.events)
+			{
+				stage_times[current_event.name].push_back(static_cast<double>(current_event.end_timestamp - current_event.begin_timestamp) / ticks_per_millisecond);
+			}
+		}
+
+		std::vector<ProfileStageSummary> summary;
+		summary.reserve(stage_times.size());
+
+		for (auto& [name, times] : stage_times)
+		{
+			ProfileStageSummary& stage = summary.emplace_back();
+			stage.name = name;
+			stage.count = times.size();
+
+			for (const double current_time : times)
+			{
+				stage.total_time += current_time;
+			}
+
+			stage.average_time = stage.total_time / static_cast<double>(times.size());
+			stage.min_time = *std::min_element(times.begin(), times.end());
+			stage.max_time = *std::max_element(times.begin(), times.end());
+
+			const size_t p99_index = std::min(times.size() - 1, (times.size() * 99) / 100);
+			std::nth_element(times.begin(), times.begin() + p99_index, times.end());
+			stage.p99_time = times[p99_index];
+		}
+
+		std::sort(summary.begin(), summary.end(), [](const ProfileStageSummary& a, const ProfileStageSummary& b) { return a.total_time > b.total_time; });
+
+		return summary;
+	}
+}
@@ -0,0 +1,99 @@
+#ifndef FORWARDPLUSDEMO_UTILITIES_PROFILER_HPP
+#define FORWARDPLUSDEMO_UTILITIES_PROFILER_HPP
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define FORWARDPLUSDEMO_PROFILER_RDTSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+// Set by the build (FORWARDPLUSDEMO_PROFILER option), scopes compile to nothing without it
+#ifndef FORWARDPLUSDEMO_PROFILER
+#define FORWARDPLUSDEMO_PROFILER 0
+#endif
+
+#define FORWARDPLUSDEMO_PROFILE_CONCAT_INNER(a, b) a##b
+#define FORWARDPLUSDEMO_PROFILE_CONCAT(a, b) FORWARDPLUSDEMO_PROFILE_CONCAT_INNER(a, b)
+
+#if FORWARDPLUSDEMO_PROFILER
+// Times the rest of the enclosing block, the name has to be a string literal
+#define FORWARDPLUSDEMO_PROFILE_SCOPE(name) const ForwardPlusDemo::ProfileScope FORWARDPLUSDEMO_PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+#define FORWARDPLUSDEMO_PROFILE_THREAD_NAME(name) ForwardPlusDemo::Profiler::set_thread_name(name)
+#else
+#define FORWARDPLUSDEMO_PROFILE_SCOPE(name) static_cast<void>(0)
+#define FORWARDPLUSDEMO_PROFILE_THREAD_NAME(name) static_cast<void>(0)
+#endif
+
+namespace ForwardPlusDemo
+{
+	// Timings of one named scope over the events still held by the thread rings, in milliseconds
+	struct ProfileStageSummary
+	{
+		std::string name;
+		uint64_t count = 0;
+		double min_time = 0.0;
+		double average_time = 0.0;
+		double p99_time = 0.0;
+		double max_time = 0.0;
+		double total_time = 0.0;
+	};
+
+	// CPU timings of the frame stages, each scope adds one event to a ring owned by its thread
+	// Writing takes no locks and allocates nothing after a thread's first event, the oldest events are overwritten once a ring is full
+	// Readers copy the rings while they are being written, and skip whatever got overwritten during the copy
+	class Profiler
+	{
+	public:
+		// Invariant TSC ticks where available (converted using steady_clock), steady_clock ticks otherwise
+		static uint64_t get_timestamp()
+		{
+#if FORWARDPLUSDEMO_PROFILER_RDTSC
+			return __rdtsc();
+#else
+			return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+		}
+
+		static void add_event(const char* name, uint64_t begin_timestamp, uint64_t end_timestamp);
+
+		// Shown instead of the thread index in the trace
+		static void set_thread_name(std::string_view name);
+
+		// Trace event format, loads in chrome://tracing & Perfetto
+		static bool write_chrome_trace(const std::filesystem::path& path);
+
+		// Sorted by total time, the stage that dominates comes first
+		static std::vector<ProfileStageSummary> get_summary();
+	};
+
+	class ProfileScope
+	{
+	public:
+		explicit ProfileScope(const char* name)
+			: m_name(name)
+			, m_begin_timestamp(Profiler::get_timestamp())
+		{
+		}
+
+		~ProfileScope()
+		{
+			Profiler::add_event(m_name, m_begin_timestamp, Profiler::get_timestamp());
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+	private:
+		const char* m_name;
+		uint64_t m_begin_timestamp;
+	};
+}
+#endif
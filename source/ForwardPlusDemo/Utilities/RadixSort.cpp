@@ -0,0 +1,76 @@
+#include <ForwardPlusDemo/Utilities/RadixSort.hpp>
+
+#include <array>
+#include <utility>
+
+namespace ForwardPlusDemo
+{
+	namespace
+	{
+		constexpr uint32_t c_radix_bits = 8;
+		constexpr uint32_t c_radix_size = 1 << c_radix_bits;
+		constexpr uint32_t c_pass_count = 64 / c_radix_bits;
+
+		using Histogram = std::array<uint32_t, c_radix_size>;
+
+		uint32_t get_digit(uint64_t key, uint32_t pass)
+		{
+			return static_cast<uint32_t>(key >> (pass * c_radix_bits)) & (c_radix_size - 1);
+		}
+	}
+
+	void radix_sort(std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch)
+	{
+		if (keys.size() < 2)
+		{
+			return;
+		}
+
+		// Every histogram in a single read of the keys
+		std::array<Histogram, c_pass_count> histograms = {};
+		for (const uint64_t current_key : keys)
+		{
+			for (uint32_t current_pass = 0; current_pass < c_pass_count; ++current_pass)
+			{
+				++histograms[current_pass][get_digit(current_key, current_pass)];
+			}
+		}
+
+		scratch.resize(keys.size());
+
+		std::vector<uint64_t>* source = &keys;
+		std::vector<uint64_t>* destination = &scratch;
+
+		const uint32_t key_count = static_cast<uint32_t>(keys.size());
+		for (uint32_t current_pass = 0; current_pass < c_pass_count; ++current_pass)
+		{
+			Histogram& histogram = histograms[current_pass];
+
+			// Nothing to reorder when all keys share this digit
+			if (histogram[get_digit(keys.front(), current_pass)] == key_count)
+			{
+				continue;
+			}
+
+			uint32_t offset = 0;
+			for (uint32_t& current_count : histogram)
+			{
+				const uint32_t count = current_count;
+				current_count = offset;
+				offset += count;
+			}
+
+			for (const uint64_t current_key : *source)
+			{
+				(*destination)[histogram[get_digit(current_key, current_pass)]++] = current_key;
+			}
+
+			std::swap(source, destination);
+		}
+
+		if (source != &keys)
+		{
+			keys.swap(scratch);
+		}
+	}
+}
@@ -0,0 +1,12 @@
+#ifndef FORWARDPLUSDEMO_UTILITIES_RADIXSORT_HPP
+#define FORWARDPLUSDEMO_UTILITIES_RADIXSORT_HPP
+#include <cstdint>
+#include <vector>
+namespace ForwardPlusDemo
+{
+	// Stable LSD radix sort of 64 bit keys, one pass per byte
+	// Bytes that are the same in every key are skipped, so keys with a small payload in the low bits stay cheap
+	// Scratch is only used as the second buffer, keeping it around between calls avoids the allocation
+	void radix_sort(std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch);
+}
+#endif
@@ -0,0 +1,64 @@
+#ifndef FORWARDPLUSDEMO_UTILITIES_RANDOM_HPP
+#define FORWARDPLUSDEMO_UTILITIES_RANDOM_HPP
+#include <cstdint>
+namespace ForwardPlusDemo
+{
+	// Small, fast and fully deterministic PRNG (PCG32), so a given seed always produces the same sequence on every platform
+	class Random
+	{
+	public:
+		explicit Random(uint64_t seed = 0, uint64_t stream = 0)
+		{
+			seed_state(seed, stream);
+		}
+
+		void seed_state(uint64_t seed, uint64_t stream = 0)
+		{
+			m_state = 0;
+			m_increment = (stream << 1) | 1;
+
+			next_uint32();
+			m_state += seed;
+			next_uint32();
+		}
+
+		uint32_t next_uint32()
+		{
+			const uint64_t old_state = m_state;
+			m_state = old_state * 6364136223846793005ULL + m_increment;
+
+			const uint32_t xor_shifted = static_cast<uint32_t>(((old_state >> 18) ^ old_state) >> 27);
+			const uint32_t rotation = static_cast<uint32_t>(old_state >> 59);
+
+			return (xor_shifted >> rotation) | (xor_shifted << ((~rotation + 1) & 31));
+		}
+
+		// Uniform in [0, bound)
+		uint32_t next_uint32(uint32_t bound)
+		{
+			// Lemire's multiply-shift, the tiny bias is irrelevant for our use cases
+			return static_cast<uint32_t>((static_cast<uint64_t>(next_uint32()) * bound) >> 32);
+		}
+
+		// Uniform in [0, 1)
+		float next_float()
+		{
+			return static_cast<float>(next_uint32() >> 8) * (1.0f / 16777216.0f);
+		}
+
+		// Uniform in [min, max)
+		float next_float(float min, float max)
+		{
+			return min + (next_float() * (max - min));
+		}
+
+		bool next_bool(float probability)
+		{
+			return next_float() < probability;
+		}
+	private:
+		uint64_t m_state = 0;
+		uint64_t m_increment = 1;
+	};
+}
+#endif
\ No newline at end of file
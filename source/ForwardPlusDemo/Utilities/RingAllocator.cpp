@@ -0,0 +1,85 @@
+#include <ForwardPlusDemo/Utilities/RingAllocator.hpp>
+
+#include <cassert>
+
+namespace ForwardPlusDemo
+{
+	RingAllocator::RingAllocator(uint32_t capacity)
+		: m_capacity(capacity)
+	{
+	}
+
+	void RingAllocator::reset(uint32_t capacity)
+	{
+		m_capacity = capacity;
+		m_head = 0;
+		m_used_size = 0;
+		m_frame_size = 0;
+		m_frames.clear();
+	}
+
+	bool RingAllocator::allocate(uint32_t size, uint32_t alignment, uint32_t& offset)
+	{
+		assert((alignment != 0) && ((alignment & (alignment - 1)) == 0));
+
+		if ((size == 0) || (size > m_capacity))
+		{
+			return false;
+		}
+
+		// Nothing in flight, start over so large allocations don't have to wrap
+		if (m_used_size == 0)
+		{
+			m_head = 0;
+		}
+
+		// Skipped bytes stay part of the frame, so they are freed along with it
+		uint64_t aligned_head = (static_cast<uint64_t>(m_head) + alignment - 1) & ~static_cast<uint64_t>(alignment - 1);
+		uint64_t padding = aligned_head - m_head;
+		if ((aligned_head + size) > m_capacity)
+		{
+			aligned_head = 0;
+			padding = m_capacity - m_head;
+		}
+
+		// The free space starts at the head and wraps around to the oldest frame still in flight
+		const uint64_t reserved_size = padding + size;
+		if ((m_used_size + reserved_size) > m_capacity)
+		{
+			return false;
+		}
+
+		offset = static_cast<uint32_t>(aligned_head);
+
+		m_head = static_cast<uint32_t>(aligned_head + size);
+		if (m_head == m_capacity)
+		{
+			m_head = 0;
+		}
+
+		m_used_size += static_cast<uint32_t>(reserved_size);
+		m_frame_size += static_cast<uint32_t>(reserved_size);
+
+		return true;
+	}
+
+	void RingAllocator::finish_frame(uint64_t fence_value)
+	{
+		assert(m_frames.empty() || (m_frames.back().fence_value <= fence_value));
+
+		if (m_frame_size > 0)
+		{
+			m_frames.push_back(FrameMarker{ fence_value, m_frame_size });
+			m_frame_size = 0;
+		}
+	}
+
+	void RingAllocator::release_completed_frames(uint64_t completed_fence_value)
+	{
+		while (!m_frames.empty() && (m_frames.front().fence_value <= completed_fence_value))
+		{
+			m_used_size -= m_frames.front().size;
+			m_frames.pop_front();
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#ifndef FORWARDPLUSDEMO_UTILITIES_RINGALLOCATOR_HPP
+#define FORWARDPLUSDEMO_UTILITIES_RINGALLOCATOR_HPP
+#include <cstdint>
+#include <deque>
+namespace ForwardPlusDemo
+{
+	// Offsets into a fixed size ring (e.g a GPU upload buffer), handed out in order and freed a whole frame at a time
+	// Every frame is tagged with a fence value and reclaimed once that value has completed, nothing here touches the GPU
+	class RingAllocator
+	{
+	public:
+		RingAllocator(uint32_t capacity = 0);
+
+		// Drops every allocation
+		void reset(uint32_t capacity);
+
+		// Alignment has to be a power of two, allocations never wrap around the end
+		// False when the frames still in flight leave no room
+		bool allocate(uint32_t size, uint32_t alignment, uint32_t& offset);
+
+		// Everything allocated since the last call belongs to a frame that is done once fence_value completes
+		void finish_frame(uint64_t fence_value);
+		void release_completed_frames(uint64_t completed_fence_value);
+
+		uint32_t get_capacity() const { return m_capacity; }
+		uint32_t get_used_size() const { return m_used_size; } // Including alignment & wrap padding
+		uint32_t get_head() const { return m_head; }
+
+		// Bytes taken by the current (unfinished) frame
+		uint32_t get_frame_size() const { return m_frame_size; }
+	private:
+		struct FrameMarker
+		{
+			uint64_t fence_value;
+			uint32_t size;
+		};
+
+		uint32_t m_capacity = 0;
+		uint32_t m_head = 0;
+		uint32_t m_used_size = 0;
+		uint32_t m_frame_size = 0;
+
+		std::deque<FrameMarker> m_frames;
+	};
+}
+#endif
@@ -0,0 +1,32 @@
+#ifndef FORWARDPLUSDEMO_UTILITIES_THREADPARKER_HPP
+#define FORWARDPLUSDEMO_UTILITIES_THREADPARKER_HPP
+#include <atomic>
+#include <cstdint>
+namespace ForwardPlusDemo
+{
+	// Lets threads sleep until others hand them new work, built on atomic wait/notify like Fence
+	// Take a token before checking for work, then park with it: a wake between the two returns right away instead of being lost
+	class ThreadParker
+	{
+	public:
+		uint32_t get_token() const { return m_wake_count.load(std::memory_order_acquire); }
+
+		void park(uint32_t token) const { m_wake_count.wait(token, std::memory_order_acquire); }
+
+		// After publishing the work
+		void wake()
+		{
+			m_wake_count.fetch_add(1, std::memory_order_release);
+			m_wake_count.notify_one();
+		}
+
+		void wake_all()
+		{
+			m_wake_count.fetch_add(1, std::memory_order_release);
+			m_wake_count.notify_all();
+		}
+	private:
+		std::atomic<uint32_t> m_wake_count = 0;
+	};
+}
+#endif
@@ -0,0 +1,200 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/GraphicsAPI/CommandList.hpp>
+#include <ForwardPlusDemo/GraphicsAPI/CountingCommandReplayer.hpp>
+
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	// Handles are only compared, never dereferenced
+	CommandHandle make_handle(uintptr_t id)
+	{
+		return reinterpret_cast<CommandHandle>(id * 16);
+	}
+
+	uint64_t get_command_count(const CommandStatistics& statistics, CommandType type)
+	{
+		return statistics.command_counts[static_cast<size_t>(type)];
+	}
+
+	bool is_aligned(const void* pointer, size_t alignment)
+	{
+		return (reinterpret_cast<uintptr_t>(pointer) % alignment) == 0;
+	}
+}
+
+FORWARDPLUSDEMO_TEST(command_list, replayed_statistics)
+{
+	const CommandHandle vertex_shader = make_handle(1);
+	const CommandHandle pixel_shader = make_handle(2);
+	const CommandHandle vertex_buffer = make_handle(3);
+	const CommandHandle index_buffer = make_handle(4);
+	const CommandHandle constant_buffer = make_handle(5);
+	const CommandHandle light_buffer = make_handle(6);
+
+	const std::vector<uint8_t> constants(96, 1);
+	const std::vector<uint8_t> lights(1000, 2);
+
+	CommandList command_list;
+	command_list.set_primitive_topology(PrimitiveTopology::TRIANGLE_LIST);
+	command_list.set_shader(ShaderStage::VERTEX, vertex_shader);
+	command_list.set_shader(ShaderStage::PIXEL, pixel_shader);
+	command_list.set_vertex_buffer(0, vertex_buffer, 32, 0);
+	command_list.set_index_buffer(index_buffer, IndexFormat::UINT16, 0);
+	command_list.update_buffer(constant_buffer, constants.data(), static_cast<uint32_t>(constants.size()));
+	command_list.update_buffer_range(light_buffer, 256, lights.data(), static_cast<uint32_t>(lights.size()));
+	command_list.set_constant_buffers(ShaderStage::VERTEX, 0, 1, &constant_buffer);
+	command_list.set_constant_buffer_range(ShaderStage::PIXEL, 0, light_buffer, 256, 1024);
+	command_list.draw_indexed_instanced(36, 10, 0, 0, 0);
+
+	// Same state again, every bind here is redundant
+	command_list.set_primitive_topology(PrimitiveTopology::TRIANGLE_LIST);
+	command_list.set_shader(ShaderStage::VERTEX, vertex_shader);
+	command_list.set_vertex_buffer(0, vertex_buffer, 32, 0);
+	command_list.set_constant_buffers(ShaderStage::VERTEX, 0, 1, &constant_buffer);
+	command_list.set_constant_buffer_range(ShaderStage::PIXEL, 0, light_buffer, 256, 1024);
+	command_list.draw_instanced(3, 2, 0, 0);
+
+	// Not redundant: another range, the whole buffer where a range was bound, another topology
+	command_list.set_constant_buffer_range(ShaderStage::PIXEL, 0, light_buffer, 512, 1024);
+	command_list.set_constant_buffers(ShaderStage::PIXEL, 0, 1, &light_buffer);
+	command_list.set_primitive_topology(PrimitiveTopology::LINE_LIST);
+	command_list.draw(24, 0);
+	command_list.dispatch(4, 2, 3);
+
+	FORWARDPLUSDEMO_CHECK(command_list.get_command_count() == 21);
+
+	CountingCommandReplayer replayer;
+	replayer.replay(command_list);
+
+	const CommandStatistics& statistics = replayer.get_statistics();
+	FORWARDPLUSDEMO_CHECK(get_command_count(statistics, CommandType::SET_PRIMITIVE_TOPOLOGY) == 3);
+	FORWARDPLUSDEMO_CHECK(get_command_count(statistics, CommandType::SET_SHADER) == 3);
+	FORWARDPLUSDEMO_CHECK(get_command_count(statistics, CommandType::SET_VERTEX_BUFFER) == 2);
+	FORWARDPLUSDEMO_CHECK(get_command_count(statistics, CommandType::SET_INDEX_BUFFER) == 1);
+	FORWARDPLUSDEMO_CHECK(get_command_count(statistics, CommandType::SET_CONSTANT_BUFFERS) == 3);
+	FORWARDPLUSDEMO_CHECK(get_command_count(statistics, CommandType::SET_CONSTANT_BUFFER_RANGE) == 3);
+	FORWARDPLUSDEMO_CHECK(get_command_count(statistics, CommandType::UPDATE_BUFFER) == 1);
+	FORWARDPLUSDEMO_CHECK(get_command_count(statistics, CommandType::UPDATE_BUFFER_RANGE) == 1);
+	FORWARDPLUSDEMO_CHECK(get_command_count(statistics, CommandType::DRAW) == 1);
+	FORWARDPLUSDEMO_CHECK(get_command_count(statistics, CommandType::DRAW_INSTANCED) == 1);
+	FORWARDPLUSDEMO_CHECK(get_command_count(statistics, CommandType::DRAW_INDEXED_INSTANCED) == 1);
+	FORWARDPLUSDEMO_CHECK(get_command_count(statistics, CommandType::DISPATCH) == 1);
+	FORWARDPLUSDEMO_CHECK(get_command_count(statistics, CommandType::SET_SHADER_RESOURCES) == 0);
+
+	FORWARDPLUSDEMO_CHECK(statistics.bytes_uploaded == constants.size() + lights.size());
+	FORWARDPLUSDEMO_CHECK(statistics.redundant_binds == 5);
+
+	FORWARDPLUSDEMO_CHECK(statistics.draw_count == 3);
+	FORWARDPLUSDEMO_CHECK(statistics.instance_count == 13);
+	FORWARDPLUSDEMO_CHECK(statistics.vertex_count == (36 * 10) + (3 * 2) + 24);
+	FORWARDPLUSDEMO_CHECK(statistics.dispatch_group_count == 24);
+
+	// The tracked state carries over to the next replay until it is reset
+	replayer.reset_statistics();
+	replayer.replay(command_list);
+	FORWARDPLUSDEMO_CHECK(replayer.get_statistics().redundant_binds > 5);
+
+	replayer.reset_statistics();
+	replayer.reset_state();
+	replayer.replay(command_list);
+	FORWARDPLUSDEMO_CHECK(replayer.get_statistics().redundant_binds == 5);
+}
+
+FORWARDPLUSDEMO_TEST(command_list, large_binding_ranges_split)
+{
+	std::vector<CommandHandle> views(Commands::c_max_bindings * 2 + 3);
+	for (size_t current_view_index = 0; current_view_index < views.size(); ++current_view_index)
+	{
+		views[current_view_index] = make_handle(current_view_index + 1);
+	}
+
+	CommandList command_list;
+	command_list.set_shader_resources(ShaderStage::PIXEL, 2, static_cast<uint32_t>(views.size()), views.data());
+	FORWARDPLUSDEMO_CHECK(command_list.get_command_count() == 3);
+
+	// Every view ends up in its own slot, in order
+	uint32_t next_slot = 2;
+	for (CommandList::Iterator command_it = command_list.get_iterator(); command_it.is_valid(); command_it.advance())
+	{
+		FORWARDPLUSDEMO_CHECK(command_it.get_type() == CommandType::SET_SHADER_RESOURCES);
+
+		const Commands::SetBindings* command = command_it.get_command<Commands::SetBindings>();
+		FORWARDPLUSDEMO_CHECK(command->start_slot == next_slot);
+		for (uint32_t current_binding_index = 0; current_binding_index < command->count; ++current_binding_index)
+		{
+			FORWARDPLUSDEMO_CHECK(command->handles[current_binding_index] == views[command->start_slot - 2 + current_binding_index]);
+		}
+
+		next_slot += command->count;
+	}
+
+	FORWARDPLUSDEMO_CHECK(next_slot == views.size() + 2);
+
+	CountingCommandReplayer replayer;
+	replayer.replay(command_list);
+	replayer.replay(command_list);
+	FORWARDPLUSDEMO_CHECK(replayer.get_statistics().redundant_binds == views.size());
+}
+
+FORWARDPLUSDEMO_TEST(command_list, payloads_keep_block_alignment)
+{
+	// Payload sizes that end anywhere inside a block, each followed by a command holding a handle
+	std::vector<uint8_t> data(64);
+	std::iota(data.begin(), data.end(), uint8_t(1));
+
+	CommandList command_list;
+	for (uint32_t data_size = 0; data_size <= 17; ++data_size)
+	{
+		command_list.update_buffer_range(make_handle(data_size + 1), data_size, data.data(), data_size);
+		command_list.set_shader(ShaderStage::COMPUTE, make_handle(100 + data_size));
+	}
+
+	FORWARDPLUSDEMO_CHECK((command_list.get_size() % sizeof(uint64_t)) == 0);
+
+	size_t total_size = 0;
+	uint32_t data_size = 0;
+	for (CommandList::Iterator command_it = command_list.get_iterator(); command_it.is_valid(); command_it.advance())
+	{
+		total_size += command_it.get_header().size;
+		FORWARDPLUSDEMO_CHECK((command_it.get_header().size % sizeof(uint64_t)) == 0);
+		FORWARDPLUSDEMO_CHECK(is_aligned(&command_it.get_header(), alignof(uint64_t)));
+
+		if (command_it.get_type() == CommandType::UPDATE_BUFFER_RANGE)
+		{
+			const Commands::UpdateBufferRange* command = command_it.get_command<Commands::UpdateBufferRange>();
+			FORWARDPLUSDEMO_CHECK(is_aligned(command, alignof(Commands::UpdateBufferRange)));
+			FORWARDPLUSDEMO_CHECK(is_aligned(command_it.get_payload<Commands::UpdateBufferRange>(), alignof(uint64_t)));
+
+			FORWARDPLUSDEMO_CHECK((command->buffer == make_handle(data_size + 1)) && (command->offset == data_size) && (command->data_size == data_size));
+			FORWARDPLUSDEMO_CHECK(std::memcmp(command_it.get_payload<Commands::UpdateBufferRange>(), data.data(), data_size) == 0);
+		}
+		else
+		{
+			// The command after the payload starts on a fresh block, so its handle is still readable in place
+			FORWARDPLUSDEMO_CHECK(command_it.get_type() == CommandType::SET_SHADER);
+
+			const Commands::SetShader* command = command_it.get_command<Commands::SetShader>();
+			FORWARDPLUSDEMO_CHECK(is_aligned(command, alignof(Commands::SetShader)));
+			FORWARDPLUSDEMO_CHECK((command->stage == ShaderStage::COMPUTE) && (command->shader == make_handle(100 + data_size)));
+
+			++data_size;
+		}
+	}
+
+	FORWARDPLUSDEMO_CHECK(data_size == 18);
+	FORWARDPLUSDEMO_CHECK(total_size == command_list.get_size());
+
+	CountingCommandReplayer replayer;
+	replayer.replay(command_list);
+	FORWARDPLUSDEMO_CHECK(replayer.get_statistics().bytes_uploaded == (17 * 18) / 2);
+	FORWARDPLUSDEMO_CHECK(replayer.get_statistics().redundant_binds == 0);
+
+	command_list.clear();
+	FORWARDPLUSDEMO_CHECK(command_list.is_empty() && (command_list.get_command_count() == 0));
+}
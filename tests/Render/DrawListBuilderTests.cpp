@@ -0,0 +1,155 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Render/DrawListBuilder.hpp>
+#include <ForwardPlusDemo/Utilities/Random.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	struct TestInstance
+	{
+		uint32_t id = 0;
+		float view_depth = 0.0f;
+	};
+
+	ObjectType get_test_type(uint32_t index)
+	{
+		return static_cast<ObjectType>(index % static_cast<uint32_t>(ObjectType::TYPE_COUNT));
+	}
+
+	// Every batch holds a single type, and its instances go front to back (at the precision of the sort keys)
+	void check_draw_order(const DrawListBuilder<TestInstance>& draw_list, uint32_t instance_count)
+	{
+		const std::vector<TestInstance>& instances = draw_list.get_instances();
+		FORWARDPLUSDEMO_CHECK(instances.size() == instance_count);
+
+		uint32_t batched_count = 0;
+		for (const DrawBatch& current_batch : draw_list.get_batches())
+		{
+			FORWARDPLUSDEMO_CHECK(current_batch.first_instance == batched_count);
+			for (uint32_t current_index = current_batch.first_instance; current_index < current_batch.first_instance + current_batch.instance_count; ++current_index)
+			{
+				FORWARDPLUSDEMO_CHECK(get_test_type(instances[current_index].id) == current_batch.type);
+				if (current_index > current_batch.first_instance)
+				{
+					FORWARDPLUSDEMO_CHECK(DrawSortKey::quantize_depth(instances[current_index - 1].view_depth) <= DrawSortKey::quantize_depth(instances[current_index].view_depth));
+				}
+			}
+
+			batched_count += current_batch.instance_count;
+		}
+
+		FORWARDPLUSDEMO_CHECK(batched_count == instance_count);
+	}
+}
+
+FORWARDPLUSDEMO_TEST(draw_list_builder, one_batch_per_type_front_to_back)
+{
+	constexpr uint32_t c_instance_count = 10000;
+
+	Random random(3);
+	DrawListBuilder<TestInstance> draw_list;
+	draw_list.begin();
+
+	for (uint32_t current_index = 0; current_index < c_instance_count; ++current_index)
+	{
+		const TestInstance instance{ current_index, random.next_float(0.0f, 500.0f) };
+		draw_list.add_instance(get_test_type(current_index), instance.view_depth, instance);
+	}
+
+	draw_list.build();
+
+	check_draw_order(draw_list, c_instance_count);
+	FORWARDPLUSDEMO_CHECK(draw_list.get_batches().size() == static_cast<size_t>(ObjectType::TYPE_COUNT));
+	FORWARDPLUSDEMO_CHECK(draw_list.get_state_change_count() == static_cast<uint32_t>(ObjectType::TYPE_COUNT) - 1);
+}
+
+FORWARDPLUSDEMO_TEST(draw_list_builder, ties_and_depths_behind_the_camera)
+{
+	DrawListBuilder<TestInstance> draw_list;
+	draw_list.begin();
+
+	// Same depth keeps the order of addition, anything behind the camera goes first
+	draw_list.add_instance(ObjectType::CUBE, 5.0f, TestInstance{ 0, 5.0f });
+	draw_list.add_instance(ObjectType::CUBE, 5.0f, TestInstance{ 1, 5.0f });
+	draw_list.add_instance(ObjectType::CUBE, -3.0f, TestInstance{ 2, -3.0f });
+	draw_list.add_instance(ObjectType::CUBE, 1.0f, TestInstance{ 3, 1.0f });
+	draw_list.build();
+
+	const std::vector<TestInstance>& instances = draw_list.get_instances();
+	FORWARDPLUSDEMO_CHECK(instances.size() == 4);
+	FORWARDPLUSDEMO_CHECK(instances[0].id == 2);
+	FORWARDPLUSDEMO_CHECK(instances[1].id == 3);
+	FORWARDPLUSDEMO_CHECK(instances[2].id == 0);
+	FORWARDPLUSDEMO_CHECK(instances[3].id == 1);
+	FORWARDPLUSDEMO_CHECK(draw_list.get_batches().size() == 1);
+
+	// Reused for the next frame
+	draw_list.begin();
+	draw_list.build();
+	FORWARDPLUSDEMO_CHECK(draw_list.get_instances().empty());
+	FORWARDPLUSDEMO_CHECK(draw_list.get_batches().empty());
+	FORWARDPLUSDEMO_CHECK(draw_list.get_state_change_count() == 0);
+}
+
+FORWARDPLUSDEMO_TEST(draw_list_builder, parallel_set_matches_add)
+{
+	constexpr uint32_t c_instance_count = 20000;
+	constexpr uint32_t c_thread_count = 4;
+
+	std::vector<TestInstance> source_instances(c_instance_count);
+	Random random(4);
+	for (uint32_t current_index = 0; current_index < c_instance_count; ++current_index)
+	{
+		// Coarse depths, so plenty of keys only differ by the instance index
+		source_instances[current_index] = TestInstance{ current_index, static_cast<float>(random.next_uint32(64)) };
+	}
+
+	DrawListBuilder<TestInstance> added_list;
+	added_list.begin();
+	for (const TestInstance& current_instance : source_instances)
+	{
+		added_list.add_instance(get_test_type(current_instance.id), current_instance.view_depth, current_instance);
+	}
+	added_list.build();
+
+	DrawListBuilder<TestInstance> set_list;
+	set_list.begin();
+	const uint32_t first_index = set_list.add_instances(c_instance_count);
+
+	std::vector<std::thread> threads;
+	for (uint32_t current_thread = 0; current_thread < c_thread_count; ++current_thread)
+	{
+		threads.emplace_back([&, current_thread]()
+		{
+			for (uint32_t current_index = current_thread; current_index < c_instance_count; current_index += c_thread_count)
+			{
+				const TestInstance& instance = source_instances[current_index];
+				set_list.set_instance(first_index + current_index, get_test_type(instance.id), instance.view_depth, instance);
+			}
+		});
+	}
+
+	for (std::thread& current_thread : threads)
+	{
+		current_thread.join();
+	}
+
+	set_list.build();
+
+	check_draw_order(set_list, c_instance_count);
+
+	const std::vector<TestInstance>& added_instances = added_list.get_instances();
+	const std::vector<TestInstance>& set_instances = set_list.get_instances();
+	bool same_order = (added_instances.size() == set_instances.size());
+	for (size_t current_index = 0; same_order && (current_index < added_instances.size()); ++current_index)
+	{
+		same_order = (added_instances[current_index].id == set_instances[current_index].id);
+	}
+
+	FORWARDPLUSDEMO_CHECK(same_order);
+}
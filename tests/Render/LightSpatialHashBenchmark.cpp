@@ -0,0 +1,117 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Render/LightSpatialHash.hpp>
+#include <ForwardPlusDemo/Utilities/Random.hpp>
+
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	// Lights spread over a city sized area, at roughly the density of the streetlights scenario
+	constexpr float c_scene_extent = 500.0f;
+}
+
+// 100k lights, 10k object sized queries per frame, with and without 1% of the lights moving every frame
+FORWARDPLUSDEMO_BENCHMARK(light_spatial_hash_queries)
+{
+	const uint32_t light_count = context.select(100000u, 10000u);
+	const uint32_t queries_per_frame = context.select(10000u, 1000u);
+	const uint32_t moving_light_count = light_count / 100;
+	const uint32_t frame_count = context.select(20u, 2u);
+
+	Random random(1);
+
+	std::vector<DirectX::BoundingSphere> light_bounds(light_count);
+	for (DirectX::BoundingSphere& current_bounds : light_bounds)
+	{
+		current_bounds.Center = Vector3(random.next_float(-c_scene_extent, c_scene_extent), random.next_float(0.0f, 8.0f), random.next_float(-c_scene_extent, c_scene_extent));
+		current_bounds.Radius = random.next_float(1.0f, 12.0f);
+	}
+
+	std::vector<DirectX::BoundingBox> query_bounds(queries_per_frame);
+	for (DirectX::BoundingBox& current_bounds : query_bounds)
+	{
+		current_bounds.Center = Vector3(random.next_float(-c_scene_extent, c_scene_extent), random.next_float(0.0f, 4.0f), random.next_float(-c_scene_extent, c_scene_extent));
+		current_bounds.Extents = Vector3(random.next_float(0.5f, 4.0f), random.next_float(0.5f, 4.0f), random.next_float(0.5f, 4.0f));
+	}
+
+	LightSpatialHash spatial_hash;
+	const double build_ms = context.time_ms([&]()
+	{
+		spatial_hash.clear();
+		for (uint32_t current_light_index = 0; current_light_index < light_count; ++current_light_index)
+		{
+			spatial_hash.insert(current_light_index, light_bounds[current_light_index]);
+		}
+	});
+
+	std::vector<uint32_t> light_ids;
+	size_t result_count = 0;
+	auto run_queries = [&]()
+	{
+		result_count = 0;
+		for (const DirectX::BoundingBox& current_bounds : query_bounds)
+		{
+			light_ids.clear();
+			spatial_hash.query(current_bounds, light_ids);
+			result_count += light_ids.size();
+		}
+	};
+
+	const double static_frame_ms = context.time_ms([&]()
+	{
+		for (uint32_t current_frame = 0; current_frame < frame_count; ++current_frame)
+		{
+			run_queries();
+		}
+	}) / frame_count;
+
+	const double moving_frame_ms = context.time_ms([&]()
+	{
+		for (uint32_t current_frame = 0; current_frame < frame_count; ++current_frame)
+		{
+			// Small steps, like the animated lights of the demo, most stay in the same cells
+			for (uint32_t current_light_index = 0; current_light_index < moving_light_count; ++current_light_index)
+			{
+				DirectX::BoundingSphere& bounds = light_bounds[current_light_index * 100];
+				bounds.Center.x += 0.25f;
+				spatial_hash.update(current_light_index * 100, bounds);
+			}
+
+			run_queries();
+		}
+	}) / frame_count;
+
+	// Reference: testing every light per query, only a few queries since it is slow
+	const uint32_t linear_query_count = context.select(100u, 10u);
+	size_t linear_result_count = 0;
+	const double linear_ms = context.time_ms([&]()
+	{
+		linear_result_count = 0;
+		for (uint32_t current_query = 0; current_query < linear_query_count; ++current_query)
+		{
+			for (const DirectX::BoundingSphere& current_bounds : light_bounds)
+			{
+				linear_result_count += current_bounds.Intersects(query_bounds[current_query]) ? 1 : 0;
+			}
+		}
+	});
+
+	// The hash has to report exactly the lights the linear scan found
+	size_t hash_result_count = 0;
+	for (uint32_t current_query = 0; current_query < linear_query_count; ++current_query)
+	{
+		light_ids.clear();
+		spatial_hash.query(query_bounds[current_query], light_ids);
+		hash_result_count += light_ids.size();
+	}
+
+	FORWARDPLUSDEMO_CHECK(hash_result_count == linear_result_count);
+
+	context.report("%u lights, %u queries per frame, build %.2f ms", light_count, queries_per_frame, build_ms);
+	context.report("static lights: %.3f ms per frame (%.3f us per query, %.2f lights per query)", static_frame_ms, static_frame_ms * 1000.0 / queries_per_frame, static_cast<double>(result_count) / queries_per_frame);
+	context.report("%u moving lights: %.3f ms per frame including the updates", moving_light_count, moving_frame_ms);
+	context.report("linear scan reference: %.3f ms per query, %.0f ms for a frame of queries", linear_ms / linear_query_count, linear_ms / linear_query_count * queries_per_frame);
+}
@@ -0,0 +1,169 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Render/LightSpatialHash.hpp>
+#include <ForwardPlusDemo/Utilities/Random.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	std::vector<DirectX::BoundingSphere> generate_light_bounds(uint32_t light_count, float extent, uint64_t seed)
+	{
+		Random random(seed);
+
+		std::vector<DirectX::BoundingSphere> light_bounds(light_count);
+		for (DirectX::BoundingSphere& current_bounds : light_bounds)
+		{
+			current_bounds.Center = Vector3(random.next_float(-extent, extent), random.next_float(-4.0f, 4.0f), random.next_float(-extent, extent));
+			current_bounds.Radius = random.next_float(0.5f, 12.0f);
+		}
+
+		// A few lights big enough to go to the oversized list
+		for (uint32_t current_light_index = 0; current_light_index < light_count; current_light_index += 97)
+		{
+			light_bounds[current_light_index].Radius = 60.0f;
+		}
+
+		return light_bounds;
+	}
+
+	template<typename TestFunc>
+	std::vector<uint32_t> brute_force_query(const std::vector<DirectX::BoundingSphere>& light_bounds, TestFunc&& test)
+	{
+		std::vector<uint32_t> light_ids;
+		for (uint32_t current_light_index = 0; current_light_index < light_bounds.size(); ++current_light_index)
+		{
+			if (test(light_bounds[current_light_index]))
+			{
+				light_ids.push_back(current_light_index);
+			}
+		}
+
+		return light_ids;
+	}
+
+	std::vector<uint32_t> sorted(std::vector<uint32_t> light_ids)
+	{
+		std::sort(light_ids.begin(), light_ids.end());
+		return light_ids;
+	}
+}
+
+FORWARDPLUSDEMO_TEST(light_spatial_hash, queries_match_brute_force)
+{
+	const std::vector<DirectX::BoundingSphere> light_bounds = generate_light_bounds(2000, 100.0f, 7);
+
+	LightSpatialHash spatial_hash;
+	for (uint32_t current_light_index = 0; current_light_index < light_bounds.size(); ++current_light_index)
+	{
+		spatial_hash.insert(current_light_index, light_bounds[current_light_index]);
+	}
+
+	FORWARDPLUSDEMO_CHECK(spatial_hash.get_light_count() == light_bounds.size());
+
+	Random random(11);
+	for (uint32_t current_query = 0; current_query < 200; ++current_query)
+	{
+		const Vector3 center(random.next_float(-110.0f, 110.0f), random.next_float(-5.0f, 5.0f), random.next_float(-110.0f, 110.0f));
+
+		const DirectX::BoundingBox box(center, Vector3(random.next_float(0.1f, 10.0f), random.next_float(0.1f, 10.0f), random.next_float(0.1f, 10.0f)));
+		std::vector<uint32_t> box_lights;
+		spatial_hash.query(box, box_lights);
+		FORWARDPLUSDEMO_CHECK(sorted(box_lights) == brute_force_query(light_bounds, [&box](const DirectX::BoundingSphere& bounds) { return bounds.Intersects(box); }));
+
+		const DirectX::BoundingSphere sphere(center, random.next_float(0.1f, 20.0f));
+		std::vector<uint32_t> sphere_lights;
+		spatial_hash.query(sphere, sphere_lights);
+		FORWARDPLUSDEMO_CHECK(sorted(sphere_lights) == brute_force_query(light_bounds, [&sphere](const DirectX::BoundingSphere& bounds) { return bounds.Intersects(sphere); }));
+
+		std::vector<uint32_t> point_lights;
+		spatial_hash.query(center, point_lights);
+		FORWARDPLUSDEMO_CHECK(sorted(point_lights) == brute_force_query(light_bounds, [&center](const DirectX::BoundingSphere& bounds) { return bounds.Contains(to_xmvector(center)) != DirectX::DISJOINT; }));
+	}
+}
+
+FORWARDPLUSDEMO_TEST(light_spatial_hash, update_and_remove)
+{
+	LightSpatialHash spatial_hash;
+	spatial_hash.insert(0, DirectX::BoundingSphere(Vector3(0.0f, 0.0f, 0.0f), 1.0f));
+	spatial_hash.insert(1, DirectX::BoundingSphere(Vector3(50.0f, 0.0f, 0.0f), 1.0f));
+
+	// Small move inside the same cells, then a move to other cells
+	spatial_hash.update(0, DirectX::BoundingSphere(Vector3(0.5f, 0.0f, 0.0f), 1.0f));
+	std::vector<uint32_t> light_ids;
+	spatial_hash.query(Vector3(1.4f, 0.0f, 0.0f), light_ids);
+	FORWARDPLUSDEMO_CHECK(light_ids == std::vector<uint32_t>{ 0 });
+
+	spatial_hash.update(0, DirectX::BoundingSphere(Vector3(-30.0f, 0.0f, 0.0f), 1.0f));
+	light_ids.clear();
+	spatial_hash.query(Vector3(0.5f, 0.0f, 0.0f), light_ids);
+	FORWARDPLUSDEMO_CHECK(light_ids.empty());
+
+	spatial_hash.query(Vector3(-30.0f, 0.0f, 0.0f), light_ids);
+	FORWARDPLUSDEMO_CHECK(light_ids == std::vector<uint32_t>{ 0 });
+
+	spatial_hash.remove(1);
+	light_ids.clear();
+	spatial_hash.query(Vector3(50.0f, 0.0f, 0.0f), light_ids);
+	FORWARDPLUSDEMO_CHECK(light_ids.empty());
+	FORWARDPLUSDEMO_CHECK(spatial_hash.get_light_count() == 1);
+}
+
+FORWARDPLUSDEMO_TEST(light_spatial_hash, queries_during_updates)
+{
+	// Queries take the shared lock, so readers on other threads always see a consistent hash while lights move
+	// Updates must still make progress while the readers query back to back
+	const std::vector<DirectX::BoundingSphere> light_bounds = generate_light_bounds(1000, 50.0f, 3);
+
+	LightSpatialHash spatial_hash;
+	for (uint32_t current_light_index = 0; current_light_index < light_bounds.size(); ++current_light_index)
+	{
+		spatial_hash.insert(current_light_index, light_bounds[current_light_index]);
+	}
+
+	std::atomic<bool> done = false;
+	std::atomic<uint32_t> bad_result_count = 0;
+
+	std::vector<std::thread> query_threads;
+	for (uint32_t current_thread = 0; current_thread < 3; ++current_thread)
+	{
+		query_threads.emplace_back([&]()
+		{
+			std::vector<uint32_t> light_ids;
+			while (!done.load())
+			{
+				light_ids.clear();
+				spatial_hash.query(DirectX::BoundingBox(Vector3(0.0f, 0.0f, 0.0f), Vector3(20.0f, 20.0f, 20.0f)), light_ids);
+
+				// Each light is reported at most once, and only valid IDs
+				const std::vector<uint32_t> sorted_ids = sorted(light_ids);
+				if ((std::adjacent_find(sorted_ids.begin(), sorted_ids.end()) != sorted_ids.end()) || (!sorted_ids.empty() && (sorted_ids.back() >= light_bounds.size())))
+				{
+					bad_result_count.fetch_add(1);
+				}
+			}
+		});
+	}
+
+	Random random(5);
+	for (uint32_t current_update = 0; current_update < 2000; ++current_update)
+	{
+		const uint32_t light_index = random.next_uint32(static_cast<uint32_t>(light_bounds.size()));
+		const Vector3 center(random.next_float(-50.0f, 50.0f), 0.0f, random.next_float(-50.0f, 50.0f));
+		spatial_hash.update(light_index, DirectX::BoundingSphere(center, light_bounds[light_index].Radius));
+	}
+
+	done = true;
+	for (std::thread& current_thread : query_threads)
+	{
+		current_thread.join();
+	}
+
+	FORWARDPLUSDEMO_CHECK(bad_result_count.load() == 0);
+	FORWARDPLUSDEMO_CHECK(spatial_hash.get_light_count() == light_bounds.size());
+}
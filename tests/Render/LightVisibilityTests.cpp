@@ -0,0 +1,117 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Render/LightVisibility.hpp>
+
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	// Camera at the origin looking down +Z, like the view space frustum LightSystem builds from the projection
+	struct TestCamera
+	{
+		XMMatrix projection = DirectX::XMMatrixPerspectiveFovLH(DirectX::XM_PIDIV2, 16.0f / 9.0f, 0.1f, 1000.0f);
+		DirectX::BoundingFrustum frustum = DirectX::BoundingFrustum(projection);
+		XMVector position = DirectX::XMVectorZero();
+
+		LightVisibility classify(LightType type, const DirectX::BoundingSphere& bounds, bool occluded = false) const
+		{
+			return get_light_visibility(type, bounds, frustum, position, projection, [occluded](const DirectX::BoundingSphere&) { return occluded; });
+		}
+	};
+}
+
+FORWARDPLUSDEMO_TEST(light_visibility, classification)
+{
+	const TestCamera camera;
+
+	const DirectX::BoundingSphere behind_camera(Vector3(0.0f, 0.0f, -50.0f), 1.0f);
+	const DirectX::BoundingSphere small_and_far(Vector3(0.0f, 0.0f, 100.0f), 1.0f);
+	const DirectX::BoundingSphere around_camera(Vector3(0.0f, 0.0f, 1.0f), 10.0f);
+
+	// Directional lights skip every test, even with bounds outside the frustum
+	FORWARDPLUSDEMO_CHECK(camera.classify(LightType::DIRECTIONAL, behind_camera) == LightVisibility::GLOBAL);
+	FORWARDPLUSDEMO_CHECK(camera.classify(LightType::DIRECTIONAL, small_and_far, true) == LightVisibility::GLOBAL);
+
+	for (LightType type : { LightType::POINT, LightType::SPOT })
+	{
+		FORWARDPLUSDEMO_CHECK(camera.classify(type, behind_camera) == LightVisibility::HIDDEN);
+		FORWARDPLUSDEMO_CHECK(camera.classify(type, small_and_far) == LightVisibility::LOCAL);
+		FORWARDPLUSDEMO_CHECK(camera.classify(type, small_and_far, true) == LightVisibility::HIDDEN);
+		FORWARDPLUSDEMO_CHECK(camera.classify(type, around_camera) == LightVisibility::SCREEN_FILLING);
+		FORWARDPLUSDEMO_CHECK(camera.classify(type, around_camera, true) == LightVisibility::HIDDEN);
+	}
+}
+
+FORWARDPLUSDEMO_TEST(light_visibility, occlusion_test_only_for_lights_in_frustum)
+{
+	const TestCamera camera;
+
+	uint32_t occlusion_test_count = 0;
+	auto is_occluded = [&occlusion_test_count](const DirectX::BoundingSphere&)
+	{
+		++occlusion_test_count;
+		return false;
+	};
+
+	get_light_visibility(LightType::DIRECTIONAL, DirectX::BoundingSphere(Vector3(0.0f, 0.0f, 10.0f), 1.0f), camera.frustum, camera.position, camera.projection, is_occluded);
+	get_light_visibility(LightType::POINT, DirectX::BoundingSphere(Vector3(0.0f, 0.0f, -10.0f), 1.0f), camera.frustum, camera.position, camera.projection, is_occluded);
+	FORWARDPLUSDEMO_CHECK(occlusion_test_count == 0);
+
+	get_light_visibility(LightType::POINT, DirectX::BoundingSphere(Vector3(0.0f, 0.0f, 10.0f), 1.0f), camera.frustum, camera.position, camera.projection, is_occluded);
+	FORWARDPLUSDEMO_CHECK(occlusion_test_count == 1);
+}
+
+FORWARDPLUSDEMO_TEST(light_visibility, screen_coverage)
+{
+	const TestCamera camera;
+
+	// Full screen from inside the light, then shrinking with distance
+	FORWARDPLUSDEMO_CHECK(get_screen_coverage(DirectX::BoundingSphere(Vector3(0.0f, 0.0f, 2.0f), 5.0f), camera.position, camera.projection) == 1.0f);
+
+	float previous_coverage = 1.0f;
+	for (float distance : { 6.0f, 12.0f, 25.0f, 50.0f, 100.0f })
+	{
+		const float coverage = get_screen_coverage(DirectX::BoundingSphere(Vector3(0.0f, 0.0f, distance), 5.0f), camera.position, camera.projection);
+		FORWARDPLUSDEMO_CHECK((coverage > 0.0f) && (coverage <= previous_coverage));
+		previous_coverage = coverage;
+	}
+
+	FORWARDPLUSDEMO_CHECK(previous_coverage < c_global_light_screen_coverage);
+}
+
+FORWARDPLUSDEMO_TEST(light_visibility, global_list_limit)
+{
+	FORWARDPLUSDEMO_CHECK(get_light_placement(LightVisibility::GLOBAL, 0) == LightVisibility::GLOBAL);
+	FORWARDPLUSDEMO_CHECK(get_light_placement(LightVisibility::SCREEN_FILLING, 0) == LightVisibility::GLOBAL);
+	FORWARDPLUSDEMO_CHECK(get_light_placement(LightVisibility::LOCAL, 0) == LightVisibility::LOCAL);
+	FORWARDPLUSDEMO_CHECK(get_light_placement(LightVisibility::HIDDEN, 0) == LightVisibility::HIDDEN);
+
+	// Once the list is full, screen-filling lights fall back to culling and directional lights are dropped
+	FORWARDPLUSDEMO_CHECK(get_light_placement(LightVisibility::GLOBAL, c_max_global_light_count) == LightVisibility::HIDDEN);
+	FORWARDPLUSDEMO_CHECK(get_light_placement(LightVisibility::SCREEN_FILLING, c_max_global_light_count) == LightVisibility::LOCAL);
+	FORWARDPLUSDEMO_CHECK(get_light_placement(LightVisibility::LOCAL, c_max_global_light_count) == LightVisibility::LOCAL);
+
+	// Same gather order as LightSystem: 50 screen-filling lights, then 30 directional ones
+	std::vector<LightVisibility> visibilities(50, LightVisibility::SCREEN_FILLING);
+	visibilities.insert(visibilities.end(), 30, LightVisibility::GLOBAL);
+
+	uint32_t global_light_count = 0;
+	uint32_t local_light_count = 0;
+	uint32_t dropped_light_count = 0;
+	for (LightVisibility visibility : visibilities)
+	{
+		switch (get_light_placement(visibility, global_light_count))
+		{
+		case LightVisibility::GLOBAL: ++global_light_count; break;
+		case LightVisibility::LOCAL: ++local_light_count; break;
+		case LightVisibility::HIDDEN: ++dropped_light_count; break;
+		case LightVisibility::SCREEN_FILLING: FORWARDPLUSDEMO_CHECK(false); break;
+		}
+	}
+
+	FORWARDPLUSDEMO_CHECK(global_light_count == c_max_global_light_count);
+	FORWARDPLUSDEMO_CHECK(local_light_count == 0);
+	FORWARDPLUSDEMO_CHECK(dropped_light_count == 80 - c_max_global_light_count);
+}
@@ -0,0 +1,52 @@
+#include <TestFramework.hpp>
+#include <Render/TestMeshes.hpp>
+
+#include <ForwardPlusDemo/Render/MeshOptimizer.hpp>
+
+using namespace ForwardPlusDemo;
+using namespace ForwardPlusDemo::Testing;
+
+// ACMR of welded meshes before & after the vertex cache and overdraw passes, at 16 & 32 entry FIFOs, and the time both passes take
+FORWARDPLUSDEMO_BENCHMARK(mesh_optimizer_acmr)
+{
+	struct TestCase
+	{
+		const char* name;
+		TestMesh mesh;
+	};
+
+	TestCase test_cases[] =
+	{
+		{ "demo plane, row order", make_grid(32) },
+		{ "grid, row order", make_grid(context.select(256u, 64u)) },
+		{ "grid, shuffled", make_grid(context.select(256u, 64u)) },
+		{ "subdivided cube, shuffled", make_subdivided_cube(context.select(16u, 4u)) },
+	};
+
+	shuffle_triangles(test_cases[2].mesh.indices, 1);
+	shuffle_triangles(test_cases[3].mesh.indices, 2);
+
+	for (const TestCase& current_case : test_cases)
+	{
+		const TestMesh& mesh = current_case.mesh;
+		const uint32_t triangle_count = static_cast<uint32_t>(mesh.indices.size() / 3);
+
+		std::vector<uint32_t> cache_indices;
+		std::vector<uint32_t> overdraw_indices;
+		const double optimize_ms = context.time_ms([&]()
+		{
+			cache_indices = mesh.indices;
+			optimize_vertex_cache(cache_indices, mesh.get_vertex_count());
+
+			overdraw_indices = cache_indices;
+			optimize_overdraw(overdraw_indices, mesh.positions);
+		});
+
+		context.report("%s (%u triangles): ACMR 16/32 input %.3f/%.3f, vertex cache %.3f/%.3f, overdraw %.3f/%.3f, %.2f ms (%.0f ns per triangle)\n",
+			current_case.name, triangle_count,
+			get_acmr(mesh.indices, mesh.get_vertex_count(), 16), get_acmr(mesh.indices, mesh.get_vertex_count(), 32),
+			get_acmr(cache_indices, mesh.get_vertex_count(), 16), get_acmr(cache_indices, mesh.get_vertex_count(), 32),
+			get_acmr(overdraw_indices, mesh.get_vertex_count(), 16), get_acmr(overdraw_indices, mesh.get_vertex_count(), 32),
+			optimize_ms, (optimize_ms * 1e6) / triangle_count);
+	}
+}
@@ -0,0 +1,155 @@
+#include <TestFramework.hpp>
+#include <Render/TestMeshes.hpp>
+
+#include <ForwardPlusDemo/Render/MeshBuilder.hpp>
+#include <ForwardPlusDemo/Render/MeshOptimizer.hpp>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+using namespace ForwardPlusDemo::Testing;
+
+namespace
+{
+	using TriangleKey = std::array<uint32_t, 3>;
+
+	// Triangles as a sorted list, each rotated to start at its smallest index so the winding still counts
+	std::vector<TriangleKey> get_triangle_keys(const std::vector<uint32_t>& indices)
+	{
+		std::vector<TriangleKey> keys;
+		for (size_t current_corner = 0; (current_corner + 2) < indices.size(); current_corner += 3)
+		{
+			TriangleKey key = { indices[current_corner], indices[current_corner + 1], indices[current_corner + 2] };
+			std::rotate(key.begin(), std::min_element(key.begin(), key.end()), key.end());
+			keys.push_back(key);
+		}
+
+		std::sort(keys.begin(), keys.end());
+		return keys;
+	}
+
+	struct TestVertex
+	{
+		Vector4 position;
+		Vector4 normal;
+	};
+}
+
+FORWARDPLUSDEMO_TEST(mesh_optimizer, acmr_fifo_model)
+{
+	FORWARDPLUSDEMO_CHECK(get_acmr({}, 0) == 0.0f);
+
+	// No shared vertices is the worst case, a repeated triangle only misses the first time
+	FORWARDPLUSDEMO_CHECK(get_acmr({ 0, 1, 2, 3, 4, 5 }, 6) == 3.0f);
+	FORWARDPLUSDEMO_CHECK(get_acmr({ 0, 1, 2, 0, 1, 2 }, 3) == 1.5f);
+	FORWARDPLUSDEMO_CHECK(get_acmr({ 0, 1, 2, 2, 1, 3 }, 4) == 2.0f);
+
+	// FIFO, not LRU: hits don't refresh a vertex, so 0 drops out after two more loads with a cache of 3
+	FORWARDPLUSDEMO_CHECK(get_acmr({ 0, 1, 2, 0, 2, 3, 0, 3, 4 }, 5, 3) == (6.0f / 3.0f));
+	FORWARDPLUSDEMO_CHECK(get_acmr({ 0, 1, 2, 0, 2, 3, 0, 3, 4 }, 5, 16) == (5.0f / 3.0f));
+}
+
+FORWARDPLUSDEMO_TEST(mesh_optimizer, vertex_cache_keeps_triangles)
+{
+	TestMesh mesh = make_grid(64);
+	shuffle_triangles(mesh.indices, 7);
+
+	const std::vector<TriangleKey> input_triangles = get_triangle_keys(mesh.indices);
+	const float input_acmr = get_acmr(mesh.indices, mesh.get_vertex_count());
+
+	optimize_vertex_cache(mesh.indices, mesh.get_vertex_count());
+	FORWARDPLUSDEMO_CHECK(get_triangle_keys(mesh.indices) == input_triangles);
+
+	// A random order misses on almost every corner, the optimized one gets close to the 0.5 lower bound for grids
+	const float output_acmr = get_acmr(mesh.indices, mesh.get_vertex_count());
+	FORWARDPLUSDEMO_CHECK(input_acmr > 2.5f);
+	FORWARDPLUSDEMO_CHECK(output_acmr < 0.8f);
+
+	// Nothing to do for an empty mesh
+	std::vector<uint32_t> empty_indices;
+	optimize_vertex_cache(empty_indices, 0);
+	FORWARDPLUSDEMO_CHECK(empty_indices.empty());
+}
+
+FORWARDPLUSDEMO_TEST(mesh_optimizer, overdraw_keeps_clusters)
+{
+	TestMesh mesh = make_subdivided_cube(8);
+	FORWARDPLUSDEMO_CHECK(mesh.get_vertex_count() == (6 * 9 * 9) - (12 * 9) + 8);
+
+	shuffle_triangles(mesh.indices, 11);
+	optimize_vertex_cache(mesh.indices, mesh.get_vertex_count());
+
+	const std::vector<TriangleKey> input_triangles = get_triangle_keys(mesh.indices);
+	const float input_acmr = get_acmr(mesh.indices, mesh.get_vertex_count());
+
+	optimize_overdraw(mesh.indices, mesh.positions);
+	FORWARDPLUSDEMO_CHECK(get_triangle_keys(mesh.indices) == input_triangles);
+
+	// Clusters start where the cache restarts, only the hits on vertices left over from the previous cluster can be lost
+	const float output_acmr = get_acmr(mesh.indices, mesh.get_vertex_count());
+	FORWARDPLUSDEMO_CHECK(output_acmr <= (input_acmr * 1.1f));
+}
+
+FORWARDPLUSDEMO_TEST(mesh_optimizer, vertex_fetch_remap)
+{
+	std::vector<uint32_t> remap;
+	const uint32_t used_vertex_count = get_vertex_fetch_remap({ 4, 2, 0, 2, 4, 5 }, 7, remap);
+
+	FORWARDPLUSDEMO_CHECK(used_vertex_count == 4);
+	FORWARDPLUSDEMO_CHECK(remap == std::vector<uint32_t>({ 2, UINT32_MAX, 1, UINT32_MAX, 0, 3, UINT32_MAX }));
+}
+
+// Same plane as RenderSystem builds: 32x32 quads, two triangles each with unshared corners
+FORWARDPLUSDEMO_TEST(mesh_optimizer, mesh_builder_plane)
+{
+	constexpr uint32_t c_plane_resolution = 32;
+	constexpr float c_plane_step = 1.0f / c_plane_resolution;
+
+	MeshBuilder<TestVertex> mesh_builder;
+	mesh_builder.begin_mesh();
+
+	const Vector4 normal(0.0f, 1.0f, 0.0f, 0.0f);
+	for (uint32_t current_z = 0; current_z < c_plane_resolution; ++current_z)
+	{
+		for (uint32_t current_x = 0; current_x < c_plane_resolution; ++current_x)
+		{
+			const float x_offset = -0.5f + current_x * c_plane_step;
+			const float z_offset = 0.5f - current_z * c_plane_step;
+
+			const TestVertex top_left{ Vector4(x_offset, 0.0f, z_offset, 1.0f), normal };
+			const TestVertex top_right{ Vector4(x_offset + c_plane_step, 0.0f, z_offset, 1.0f), normal };
+			const TestVertex bottom_left{ Vector4(x_offset, 0.0f, z_offset - c_plane_step, 1.0f), normal };
+			const TestVertex bottom_right{ Vector4(x_offset + c_plane_step, 0.0f, z_offset - c_plane_step, 1.0f), normal };
+
+			mesh_builder.add_triangle(top_left, top_right, bottom_left);
+			mesh_builder.add_triangle(top_right, bottom_right, bottom_left);
+		}
+	}
+
+	const MeshRange range = mesh_builder.end_mesh();
+	FORWARDPLUSDEMO_CHECK(range.input_vertex_count == c_plane_resolution * c_plane_resolution * 6);
+	FORWARDPLUSDEMO_CHECK(range.vertex_count == (c_plane_resolution + 1) * (c_plane_resolution + 1));
+	FORWARDPLUSDEMO_CHECK(range.index_count == c_plane_resolution * c_plane_resolution * 6);
+	FORWARDPLUSDEMO_CHECK(range.output_acmr < range.input_acmr);
+	FORWARDPLUSDEMO_CHECK(range.output_acmr < 0.75f);
+
+	FORWARDPLUSDEMO_CHECK(mesh_builder.get_vertices().size() == range.vertex_count);
+	FORWARDPLUSDEMO_CHECK(mesh_builder.get_index_format() == IndexFormat::UINT16);
+
+	// Every quad still has both triangles with the same winding (facing +Y)
+	const std::vector<uint8_t> index_data = mesh_builder.get_index_data();
+	FORWARDPLUSDEMO_CHECK(index_data.size() == range.index_count * sizeof(uint16_t));
+
+	const uint16_t* indices = reinterpret_cast<const uint16_t*>(index_data.data());
+	for (uint32_t current_corner = 0; current_corner < range.index_count; current_corner += 3)
+	{
+		FORWARDPLUSDEMO_CHECK(std::max({ indices[current_corner], indices[current_corner + 1], indices[current_corner + 2] }) < range.vertex_count);
+
+		const XMVector p0 = to_xmvector(mesh_builder.get_vertices()[indices[current_corner]].position);
+		const XMVector p1 = to_xmvector(mesh_builder.get_vertices()[indices[current_corner + 1]].position);
+		const XMVector p2 = to_xmvector(mesh_builder.get_vertices()[indices[current_corner + 2]].position);
+		FORWARDPLUSDEMO_CHECK(DirectX::XMVectorGetY(DirectX::XMVector3Cross(p1 - p0, p2 - p0)) > 0.0f);
+	}
+}
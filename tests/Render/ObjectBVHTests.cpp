@@ -0,0 +1,161 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Render/ObjectBVH.hpp>
+#include <ForwardPlusDemo/Utilities/JobSystem.hpp>
+#include <ForwardPlusDemo/Utilities/Random.hpp>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	// Objects of the generated scenes are a few meters wide, over a few hundred meters
+	std::vector<DirectX::BoundingBox> generate_object_bounds(uint32_t object_count, float extent, uint64_t seed)
+	{
+		Random random(seed);
+
+		std::vector<DirectX::BoundingBox> object_bounds(object_count);
+		for (DirectX::BoundingBox& current_bounds : object_bounds)
+		{
+			current_bounds.Center = Vector3(random.next_float(-extent, extent), random.next_float(-10.0f, 30.0f), random.next_float(-extent, extent));
+			current_bounds.Extents = Vector3(random.next_float(0.1f, 4.0f), random.next_float(0.1f, 4.0f), random.next_float(0.1f, 4.0f));
+		}
+
+		// A few large ones (e.g ground planes) that overlap many nodes
+		for (uint32_t current_object = 0; current_object < object_count; current_object += 997)
+		{
+			object_bounds[current_object].Extents = Vector3(100.0f, 0.5f, 100.0f);
+		}
+
+		return object_bounds;
+	}
+
+	// World space frustum of a camera at position, turned by yaw & pitch (radians)
+	DirectX::BoundingFrustum make_frustum(const Vector3& position, float yaw, float pitch, float far_z = 300.0f)
+	{
+		const XMMatrix projection = DirectX::XMMatrixPerspectiveFovLH(DirectX::XM_PIDIV4, 16.0f / 9.0f, 0.1f, far_z);
+
+		DirectX::BoundingFrustum frustum(projection);
+		frustum.Transform(frustum, 1.0f, DirectX::XMQuaternionRotationRollPitchYaw(pitch, yaw, 0.0f), to_xmvector(position));
+
+		return frustum;
+	}
+
+	std::vector<DirectX::BoundingFrustum> get_test_frustums()
+	{
+		return
+		{
+			make_frustum(Vector3(0.0f, 2.0f, 0.0f), 0.0f, 0.0f),
+			make_frustum(Vector3(-200.0f, 50.0f, -200.0f), DirectX::XM_PIDIV4, 0.3f),
+			make_frustum(Vector3(100.0f, 5.0f, 50.0f), -2.0f, -0.1f, 50.0f),
+			make_frustum(Vector3(0.0f, 500.0f, 0.0f), 0.0f, DirectX::XM_PIDIV2 - 0.01f, 1000.0f), // Looking down at everything
+			make_frustum(Vector3(0.0f, 2000.0f, 0.0f), 0.0f, -0.5f), // Nothing in range
+		};
+	}
+
+	// Reference: every box against the six planes, as conservative as the BVH (boxes outside near a frustum corner still pass)
+	std::vector<uint32_t> brute_force_cull(const std::vector<DirectX::BoundingBox>& object_bounds, const DirectX::BoundingFrustum& frustum)
+	{
+		std::array<XMVector, 6> planes;
+		frustum.GetPlanes(&planes[0], &planes[1], &planes[2], &planes[3], &planes[4], &planes[5]);
+
+		std::vector<uint32_t> visible_objects;
+		for (uint32_t current_object = 0; current_object < object_bounds.size(); ++current_object)
+		{
+			const XMVector center = DirectX::XMVectorSetW(DirectX::XMLoadFloat3(&object_bounds[current_object].Center), 1.0f);
+			const XMVector extents = DirectX::XMLoadFloat3(&object_bounds[current_object].Extents);
+
+			// Planes face outward, a box is outside when its center is further out than its projected radius
+			const bool outside = std::any_of(planes.begin(), planes.end(), [&center, &extents](const XMVector& plane)
+			{
+				const float radius = DirectX::XMVectorGetX(DirectX::XMVector3Dot(DirectX::XMVectorAbs(plane), extents));
+				return DirectX::XMVectorGetX(DirectX::XMVector4Dot(plane, center)) > radius;
+			});
+
+			if (!outside)
+			{
+				visible_objects.push_back(current_object);
+			}
+		}
+
+		return visible_objects;
+	}
+
+	std::vector<uint32_t> sorted(std::vector<uint32_t> values)
+	{
+		std::sort(values.begin(), values.end());
+		return values;
+	}
+
+	void check_against_brute_force(uint32_t object_count, JobSystem* job_system)
+	{
+		const std::vector<DirectX::BoundingBox> object_bounds = generate_object_bounds(object_count, 400.0f, object_count);
+
+		ObjectBVH bvh;
+		bvh.build(object_bounds);
+		FORWARDPLUSDEMO_CHECK(bvh.get_object_count() == object_count);
+
+		size_t total_visible_count = 0;
+		std::vector<uint32_t> visible_objects;
+		for (const DirectX::BoundingFrustum& current_frustum : get_test_frustums())
+		{
+			bvh.cull(current_frustum, visible_objects, job_system);
+
+			const std::vector<uint32_t> expected_objects = brute_force_cull(object_bounds, current_frustum);
+			FORWARDPLUSDEMO_CHECK(sorted(visible_objects) == expected_objects);
+			total_visible_count += visible_objects.size();
+
+			if (job_system != nullptr)
+			{
+				// Same order as the serial traversal
+				std::vector<uint32_t> serial_objects;
+				bvh.cull(current_frustum, serial_objects);
+				FORWARDPLUSDEMO_CHECK(visible_objects == serial_objects);
+			}
+		}
+
+		// The frustums see some of the scene, but not all of it every time
+		FORWARDPLUSDEMO_CHECK((total_visible_count > 0) && (total_visible_count < object_count * get_test_frustums().size()));
+	}
+}
+
+FORWARDPLUSDEMO_TEST(object_bvh, serial_cull_matches_brute_force)
+{
+	for (uint32_t object_count : { 1u, 3u, 4u, 5u, 17u, 100u, 5000u })
+	{
+		check_against_brute_force(object_count, nullptr);
+	}
+}
+
+FORWARDPLUSDEMO_TEST(object_bvh, parallel_cull_matches_brute_force)
+{
+	// Enough objects for the subtree tasks (c_min_parallel_object_count in ObjectBVH.cpp)
+	JobSystem job_system(4);
+	check_against_brute_force(40000, &job_system);
+
+	// Below the threshold the job system is ignored
+	check_against_brute_force(1000, &job_system);
+}
+
+FORWARDPLUSDEMO_TEST(object_bvh, empty_and_rebuilt)
+{
+	ObjectBVH bvh;
+
+	std::vector<uint32_t> visible_objects = { 7 };
+	bvh.cull(make_frustum(Vector3(0.0f, 0.0f, 0.0f), 0.0f, 0.0f), visible_objects);
+	FORWARDPLUSDEMO_CHECK(visible_objects.empty());
+
+	bvh.build(generate_object_bounds(100, 50.0f, 1));
+	bvh.build({ DirectX::BoundingBox(Vector3(0.0f, 0.0f, 10.0f), Vector3(1.0f, 1.0f, 1.0f)), DirectX::BoundingBox(Vector3(0.0f, 0.0f, -10.0f), Vector3(1.0f, 1.0f, 1.0f)) });
+	FORWARDPLUSDEMO_CHECK(bvh.get_object_count() == 2);
+
+	bvh.cull(make_frustum(Vector3(0.0f, 0.0f, 0.0f), 0.0f, 0.0f), visible_objects);
+	FORWARDPLUSDEMO_CHECK(visible_objects == std::vector<uint32_t>{ 0 });
+
+	bvh.clear();
+	bvh.cull(make_frustum(Vector3(0.0f, 0.0f, 0.0f), 0.0f, 0.0f), visible_objects);
+	FORWARDPLUSDEMO_CHECK(visible_objects.empty() && (bvh.get_object_count() == 0));
+}
@@ -0,0 +1,327 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Scene/ScenarioGenerator.hpp>
+
+#include <DirectXCollision.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <iterator>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	constexpr int32_t c_screen_width = 1920;
+	constexpr int32_t c_screen_height = 1080;
+
+	// Tile grid of LightSystem.cpp, tile sizes follow the resolution
+	constexpr int32_t c_tile_count_x = 32;
+	constexpr int32_t c_tile_count_y = 24;
+	constexpr int32_t c_tile_x_dim = c_screen_width / c_tile_count_x;
+	constexpr int32_t c_tile_y_dim = c_screen_height / c_tile_count_y;
+
+	constexpr float c_near_z = 0.1f;
+	constexpr float c_far_z = 1000.0f;
+
+	// Pixel rectangle (max exclusive) & view depth range of a box
+	struct ScreenBounds
+	{
+		int32_t min_x = 0;
+		int32_t min_y = 0;
+		int32_t max_x = 0;
+		int32_t max_y = 0;
+		float min_z = 0.0f;
+		float max_z = 0.0f;
+
+		bool is_visible() const { return (min_x < max_x) && (min_y < max_y) && (max_z > c_near_z) && (min_z < c_far_z); }
+		int64_t get_area() const { return static_cast<int64_t>(max_x - min_x) * (max_y - min_y); }
+	};
+
+	ScreenBounds get_screen_bounds(const DirectX::BoundingBox& box, const XMMatrix& view, const XMMatrix& projection)
+	{
+		Vector3 corners[DirectX::BoundingBox::CORNER_COUNT];
+		box.GetCorners(corners);
+
+		ScreenBounds bounds;
+		bounds.min_z = FLT_MAX;
+		bounds.max_z = -FLT_MAX;
+
+		XMVector view_corners[DirectX::BoundingBox::CORNER_COUNT];
+		for (size_t current_corner = 0; current_corner < DirectX::BoundingBox::CORNER_COUNT; ++current_corner)
+		{
+			view_corners[current_corner] = DirectX::XMVector3Transform(DirectX::XMLoadFloat3(&corners[current_corner]), view);
+
+			const float view_z = DirectX::XMVectorGetZ(view_corners[current_corner]);
+			bounds.min_z = std::min(bounds.min_z, view_z);
+			bounds.max_z = std::max(bounds.max_z, view_z);
+		}
+
+		// Corners in front of the near plane, plus where the box edges cross it
+		XMVector clipped_points[DirectX::BoundingBox::CORNER_COUNT + 12];
+		size_t clipped_point_count = 0;
+		for (size_t current_corner = 0; current_corner < DirectX::BoundingBox::CORNER_COUNT; ++current_corner)
+		{
+			const float corner_z = DirectX::XMVectorGetZ(view_corners[current_corner]);
+			if (corner_z >= c_near_z)
+			{
+				clipped_points[clipped_point_count++] = view_corners[current_corner];
+			}
+
+			// Corners differing in one bit of the index share an edge
+			for (size_t axis_bit = 1; axis_bit < DirectX::BoundingBox::CORNER_COUNT; axis_bit <<= 1)
+			{
+				const size_t other_corner = current_corner | axis_bit;
+				if (other_corner == current_corner)
+				{
+					continue;
+				}
+
+				const float other_z = DirectX::XMVectorGetZ(view_corners[other_corner]);
+				if ((corner_z < c_near_z) != (other_z < c_near_z))
+				{
+					const float t = (c_near_z - corner_z) / (other_z - corner_z);
+					clipped_points[clipped_point_count++] = DirectX::XMVectorLerp(view_corners[current_corner], view_corners[other_corner], t);
+				}
+			}
+		}
+
+		if (clipped_point_count == 0)
+		{
+			return bounds;
+		}
+
+		float min_ndc_x = FLT_MAX;
+		float min_ndc_y = FLT_MAX;
+		float max_ndc_x = -FLT_MAX;
+		float max_ndc_y = -FLT_MAX;
+
+		for (size_t current_point = 0; current_point < clipped_point_count; ++current_point)
+		{
+			const XMVector clip_position = DirectX::XMVector4Transform(DirectX::XMVectorSetW(clipped_points[current_point], 1.0f), projection);
+			const float w = DirectX::XMVectorGetW(clip_position);
+
+			min_ndc_x = std::min(min_ndc_x, DirectX::XMVectorGetX(clip_position) / w);
+			max_ndc_x = std::max(max_ndc_x, DirectX::XMVectorGetX(clip_position) / w);
+			min_ndc_y = std::min(min_ndc_y, DirectX::XMVectorGetY(clip_position) / w);
+			max_ndc_y = std::max(max_ndc_y, DirectX::XMVectorGetY(clip_position) / w);
+		}
+
+		bounds.min_x = static_cast<int32_t>(std::clamp((min_ndc_x * 0.5f + 0.5f) * c_screen_width, 0.0f, static_cast<float>(c_screen_width)));
+		bounds.max_x = static_cast<int32_t>(std::clamp((max_ndc_x * 0.5f + 0.5f) * c_screen_width + 1.0f, 0.0f, static_cast<float>(c_screen_width)));
+		bounds.min_y = static_cast<int32_t>(std::clamp((0.5f - max_ndc_y * 0.5f) * c_screen_height, 0.0f, static_cast<float>(c_screen_height)));
+		bounds.max_y = static_cast<int32_t>(std::clamp((0.5f - min_ndc_y * 0.5f) * c_screen_height + 1.0f, 0.0f, static_cast<float>(c_screen_height)));
+		bounds.min_z = std::max(bounds.min_z, c_near_z);
+
+		return bounds;
+	}
+
+	struct CrossoverScene
+	{
+		const char* name;
+		ScenarioParameters parameters;
+		bool ground_plane; // Like the built-in scene, one object touching every light
+	};
+
+	struct VisibleLight
+	{
+		DirectX::BoundingSphere bounds;
+		ScreenBounds screen_bounds;
+	};
+
+	struct VisibleObject
+	{
+		DirectX::BoundingBox bounds;
+		ScreenBounds screen_bounds;
+	};
+
+	// Light evaluations of the scene pass for both light culling modes, counted over the screen rectangles of the objects
+	// Per-object lists shade every pixel of an object with all the lights touching its box, tiled culling with the lights
+	// of the tile whose depth range overlaps the object (what the Z bins narrow it down to)
+	struct LightEvaluations
+	{
+		uint64_t object_lists = 0;
+		uint64_t tiles = 0;
+	};
+
+	LightEvaluations count_light_evaluations(const std::vector<VisibleLight>& lights, uint32_t light_count, const std::vector<VisibleObject>& objects)
+	{
+		std::vector<std::vector<uint32_t>> tile_lights(c_tile_count_x * c_tile_count_y);
+		for (uint32_t current_light_index = 0; current_light_index < light_count; ++current_light_index)
+		{
+			const ScreenBounds& screen_bounds = lights[current_light_index].screen_bounds;
+			for (int32_t tile_y = screen_bounds.min_y / c_tile_y_dim; tile_y <= (screen_bounds.max_y - 1) / c_tile_y_dim; ++tile_y)
+			{
+				for (int32_t tile_x = screen_bounds.min_x / c_tile_x_dim; tile_x <= (screen_bounds.max_x - 1) / c_tile_x_dim; ++tile_x)
+				{
+					tile_lights[tile_y * c_tile_count_x + tile_x].push_back(current_light_index);
+				}
+			}
+		}
+
+		LightEvaluations evaluations;
+		for (const VisibleObject& current_object : objects)
+		{
+			const ScreenBounds& object_screen_bounds = current_object.screen_bounds;
+
+			uint64_t object_light_count = 0;
+			for (uint32_t current_light_index = 0; current_light_index < light_count; ++current_light_index)
+			{
+				object_light_count += lights[current_light_index].bounds.Intersects(current_object.bounds) ? 1 : 0;
+			}
+
+			evaluations.object_lists += object_light_count * static_cast<uint64_t>(object_screen_bounds.get_area());
+
+			for (int32_t tile_y = object_screen_bounds.min_y / c_tile_y_dim; tile_y <= (object_screen_bounds.max_y - 1) / c_tile_y_dim; ++tile_y)
+			{
+				const int32_t pixel_count_y = std::min(object_screen_bounds.max_y, (tile_y + 1) * c_tile_y_dim) - std::max(object_screen_bounds.min_y, tile_y * c_tile_y_dim);
+				for (int32_t tile_x = object_screen_bounds.min_x / c_tile_x_dim; tile_x <= (object_screen_bounds.max_x - 1) / c_tile_x_dim; ++tile_x)
+				{
+					const int32_t pixel_count_x = std::min(object_screen_bounds.max_x, (tile_x + 1) * c_tile_x_dim) - std::max(object_screen_bounds.min_x, tile_x * c_tile_x_dim);
+
+					uint64_t tile_light_count = 0;
+					for (uint32_t current_light_index : tile_lights[tile_y * c_tile_count_x + tile_x])
+					{
+						const ScreenBounds& light_screen_bounds = lights[current_light_index].screen_bounds;
+						tile_light_count += ((light_screen_bounds.max_z >= object_screen_bounds.min_z) && (light_screen_bounds.min_z <= object_screen_bounds.max_z)) ? 1 : 0;
+					}
+
+					evaluations.tiles += tile_light_count * static_cast<uint64_t>(pixel_count_x) * static_cast<uint64_t>(pixel_count_y);
+				}
+			}
+		}
+
+		return evaluations;
+	}
+}
+
+// Visible light count where per-object light lists stop shading fewer lights than tiled culling, see c_object_light_list_enter_count
+FORWARDPLUSDEMO_BENCHMARK(object_light_list_crossover)
+{
+	const uint32_t object_count = context.select(3000u, 300u);
+	const float extent = 200.0f;
+
+	ScenarioParameters streetlights;
+	streetlights.type = ScenarioType::CLUSTERED_STREETLIGHTS;
+	streetlights.light_count = 4096;
+	streetlights.extent = extent;
+	streetlights.object_count = object_count;
+
+	ScenarioParameters grid = streetlights;
+	grid.type = ScenarioType::UNIFORM_GRID;
+
+	ScenarioParameters corridor = streetlights;
+	corridor.type = ScenarioType::DENSE_CORRIDOR;
+
+	const CrossoverScene scenes[] = {
+		{ "streetlights", streetlights, false },
+		{ "streetlights + ground", streetlights, true },
+		{ "grid", grid, false },
+		{ "grid + ground", grid, true },
+		{ "corridor", corridor, false },
+		{ "corridor + ground", corridor, true },
+	};
+
+	const uint32_t light_counts[] = { 8, 16, 24, 32, 48, 64, 96, 128, 192, 256 };
+
+	// Default camera, raised to eye height
+	const XMMatrix view = DirectX::XMMatrixLookToLH(DirectX::XMVectorSet(0.0f, 2.0f, 1.0f, 1.0f), c_camera_default_forward, c_camera_default_up);
+	const XMMatrix projection = get_perspective_matrix(DirectX::XMConvertToRadians(70.0f), static_cast<float>(c_screen_width), static_cast<float>(c_screen_height), c_near_z, c_far_z);
+
+	for (const CrossoverScene& current_scene : scenes)
+	{
+		SceneDescription scene;
+		generate_scenario(current_scene.parameters, scene);
+
+		// Lights in generation order are spread over the whole area, so the first N visible ones are a sparser version of the same scene
+		std::vector<VisibleLight> lights;
+		const SceneLightView light_view = scene.get_light_view();
+		for (size_t current_light_index = 0; current_light_index < light_view.count; ++current_light_index)
+		{
+			VisibleLight light;
+			light.bounds = DirectX::BoundingSphere(light_view.positions[current_light_index], light_view.ranges[current_light_index]);
+
+			DirectX::BoundingBox light_box;
+			DirectX::BoundingBox::CreateFromSphere(light_box, light.bounds);
+			light.screen_bounds = get_screen_bounds(light_box, view, projection);
+
+			if (light.screen_bounds.is_visible())
+			{
+				lights.push_back(light);
+			}
+		}
+
+		std::vector<VisibleObject> objects;
+		const SceneObjectView object_view = scene.get_object_view();
+		for (size_t current_object_index = 0; current_object_index < object_view.count; ++current_object_index)
+		{
+			const DirectX::BoundingBox unit_box(Vector3(0.0f, 0.0f, 0.0f), Vector3(0.5f, 0.5f, 0.5f));
+
+			VisibleObject object;
+			unit_box.Transform(object.bounds, DirectX::XMLoadFloat4x4(&object_view.records[current_object_index].model));
+			object.screen_bounds = get_screen_bounds(object.bounds, view, projection);
+
+			if (object.screen_bounds.is_visible())
+			{
+				objects.push_back(object);
+			}
+		}
+
+		if (current_scene.ground_plane)
+		{
+			VisibleObject ground;
+			ground.bounds = DirectX::BoundingBox(Vector3(0.0f, 0.0f, 0.0f), Vector3(extent * 0.5f, 0.001f, extent * 0.5f));
+			ground.screen_bounds = get_screen_bounds(ground.bounds, view, projection);
+			objects.push_back(ground);
+		}
+
+		uint32_t crossover_light_count = 0;
+		for (uint32_t current_light_count : light_counts)
+		{
+			if (current_light_count > lights.size())
+			{
+				break;
+			}
+
+			const LightEvaluations evaluations = count_light_evaluations(lights, current_light_count, objects);
+
+			// CPU side of the object lists, the same loop as LightSystem's add_object_light_list
+			std::vector<uint32_t> object_light_indices;
+			const double build_ms = context.time_ms([&]()
+			{
+				object_light_indices.clear();
+				for (const VisibleObject& current_object : objects)
+				{
+					for (uint32_t current_light_index = 0; current_light_index < current_light_count; ++current_light_index)
+					{
+						if (lights[current_light_index].bounds.Intersects(current_object.bounds))
+						{
+							object_light_indices.push_back(current_light_index);
+						}
+					}
+				}
+			});
+
+			const double ratio = (evaluations.tiles > 0) ? (static_cast<double>(evaluations.object_lists) / static_cast<double>(evaluations.tiles)) : 0.0;
+			context.report("%-22s %3u lights: object lists %6.2fM evaluations, tiles %6.2fM, ratio %.2f, list build %.3f ms (%zu objects, %zu indices)",
+				current_scene.name, current_light_count, evaluations.object_lists / 1e6, evaluations.tiles / 1e6, ratio, build_ms, objects.size(), object_light_indices.size());
+
+			if ((crossover_light_count == 0) && (evaluations.object_lists > evaluations.tiles))
+			{
+				crossover_light_count = current_light_count;
+			}
+		}
+
+		FORWARDPLUSDEMO_CHECK(lights.size() >= light_counts[0]);
+
+		if (crossover_light_count > 0)
+		{
+			context.report("%-22s object lists shade more lights from %u visible lights on", current_scene.name, crossover_light_count);
+		}
+		else
+		{
+			context.report("%-22s object lists shade fewer lights up to %zu visible lights", current_scene.name, std::min(lights.size(), static_cast<size_t>(light_counts[std::size(light_counts) - 1])));
+		}
+	}
+}
@@ -0,0 +1,110 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Render/OcclusionCuller.hpp>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	// Camera at the origin looking down +Z, same aspect as the default depth buffer
+	XMMatrix get_view_projection()
+	{
+		const XMMatrix view = DirectX::XMMatrixLookToLH(DirectX::XMVectorZero(), DirectX::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		return DirectX::XMMatrixMultiply(view, DirectX::XMMatrixPerspectiveFovLH(DirectX::XM_PIDIV2, 2.0f, 0.1f, 1000.0f));
+	}
+
+	// 20x20 m wall, 1 m thick, centered 20 m in front of the camera
+	XMMatrix get_wall_transform()
+	{
+		return DirectX::XMMatrixMultiply(DirectX::XMMatrixScaling(20.0f, 20.0f, 1.0f), DirectX::XMMatrixTranslation(0.0f, 0.0f, 20.0f));
+	}
+
+	DirectX::BoundingBox make_box(float x, float y, float z, float extent)
+	{
+		return DirectX::BoundingBox(Vector3(x, y, z), Vector3(extent, extent, extent));
+	}
+}
+
+FORWARDPLUSDEMO_TEST(occlusion_culler, objects_behind_occluder)
+{
+	OcclusionCuller occlusion_culler;
+	occlusion_culler.begin(get_view_projection());
+	occlusion_culler.add_box_occluder(get_wall_transform());
+	occlusion_culler.finish();
+
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.get_occluder_count() == 1);
+
+	// The wall hides [-20, 20] on X & Y at twice its distance
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(make_box(0.0f, 0.0f, 40.0f, 5.0f)));
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(make_box(-10.0f, 10.0f, 40.0f, 5.0f)));
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(make_box(0.0f, 0.0f, 500.0f, 50.0f)));
+
+	// Partly beside, partly in front, in front, beside & above the wall
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(make_box(20.0f, 0.0f, 40.0f, 5.0f)) == false);
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(make_box(0.0f, 0.0f, 20.0f, 3.0f)) == false);
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(make_box(0.0f, 0.0f, 10.0f, 1.0f)) == false);
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(make_box(40.0f, 0.0f, 40.0f, 5.0f)) == false);
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(make_box(0.0f, 30.0f, 40.0f, 5.0f)) == false);
+
+	// Crossing the near plane is never occluded
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(make_box(0.0f, 0.0f, 0.0f, 1.0f)) == false);
+}
+
+FORWARDPLUSDEMO_TEST(occlusion_culler, lights_behind_occluder)
+{
+	OcclusionCuller occlusion_culler;
+	occlusion_culler.begin(get_view_projection());
+	occlusion_culler.add_box_occluder(get_wall_transform());
+	occlusion_culler.finish();
+
+	// Light ranges entirely behind the wall
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(DirectX::BoundingSphere(Vector3(0.0f, 0.0f, 30.0f), 5.0f)));
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(DirectX::BoundingSphere(Vector3(5.0f, -5.0f, 60.0f), 10.0f)));
+
+	// Reaching through the wall, past its edge, or in front of it
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(DirectX::BoundingSphere(Vector3(0.0f, 0.0f, 22.0f), 3.0f)) == false);
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(DirectX::BoundingSphere(Vector3(18.0f, 0.0f, 40.0f), 5.0f)) == false);
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(DirectX::BoundingSphere(Vector3(0.0f, 0.0f, 10.0f), 2.0f)) == false);
+}
+
+FORWARDPLUSDEMO_TEST(occlusion_culler, flat_and_partial_occluders)
+{
+	OcclusionCuller occlusion_culler;
+	occlusion_culler.begin(get_view_projection());
+
+	// Ground plane flattened on Y, seen from 2 m above: hides what is below it
+	occlusion_culler.add_box_occluder(DirectX::XMMatrixMultiply(DirectX::XMMatrixScaling(400.0f, 0.0f, 400.0f), DirectX::XMMatrixTranslation(0.0f, -2.0f, 200.0f)));
+
+	// Wall crossing the near plane, only the part in front of the camera is rasterized
+	occlusion_culler.add_box_occluder(DirectX::XMMatrixMultiply(DirectX::XMMatrixScaling(1.0f, 20.0f, 40.0f), DirectX::XMMatrixTranslation(-5.0f, 0.0f, 0.0f)));
+	occlusion_culler.finish();
+
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.get_occluder_count() == 2);
+
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(make_box(0.0f, -10.0f, 30.0f, 2.0f)));
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(make_box(0.0f, 2.0f, 30.0f, 2.0f)) == false);
+
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(make_box(-10.0f, 0.0f, 10.0f, 1.0f)));
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(make_box(-3.0f, 0.0f, 10.0f, 1.0f)) == false);
+}
+
+FORWARDPLUSDEMO_TEST(occlusion_culler, nothing_occluded_without_occluders)
+{
+	OcclusionCuller occlusion_culler;
+
+	// Queries before the first frame is finished never reject anything
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(make_box(0.0f, 0.0f, 40.0f, 1.0f)) == false);
+
+	occlusion_culler.begin(get_view_projection());
+	occlusion_culler.add_box_occluder(get_wall_transform());
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(make_box(0.0f, 0.0f, 40.0f, 1.0f)) == false);
+	occlusion_culler.finish();
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(make_box(0.0f, 0.0f, 40.0f, 1.0f)));
+
+	// A new frame without occluders clears the depth buffer
+	occlusion_culler.begin(get_view_projection());
+	occlusion_culler.finish();
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.get_occluder_count() == 0);
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(make_box(0.0f, 0.0f, 40.0f, 1.0f)) == false);
+	FORWARDPLUSDEMO_CHECK(occlusion_culler.is_occluded(DirectX::BoundingSphere(Vector3(0.0f, 0.0f, 900.0f), 1.0f)) == false);
+}
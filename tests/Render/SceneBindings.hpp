@@ -0,0 +1,187 @@
+#ifndef FORWARDPLUSDEMO_TESTS_RENDER_SCENEBINDINGS_HPP
+#define FORWARDPLUSDEMO_TESTS_RENDER_SCENEBINDINGS_HPP
+#include <ForwardPlusDemo/GraphicsAPI/NullDevice.hpp>
+#include <ForwardPlusDemo/Render/LightSystem.hpp>
+#include <ForwardPlusDemo/Render/Math.hpp>
+
+#include <vector>
+namespace ForwardPlusDemo::Testing
+{
+	// NOTE: must match Defines.hlsl & the slots and structs in SoftwareRasterizer.cpp
+	constexpr uint32_t c_tile_x_dim = 32;
+	constexpr uint32_t c_tile_y_dim = 24;
+	constexpr uint32_t c_z_bin_count = 1024;
+
+	constexpr uint32_t c_forward_plus_parameters_slot = 0;
+	constexpr uint32_t c_camera_slot = 1;
+	constexpr uint32_t c_draw_batch_slot = 2;
+
+	constexpr uint32_t c_z_bins_slot = 0;
+	constexpr uint32_t c_tile_bitmasks_slot = 1;
+	constexpr uint32_t c_light_data_slot = 2;
+	constexpr uint32_t c_global_light_data_slot = 3;
+	constexpr uint32_t c_object_light_indices_slot = 4;
+	constexpr uint32_t c_instance_data_slot = 5;
+
+	struct alignas(16) ShaderLightData
+	{
+		Vector3 position;
+		float inv_range;
+
+		Vector3 direction;
+		float cos_outer_angle;
+
+		Vector3 diffuse;
+		float inv_cos_inner_angle;
+
+		Vector3 ambient;
+		float linear_attenuation;
+
+		uint32_t type;
+		uint32_t index;
+		uint32_t z_range;
+		uint32_t _padding;
+	};
+
+	struct alignas(16) ForwardPlusParameters
+	{
+		ShaderLightData global_light;
+
+		std::array<uint32_t, 4> light_counts;
+
+		float z_near;
+		float z_far;
+
+		Vector2i resolution;
+	};
+
+	struct alignas(16) Camera
+	{
+		XMVector world_position;
+		XMMatrix view;
+		XMMatrix view_projection;
+	};
+
+	struct alignas(16) PerDrawData
+	{
+		XMMatrix model;
+		XMMatrix inv_model;
+		Vector4 diffuse;
+		Vector4 ambient;
+		ObjectLightList light_list;
+	};
+
+	struct alignas(16) DrawBatchData
+	{
+		uint32_t first_instance;
+		Vector3i _padding;
+	};
+
+	struct Vertex
+	{
+		Vector4 position;
+		Vector4 normal;
+	};
+
+	inline uint32_t pack_z_range(uint32_t min, uint32_t max)
+	{
+		return min | (max << 16);
+	}
+
+	template<typename T>
+	NullBufferView get_buffer_view(std::vector<T>& data)
+	{
+		return NullBufferView{ data.data(), static_cast<uint32_t>(data.size() * sizeof(T)) };
+	}
+
+	template<typename T>
+	NullBufferView get_buffer_view(T& data)
+	{
+		return NullBufferView{ &data, sizeof(T) };
+	}
+
+	// Everything the scene pass binds, for driving a NullGraphicsPipeline without the renderer
+	// Identity camera & transforms, so vertex positions are in clip space (W = 1) and view Z is the depth
+	// The light culling buffers start out empty (no tile bits, every Z bin empty)
+	struct SceneBindings
+	{
+		Camera camera;
+		ForwardPlusParameters parameters = {};
+		DrawBatchData draw_batch = {};
+
+		std::vector<PerDrawData> instances;
+		std::vector<Vertex> vertices;
+
+		std::vector<uint32_t> z_bins = std::vector<uint32_t>(c_z_bin_count, pack_z_range(1, 0));
+		std::vector<uint32_t> tile_bitmasks = std::vector<uint32_t>(c_tile_x_dim * c_tile_y_dim, 0);
+		std::vector<ShaderLightData> lights;
+		std::vector<ShaderLightData> global_lights;
+		std::vector<uint32_t> object_light_indices;
+
+		SceneBindings(uint32_t width, uint32_t height)
+		{
+			camera.world_position = DirectX::XMVectorZero();
+			camera.view = DirectX::XMMatrixIdentity();
+			camera.view_projection = DirectX::XMMatrixIdentity();
+
+			parameters.z_near = 0.0f;
+			parameters.z_far = 1.0f;
+			parameters.resolution = Vector2i(static_cast<int32_t>(width), static_cast<int32_t>(height));
+
+			PerDrawData instance = {};
+			instance.model = DirectX::XMMatrixIdentity();
+			instance.inv_model = DirectX::XMMatrixIdentity();
+			instance.diffuse = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
+			instance.ambient = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
+			instances.push_back(instance);
+		}
+
+		// Two clockwise triangles facing the camera, in NDC
+		void add_rect(float min_x, float min_y, float max_x, float max_y, float top_z, float bottom_z)
+		{
+			const Vector4 normal(0.0f, 0.0f, -1.0f, 0.0f);
+			const Vertex top_left{ Vector4(min_x, max_y, top_z, 1.0f), normal };
+			const Vertex top_right{ Vector4(max_x, max_y, top_z, 1.0f), normal };
+			const Vertex bottom_left{ Vector4(min_x, min_y, bottom_z, 1.0f), normal };
+			const Vertex bottom_right{ Vector4(max_x, min_y, bottom_z, 1.0f), normal };
+
+			vertices.insert(vertices.end(), { top_left, top_right, bottom_left, top_right, bottom_right, bottom_left });
+		}
+
+		// Point light in front of the screen, covering the depth range of the given Z bins
+		void add_light(uint32_t z_range_min, uint32_t z_range_max)
+		{
+			ShaderLightData light = {};
+			light.position = Vector3(0.0f, 0.0f, -1.0f);
+			light.inv_range = 0.1f;
+			light.diffuse = Vector3(1.0f, 1.0f, 1.0f);
+			light.z_range = pack_z_range(z_range_min, z_range_max);
+			lights.push_back(light);
+
+			parameters.light_counts[0] = static_cast<uint32_t>(lights.size());
+		}
+
+		NullDrawContext get_draw_context()
+		{
+			NullDrawContext context;
+			context.vertex_buffer = get_buffer_view(vertices);
+			context.vertex_stride = sizeof(Vertex);
+			context.vertex_count = static_cast<uint32_t>(vertices.size());
+			context.instance_count = static_cast<uint32_t>(instances.size());
+
+			context.vertex_constant_buffers[c_camera_slot] = get_buffer_view(camera);
+			context.vertex_constant_buffers[c_draw_batch_slot] = get_buffer_view(draw_batch);
+			context.vertex_shader_resources[c_instance_data_slot] = get_buffer_view(instances);
+
+			context.pixel_constant_buffers[c_forward_plus_parameters_slot] = get_buffer_view(parameters);
+			context.pixel_shader_resources[c_z_bins_slot] = get_buffer_view(z_bins);
+			context.pixel_shader_resources[c_tile_bitmasks_slot] = get_buffer_view(tile_bitmasks);
+			context.pixel_shader_resources[c_light_data_slot] = get_buffer_view(lights);
+			context.pixel_shader_resources[c_global_light_data_slot] = get_buffer_view(global_lights);
+			context.pixel_shader_resources[c_object_light_indices_slot] = get_buffer_view(object_light_indices);
+
+			return context;
+		}
+	};
+}
+#endif
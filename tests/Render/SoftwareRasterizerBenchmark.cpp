@@ -0,0 +1,98 @@
+#include <TestFramework.hpp>
+#include <Render/SceneBindings.hpp>
+
+#include <ForwardPlusDemo/Render/SoftwareRasterizer.hpp>
+#include <ForwardPlusDemo/Utilities/JobSystem.hpp>
+#include <ForwardPlusDemo/Utilities/Random.hpp>
+
+#include <algorithm>
+#include <thread>
+
+using namespace ForwardPlusDemo;
+using namespace ForwardPlusDemo::Testing;
+
+// Random overlapping rectangles in submission order (2.2x depth complexity at 1080p), with 0, 8 object list lights or 32 tiled lights per pixel
+// Reports the frame time on one thread & on every hardware thread, and the cost per shaded pixel and light evaluation
+FORWARDPLUSDEMO_BENCHMARK(software_rasterizer_frame)
+{
+	const uint32_t width = context.select(1920u, 320u);
+	const uint32_t height = context.select(1080u, 180u);
+	const uint32_t rect_count = 1000;
+	const uint32_t list_light_count = 8;
+	const uint32_t tiled_light_count = 32;
+
+	Random random(5);
+
+	SceneBindings bindings(width, height);
+	for (uint32_t current_rect = 0; current_rect < rect_count; ++current_rect)
+	{
+		const float size_x = random.next_float(0.05f, 0.25f);
+		const float size_y = random.next_float(0.05f, 0.25f);
+		const float min_x = random.next_float(-1.0f, 1.0f - size_x);
+		const float min_y = random.next_float(-1.0f, 1.0f - size_y);
+		const float depth = random.next_float(0.1f, 0.9f);
+
+		bindings.add_rect(min_x, min_y, min_x + size_x, min_y + size_y, depth, depth);
+	}
+
+	for (uint32_t current_light = 0; current_light < tiled_light_count; ++current_light)
+	{
+		bindings.add_light(0, c_z_bin_count - 1);
+	}
+
+	for (uint32_t current_light = 0; current_light < list_light_count; ++current_light)
+	{
+		bindings.object_light_indices.push_back(current_light);
+	}
+
+	const uint32_t hardware_thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+
+	struct LightingMode
+	{
+		const char* name;
+		ObjectLightList light_list;
+		uint32_t tile_bitmask;
+	};
+
+	const LightingMode lighting_modes[] =
+	{
+		{ "no lights", ObjectLightList{}, 0 },
+		{ "8 list lights", ObjectLightList{ 0, list_light_count, 1 }, 0 },
+		{ "32 tiled lights", ObjectLightList{}, UINT32_MAX },
+	};
+
+	for (const LightingMode& current_mode : lighting_modes)
+	{
+		bindings.instances[0].light_list = current_mode.light_list;
+		std::fill(bindings.tile_bitmasks.begin(), bindings.tile_bitmasks.end(), current_mode.tile_bitmask);
+		std::fill(bindings.z_bins.begin(), bindings.z_bins.end(), pack_z_range(0, tiled_light_count - 1));
+
+		const NullDrawContext draw_context = bindings.get_draw_context();
+
+		for (const uint32_t thread_count : { 1u, hardware_thread_count })
+		{
+			JobSystem job_system(thread_count);
+			SoftwareRasterizer rasterizer(width, height, job_system);
+
+			const double frame_ms = context.time_ms([&]()
+			{
+				rasterizer.begin_frame();
+				rasterizer.draw(draw_context);
+				rasterizer.end_frame();
+			});
+
+			const SoftwareRasterizerStatistics& statistics = rasterizer.get_statistics();
+			const double frame_ns = frame_ms * 1e6;
+			context.report("%ux%u, %s, %u thread(s): %.2f ms per frame, %llu triangles, %.2fx depth complexity, %.1f ns per shaded pixel, %.2f ns per light evaluation\n",
+				width, height, current_mode.name, thread_count, frame_ms, static_cast<unsigned long long>(statistics.triangle_count),
+				static_cast<double>(statistics.depth_passed_pixel_count) / std::max<uint64_t>(statistics.shaded_pixel_count, 1),
+				frame_ns / std::max<uint64_t>(statistics.shaded_pixel_count, 1),
+				(statistics.lights_evaluated > 0) ? (frame_ns / statistics.lights_evaluated) : 0.0);
+
+			if (thread_count == hardware_thread_count)
+			{
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,213 @@
+#include <TestFramework.hpp>
+#include <Render/SceneBindings.hpp>
+
+#include <ForwardPlusDemo/Render/SoftwareRasterizer.hpp>
+#include <ForwardPlusDemo/Utilities/JobSystem.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+using namespace ForwardPlusDemo::Testing;
+
+namespace
+{
+	// 2x2 pixel light culling tiles (32x24 tiles)
+	constexpr uint32_t c_width = 64;
+	constexpr uint32_t c_height = 48;
+	constexpr uint32_t c_half_pixel_count = (c_width / 2) * c_height;
+
+	SoftwareRasterizerStatistics render(SceneBindings& frame, JobSystem& job_system)
+	{
+		SoftwareRasterizer rasterizer(c_width, c_height, job_system);
+		rasterizer.begin_frame();
+		rasterizer.draw(frame.get_draw_context());
+		rasterizer.end_frame();
+
+		return rasterizer.get_statistics();
+	}
+}
+
+FORWARDPLUSDEMO_TEST(software_rasterizer, shared_edges_shade_pixels_once)
+{
+	JobSystem job_system(2);
+
+	SceneBindings frame(c_width, c_height);
+	frame.add_rect(-1.0f, -1.0f, 1.0f, 1.0f, 0.5f, 0.5f);
+
+	const SoftwareRasterizerStatistics statistics = render(frame, job_system);
+	FORWARDPLUSDEMO_CHECK(statistics.triangle_count == 2);
+	FORWARDPLUSDEMO_CHECK(statistics.shaded_pixel_count == c_width * c_height);
+	FORWARDPLUSDEMO_CHECK(statistics.depth_passed_pixel_count == c_width * c_height);
+	FORWARDPLUSDEMO_CHECK(statistics.lights_evaluated == 0);
+
+	// Counter clockwise triangles are back faces
+	SceneBindings back_frame(c_width, c_height);
+	back_frame.add_rect(-1.0f, -1.0f, 1.0f, 1.0f, 0.5f, 0.5f);
+	std::swap(back_frame.vertices[1], back_frame.vertices[2]);
+	std::swap(back_frame.vertices[4], back_frame.vertices[5]);
+
+	const SoftwareRasterizerStatistics back_statistics = render(back_frame, job_system);
+	FORWARDPLUSDEMO_CHECK(back_statistics.triangle_count == 0);
+	FORWARDPLUSDEMO_CHECK(back_statistics.shaded_pixel_count == 0);
+}
+
+FORWARDPLUSDEMO_TEST(software_rasterizer, depth_test_in_submission_order)
+{
+	JobSystem job_system(2);
+
+	// Front to back, the far rectangle only passes where the near one is not
+	SceneBindings front_to_back(c_width, c_height);
+	front_to_back.add_rect(-1.0f, -1.0f, 0.0f, 1.0f, 0.25f, 0.25f);
+	front_to_back.add_rect(-1.0f, -1.0f, 1.0f, 1.0f, 0.5f, 0.5f);
+
+	const SoftwareRasterizerStatistics front_to_back_statistics = render(front_to_back, job_system);
+	FORWARDPLUSDEMO_CHECK(front_to_back_statistics.shaded_pixel_count == c_width * c_height);
+	FORWARDPLUSDEMO_CHECK(front_to_back_statistics.depth_passed_pixel_count == c_width * c_height);
+
+	// Back to front overdraws the left half, it is still only shaded once
+	SceneBindings back_to_front(c_width, c_height);
+	back_to_front.add_rect(-1.0f, -1.0f, 1.0f, 1.0f, 0.5f, 0.5f);
+	back_to_front.add_rect(-1.0f, -1.0f, 0.0f, 1.0f, 0.25f, 0.25f);
+
+	const SoftwareRasterizerStatistics back_to_front_statistics = render(back_to_front, job_system);
+	FORWARDPLUSDEMO_CHECK(back_to_front_statistics.shaded_pixel_count == c_width * c_height);
+	FORWARDPLUSDEMO_CHECK(back_to_front_statistics.depth_passed_pixel_count == (c_width * c_height) + c_half_pixel_count);
+}
+
+FORWARDPLUSDEMO_TEST(software_rasterizer, near_plane_clipping)
+{
+	JobSystem job_system(2);
+
+	// The top half is behind the near plane (Z < 0), Z crosses zero on the middle row
+	SceneBindings frame(c_width, c_height);
+	frame.add_rect(-1.0f, -1.0f, 1.0f, 1.0f, -0.5f, 0.5f);
+
+	const SoftwareRasterizerStatistics statistics = render(frame, job_system);
+	FORWARDPLUSDEMO_CHECK(statistics.triangle_count == 3); // One triangle stays a triangle, the other becomes a quad
+	FORWARDPLUSDEMO_CHECK(statistics.shaded_pixel_count == c_width * (c_height / 2));
+}
+
+FORWARDPLUSDEMO_TEST(software_rasterizer, object_light_lists)
+{
+	JobSystem job_system(2);
+
+	SceneBindings frame(c_width, c_height);
+	frame.add_rect(-1.0f, -1.0f, 1.0f, 1.0f, 0.5f, 0.5f);
+	frame.add_light(0, 0);
+	frame.add_light(0, 0);
+	frame.add_light(0, 0);
+
+	// The list skips light 1, its index past the end of the light data is ignored like on the GPU
+	frame.object_light_indices = { 0, 2, 100 };
+	frame.instances[0].light_list = ObjectLightList{ 0, 3, 1 };
+
+	frame.global_lights.push_back(frame.lights[0]);
+	frame.parameters.light_counts[3] = 1;
+
+	const SoftwareRasterizerStatistics statistics = render(frame, job_system);
+	FORWARDPLUSDEMO_CHECK(statistics.shaded_pixel_count == c_width * c_height);
+	FORWARDPLUSDEMO_CHECK(statistics.lights_evaluated == 3 * c_width * c_height);
+	FORWARDPLUSDEMO_CHECK(statistics.max_lights_per_pixel == 3);
+}
+
+FORWARDPLUSDEMO_TEST(software_rasterizer, tiled_lights)
+{
+	JobSystem job_system(2);
+
+	SceneBindings frame(c_width, c_height);
+	frame.add_rect(-1.0f, -1.0f, 1.0f, 1.0f, 0.5f, 0.5f);
+
+	// Light 1 is in the tiles but not in the depth range of the rectangle's Z bin (512)
+	frame.add_light(0, c_z_bin_count - 1);
+	frame.add_light(600, 700);
+	std::fill(frame.z_bins.begin(), frame.z_bins.end(), pack_z_range(0, 1));
+
+	// Left half of the tiles only
+	for (uint32_t tile_y = 0; tile_y < c_tile_y_dim; ++tile_y)
+	{
+		for (uint32_t tile_x = 0; tile_x < (c_tile_x_dim / 2); ++tile_x)
+		{
+			frame.tile_bitmasks[(tile_y * c_tile_x_dim) + tile_x] = 0b11;
+		}
+	}
+
+	const SoftwareRasterizerStatistics statistics = render(frame, job_system);
+	FORWARDPLUSDEMO_CHECK(statistics.lights_evaluated == c_half_pixel_count);
+	FORWARDPLUSDEMO_CHECK(statistics.max_lights_per_pixel == 1);
+
+	// Empty Z bins (min > max) skip the tiles
+	std::fill(frame.z_bins.begin(), frame.z_bins.end(), pack_z_range(1, 0));
+
+	const SoftwareRasterizerStatistics empty_bin_statistics = render(frame, job_system);
+	FORWARDPLUSDEMO_CHECK(empty_bin_statistics.shaded_pixel_count == c_width * c_height);
+	FORWARDPLUSDEMO_CHECK(empty_bin_statistics.lights_evaluated == 0);
+}
+
+FORWARDPLUSDEMO_TEST(software_rasterizer, packed_vertices_match_full)
+{
+	JobSystem job_system(2);
+
+	SceneBindings frame(c_width, c_height);
+	frame.add_rect(-1.0f, -1.0f, 0.5f, 0.5f, 0.5f, 0.5f);
+	frame.add_rect(-0.5f, -0.5f, 1.0f, 1.0f, 0.25f, 0.75f);
+
+	const SoftwareRasterizerStatistics full_statistics = render(frame, job_system);
+
+	std::vector<PackedVertex> packed_vertices(frame.vertices.size());
+	pack_vertices(&frame.vertices[0].position, &frame.vertices[0].normal, sizeof(Vertex), frame.vertices.size(), packed_vertices.data());
+
+	// Same draw with the packed buffer bound, these positions are exact in half floats
+	NullDrawContext packed_context = frame.get_draw_context();
+	packed_context.vertex_buffer = get_buffer_view(packed_vertices);
+	packed_context.vertex_stride = sizeof(PackedVertex);
+
+	SoftwareRasterizer rasterizer(c_width, c_height, job_system);
+	rasterizer.set_vertex_format(VertexFormat::PACKED);
+	rasterizer.begin_frame();
+	rasterizer.draw(packed_context);
+	rasterizer.end_frame();
+
+	const SoftwareRasterizerStatistics& packed_statistics = rasterizer.get_statistics();
+	FORWARDPLUSDEMO_CHECK(packed_statistics.triangle_count == full_statistics.triangle_count);
+	FORWARDPLUSDEMO_CHECK(packed_statistics.shaded_pixel_count == full_statistics.shaded_pixel_count);
+	FORWARDPLUSDEMO_CHECK(packed_statistics.depth_passed_pixel_count == full_statistics.depth_passed_pixel_count);
+}
+
+FORWARDPLUSDEMO_TEST(software_rasterizer, color_image)
+{
+	JobSystem job_system(2);
+
+	// Without lights the color is the global ambient, the other half keeps the clear color
+	SceneBindings frame(c_width, c_height);
+	frame.add_rect(-1.0f, -1.0f, 0.0f, 1.0f, 0.5f, 0.5f);
+	frame.parameters.global_light.ambient = Vector3(0.0f, 0.5f, 1.0f);
+
+	SoftwareRasterizer rasterizer(c_width, c_height, job_system);
+	rasterizer.begin_frame();
+	rasterizer.draw(frame.get_draw_context());
+	rasterizer.end_frame();
+
+	const std::filesystem::path image_path = std::filesystem::temp_directory_path() / "software_rasterizer_color_image.ppm";
+	FORWARDPLUSDEMO_CHECK(rasterizer.write_color_image(image_path));
+
+	std::ifstream file(image_path, std::ios::binary);
+	const std::vector<uint8_t> file_data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	file.close();
+	std::filesystem::remove(image_path);
+
+	const std::string header = "P6\n64 48\n255\n";
+	FORWARDPLUSDEMO_CHECK(file_data.size() == header.size() + (c_width * c_height * 3));
+	if (file_data.size() != header.size() + (c_width * c_height * 3))
+	{
+		return;
+	}
+
+	const uint8_t* first_row = file_data.data() + header.size();
+	FORWARDPLUSDEMO_CHECK((first_row[0] == 0) && (first_row[1] == 128) && (first_row[2] == 255));
+
+	const uint8_t* last_pixel = first_row + ((c_width - 1) * 3);
+	FORWARDPLUSDEMO_CHECK((last_pixel[0] == 0) && (last_pixel[1] == 0) && (last_pixel[2] == 255));
+}
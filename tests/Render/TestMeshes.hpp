@@ -0,0 +1,121 @@
+#ifndef FORWARDPLUSDEMO_TESTS_RENDER_TESTMESHES_HPP
+#define FORWARDPLUSDEMO_TESTS_RENDER_TESTMESHES_HPP
+#include <ForwardPlusDemo/Render/Math.hpp>
+#include <ForwardPlusDemo/Utilities/Random.hpp>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+namespace ForwardPlusDemo::Testing
+{
+	// Indexed mesh as the optimizer sees it, before welding or after
+	struct TestMesh
+	{
+		std::vector<Vector3> positions;
+		std::vector<uint32_t> indices;
+
+		uint32_t get_vertex_count() const { return static_cast<uint32_t>(positions.size()); }
+	};
+
+	// Regular grid of resolution x resolution quads in the XZ plane, rows of quads in order like the demo's plane
+	inline TestMesh make_grid(uint32_t resolution)
+	{
+		TestMesh mesh;
+
+		const uint32_t row_vertex_count = resolution + 1;
+		for (uint32_t current_z = 0; current_z < row_vertex_count; ++current_z)
+		{
+			for (uint32_t current_x = 0; current_x < row_vertex_count; ++current_x)
+			{
+				mesh.positions.push_back(Vector3(static_cast<float>(current_x), 0.0f, -static_cast<float>(current_z)));
+			}
+		}
+
+		for (uint32_t current_z = 0; current_z < resolution; ++current_z)
+		{
+			for (uint32_t current_x = 0; current_x < resolution; ++current_x)
+			{
+				const uint32_t top_left = (current_z * row_vertex_count) + current_x;
+				const uint32_t top_right = top_left + 1;
+				const uint32_t bottom_left = top_left + row_vertex_count;
+				const uint32_t bottom_right = bottom_left + 1;
+
+				mesh.indices.insert(mesh.indices.end(), { top_left, top_right, bottom_left, top_right, bottom_right, bottom_left });
+			}
+		}
+
+		return mesh;
+	}
+
+	// Closed unit cube made of six face grids, welded along the edges (exactly for power of two resolutions)
+	inline TestMesh make_subdivided_cube(uint32_t resolution)
+	{
+		TestMesh mesh;
+
+		auto add_vertex = [&mesh](const Vector3& position)
+		{
+			const auto vertex_it = std::find_if(mesh.positions.begin(), mesh.positions.end(), [&position](const Vector3& current_position)
+			{
+				return (current_position.x == position.x) && (current_position.y == position.y) && (current_position.z == position.z);
+			});
+
+			if (vertex_it != mesh.positions.end())
+			{
+				return static_cast<uint32_t>(vertex_it - mesh.positions.begin());
+			}
+
+			mesh.positions.push_back(position);
+			return static_cast<uint32_t>(mesh.positions.size() - 1);
+		};
+
+		// Origin, U & V of every face, U x V points outwards
+		const std::array<std::array<Vector3, 3>, 6> faces = { {
+			{ Vector3(0, 0, 0), Vector3(0, 1, 0), Vector3(1, 0, 0) },
+			{ Vector3(0, 0, 1), Vector3(1, 0, 0), Vector3(0, 1, 0) },
+			{ Vector3(0, 0, 0), Vector3(0, 0, 1), Vector3(0, 1, 0) },
+			{ Vector3(1, 0, 0), Vector3(0, 1, 0), Vector3(0, 0, 1) },
+			{ Vector3(0, 0, 0), Vector3(1, 0, 0), Vector3(0, 0, 1) },
+			{ Vector3(0, 1, 0), Vector3(0, 0, 1), Vector3(1, 0, 0) },
+		} };
+
+		const float step = 1.0f / resolution;
+		for (const std::array<Vector3, 3>& current_face : faces)
+		{
+			auto get_position = [&current_face, step](uint32_t u, uint32_t v)
+			{
+				return Vector3(current_face[0].x + (current_face[1].x * u + current_face[2].x * v) * step,
+					current_face[0].y + (current_face[1].y * u + current_face[2].y * v) * step,
+					current_face[0].z + (current_face[1].z * u + current_face[2].z * v) * step);
+			};
+
+			for (uint32_t current_v = 0; current_v < resolution; ++current_v)
+			{
+				for (uint32_t current_u = 0; current_u < resolution; ++current_u)
+				{
+					const uint32_t corner00 = add_vertex(get_position(current_u, current_v));
+					const uint32_t corner10 = add_vertex(get_position(current_u + 1, current_v));
+					const uint32_t corner01 = add_vertex(get_position(current_u, current_v + 1));
+					const uint32_t corner11 = add_vertex(get_position(current_u + 1, current_v + 1));
+
+					mesh.indices.insert(mesh.indices.end(), { corner00, corner10, corner11, corner00, corner11, corner01 });
+				}
+			}
+		}
+
+		return mesh;
+	}
+
+	// Random triangle order, each triangle keeps its winding
+	inline void shuffle_triangles(std::vector<uint32_t>& indices, uint32_t seed)
+	{
+		Random random(seed);
+
+		const uint32_t triangle_count = static_cast<uint32_t>(indices.size() / 3);
+		for (uint32_t current_triangle = triangle_count; current_triangle > 1; --current_triangle)
+		{
+			const uint32_t other_triangle = random.next_uint32(current_triangle);
+			std::swap_ranges(indices.begin() + (current_triangle - 1) * 3, indices.begin() + current_triangle * 3, indices.begin() + other_triangle * 3);
+		}
+	}
+}
+#endif
@@ -0,0 +1,168 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Render/TileCulling.hpp>
+
+#include <bit>
+#include <cstdlib>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	const Vector2i c_resolution(1920, 1080);
+
+	// Camera at the origin looking down +Z
+	struct TestCamera
+	{
+		XMMatrix projection = DirectX::XMMatrixPerspectiveFovLH(DirectX::XM_PIDIV2, static_cast<float>(c_resolution.x) / c_resolution.y, 0.1f, 1000.0f);
+		XMMatrix view_projection = DirectX::XMMatrixMultiply(DirectX::XMMatrixLookToLH(DirectX::XMVectorZero(), DirectX::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)), projection);
+
+		// Small light whose center projects to the given NDC position
+		DirectX::BoundingSphere make_light(float ndc_x, float ndc_y, float view_z = 10.0f) const
+		{
+			const Matrix4 projection_matrix = to_matrix4(projection);
+			return DirectX::BoundingSphere(Vector3(ndc_x * view_z / projection_matrix.m[0][0], ndc_y * view_z / projection_matrix.m[1][1], view_z), 0.05f);
+		}
+	};
+
+	Vector2 get_pixel_position(float ndc_x, float ndc_y)
+	{
+		return Vector2((ndc_x * 0.5f + 0.5f) * c_resolution.x, (0.5f - ndc_y * 0.5f) * c_resolution.y);
+	}
+
+	uint32_t get_batch_count(size_t light_count)
+	{
+		return static_cast<uint32_t>((light_count + c_light_batch_size - 1) / c_light_batch_size);
+	}
+
+	std::vector<uint32_t> cull_tiles(const std::vector<DirectX::BoundingSphere>& light_bounds, const XMMatrix& view_projection)
+	{
+		const uint32_t batch_count = get_batch_count(light_bounds.size());
+
+		std::vector<uint32_t> tile_bitmasks(c_tile_x_dim * c_tile_y_dim * batch_count, 0);
+		cull_light_tiles(light_bounds.data(), static_cast<uint32_t>(light_bounds.size()), view_projection, 0, batch_count, tile_bitmasks.data());
+
+		return tile_bitmasks;
+	}
+
+	bool has_light(const std::vector<uint32_t>& tile_bitmasks, size_t light_count, const Vector2i& tile, uint32_t light_index)
+	{
+		const uint32_t tile_flat_index = static_cast<uint32_t>(tile.y) * c_tile_x_dim + static_cast<uint32_t>(tile.x);
+		const uint32_t bitmask = tile_bitmasks[tile_flat_index * get_batch_count(light_count) + (light_index / c_light_batch_size)];
+
+		return (bitmask & (1u << (light_index % c_light_batch_size))) != 0;
+	}
+
+	uint32_t get_tile_count(const std::vector<uint32_t>& tile_bitmasks, size_t light_count, uint32_t light_index)
+	{
+		uint32_t tile_count = 0;
+		for (int32_t tile_y = 0; tile_y < static_cast<int32_t>(c_tile_y_dim); ++tile_y)
+		{
+			for (int32_t tile_x = 0; tile_x < static_cast<int32_t>(c_tile_x_dim); ++tile_x)
+			{
+				tile_count += has_light(tile_bitmasks, light_count, Vector2i(tile_x, tile_y), light_index) ? 1 : 0;
+			}
+		}
+
+		return tile_count;
+	}
+}
+
+FORWARDPLUSDEMO_TEST(tile_culling, pixel_tiles_start_at_the_bottom)
+{
+	// Same remap as the pixel shader, pixel rows go down while tile rows go up
+	FORWARDPLUSDEMO_CHECK((get_pixel_tile(Vector2(0.0f, 0.0f), c_resolution).x == 0) && (get_pixel_tile(Vector2(0.0f, 0.0f), c_resolution).y == c_tile_y_dim - 1));
+	FORWARDPLUSDEMO_CHECK((get_pixel_tile(Vector2(1919.0f, 1079.0f), c_resolution).x == c_tile_x_dim - 1) && (get_pixel_tile(Vector2(1919.0f, 1079.0f), c_resolution).y == 0));
+	FORWARDPLUSDEMO_CHECK((get_pixel_tile(Vector2(60.0f, 45.0f), c_resolution).x == 1) && (get_pixel_tile(Vector2(60.0f, 45.0f), c_resolution).y == c_tile_y_dim - 2));
+}
+
+FORWARDPLUSDEMO_TEST(tile_culling, lights_land_in_the_tiles_the_pixel_shader_reads)
+{
+	const TestCamera camera;
+
+	// 8x5 grid of small lights over the screen, more than one light batch
+	std::vector<Vector2> light_ndc_positions;
+	for (uint32_t current_row = 0; current_row < 5; ++current_row)
+	{
+		for (uint32_t current_column = 0; current_column < 8; ++current_column)
+		{
+			light_ndc_positions.emplace_back(-0.875f + 0.25f * current_column + 0.01f, 0.8f - 0.4f * current_row - 0.03f);
+		}
+	}
+
+	std::vector<DirectX::BoundingSphere> light_bounds;
+	for (const Vector2& current_position : light_ndc_positions)
+	{
+		light_bounds.push_back(camera.make_light(current_position.x, current_position.y));
+	}
+
+	const std::vector<uint32_t> tile_bitmasks = cull_tiles(light_bounds, camera.view_projection);
+
+	for (uint32_t current_light_index = 0; current_light_index < light_bounds.size(); ++current_light_index)
+	{
+		const Vector2& ndc_position = light_ndc_positions[current_light_index];
+		const Vector2i tile = get_pixel_tile(get_pixel_position(ndc_position.x, ndc_position.y), c_resolution);
+		FORWARDPLUSDEMO_CHECK(has_light(tile_bitmasks, light_bounds.size(), tile, current_light_index));
+
+		// Small lights only touch the tiles around their center, and never the mirrored row (the old top down order)
+		const uint32_t tile_count = get_tile_count(tile_bitmasks, light_bounds.size(), current_light_index);
+		FORWARDPLUSDEMO_CHECK((tile_count >= 1) && (tile_count <= 4));
+
+		const Vector2i mirrored_tile(tile.x, static_cast<int32_t>(c_tile_y_dim - 1) - tile.y);
+		if (std::abs(mirrored_tile.y - tile.y) > 1)
+		{
+			FORWARDPLUSDEMO_CHECK(has_light(tile_bitmasks, light_bounds.size(), mirrored_tile, current_light_index) == false);
+		}
+	}
+}
+
+FORWARDPLUSDEMO_TEST(tile_culling, off_screen_and_surrounding_lights)
+{
+	const TestCamera camera;
+
+	const std::vector<DirectX::BoundingSphere> light_bounds =
+	{
+		camera.make_light(3.0f, 0.0f), // Right of the screen
+		camera.make_light(0.0f, -3.0f), // Below the screen
+		DirectX::BoundingSphere(Vector3(0.0f, 0.0f, 0.0f), 2.0f), // Around the camera
+	};
+
+	const std::vector<uint32_t> tile_bitmasks = cull_tiles(light_bounds, camera.view_projection);
+	FORWARDPLUSDEMO_CHECK(get_tile_count(tile_bitmasks, light_bounds.size(), 0) == 0);
+	FORWARDPLUSDEMO_CHECK(get_tile_count(tile_bitmasks, light_bounds.size(), 1) == 0);
+	FORWARDPLUSDEMO_CHECK(get_tile_count(tile_bitmasks, light_bounds.size(), 2) == c_tile_x_dim * c_tile_y_dim);
+}
+
+FORWARDPLUSDEMO_TEST(tile_culling, batch_ranges_match_a_single_pass)
+{
+	const TestCamera camera;
+
+	std::vector<DirectX::BoundingSphere> light_bounds;
+	for (uint32_t current_light_index = 0; current_light_index < 100; ++current_light_index)
+	{
+		const float ndc_x = -0.95f + 0.019f * current_light_index;
+		const float ndc_y = 0.9f - 0.018f * ((current_light_index * 37) % 100);
+		light_bounds.push_back(camera.make_light(ndc_x, ndc_y, 5.0f + current_light_index * 0.5f));
+	}
+
+	const std::vector<uint32_t> single_pass = cull_tiles(light_bounds, camera.view_projection);
+
+	// One batch at a time into the same bitmasks, like the jobs of the null device kernel
+	const uint32_t batch_count = get_batch_count(light_bounds.size());
+	std::vector<uint32_t> per_batch(single_pass.size(), 0);
+	for (uint32_t current_batch = batch_count; current_batch > 0; --current_batch)
+	{
+		cull_light_tiles(light_bounds.data(), static_cast<uint32_t>(light_bounds.size()), camera.view_projection, current_batch - 1, current_batch, per_batch.data());
+	}
+
+	FORWARDPLUSDEMO_CHECK(per_batch == single_pass);
+
+	uint32_t set_bit_count = 0;
+	for (uint32_t current_bitmask : single_pass)
+	{
+		set_bit_count += static_cast<uint32_t>(std::popcount(current_bitmask));
+	}
+
+	FORWARDPLUSDEMO_CHECK(set_bit_count >= light_bounds.size());
+}
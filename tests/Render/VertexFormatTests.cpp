@@ -0,0 +1,186 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Render/VertexFormat.hpp>
+#include <ForwardPlusDemo/Utilities/Random.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	// Largest rounding error of a half float relative to its value (10 bit mantissa, round to nearest)
+	constexpr float c_half_relative_error = 1.0f / 2048.0f;
+
+	// Half a step of the subnormal halves, the absolute error below 2^-14
+	constexpr float c_half_subnormal_error = 1.0f / 33554432.0f;
+
+	// 16 bit octahedral normals, the worst of a million random directions is 0.0037 degrees
+	constexpr float c_normal_error_degrees = 0.005f;
+
+	struct TestVertex
+	{
+		Vector4 position;
+		Vector4 normal;
+	};
+
+	XMVector get_random_normal(Random& random)
+	{
+		// Rejection sampling in the unit ball, uniform over the directions
+		while (true)
+		{
+			const XMVector candidate = DirectX::XMVectorSet(random.next_float(-1.0f, 1.0f), random.next_float(-1.0f, 1.0f), random.next_float(-1.0f, 1.0f), 0.0f);
+			const float length_squared = DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(candidate));
+			if ((length_squared > 1e-4f) && (length_squared <= 1.0f))
+			{
+				return DirectX::XMVector3Normalize(candidate);
+			}
+		}
+	}
+
+	// Axes, the octahedron's folded edges & corners and random directions
+	std::vector<TestVertex> get_test_vertices(uint32_t random_count)
+	{
+		std::vector<TestVertex> vertices;
+
+		const float sqrt_half = std::sqrt(0.5f);
+		const std::vector<Vector4> special_normals = {
+			Vector4(1, 0, 0, 0), Vector4(-1, 0, 0, 0), Vector4(0, 1, 0, 0), Vector4(0, -1, 0, 0), Vector4(0, 0, 1, 0), Vector4(0, 0, -1, 0),
+			Vector4(sqrt_half, 0, -sqrt_half, 0), Vector4(-sqrt_half, 0, -sqrt_half, 0), Vector4(0, sqrt_half, -sqrt_half, 0), Vector4(0, -sqrt_half, -sqrt_half, 0),
+			Vector4(sqrt_half, sqrt_half, 0, 0), Vector4(-sqrt_half, -sqrt_half, 0, 0),
+		};
+
+		Random random(13);
+		for (const Vector4& current_normal : special_normals)
+		{
+			vertices.push_back(TestVertex{ Vector4(random.next_float(-1.0f, 1.0f), random.next_float(-1.0f, 1.0f), random.next_float(-1.0f, 1.0f), 1.0f), current_normal });
+		}
+
+		for (uint32_t current_vertex = 0; current_vertex < random_count; ++current_vertex)
+		{
+			const float scale = std::pow(2.0f, random.next_float(-4.0f, 8.0f));
+			const Vector4 position(random.next_float(-scale, scale), random.next_float(-scale, scale), random.next_float(-scale, scale), 1.0f);
+
+			vertices.push_back(TestVertex{ position, to_vector4(get_random_normal(random)) });
+		}
+
+		return vertices;
+	}
+
+	bool is_within_half_error(float value, float source_value)
+	{
+		return std::abs(value - source_value) <= std::max(std::abs(source_value) * c_half_relative_error, c_half_subnormal_error);
+	}
+
+	// atan2 keeps its precision for tiny angles, unlike acos of the dot product
+	float get_angle_degrees(const XMVector& left, const XMVector& right)
+	{
+		const XMVector left_normal = DirectX::XMVector3Normalize(left);
+		const XMVector right_normal = DirectX::XMVector3Normalize(right);
+
+		const float sin_angle = DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMVector3Cross(left_normal, right_normal)));
+		const float cos_angle = DirectX::XMVectorGetX(DirectX::XMVector3Dot(left_normal, right_normal));
+		return DirectX::XMConvertToDegrees(std::atan2(sin_angle, cos_angle));
+	}
+}
+
+FORWARDPLUSDEMO_TEST(vertex_format, parse_names)
+{
+	VertexFormat format = VertexFormat::FULL;
+	FORWARDPLUSDEMO_CHECK(parse_vertex_format("packed", format) && (format == VertexFormat::PACKED));
+	FORWARDPLUSDEMO_CHECK(parse_vertex_format("full", format) && (format == VertexFormat::FULL));
+	FORWARDPLUSDEMO_CHECK(parse_vertex_format("half", format) == false);
+	FORWARDPLUSDEMO_CHECK(format == VertexFormat::FULL);
+}
+
+FORWARDPLUSDEMO_TEST(vertex_format, snorm16_rounding)
+{
+	FORWARDPLUSDEMO_CHECK(encode_snorm16(1.0f) == 32767);
+	FORWARDPLUSDEMO_CHECK(encode_snorm16(-1.0f) == -32767);
+	FORWARDPLUSDEMO_CHECK(encode_snorm16(0.0f) == 0);
+	FORWARDPLUSDEMO_CHECK(encode_snorm16(4.0f) == 32767);
+	FORWARDPLUSDEMO_CHECK(encode_snorm16(-4.0f) == -32767);
+
+	// Both -32768 and -32767 decode to -1, like D3D
+	FORWARDPLUSDEMO_CHECK(decode_snorm16(-32768) == -1.0f);
+	FORWARDPLUSDEMO_CHECK(decode_snorm16(-32767) == -1.0f);
+	FORWARDPLUSDEMO_CHECK(decode_snorm16(32767) == 1.0f);
+
+	// Round to nearest, at most half a step off
+	Random random(17);
+	float max_error = 0.0f;
+	for (uint32_t current_value = 0; current_value < 100000; ++current_value)
+	{
+		const float value = random.next_float(-1.0f, 1.0f);
+		max_error = std::max(max_error, std::abs(decode_snorm16(encode_snorm16(value)) - value));
+	}
+
+	FORWARDPLUSDEMO_CHECK(max_error <= (0.5f / 32767.0f) * 1.001f);
+}
+
+FORWARDPLUSDEMO_TEST(vertex_format, octahedral_normal_error)
+{
+	// Axes land on the octahedron's corners and decode exactly, zero vectors come back as +Z
+	FORWARDPLUSDEMO_CHECK(get_angle_degrees(decode_octahedral_normal(encode_octahedral_normal(DirectX::XMVectorSet(0, 0, -1, 0))), DirectX::XMVectorSet(0, 0, -1, 0)) == 0.0f);
+	FORWARDPLUSDEMO_CHECK(get_angle_degrees(decode_octahedral_normal(encode_octahedral_normal(DirectX::XMVectorSet(0, 1, 0, 0))), DirectX::XMVectorSet(0, 1, 0, 0)) == 0.0f);
+	FORWARDPLUSDEMO_CHECK(get_angle_degrees(decode_octahedral_normal(encode_octahedral_normal(DirectX::XMVectorZero())), DirectX::XMVectorSet(0, 0, 1, 0)) == 0.0f);
+
+	// Unquantized the encoding is exact up to float precision, the SNORM16 quantization adds the error
+	Random random(19);
+	float max_float_error = 0.0f;
+	float max_snorm_error = 0.0f;
+	for (uint32_t current_normal = 0; current_normal < 100000; ++current_normal)
+	{
+		const XMVector normal = get_random_normal(random);
+		const Vector2 encoded = encode_octahedral_normal(normal);
+		FORWARDPLUSDEMO_CHECK((std::abs(encoded.x) <= 1.0f) && (std::abs(encoded.y) <= 1.0f));
+
+		max_float_error = std::max(max_float_error, get_angle_degrees(decode_octahedral_normal(encoded), normal));
+
+		const Vector2 quantized(decode_snorm16(encode_snorm16(encoded.x)), decode_snorm16(encode_snorm16(encoded.y)));
+		max_snorm_error = std::max(max_snorm_error, get_angle_degrees(decode_octahedral_normal(quantized), normal));
+	}
+
+	FORWARDPLUSDEMO_CHECK(max_float_error < 0.0001f);
+	FORWARDPLUSDEMO_CHECK(max_snorm_error < c_normal_error_degrees);
+}
+
+FORWARDPLUSDEMO_TEST(vertex_format, packed_vertex_error)
+{
+	// Not a multiple of four, so both the four wide and the scalar normal paths run
+	const std::vector<TestVertex> vertices = get_test_vertices(10001);
+
+	std::vector<PackedVertex> packed(vertices.size());
+	pack_vertices(&vertices[0].position, &vertices[0].normal, sizeof(TestVertex), vertices.size(), packed.data());
+
+	for (size_t current_vertex = 0; current_vertex < vertices.size(); ++current_vertex)
+	{
+		const TestVertex& source = vertices[current_vertex];
+
+		// Four wide encode rounds exactly like the scalar one
+		const Vector2 encoded = encode_octahedral_normal(to_xmvector(source.normal));
+		FORWARDPLUSDEMO_CHECK(packed[current_vertex].normal[0] == encode_snorm16(encoded.x));
+		FORWARDPLUSDEMO_CHECK(packed[current_vertex].normal[1] == encode_snorm16(encoded.y));
+
+		Vector4 position;
+		Vector4 normal;
+		unpack_vertex(packed[current_vertex], position, normal);
+
+		FORWARDPLUSDEMO_CHECK(position.w == 1.0f);
+		FORWARDPLUSDEMO_CHECK(normal.w == 0.0f);
+
+		FORWARDPLUSDEMO_CHECK(is_within_half_error(position.x, source.position.x));
+		FORWARDPLUSDEMO_CHECK(is_within_half_error(position.y, source.position.y));
+		FORWARDPLUSDEMO_CHECK(is_within_half_error(position.z, source.position.z));
+
+		FORWARDPLUSDEMO_CHECK(get_angle_degrees(to_xmvector(normal), to_xmvector(source.normal)) < c_normal_error_degrees);
+	}
+
+	// The summary used by the headless log agrees with the per vertex bounds
+	const VertexPackingError error = get_vertex_packing_error(&vertices[0].position, &vertices[0].normal, sizeof(TestVertex), vertices.size(), packed.data());
+	FORWARDPLUSDEMO_CHECK(error.position > 0.0f);
+	FORWARDPLUSDEMO_CHECK(error.position <= 256.0f * std::sqrt(3.0f) * c_half_relative_error);
+	FORWARDPLUSDEMO_CHECK(error.normal_degrees < c_normal_error_degrees);
+}
@@ -0,0 +1,118 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Scene/CameraPath.hpp>
+#include <ForwardPlusDemo/Utilities/Random.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	std::filesystem::path get_test_path(const char* name)
+	{
+		return std::filesystem::temp_directory_path() / name;
+	}
+
+	CameraKeyframe make_keyframe(float time, const Vector3& position, float pitch, float yaw)
+	{
+		CameraKeyframe keyframe;
+		keyframe.time = time;
+		keyframe.position = position;
+		keyframe.rotation = Vector2(pitch, yaw);
+
+		return keyframe;
+	}
+
+	bool is_same_keyframe(const CameraKeyframe& left, const CameraKeyframe& right)
+	{
+		return std::memcmp(&left, &right, sizeof(CameraKeyframe)) == 0;
+	}
+
+	bool is_near(float value, float expected_value)
+	{
+		return std::abs(value - expected_value) <= 1e-5f;
+	}
+}
+
+FORWARDPLUSDEMO_TEST(camera_path, sample_between_keyframes)
+{
+	CameraPath path;
+	FORWARDPLUSDEMO_CHECK(path.is_empty() && (path.get_duration() == 0.0f));
+	FORWARDPLUSDEMO_CHECK(is_same_keyframe(path.sample(1.0f), CameraKeyframe()));
+
+	path.add_keyframe(make_keyframe(1.0f, Vector3(0, 0, 0), 0.0f, 3.0f));
+	path.add_keyframe(make_keyframe(3.0f, Vector3(10, 20, -4), 1.0f, -3.0f));
+	FORWARDPLUSDEMO_CHECK(path.get_duration() == 3.0f);
+
+	const CameraKeyframe middle = path.sample(2.5f);
+	FORWARDPLUSDEMO_CHECK(middle.time == 2.5f);
+	FORWARDPLUSDEMO_CHECK(is_near(middle.position.x, 7.5f) && is_near(middle.position.y, 15.0f) && is_near(middle.position.z, -3.0f));
+	FORWARDPLUSDEMO_CHECK(is_near(middle.rotation.x, 0.75f));
+
+	// Yaw goes the short way around through +-pi (0.28 radians) rather than back through zero
+	FORWARDPLUSDEMO_CHECK(is_near(path.sample(1.5f).rotation.y, 3.0f + (DirectX::XM_2PI - 6.0f) * 0.25f));
+	FORWARDPLUSDEMO_CHECK(is_near(path.sample(2.75f).rotation.y, -3.0f - (DirectX::XM_2PI - 6.0f) * 0.125f));
+
+	// Clamped outside the recorded range
+	FORWARDPLUSDEMO_CHECK(is_same_keyframe(path.sample(0.0f), make_keyframe(1.0f, Vector3(0, 0, 0), 0.0f, 3.0f)));
+	FORWARDPLUSDEMO_CHECK(is_same_keyframe(path.sample(100.0f), make_keyframe(3.0f, Vector3(10, 20, -4), 1.0f, -3.0f)));
+}
+
+FORWARDPLUSDEMO_TEST(camera_path, save_load_round_trip)
+{
+	const std::filesystem::path file_path = get_test_path("camera_path_round_trip.txt");
+
+	// Like a recording, one keyframe per 60 Hz step
+	Random random(37);
+	CameraPath path;
+	float time = 0.0f;
+	for (uint32_t current_keyframe = 0; current_keyframe < 1000; ++current_keyframe)
+	{
+		time += 1.0f / 60.0f;
+		path.add_keyframe(make_keyframe(time, Vector3(random.next_float(-100.0f, 100.0f), random.next_float(0.0f, 10.0f), random.next_float(-100.0f, 100.0f)),
+			random.next_float(-1.5f, 1.5f), random.next_float(-DirectX::XM_PI, DirectX::XM_PI)));
+	}
+
+	FORWARDPLUSDEMO_CHECK(path.save(file_path));
+
+	// Floats round trip exactly, so a replay samples the very same views
+	CameraPath loaded_path;
+	FORWARDPLUSDEMO_CHECK(loaded_path.load(file_path));
+	FORWARDPLUSDEMO_CHECK(loaded_path.get_duration() == path.get_duration());
+	for (float sample_time = 0.0f; sample_time < time; sample_time += 0.01f)
+	{
+		FORWARDPLUSDEMO_CHECK(is_same_keyframe(loaded_path.sample(sample_time), path.sample(sample_time)));
+	}
+
+	std::filesystem::remove(file_path);
+}
+
+FORWARDPLUSDEMO_TEST(camera_path, malformed_files)
+{
+	const std::filesystem::path file_path = get_test_path("camera_path_malformed.txt");
+
+	auto load = [&file_path](const char* text, CameraPath& path)
+	{
+		std::ofstream(file_path, std::ios::trunc) << text;
+		return path.load(file_path);
+	};
+
+	CameraPath path;
+	FORWARDPLUSDEMO_CHECK(load("0.5 1 2 3 0.1 0.2\n1.0 1 2 3 0.1 0.2\n", path) && (path.get_duration() == 1.0f));
+
+	// Times that don't increase, a value that isn't a number & a cut off keyframe, nothing is kept from a failed load
+	FORWARDPLUSDEMO_CHECK(!load("1.0 0 0 0 0 0\n0.5 0 0 0 0 0\n", path) && path.is_empty());
+	FORWARDPLUSDEMO_CHECK(!load("1.0 0 0 0 0 0\n1.0 0 0 0 0 0\n", path) && path.is_empty());
+	FORWARDPLUSDEMO_CHECK(!load("nan 0 0 0 0 0\n", path) && path.is_empty());
+	FORWARDPLUSDEMO_CHECK(!load("1.0 0 0 zero 0 0\n", path) && path.is_empty());
+	FORWARDPLUSDEMO_CHECK(!load("1.0 0 0 0 0 0\n2.0 0 0\n", path));
+	FORWARDPLUSDEMO_CHECK(!path.load(get_test_path("camera_path_missing.txt")));
+
+	FORWARDPLUSDEMO_CHECK(load("", path) && path.is_empty());
+
+	std::filesystem::remove(file_path);
+}
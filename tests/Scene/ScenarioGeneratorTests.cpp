@@ -0,0 +1,108 @@
+#include <TestFramework.hpp>
+#include <Scene/SceneComparison.hpp>
+
+#include <ForwardPlusDemo/Scene/ScenarioGenerator.hpp>
+#include <ForwardPlusDemo/Utilities/Random.hpp>
+
+using namespace ForwardPlusDemo;
+using namespace ForwardPlusDemo::Testing;
+
+namespace
+{
+	ScenarioParameters make_parameters(ScenarioType type, uint64_t seed)
+	{
+		ScenarioParameters parameters;
+		parameters.type = type;
+		parameters.seed = seed;
+		parameters.light_count = 500;
+		parameters.directional_light_count = 3;
+		parameters.object_count = 200;
+
+		return parameters;
+	}
+
+	SceneDescription generate(const ScenarioParameters& parameters)
+	{
+		SceneDescription scene;
+		generate_scenario(parameters, scene);
+
+		return scene;
+	}
+}
+
+// Integer only, so the sequence is the same on every platform & compiler, pinned here so a change to the generator shows
+FORWARDPLUSDEMO_TEST(scenario_generator, random_sequence_is_pinned)
+{
+	Random random(42);
+	FORWARDPLUSDEMO_CHECK(random.next_uint32() == 565663470u);
+	FORWARDPLUSDEMO_CHECK(random.next_uint32() == 3244226384u);
+	FORWARDPLUSDEMO_CHECK(random.next_uint32() == 2504567229u);
+	FORWARDPLUSDEMO_CHECK(random.next_uint32() == 903561869u);
+
+	// Streams are independent sequences for the same seed
+	FORWARDPLUSDEMO_CHECK(Random(42, 3).next_uint32() == 1594523791u);
+
+	// Reseeding starts the sequence over
+	random.seed_state(42);
+	FORWARDPLUSDEMO_CHECK(random.next_uint32() == 565663470u);
+
+	for (uint32_t current_value = 0; current_value < 10000; ++current_value)
+	{
+		FORWARDPLUSDEMO_CHECK(random.next_uint32(7) < 7);
+
+		const float value = random.next_float(-2.0f, 3.0f);
+		FORWARDPLUSDEMO_CHECK((value >= -2.0f) && (value < 3.0f));
+	}
+}
+
+FORWARDPLUSDEMO_TEST(scenario_generator, same_seed_same_scene)
+{
+	for (uint32_t current_type_index = 0; current_type_index < static_cast<uint32_t>(ScenarioType::TYPE_COUNT); ++current_type_index)
+	{
+		const ScenarioParameters parameters = make_parameters(static_cast<ScenarioType>(current_type_index), 1234);
+
+		const SceneDescription scene = generate(parameters);
+		const SceneDescription same_scene = generate(parameters);
+		FORWARDPLUSDEMO_CHECK(is_same_scene(same_scene.get_light_view(), same_scene.get_object_view(), scene));
+
+		// The demo layout has a fixed light count, the others have exactly the ones asked for
+		const size_t scenario_light_count = (parameters.type == ScenarioType::DEMO) ? 20 : parameters.light_count;
+		FORWARDPLUSDEMO_CHECK(scene.get_light_count() == (scenario_light_count + parameters.directional_light_count));
+		FORWARDPLUSDEMO_CHECK(scene.get_object_count() == parameters.object_count);
+
+		// Generating adds to the scene, like a text scene with a scenario on top
+		SceneDescription added_scene = scene;
+		generate_scenario(parameters, added_scene);
+		FORWARDPLUSDEMO_CHECK(added_scene.get_light_count() == (2 * scene.get_light_count()));
+	}
+}
+
+FORWARDPLUSDEMO_TEST(scenario_generator, other_seed_other_scene)
+{
+	for (uint32_t current_type_index = 0; current_type_index < static_cast<uint32_t>(ScenarioType::TYPE_COUNT); ++current_type_index)
+	{
+		const ScenarioType type = static_cast<ScenarioType>(current_type_index);
+
+		const SceneDescription scene = generate(make_parameters(type, 1234));
+		const SceneDescription other_scene = generate(make_parameters(type, 1235));
+
+		FORWARDPLUSDEMO_CHECK(scene.get_light_count() == other_scene.get_light_count());
+		FORWARDPLUSDEMO_CHECK(!is_same_scene(other_scene.get_light_view(), SceneObjectView(), scene));
+		FORWARDPLUSDEMO_CHECK(!is_same_column(scene.get_object_view().records, other_scene.get_object_view().records, scene.get_object_count()));
+	}
+}
+
+FORWARDPLUSDEMO_TEST(scenario_generator, scenario_names)
+{
+	for (uint32_t current_type_index = 0; current_type_index < static_cast<uint32_t>(ScenarioType::TYPE_COUNT); ++current_type_index)
+	{
+		const ScenarioType type = static_cast<ScenarioType>(current_type_index);
+
+		ScenarioType parsed_type = ScenarioType::TYPE_COUNT;
+		FORWARDPLUSDEMO_CHECK(parse_scenario_type(get_scenario_name(type), parsed_type) && (parsed_type == type));
+	}
+
+	ScenarioType parsed_type = ScenarioType::DEMO;
+	FORWARDPLUSDEMO_CHECK(!parse_scenario_type("Grid", parsed_type) && (parsed_type == ScenarioType::DEMO));
+	FORWARDPLUSDEMO_CHECK(!parse_scenario_type("", parsed_type));
+}
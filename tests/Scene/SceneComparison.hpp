@@ -0,0 +1,33 @@
+#ifndef FORWARDPLUSDEMO_TESTS_SCENE_SCENECOMPARISON_HPP
+#define FORWARDPLUSDEMO_TESTS_SCENE_SCENECOMPARISON_HPP
+#include <ForwardPlusDemo/Scene/SceneDescription.hpp>
+
+#include <cstring>
+namespace ForwardPlusDemo::Testing
+{
+	template<typename T>
+	bool is_same_column(const T* left, const T* right, size_t count)
+	{
+		return (count == 0) || ((left != nullptr) && (right != nullptr) && (std::memcmp(left, right, count * sizeof(T)) == 0));
+	}
+
+	// Bit for bit, every light column & object record
+	inline bool is_same_scene(const SceneLightView& lights, const SceneObjectView& objects, const SceneDescription& scene)
+	{
+		const SceneLightView expected_lights = scene.get_light_view();
+		const SceneObjectView expected_objects = scene.get_object_view();
+
+		return (lights.count == expected_lights.count) && (objects.count == expected_objects.count)
+			&& is_same_column(lights.types, expected_lights.types, lights.count)
+			&& is_same_column(lights.positions, expected_lights.positions, lights.count)
+			&& is_same_column(lights.rotations, expected_lights.rotations, lights.count)
+			&& is_same_column(lights.ranges, expected_lights.ranges, lights.count)
+			&& is_same_column(lights.outer_angles, expected_lights.outer_angles, lights.count)
+			&& is_same_column(lights.inner_angles, expected_lights.inner_angles, lights.count)
+			&& is_same_column(lights.linear_attenuations, expected_lights.linear_attenuations, lights.count)
+			&& is_same_column(lights.diffuse, expected_lights.diffuse, lights.count)
+			&& is_same_column(lights.ambient, expected_lights.ambient, lights.count)
+			&& is_same_column(objects.records, expected_objects.records, objects.count);
+	}
+}
+#endif
@@ -0,0 +1,70 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Scene/SceneFile.hpp>
+#include <ForwardPlusDemo/Utilities/Random.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+using namespace ForwardPlusDemo;
+
+// Opening a mapped binary scene against parsing the same point lights from text, and a first pass over the columns
+FORWARDPLUSDEMO_BENCHMARK(scene_file_load)
+{
+	const uint32_t light_count = context.select(100000u, 10000u);
+
+	const std::filesystem::path binary_path = std::filesystem::temp_directory_path() / "scene_file_load.fpscene";
+	const std::filesystem::path text_path = std::filesystem::temp_directory_path() / "scene_file_load.txt";
+
+	{
+		Random random(31);
+		SceneDescription scene;
+		std::ofstream text_file(text_path, std::ios::trunc);
+
+		for (uint32_t current_light = 0; current_light < light_count; ++current_light)
+		{
+			SceneLight light;
+			light.position = Vector3(random.next_float(-500.0f, 500.0f), random.next_float(0.0f, 20.0f), random.next_float(-500.0f, 500.0f));
+			light.range = random.next_float(1.0f, 20.0f);
+			light.diffuse = Vector3(random.next_float(), random.next_float(), random.next_float());
+			light.ambient = Vector3(light.diffuse.x * 0.3f, light.diffuse.y * 0.3f, light.diffuse.z * 0.3f);
+			scene.add_light(light);
+
+			char line[160];
+			std::snprintf(line, sizeof(line), "light point %.9g %.9g %.9g %.9g %.9g %.9g %.9g\n",
+				light.position.x, light.position.y, light.position.z, light.range, light.diffuse.x, light.diffuse.y, light.diffuse.z);
+			text_file << line;
+		}
+
+		scene.write_binary(binary_path);
+	}
+
+	float range_sum = 0.0f;
+	const double binary_ms = context.time_ms([&]()
+	{
+		SceneFile scene_file;
+		scene_file.open(binary_path);
+
+		// Pages come in on first use, so the load isn't done before the columns were read once
+		const SceneLightView lights = scene_file.get_light_view();
+		for (size_t current_light = 0; current_light < lights.count; ++current_light)
+		{
+			range_sum += lights.ranges[current_light] + lights.positions[current_light].x;
+		}
+	});
+
+	size_t text_light_count = 0;
+	const double text_ms = context.time_ms([&]()
+	{
+		SceneDescription scene;
+		scene.load_text(text_path);
+		text_light_count = scene.get_light_count();
+	});
+
+	context.report("%u lights, SceneFile open & first pass: %.3f ms (%.1f MB), text parse: %.1f ms for %zu lights (sum %.1f)",
+		light_count, binary_ms, std::filesystem::file_size(binary_path) / (1024.0 * 1024.0), text_ms, text_light_count, range_sum);
+
+	std::filesystem::remove(binary_path);
+	std::filesystem::remove(text_path);
+}
@@ -0,0 +1,229 @@
+#include <TestFramework.hpp>
+#include <Scene/SceneComparison.hpp>
+
+#include <ForwardPlusDemo/Scene/SceneFile.hpp>
+#include <ForwardPlusDemo/Utilities/Random.hpp>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+using namespace ForwardPlusDemo::Testing;
+using namespace ForwardPlusDemo::SceneFileFormat;
+
+namespace
+{
+	std::filesystem::path get_test_path(const char* name)
+	{
+		return std::filesystem::temp_directory_path() / name;
+	}
+
+	// Every light type & distinct values in every column, so a column read from the wrong place shows
+	SceneDescription make_test_scene(uint32_t light_count, uint32_t object_count)
+	{
+		Random random(29);
+		SceneDescription scene;
+
+		for (uint32_t current_light = 0; current_light < light_count; ++current_light)
+		{
+			SceneLight light;
+			light.type = static_cast<LightType>(current_light % static_cast<uint32_t>(LightType::TYPE_COUNT));
+			light.position = Vector3(random.next_float(-50.0f, 50.0f), random.next_float(0.0f, 10.0f), random.next_float(-50.0f, 50.0f));
+			light.rotation = Vector3(random.next_float(), random.next_float(), random.next_float());
+			light.range = random.next_float(1.0f, 20.0f);
+			light.outer_angle = random.next_float(0.2f, 0.8f);
+			light.inner_angle = light.outer_angle * 0.5f;
+			light.linear_attenuation = random.next_float();
+			light.diffuse = Vector3(random.next_float(), random.next_float(), random.next_float());
+			light.ambient = Vector3(random.next_float(), random.next_float(), random.next_float());
+			scene.add_light(light);
+		}
+
+		for (uint32_t current_object = 0; current_object < object_count; ++current_object)
+		{
+			const XMMatrix model = DirectX::XMMatrixTranslation(random.next_float(-50.0f, 50.0f), 0.0f, random.next_float(-50.0f, 50.0f));
+			scene.add_object(static_cast<ObjectType>(current_object % static_cast<uint32_t>(ObjectType::TYPE_COUNT)), to_matrix4(model),
+				Vector4(random.next_float(), random.next_float(), random.next_float(), 1.0f), Vector4(1.0f, 1.0f, 1.0f, 1.0f));
+		}
+
+		return scene;
+	}
+
+	std::vector<char> read_bytes(const std::filesystem::path& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	void write_bytes(const std::filesystem::path& path, const std::vector<char>& bytes)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+	}
+
+	Header& get_header(std::vector<char>& bytes)
+	{
+		return *reinterpret_cast<Header*>(bytes.data());
+	}
+
+	SectionEntry& get_section(std::vector<char>& bytes, SectionId id)
+	{
+		SectionEntry* section_table = reinterpret_cast<SectionEntry*>(bytes.data() + sizeof(Header));
+		for (uint32_t section_index = 0; section_index < get_header(bytes).section_count; ++section_index)
+		{
+			if (section_table[section_index].id == static_cast<uint32_t>(id))
+			{
+				return section_table[section_index];
+			}
+		}
+
+		return section_table[0];
+	}
+}
+
+FORWARDPLUSDEMO_TEST(scene_file, binary_round_trip)
+{
+	const std::filesystem::path path = get_test_path("scene_file_round_trip.fpscene");
+
+	const SceneDescription scene = make_test_scene(1000, 300);
+	FORWARDPLUSDEMO_CHECK(scene.write_binary(path));
+
+	SceneFile scene_file;
+	FORWARDPLUSDEMO_CHECK(scene_file.open(path));
+	FORWARDPLUSDEMO_CHECK(is_same_scene(scene_file.get_light_view(), scene_file.get_object_view(), scene));
+
+	// Columns are used in place, each on its own aligned section
+	FORWARDPLUSDEMO_CHECK((reinterpret_cast<uintptr_t>(scene_file.get_light_view().positions) % c_section_alignment) == 0);
+	FORWARDPLUSDEMO_CHECK((reinterpret_cast<uintptr_t>(scene_file.get_object_view().records) % c_section_alignment) == 0);
+
+	const SceneLight light = scene_file.get_light_view().get_light(2);
+	FORWARDPLUSDEMO_CHECK((light.type == LightType::SPOT) && (light.range == scene.get_light_view().ranges[2]));
+
+	scene_file.close();
+	FORWARDPLUSDEMO_CHECK(!scene_file.is_open() && (scene_file.get_light_view().count == 0));
+
+	// An empty scene has no sections at all
+	FORWARDPLUSDEMO_CHECK(SceneDescription().write_binary(path));
+	FORWARDPLUSDEMO_CHECK(scene_file.open(path));
+	FORWARDPLUSDEMO_CHECK((scene_file.get_light_view().count == 0) && (scene_file.get_object_view().count == 0));
+	scene_file.close();
+
+	std::filesystem::remove(path);
+}
+
+// Each file is the valid one with a single field broken, none may open
+FORWARDPLUSDEMO_TEST(scene_file, malformed_files)
+{
+	const std::filesystem::path path = get_test_path("scene_file_malformed.fpscene");
+	const std::filesystem::path broken_path = get_test_path("scene_file_malformed_broken.fpscene");
+
+	FORWARDPLUSDEMO_CHECK(make_test_scene(100, 10).write_binary(path));
+	const std::vector<char> valid_bytes = read_bytes(path);
+
+	auto opens = [&broken_path](const std::vector<char>& bytes)
+	{
+		write_bytes(broken_path, bytes);
+
+		SceneFile scene_file;
+		const bool opened = scene_file.open(broken_path);
+		FORWARDPLUSDEMO_CHECK(opened == scene_file.is_open());
+		return opened;
+	};
+
+	auto break_file = [&valid_bytes, &opens](auto&& change)
+	{
+		std::vector<char> bytes = valid_bytes;
+		change(bytes);
+		return !opens(bytes);
+	};
+
+	FORWARDPLUSDEMO_CHECK(opens(valid_bytes));
+	FORWARDPLUSDEMO_CHECK(!SceneFile().open(get_test_path("scene_file_missing.fpscene")));
+
+	// Header
+	FORWARDPLUSDEMO_CHECK(break_file([](std::vector<char>& bytes) { bytes.resize(sizeof(Header) - 1); }));
+	FORWARDPLUSDEMO_CHECK(break_file([](std::vector<char>& bytes) { get_header(bytes).magic = 0; }));
+	FORWARDPLUSDEMO_CHECK(break_file([](std::vector<char>& bytes) { get_header(bytes).version = c_version + 1; }));
+	FORWARDPLUSDEMO_CHECK(break_file([](std::vector<char>& bytes) { get_header(bytes).endian_tag = 0x04030201; }));
+	FORWARDPLUSDEMO_CHECK(break_file([](std::vector<char>& bytes) { get_header(bytes).section_count = 0x10000000; }));
+
+	// Counts that don't match the sections, including one whose byte size wraps around 64 bits
+	FORWARDPLUSDEMO_CHECK(break_file([](std::vector<char>& bytes) { get_header(bytes).light_count += 1; }));
+	FORWARDPLUSDEMO_CHECK(break_file([](std::vector<char>& bytes) { get_header(bytes).object_count = 1ull << 60; }));
+	FORWARDPLUSDEMO_CHECK(break_file([](std::vector<char>& bytes) { get_header(bytes).light_count = (1ull << 62) + 100; }));
+
+	// Sections
+	FORWARDPLUSDEMO_CHECK(break_file([](std::vector<char>& bytes) { get_section(bytes, SectionId::LIGHT_RANGES).offset += 4; }));
+	FORWARDPLUSDEMO_CHECK(break_file([](std::vector<char>& bytes) { get_section(bytes, SectionId::LIGHT_POSITIONS).element_size = sizeof(Vector4); }));
+	FORWARDPLUSDEMO_CHECK(break_file([](std::vector<char>& bytes) { get_section(bytes, SectionId::OBJECT_RECORDS).size -= sizeof(SceneObjectRecord); }));
+	FORWARDPLUSDEMO_CHECK(break_file([](std::vector<char>& bytes) { get_section(bytes, SectionId::LIGHT_AMBIENT).offset = (bytes.size() / c_section_alignment) * c_section_alignment; }));
+	FORWARDPLUSDEMO_CHECK(break_file([](std::vector<char>& bytes) { get_section(bytes, SectionId::LIGHT_DIFFUSE).offset = UINT64_MAX - (c_section_alignment - 1); }));
+	FORWARDPLUSDEMO_CHECK(break_file([](std::vector<char>& bytes) { get_section(bytes, SectionId::LIGHT_TYPES).id = static_cast<uint32_t>(SectionId::SECTION_COUNT) + 1; }));
+	FORWARDPLUSDEMO_CHECK(break_file([](std::vector<char>& bytes) { bytes.resize(bytes.size() - 1); }));
+
+	// Light types index per type arrays when rendering
+	FORWARDPLUSDEMO_CHECK(break_file([](std::vector<char>& bytes)
+	{
+		uint32_t* types = reinterpret_cast<uint32_t*>(bytes.data() + get_section(bytes, SectionId::LIGHT_TYPES).offset);
+		types[57] = static_cast<uint32_t>(LightType::TYPE_COUNT);
+	}));
+
+	// Unknown sections are skipped, so newer writers can append data
+	std::vector<char> bytes = valid_bytes;
+	get_section(bytes, SectionId::LIGHT_TYPES).id = 1000;
+	get_header(bytes).light_count = 0;
+	for (SectionId light_section : { SectionId::LIGHT_POSITIONS, SectionId::LIGHT_ROTATIONS, SectionId::LIGHT_RANGES, SectionId::LIGHT_OUTER_ANGLES, SectionId::LIGHT_INNER_ANGLES,
+		SectionId::LIGHT_LINEAR_ATTENUATIONS, SectionId::LIGHT_DIFFUSE, SectionId::LIGHT_AMBIENT })
+	{
+		get_section(bytes, light_section).id = 1000;
+	}
+
+	FORWARDPLUSDEMO_CHECK(opens(bytes));
+
+	std::filesystem::remove(path);
+	std::filesystem::remove(broken_path);
+}
+
+FORWARDPLUSDEMO_TEST(scene_file, text_scenes)
+{
+	const std::filesystem::path path = get_test_path("scene_file_text.txt");
+
+	auto load = [&path](const char* text, SceneDescription& scene)
+	{
+		std::ofstream(path, std::ios::trunc) << text;
+		return scene.load_text(path);
+	};
+
+	SceneDescription scene;
+	FORWARDPLUSDEMO_CHECK(load(
+		"# Comment\n"
+		"light point 1 2 3 10 1 0.5 0\n"
+		"\n"
+		"light spot 0 5 0 90 0 0 15 40 20 0 1 0 # Trailing comment\n"
+		"light directional -45 30 0 0.2 0.2 0.2\n"
+		"object cube 0 0 0 0 45 0 1 2 1 1 1 1\n"
+		"object plane 0 -1 0 0 0 0 50 1 50 0.5 0.5 0.5\n", scene));
+
+	FORWARDPLUSDEMO_CHECK((scene.get_light_count() == 3) && (scene.get_object_count() == 2));
+
+	const SceneLight point_light = scene.get_light_view().get_light(0);
+	FORWARDPLUSDEMO_CHECK((point_light.type == LightType::POINT) && (point_light.position.z == 3.0f) && (point_light.range == 10.0f));
+	FORWARDPLUSDEMO_CHECK((point_light.diffuse.y == 0.5f) && (point_light.ambient.y == 0.15f));
+
+	const SceneLight spot_light = scene.get_light_view().get_light(1);
+	FORWARDPLUSDEMO_CHECK((spot_light.type == LightType::SPOT) && (std::abs(spot_light.outer_angle - DirectX::XMConvertToRadians(40.0f)) < 1e-6f));
+	FORWARDPLUSDEMO_CHECK(scene.get_light_view().get_light(2).type == LightType::DIRECTIONAL);
+	FORWARDPLUSDEMO_CHECK(scene.get_object_view().records[1].type == static_cast<uint32_t>(ObjectType::PLANE));
+
+	// Unknown entries & types and missing values fail the whole file
+	FORWARDPLUSDEMO_CHECK(!load("light area 0 0 0 1 1 1 1\n", scene));
+	FORWARDPLUSDEMO_CHECK(!load("light point 1 2 3\n", scene));
+	FORWARDPLUSDEMO_CHECK(!load("object sphere 0 0 0 0 0 0 1 1 1 1 1 1\n", scene));
+	FORWARDPLUSDEMO_CHECK(!load("camera 0 0 0\n", scene));
+	FORWARDPLUSDEMO_CHECK(!scene.load_text(get_test_path("scene_file_missing.txt")));
+
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,145 @@
+#include <TestFramework.hpp>
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace ForwardPlusDemo::Testing
+{
+	namespace
+	{
+		struct RegisteredTest
+		{
+			const char* suite;
+			const char* name;
+			TestFunction function;
+		};
+
+		struct RegisteredBenchmark
+		{
+			const char* name;
+			BenchmarkFunction function;
+		};
+
+		// Function local so registration from other translation units' static initializers is safe
+		std::vector<RegisteredTest>& get_tests()
+		{
+			static std::vector<RegisteredTest> tests;
+			return tests;
+		}
+
+		std::vector<RegisteredBenchmark>& get_benchmarks()
+		{
+			static std::vector<RegisteredBenchmark> benchmarks;
+			return benchmarks;
+		}
+
+		uint32_t g_failure_count = 0;
+
+		bool is_selected(const char* name, const std::vector<const char*>& selected_names)
+		{
+			if (selected_names.empty())
+			{
+				return true;
+			}
+
+			return std::any_of(selected_names.begin(), selected_names.end(), [name](const char* selected_name) { return std::strcmp(name, selected_name) == 0; });
+		}
+	}
+
+	void BenchmarkContext::report(const char* format, ...) const
+	{
+		std::printf("%s: ", m_name);
+
+		va_list arguments;
+		va_start(arguments, format);
+		std::vprintf(format, arguments);
+		va_end(arguments);
+
+		std::printf("\n");
+		std::fflush(stdout);
+	}
+
+	double BenchmarkContext::get_median(double* values, uint32_t count)
+	{
+		std::sort(values, values + count);
+		return values[count / 2];
+	}
+
+	bool register_test(const char* suite, const char* name, TestFunction function)
+	{
+		get_tests().push_back({ suite, name, function });
+		return true;
+	}
+
+	bool register_benchmark(const char* name, BenchmarkFunction function)
+	{
+		get_benchmarks().push_back({ name, function });
+		return true;
+	}
+
+	void report_failure(const char* file, int line, const char* expression)
+	{
+		std::printf("%s(%d): check failed: %s\n", file, line, expression);
+		++g_failure_count;
+	}
+
+	int run_tests(int argc, char** argv)
+	{
+		const std::vector<const char*> selected_suites(argv + 1, argv + argc);
+
+		uint32_t test_count = 0;
+		for (const RegisteredTest& current_test : get_tests())
+		{
+			if (!is_selected(current_test.suite, selected_suites))
+			{
+				continue;
+			}
+
+			const uint32_t previous_failure_count = g_failure_count;
+			current_test.function();
+			++test_count;
+
+			std::printf("[%s] %s.%s\n", (g_failure_count == previous_failure_count) ? "pass" : "FAIL", current_test.suite, current_test.name);
+		}
+
+		std::printf("%u tests, %u failed checks\n", test_count, g_failure_count);
+
+		return ((test_count > 0) && (g_failure_count == 0)) ? 0 : 1;
+	}
+
+	int run_benchmarks(int argc, char** argv)
+	{
+		bool quick = false;
+		std::vector<const char*> selected_benchmarks;
+		for (int argument_index = 1; argument_index < argc; ++argument_index)
+		{
+			if (std::strcmp(argv[argument_index], "--quick") == 0)
+			{
+				quick = true;
+			}
+			else
+			{
+				selected_benchmarks.push_back(argv[argument_index]);
+			}
+		}
+
+		uint32_t benchmark_count = 0;
+		for (const RegisteredBenchmark& current_benchmark : get_benchmarks())
+		{
+			if (!is_selected(current_benchmark.name, selected_benchmarks))
+			{
+				continue;
+			}
+
+			BenchmarkContext context(current_benchmark.name, quick);
+			current_benchmark.function(context);
+			++benchmark_count;
+		}
+
+		// Benchmarks check their results too, a wrong answer fails the run
+		return ((benchmark_count > 0) && (g_failure_count == 0)) ? 0 : 1;
+	}
+}
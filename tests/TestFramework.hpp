@@ -0,0 +1,77 @@
+#ifndef FORWARDPLUSDEMO_TESTS_TESTFRAMEWORK_HPP
+#define FORWARDPLUSDEMO_TESTS_TESTFRAMEWORK_HPP
+#include <chrono>
+#include <cstdint>
+#include <string>
+namespace ForwardPlusDemo::Testing
+{
+	class BenchmarkContext
+	{
+	public:
+		BenchmarkContext(const char* name, bool quick) : m_name(name), m_quick(quick) {}
+
+		// CTest runs the benchmarks with --quick, as a smoke test on small inputs
+		bool is_quick() const { return m_quick; }
+
+		template<typename T>
+		T select(T full_value, T quick_value) const { return m_quick ? quick_value : full_value; }
+
+		// Median of a few runs, in milliseconds
+		template<typename Func>
+		double time_ms(Func&& func) const
+		{
+			const uint32_t run_count = m_quick ? 1 : 5;
+
+			double run_times[5] = {};
+			for (uint32_t current_run = 0; current_run < run_count; ++current_run)
+			{
+				const auto start_time = std::chrono::steady_clock::now();
+				func();
+				run_times[current_run] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+			}
+
+			return get_median(run_times, run_count);
+		}
+
+		// printf style, prefixed with the benchmark name
+		void report(const char* format, ...) const;
+	private:
+		static double get_median(double* values, uint32_t count);
+
+		const char* m_name;
+		bool m_quick;
+	};
+
+	using TestFunction = void (*)();
+	using BenchmarkFunction = void (*)(BenchmarkContext&);
+
+	bool register_test(const char* suite, const char* name, TestFunction function);
+	bool register_benchmark(const char* name, BenchmarkFunction function);
+
+	void report_failure(const char* file, int line, const char* expression);
+
+	// Entry points of the test & benchmark executables, both take the names to run (all when empty)
+	int run_tests(int argc, char** argv);
+	int run_benchmarks(int argc, char** argv);
+}
+
+#define FORWARDPLUSDEMO_TEST(suite, name) \
+	static void suite##_##name(); \
+	static const bool suite##_##name##_registered = ForwardPlusDemo::Testing::register_test(#suite, #name, &suite##_##name); \
+	static void suite##_##name()
+
+#define FORWARDPLUSDEMO_BENCHMARK(name) \
+	static void name##_benchmark(ForwardPlusDemo::Testing::BenchmarkContext& context); \
+	static const bool name##_benchmark_registered = ForwardPlusDemo::Testing::register_benchmark(#name, &name##_benchmark); \
+	static void name##_benchmark(ForwardPlusDemo::Testing::BenchmarkContext& context)
+
+// Records the failure and carries on with the test
+#define FORWARDPLUSDEMO_CHECK(expression) \
+	do \
+	{ \
+		if (!(expression)) \
+		{ \
+			ForwardPlusDemo::Testing::report_failure(__FILE__, __LINE__, #expression); \
+		} \
+	} while (false)
+#endif
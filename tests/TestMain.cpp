@@ -0,0 +1,6 @@
+#include <TestFramework.hpp>
+
+int main(int argc, char** argv)
+{
+	return ForwardPlusDemo::Testing::run_tests(argc, argv);
+}
@@ -0,0 +1,118 @@
+#include <TestFramework.hpp>
+#include <Utilities/OldEventQueue.hpp>
+
+#include <ForwardPlusDemo/Utilities/EventQueue.hpp>
+
+#include <cstring>
+
+using namespace ForwardPlusDemo;
+using namespace ForwardPlusDemo::Testing;
+
+namespace
+{
+	// Camera transform sized
+	struct TestEvent
+	{
+		uint32_t values[8];
+	};
+
+	template<typename Queue>
+	void write_batch(Queue& queue, uint32_t batch_size)
+	{
+		for (uint32_t current_event = 0; current_event < batch_size; ++current_event)
+		{
+			queue.write_event(current_event & 3, TestEvent{ { current_event } });
+		}
+	}
+
+	// Sum of the first value of every event, so reading can't be skipped
+	uint64_t read_batch(const EventQueue& queue)
+	{
+		uint64_t sum = 0;
+		for (EventQueue::Iterator event_it = queue.get_iterator(); event_it.is_valid(); event_it.advance())
+		{
+			sum += event_it.get_event<TestEvent>()->values[0];
+		}
+
+		return sum;
+	}
+
+	uint64_t read_batch(const Old::EventQueue& queue)
+	{
+		uint64_t sum = 0;
+		for (Old::EventQueue::Iterator event_it(queue); event_it.is_valid(); event_it.advance())
+		{
+			uint32_t value = 0;
+			std::memcpy(&value, event_it.get_event_data(), sizeof(uint32_t));
+			sum += value;
+		}
+
+		return sum;
+	}
+
+	// Writes & reads event_count events in batches, through one reused queue or a fresh queue per batch
+	template<typename Queue>
+	uint64_t run_batches(uint64_t event_count, uint32_t batch_size, bool reuse_queue)
+	{
+		uint64_t sum = 0;
+
+		Queue reused_queue;
+		for (uint64_t current_event = 0; current_event < event_count; current_event += batch_size)
+		{
+			if (reuse_queue)
+			{
+				write_batch(reused_queue, batch_size);
+				sum += read_batch(reused_queue);
+				reused_queue.clear();
+			}
+			else
+			{
+				Queue queue;
+				write_batch(queue, batch_size);
+				sum += read_batch(queue);
+			}
+		}
+
+		return sum;
+	}
+}
+
+// Write & read throughput of 32 byte events, chunked EventQueue against the vector based one it replaced
+FORWARDPLUSDEMO_BENCHMARK(event_queue_batches)
+{
+	const uint64_t event_count = context.select(20000000ull, 200000ull);
+
+	struct TestCase
+	{
+		uint32_t batch_size;
+		bool reuse_queue;
+	};
+
+	const TestCase test_cases[] =
+	{
+		{ 4, true },
+		{ 64, true },
+		{ 4096, true },
+		{ 4, false },
+		{ 4096, false },
+	};
+
+	for (const TestCase& current_case : test_cases)
+	{
+		uint64_t sum = 0;
+		const double new_ms = context.time_ms([&]()
+		{
+			sum = run_batches<EventQueue>(event_count, current_case.batch_size, current_case.reuse_queue);
+		});
+
+		uint64_t old_sum = 0;
+		const double old_ms = context.time_ms([&]()
+		{
+			old_sum = run_batches<Old::EventQueue>(event_count, current_case.batch_size, current_case.reuse_queue);
+		});
+
+		context.report("batches of %u, %s: EventQueue %.1f M events/s, old EventQueue %.1f M events/s%s\n",
+			current_case.batch_size, current_case.reuse_queue ? "reused queue" : "new queue per batch",
+			(event_count / new_ms) * 1e-3, (event_count / old_ms) * 1e-3, (sum == old_sum) ? "" : ", MISMATCH");
+	}
+}
@@ -0,0 +1,247 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Utilities/EventQueue.hpp>
+#include <ForwardPlusDemo/Utilities/Random.hpp>
+
+#include <cstring>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	struct SmallEvent
+	{
+		uint32_t value;
+	};
+
+	struct alignas(16) VectorEvent
+	{
+		float values[4];
+	};
+
+	struct alignas(64) CacheLineEvent
+	{
+		uint32_t value;
+	};
+
+	bool is_aligned(const void* pointer, size_t alignment)
+	{
+		return (reinterpret_cast<uintptr_t>(pointer) % alignment) == 0;
+	}
+
+	struct ExpectedEvent
+	{
+		uint32_t id;
+		uint32_t size;
+		const char* data;
+	};
+
+	// Same events in the same order, each still at the address it was allocated at
+	bool has_events(const EventQueue& queue, const std::vector<ExpectedEvent>& expected_events)
+	{
+		size_t current_event = 0;
+		for (EventQueue::Iterator event_it = queue.get_iterator(); event_it.is_valid(); event_it.advance(), ++current_event)
+		{
+			if (current_event == expected_events.size())
+			{
+				return false;
+			}
+
+			const ExpectedEvent& expected_event = expected_events[current_event];
+			if ((event_it.get_header().event_id != expected_event.id) || (event_it.get_header().data_size != expected_event.size) || (event_it.get_event_data() != expected_event.data))
+			{
+				return false;
+			}
+		}
+
+		return current_event == expected_events.size();
+	}
+}
+
+FORWARDPLUSDEMO_TEST(event_queue, empty_queue)
+{
+	EventQueue queue;
+	FORWARDPLUSDEMO_CHECK(queue.is_empty());
+	FORWARDPLUSDEMO_CHECK(queue.get_size() == 0);
+	FORWARDPLUSDEMO_CHECK(!queue.get_iterator().is_valid());
+
+	queue.write_event(0, SmallEvent{ 1 });
+	queue.clear();
+	FORWARDPLUSDEMO_CHECK(queue.is_empty());
+	FORWARDPLUSDEMO_CHECK(!queue.get_iterator().is_valid());
+}
+
+FORWARDPLUSDEMO_TEST(event_queue, aligned_event_data)
+{
+	EventQueue queue;
+	const SmallEvent* small_event = queue.allocate_event<SmallEvent>(0);
+	queue.write_event(1, VectorEvent{ { 1.0f, 2.0f, 3.0f, 4.0f } });
+	queue.write_event(2, CacheLineEvent{ 7 });
+	queue.write_event(0, SmallEvent{ 3 });
+
+	// Value initialized
+	FORWARDPLUSDEMO_CHECK(small_event->value == 0);
+
+	std::vector<uint32_t> data_offsets;
+	for (EventQueue::Iterator event_it = queue.get_iterator(); event_it.is_valid(); event_it.advance())
+	{
+		const EventQueue::Header& header = event_it.get_header();
+		FORWARDPLUSDEMO_CHECK(is_aligned(event_it.get_event_data(), (header.event_id == 2) ? 64 : 16));
+		data_offsets.push_back(header.data_offset);
+
+		if (header.event_id == 1)
+		{
+			FORWARDPLUSDEMO_CHECK(event_it.get_event<VectorEvent>()->values[3] == 4.0f);
+		}
+		else if (header.event_id == 2)
+		{
+			FORWARDPLUSDEMO_CHECK(event_it.get_event<CacheLineEvent>()->value == 7);
+		}
+	}
+
+	// Records at 0, 32, 64 & 192, the 64 byte aligned data starts at the next boundary after its header
+	FORWARDPLUSDEMO_CHECK(data_offsets == std::vector<uint32_t>({ 16, 16, 64, 16 }));
+	FORWARDPLUSDEMO_CHECK(queue.get_size() == 32 + 32 + 128 + 32);
+}
+
+FORWARDPLUSDEMO_TEST(event_queue, events_never_move)
+{
+	EventQueue queue;
+
+	std::vector<ExpectedEvent> expected_events;
+	for (uint32_t current_event = 0; current_event < 10000; ++current_event)
+	{
+		const SmallEvent* event = queue.allocate_event<SmallEvent>(current_event);
+		expected_events.push_back(ExpectedEvent{ current_event, sizeof(SmallEvent), reinterpret_cast<const char*>(event) });
+	}
+
+	// 128 records of 32 bytes per 4 KB chunk
+	FORWARDPLUSDEMO_CHECK(queue.get_size() == 10000 * 32);
+	FORWARDPLUSDEMO_CHECK(has_events(queue, expected_events));
+}
+
+FORWARDPLUSDEMO_TEST(event_queue, large_events_get_their_own_chunk)
+{
+	EventQueue queue;
+	std::vector<ExpectedEvent> expected_events;
+
+	queue.write_event(0, SmallEvent{ 1 });
+	expected_events.push_back(ExpectedEvent{ 0, sizeof(SmallEvent), queue.get_iterator().get_event_data() });
+
+	const char* large_data = queue.allocate_raw_data(1, 9000);
+	expected_events.push_back(ExpectedEvent{ 1, 9000, large_data });
+
+	bool zero_filled = true;
+	for (uint32_t current_byte = 0; current_byte < 9000; ++current_byte)
+	{
+		zero_filled = zero_filled && (large_data[current_byte] == 0);
+	}
+
+	FORWARDPLUSDEMO_CHECK(zero_filled);
+
+	// The next event goes into a new chunk after the large one
+	const SmallEvent* next_event = queue.allocate_event<SmallEvent>(2);
+	expected_events.push_back(ExpectedEvent{ 2, sizeof(SmallEvent), reinterpret_cast<const char*>(next_event) });
+	FORWARDPLUSDEMO_CHECK((reinterpret_cast<const char*>(next_event) < large_data) || (reinterpret_cast<const char*>(next_event) >= (large_data + 9000)));
+
+	FORWARDPLUSDEMO_CHECK(has_events(queue, expected_events));
+}
+
+FORWARDPLUSDEMO_TEST(event_queue, clear_reuses_chunks)
+{
+	EventQueue queue;
+
+	auto write_events = [&queue]()
+	{
+		std::vector<ExpectedEvent> expected_events;
+		for (uint32_t current_event = 0; current_event < 1000; ++current_event)
+		{
+			const SmallEvent* event = queue.allocate_event<SmallEvent>(current_event);
+			expected_events.push_back(ExpectedEvent{ current_event, sizeof(SmallEvent), reinterpret_cast<const char*>(event) });
+		}
+
+		return expected_events;
+	};
+
+	// Same events after a clear land at the same addresses, nothing was freed or allocated
+	const std::vector<ExpectedEvent> first_events = write_events();
+	queue.clear();
+	const std::vector<ExpectedEvent> second_events = write_events();
+
+	FORWARDPLUSDEMO_CHECK(has_events(queue, first_events));
+	FORWARDPLUSDEMO_CHECK(has_events(queue, second_events));
+
+	// A large event doesn't fit the spare chunks, it gets a new one in front of them & the spares stay in order
+	queue.clear();
+	const char* large_data = queue.allocate_raw_data(0, 9000);
+	const SmallEvent* next_event = queue.allocate_event<SmallEvent>(1);
+	FORWARDPLUSDEMO_CHECK(reinterpret_cast<const char*>(next_event) == first_events[0].data);
+	FORWARDPLUSDEMO_CHECK(has_events(queue, { ExpectedEvent{ 0, 9000, large_data }, ExpectedEvent{ 1, sizeof(SmallEvent), reinterpret_cast<const char*>(next_event) } }));
+}
+
+// Random sizes, some larger than a chunk, the data read back matches what was written
+FORWARDPLUSDEMO_TEST(event_queue, random_round_trip)
+{
+	Random random(53);
+	EventQueue queue;
+
+	for (uint32_t current_batch = 0; current_batch < 20; ++current_batch)
+	{
+		std::vector<std::vector<uint8_t>> expected_data;
+		const uint32_t event_count = random.next_uint32(500);
+		for (uint32_t current_event = 0; current_event < event_count; ++current_event)
+		{
+			std::vector<uint8_t> data;
+			switch (random.next_uint32(4))
+			{
+			case 0:
+				data.resize(4);
+				break;
+			case 1:
+				data.resize(16 * (1 + random.next_uint32(4)));
+				break;
+			case 2:
+				data.resize(64);
+				break;
+			default:
+				data.resize(1 + random.next_uint32(9000));
+				break;
+			}
+
+			for (uint8_t& current_byte : data)
+			{
+				current_byte = static_cast<uint8_t>(random.next_uint32(255) + 1);
+			}
+
+			char* event_data = queue.allocate_raw_data(current_event, data.size());
+			std::memcpy(event_data, data.data(), data.size());
+			expected_data.push_back(std::move(data));
+		}
+
+		size_t used_size = 0;
+		uint32_t current_event = 0;
+		for (EventQueue::Iterator event_it = queue.get_iterator(); event_it.is_valid(); event_it.advance(), ++current_event)
+		{
+			const EventQueue::Header& header = event_it.get_header();
+			FORWARDPLUSDEMO_CHECK(header.event_id == current_event);
+			FORWARDPLUSDEMO_CHECK(is_aligned(event_it.get_event_data(), EventQueue::c_event_alignment));
+
+			if ((current_event < expected_data.size()) && (header.data_size == expected_data[current_event].size()))
+			{
+				FORWARDPLUSDEMO_CHECK(std::memcmp(event_it.get_event_data(), expected_data[current_event].data(), header.data_size) == 0);
+			}
+			else
+			{
+				FORWARDPLUSDEMO_CHECK(false);
+			}
+
+			used_size += (header.data_offset + header.data_size + 15) & ~size_t(15);
+		}
+
+		FORWARDPLUSDEMO_CHECK(current_event == event_count);
+		FORWARDPLUSDEMO_CHECK(queue.get_size() == used_size);
+
+		queue.clear();
+	}
+}
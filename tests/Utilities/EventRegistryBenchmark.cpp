@@ -0,0 +1,146 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Utilities/EventQueue.hpp>
+#include <ForwardPlusDemo/Utilities/EventRegistry.hpp>
+#include <ForwardPlusDemo/Utilities/Random.hpp>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	// Shaped like RenderSystem's events
+	struct FenceEvent
+	{
+		uint64_t value;
+	};
+
+	struct PauseEvent
+	{
+		bool paused;
+	};
+
+	struct FullscreenEvent
+	{
+		uint32_t width;
+		uint32_t height;
+		bool fullscreen;
+	};
+
+	struct ToggleEvent
+	{
+	};
+
+	using TestEvents = EventRegistry<FenceEvent, PauseEvent, FullscreenEvent, ToggleEvent>;
+
+	struct TestHandler
+	{
+		uint64_t fence_value = 0;
+		uint32_t pause_count = 0;
+		uint64_t fullscreen_area = 0;
+		uint32_t toggle_count = 0;
+
+		void handle_event(const FenceEvent& event) { fence_value += event.value; }
+		void handle_event(const PauseEvent& event) { pause_count += event.paused ? 1 : 0; }
+		void handle_event(const FullscreenEvent& event) { fullscreen_area += event.fullscreen ? (static_cast<uint64_t>(event.width) * event.height) : 0; }
+		void handle_event(const ToggleEvent&) { ++toggle_count; }
+
+		bool operator==(const TestHandler& other) const = default;
+	};
+
+	// The enum & switch the registry replaced, casting by hand
+	void dispatch_switch(EventQueue::Iterator& event_it, TestHandler& handler)
+	{
+		for (; event_it.is_valid(); event_it.advance())
+		{
+			switch (event_it.get_header().event_id)
+			{
+			case TestEvents::get_event_id<FenceEvent>():
+				handler.handle_event(*event_it.get_event<FenceEvent>());
+				break;
+			case TestEvents::get_event_id<PauseEvent>():
+				handler.handle_event(*event_it.get_event<PauseEvent>());
+				break;
+			case TestEvents::get_event_id<FullscreenEvent>():
+				handler.handle_event(*event_it.get_event<FullscreenEvent>());
+				break;
+			case TestEvents::get_event_id<ToggleEvent>():
+				handler.handle_event(*event_it.get_event<ToggleEvent>());
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	// Event types at random, changing every run_length events
+	void write_test_events(EventQueue& queue, uint32_t event_count, uint32_t run_length)
+	{
+		Random random(59);
+
+		uint32_t event_type = 0;
+		for (uint32_t current_event = 0; current_event < event_count; ++current_event)
+		{
+			if ((current_event % run_length) == 0)
+			{
+				event_type = random.next_uint32(TestEvents::c_event_count);
+			}
+
+			switch (event_type)
+			{
+			case 0:
+				TestEvents::write_event(queue, FenceEvent{ current_event });
+				break;
+			case 1:
+				TestEvents::write_event(queue, PauseEvent{ (current_event & 1) != 0 });
+				break;
+			case 2:
+				TestEvents::write_event(queue, FullscreenEvent{ current_event & 1023, 720, (current_event & 2) != 0 });
+				break;
+			default:
+				TestEvents::write_event(queue, ToggleEvent());
+				break;
+			}
+		}
+	}
+}
+
+// Dispatch cost per event of EventRegistry's function table against a switch, events of four types in random order & in runs
+FORWARDPLUSDEMO_BENCHMARK(event_registry_dispatch)
+{
+	const uint32_t event_count = context.select(1000000u, 10000u);
+	const uint32_t repeat_count = context.select(50u, 2u);
+
+	for (uint32_t run_length : { 1u, 16u })
+	{
+		EventQueue queue;
+		write_test_events(queue, event_count, run_length);
+
+		TestHandler registry_handler;
+		const double registry_ms = context.time_ms([&]()
+		{
+			registry_handler = TestHandler();
+			for (uint32_t current_repeat = 0; current_repeat < repeat_count; ++current_repeat)
+			{
+				EventQueue::Iterator event_it = queue.get_iterator();
+				TestEvents::dispatch(event_it, registry_handler);
+			}
+		});
+
+		TestHandler switch_handler;
+		const double switch_ms = context.time_ms([&]()
+		{
+			switch_handler = TestHandler();
+			for (uint32_t current_repeat = 0; current_repeat < repeat_count; ++current_repeat)
+			{
+				EventQueue::Iterator event_it = queue.get_iterator();
+				dispatch_switch(event_it, switch_handler);
+			}
+		});
+
+		const double dispatched_count = static_cast<double>(event_count) * repeat_count;
+		context.report("%u events, %s: registry %.2f ns per event, switch %.2f ns per event%s\n",
+			event_count, (run_length == 1) ? "random order" : "runs of 16",
+			(registry_ms * 1e6) / dispatched_count, (switch_ms * 1e6) / dispatched_count,
+			(registry_handler == switch_handler) ? "" : ", MISMATCH");
+	}
+}
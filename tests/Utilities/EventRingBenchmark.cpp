@@ -0,0 +1,183 @@
+#include <TestFramework.hpp>
+#include <Utilities/OldEventQueue.hpp>
+
+#include <ForwardPlusDemo/Utilities/EventRing.hpp>
+#include <ForwardPlusDemo/Utilities/Random.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+using namespace ForwardPlusDemo::Testing;
+
+namespace
+{
+	constexpr uint32_t c_batch_size = 64;
+
+	// Mix of the demo's small events & larger ones
+	struct SmallEvent
+	{
+		uint64_t value;
+	};
+
+	struct LargeEvent
+	{
+		uint64_t value;
+		uint32_t payload[8];
+	};
+
+	template<typename Queue>
+	void write_test_event(Queue& queue, Random& random, uint64_t value)
+	{
+		if (random.next_uint32(2) == 0)
+		{
+			queue.write_event(0, SmallEvent{ value });
+		}
+		else
+		{
+			queue.write_event(1, LargeEvent{ value, {} });
+		}
+	}
+
+	struct RunResult
+	{
+		size_t peak_size = 0; // Largest queue or ring use
+		bool in_order = true;
+	};
+
+	// The producer writes batches & dispatches them like RenderSystem::dispatch_events in a headless run, the consumer reads whatever is published
+	RunResult run_event_ring(uint64_t event_count)
+	{
+		constexpr uint32_t c_ring_capacity = 64 * 1024;
+
+		EventRing ring(c_ring_capacity);
+		RunResult result;
+
+		std::thread consumer_thread([&ring, &result, event_count]()
+		{
+			uint64_t next_value = 0;
+			while (next_value < event_count)
+			{
+				const uint64_t batch_start = next_value;
+				for (EventRing::Iterator event_it = ring.get_read_iterator(); event_it.is_valid(); event_it.advance())
+				{
+					result.in_order = result.in_order && (event_it.get_event<SmallEvent>()->value == next_value);
+					++next_value;
+				}
+
+				ring.finish_read();
+
+				if (next_value == batch_start)
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+
+		Random random(47);
+		EventQueue queue;
+		for (uint64_t next_value = 0; next_value < event_count;)
+		{
+			const uint64_t batch_end = std::min(next_value + c_batch_size, event_count);
+			for (; next_value < batch_end; ++next_value)
+			{
+				write_test_event(queue, random, next_value);
+			}
+
+			EventQueue::Iterator event_it = queue.get_iterator();
+			while (!ring.try_write_partial(event_it))
+			{
+				ring.wait_for_space();
+			}
+
+			queue.clear();
+		}
+
+		consumer_thread.join();
+
+		result.peak_size = ring.get_high_water_mark();
+		return result;
+	}
+
+	RunResult run_double_buffer(uint64_t event_count)
+	{
+		Old::EventDoubleBuffer double_buffer;
+		RunResult result;
+
+		std::thread consumer_thread([&double_buffer, &result, event_count]()
+		{
+			uint64_t next_value = 0;
+			while (next_value < event_count)
+			{
+				Old::EventQueue* read_queue = double_buffer.get_read_queue();
+				if (read_queue == nullptr)
+				{
+					std::this_thread::yield();
+					continue;
+				}
+
+				for (Old::EventQueue::Iterator event_it(*read_queue); event_it.is_valid(); event_it.advance())
+				{
+					// Unaligned in the old queue
+					SmallEvent event;
+					std::memcpy(&event, event_it.get_event_data(), sizeof(SmallEvent));
+					result.in_order = result.in_order && (event.value == next_value);
+					++next_value;
+				}
+
+				double_buffer.finish_read();
+			}
+		});
+
+		Random random(47);
+		for (uint64_t next_value = 0; next_value < event_count;)
+		{
+			Old::EventQueue* write_queue = double_buffer.get_write_queue();
+
+			const uint64_t batch_end = std::min(next_value + c_batch_size, event_count);
+			for (; next_value < batch_end; ++next_value)
+			{
+				write_test_event(*write_queue, random, next_value);
+			}
+
+			result.peak_size = std::max(result.peak_size, write_queue->get_size());
+			double_buffer.dispatch_write();
+		}
+
+		// The last events go out once the reader is done with the previous ones
+		while (!double_buffer.get_write_queue()->is_empty())
+		{
+			double_buffer.dispatch_write();
+			std::this_thread::yield();
+		}
+
+		consumer_thread.join();
+
+		return result;
+	}
+}
+
+// Producer to consumer thread throughput of mixed 8 & 40 byte events, and the most memory either side holds on to
+FORWARDPLUSDEMO_BENCHMARK(event_ring_throughput)
+{
+	const uint64_t event_count = context.select(20000000ull, 200000ull);
+
+	RunResult ring_result;
+	const double ring_ms = context.time_ms([&]()
+	{
+		ring_result = run_event_ring(event_count);
+	});
+
+	RunResult double_buffer_result;
+	const double double_buffer_ms = context.time_ms([&]()
+	{
+		double_buffer_result = run_double_buffer(event_count);
+	});
+
+	context.report("%llu events, EventRing: %.1f M events/s, %zu bytes at most%s\n",
+		static_cast<unsigned long long>(event_count), (event_count / ring_ms) * 1e-3, ring_result.peak_size, ring_result.in_order ? "" : ", OUT OF ORDER");
+	context.report("%llu events, old EventDoubleBuffer: %.1f M events/s, write queue up to %zu bytes%s\n",
+		static_cast<unsigned long long>(event_count), (event_count / double_buffer_ms) * 1e-3, double_buffer_result.peak_size, double_buffer_result.in_order ? "" : ", OUT OF ORDER");
+}
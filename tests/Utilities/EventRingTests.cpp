@@ -0,0 +1,281 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Utilities/EventRing.hpp>
+#include <ForwardPlusDemo/Utilities/Random.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	enum TestEventId : uint32_t
+	{
+		SMALL_EVENT,
+		LARGE_EVENT,
+		ALIGNED_EVENT,
+	};
+
+	// 32 byte records in the ring
+	struct SmallEvent
+	{
+		uint32_t value;
+	};
+
+	// 64 byte records in the ring
+	struct LargeEvent
+	{
+		uint32_t value;
+		uint32_t payload[9];
+	};
+
+	// 64 byte aligned in the queue, moved to the ring's 16 byte alignment
+	struct alignas(64) AlignedEvent
+	{
+		float values[4];
+	};
+
+	LargeEvent make_large_event(uint32_t value)
+	{
+		LargeEvent event{ value, {} };
+		for (uint32_t current_index = 0; current_index < 9; ++current_index)
+		{
+			event.payload[current_index] = value * 31 + current_index;
+		}
+
+		return event;
+	}
+
+	bool is_large_event_intact(const LargeEvent& event)
+	{
+		const LargeEvent expected_event = make_large_event(event.value);
+		return std::memcmp(&event, &expected_event, sizeof(LargeEvent)) == 0;
+	}
+
+	// Values of the small & large events published so far, releases them
+	std::vector<uint32_t> read_values(EventRing& ring)
+	{
+		std::vector<uint32_t> values;
+		for (EventRing::Iterator event_it = ring.get_read_iterator(); event_it.is_valid(); event_it.advance())
+		{
+			const EventRing::Header& header = event_it.get_header();
+			FORWARDPLUSDEMO_CHECK(header.data_offset == EventRing::c_event_alignment);
+			FORWARDPLUSDEMO_CHECK((reinterpret_cast<uintptr_t>(event_it.get_event_data()) % EventRing::c_event_alignment) == 0);
+
+			if (header.event_id == SMALL_EVENT)
+			{
+				values.push_back(event_it.get_event<SmallEvent>()->value);
+			}
+			else if (header.event_id == LARGE_EVENT)
+			{
+				FORWARDPLUSDEMO_CHECK(is_large_event_intact(*event_it.get_event<LargeEvent>()));
+				values.push_back(event_it.get_event<LargeEvent>()->value);
+			}
+		}
+
+		ring.finish_read();
+		return values;
+	}
+
+	void write_small_events(EventQueue& queue, uint32_t first_value, uint32_t count)
+	{
+		for (uint32_t current_value = first_value; current_value < (first_value + count); ++current_value)
+		{
+			queue.write_event(SMALL_EVENT, SmallEvent{ current_value });
+		}
+	}
+}
+
+FORWARDPLUSDEMO_TEST(event_ring, capacity_rounds_up)
+{
+	FORWARDPLUSDEMO_CHECK(EventRing(1000).get_capacity() == 1024);
+	FORWARDPLUSDEMO_CHECK(EventRing(4096).get_capacity() == 4096);
+
+	// At least two records
+	FORWARDPLUSDEMO_CHECK(EventRing(0).get_capacity() == 32);
+}
+
+FORWARDPLUSDEMO_TEST(event_ring, events_in_order)
+{
+	EventRing ring(1024);
+
+	EventQueue queue;
+	queue.write_event(SMALL_EVENT, SmallEvent{ 1 });
+	queue.write_event(ALIGNED_EVENT, AlignedEvent{ { 1.0f, 2.0f, 3.0f, 4.0f } });
+	queue.write_event(LARGE_EVENT, make_large_event(2));
+	queue.write_event(SMALL_EVENT, SmallEvent{ 3 });
+	FORWARDPLUSDEMO_CHECK(ring.try_write(queue));
+
+	uint32_t event_count = 0;
+	for (EventRing::Iterator event_it = ring.get_read_iterator(); event_it.is_valid(); event_it.advance())
+	{
+		if (event_it.get_header().event_id == ALIGNED_EVENT)
+		{
+			FORWARDPLUSDEMO_CHECK(event_count == 1);
+			FORWARDPLUSDEMO_CHECK(event_it.get_header().data_size == sizeof(AlignedEvent));
+			FORWARDPLUSDEMO_CHECK(event_it.get_event<float>()[3] == 4.0f);
+		}
+
+		++event_count;
+	}
+
+	FORWARDPLUSDEMO_CHECK(event_count == 4);
+
+	// Not released yet, so reading again starts over at the same events
+	FORWARDPLUSDEMO_CHECK(read_values(ring) == std::vector<uint32_t>({ 1, 2, 3 }));
+	FORWARDPLUSDEMO_CHECK(!ring.get_read_iterator().is_valid());
+
+	// An empty queue always fits
+	FORWARDPLUSDEMO_CHECK(ring.try_write(EventQueue()));
+	FORWARDPLUSDEMO_CHECK(ring.get_high_water_mark() == 32 + 80 + 64 + 32);
+}
+
+FORWARDPLUSDEMO_TEST(event_ring, all_or_nothing_when_full)
+{
+	EventRing ring(256);
+
+	EventQueue queue;
+	write_small_events(queue, 0, 8);
+	FORWARDPLUSDEMO_CHECK(ring.try_write(queue));
+	FORWARDPLUSDEMO_CHECK(ring.get_high_water_mark() == 256);
+
+	EventQueue next_queue;
+	write_small_events(next_queue, 8, 1);
+	FORWARDPLUSDEMO_CHECK(ring.try_write(next_queue) == false);
+	FORWARDPLUSDEMO_CHECK(ring.get_full_count() == 1);
+
+	// The failed write published nothing, the consumer only sees the first queue
+	FORWARDPLUSDEMO_CHECK(read_values(ring) == std::vector<uint32_t>({ 0, 1, 2, 3, 4, 5, 6, 7 }));
+
+	FORWARDPLUSDEMO_CHECK(ring.try_write(next_queue));
+	FORWARDPLUSDEMO_CHECK(read_values(ring) == std::vector<uint32_t>({ 8 }));
+}
+
+FORWARDPLUSDEMO_TEST(event_ring, wraps_with_padding)
+{
+	EventRing ring(256);
+
+	// 32 bytes left before the end
+	EventQueue queue;
+	write_small_events(queue, 0, 7);
+	FORWARDPLUSDEMO_CHECK(ring.try_write(queue));
+	FORWARDPLUSDEMO_CHECK(read_values(ring).size() == 7);
+
+	// The large event doesn't fit the 32 bytes, it starts over at zero behind a padding record the consumer never sees
+	queue.clear();
+	queue.write_event(LARGE_EVENT, make_large_event(7));
+	FORWARDPLUSDEMO_CHECK(ring.try_write(queue));
+	FORWARDPLUSDEMO_CHECK(ring.get_high_water_mark() == 224);
+
+	// The padding counts as used until the consumer is past it, 160 bytes are left
+	queue.clear();
+	write_small_events(queue, 8, 6);
+	FORWARDPLUSDEMO_CHECK(ring.try_write(queue) == false);
+
+	queue.clear();
+	write_small_events(queue, 8, 5);
+	FORWARDPLUSDEMO_CHECK(ring.try_write(queue));
+
+	FORWARDPLUSDEMO_CHECK(read_values(ring) == std::vector<uint32_t>({ 7, 8, 9, 10, 11, 12 }));
+}
+
+FORWARDPLUSDEMO_TEST(event_ring, partial_writes_keep_order)
+{
+	EventRing ring(256);
+
+	// 640 bytes of events, more than the whole ring
+	EventQueue queue;
+	write_small_events(queue, 0, 20);
+	FORWARDPLUSDEMO_CHECK(ring.try_write(queue) == false);
+
+	EventQueue::Iterator event_it = queue.get_iterator();
+	FORWARDPLUSDEMO_CHECK(ring.try_write_partial(event_it) == false);
+	FORWARDPLUSDEMO_CHECK(event_it.is_valid() && (event_it.get_event<SmallEvent>()->value == 8));
+
+	// Without the consumer nothing more fits, the iterator stays put
+	FORWARDPLUSDEMO_CHECK(ring.try_write_partial(event_it) == false);
+	FORWARDPLUSDEMO_CHECK(event_it.get_event<SmallEvent>()->value == 8);
+
+	std::vector<uint32_t> values = read_values(ring);
+	while (!ring.try_write_partial(event_it))
+	{
+		const std::vector<uint32_t> next_values = read_values(ring);
+		values.insert(values.end(), next_values.begin(), next_values.end());
+	}
+
+	const std::vector<uint32_t> last_values = read_values(ring);
+	values.insert(values.end(), last_values.begin(), last_values.end());
+	FORWARDPLUSDEMO_CHECK(!event_it.is_valid());
+
+	FORWARDPLUSDEMO_CHECK(values.size() == 20);
+	for (uint32_t current_value = 0; current_value < values.size(); ++current_value)
+	{
+		FORWARDPLUSDEMO_CHECK(values[current_value] == current_value);
+	}
+}
+
+// Producer & consumer threads, batches of random size (some larger than the ring) go through in pieces like RenderSystem::dispatch_events
+FORWARDPLUSDEMO_TEST(event_ring, threads_hand_over_in_order)
+{
+	constexpr uint32_t c_event_count = 200000;
+
+	EventRing ring(1024);
+
+	std::thread consumer_thread([&ring]()
+	{
+		uint32_t next_value = 0;
+		bool in_order = true;
+		while (next_value < c_event_count)
+		{
+			const std::vector<uint32_t> values = read_values(ring);
+			for (uint32_t current_value : values)
+			{
+				in_order = in_order && (current_value == next_value);
+				++next_value;
+			}
+
+			if (values.empty())
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		FORWARDPLUSDEMO_CHECK(in_order);
+	});
+
+	Random random(43);
+	EventQueue queue;
+
+	uint32_t next_value = 0;
+	while (next_value < c_event_count)
+	{
+		const uint32_t batch_size = std::min(1 + random.next_uint32(64), c_event_count - next_value);
+		for (uint32_t current_event = 0; current_event < batch_size; ++current_event, ++next_value)
+		{
+			if (random.next_uint32(4) == 0)
+			{
+				queue.write_event(LARGE_EVENT, make_large_event(next_value));
+			}
+			else
+			{
+				queue.write_event(SMALL_EVENT, SmallEvent{ next_value });
+			}
+		}
+
+		EventQueue::Iterator event_it = queue.get_iterator();
+		while (!ring.try_write_partial(event_it))
+		{
+			ring.wait_for_space();
+		}
+
+		queue.clear();
+	}
+
+	consumer_thread.join();
+
+	FORWARDPLUSDEMO_CHECK(ring.get_high_water_mark() <= ring.get_capacity());
+	FORWARDPLUSDEMO_CHECK(ring.get_full_count() > 0);
+}
@@ -0,0 +1,71 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Utilities/Fence.hpp>
+
+#include <thread>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	void count_call(void* data, uint64_t /*value*/)
+	{
+		++*static_cast<uint64_t*>(data);
+	}
+}
+
+// Cost of a signal on its own and with a callback to run, and how long a wait takes to see a signal from another thread
+FORWARDPLUSDEMO_BENCHMARK(fence_signal)
+{
+	const uint64_t signal_count = context.select(10000000ull, 100000ull);
+
+	const double signal_ms = context.time_ms([&]()
+	{
+		Fence fence;
+		for (uint64_t current_value = 1; current_value <= signal_count; ++current_value)
+		{
+			fence.signal(current_value);
+		}
+	});
+
+	uint64_t call_count = 0;
+	const double callback_ms = context.time_ms([&]()
+	{
+		Fence fence;
+		for (uint64_t current_value = 1; current_value <= signal_count; ++current_value)
+		{
+			fence.add_completion_callback(current_value, count_call, &call_count);
+			fence.signal(current_value);
+		}
+	});
+
+	context.report("signal: %.1f ns, add_completion_callback & signal: %.1f ns", (signal_ms * 1e6) / signal_count, (callback_ms * 1e6) / signal_count);
+
+	// Two threads taking turns, each waits for the other's signal
+	const uint64_t round_trip_count = context.select(100000ull, 2000ull);
+
+	const double round_trip_ms = context.time_ms([&]()
+	{
+		Fence ping;
+		Fence pong;
+
+		std::thread pong_thread([&]()
+		{
+			for (uint64_t current_value = 1; current_value <= round_trip_count; ++current_value)
+			{
+				ping.wait_until(current_value);
+				pong.signal(current_value);
+			}
+		});
+
+		for (uint64_t current_value = 1; current_value <= round_trip_count; ++current_value)
+		{
+			ping.signal(current_value);
+			pong.wait_until(current_value);
+		}
+
+		pong_thread.join();
+	});
+
+	context.report("wait_until round trip between two threads: %.2f us", (round_trip_ms * 1e3) / round_trip_count);
+}
@@ -0,0 +1,146 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Utilities/Fence.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	void record_value(void* data, uint64_t value)
+	{
+		static_cast<std::vector<uint64_t>*>(data)->push_back(value);
+	}
+
+	void count_call(void* data, uint64_t /*value*/)
+	{
+		static_cast<std::atomic<uint64_t>*>(data)->fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+FORWARDPLUSDEMO_TEST(fence, values_only_increase)
+{
+	Fence fence;
+	FORWARDPLUSDEMO_CHECK(fence.get_value() == 0);
+	FORWARDPLUSDEMO_CHECK(fence.is_completed(0) && !fence.is_completed(1));
+
+	fence.signal(5);
+	FORWARDPLUSDEMO_CHECK(fence.get_value() == 5);
+
+	// Older values are ignored
+	fence.signal(3);
+	FORWARDPLUSDEMO_CHECK(fence.get_value() == 5);
+	FORWARDPLUSDEMO_CHECK(fence.is_completed(5) && !fence.is_completed(6));
+
+	// Reached values don't block
+	fence.wait_until(4);
+	FORWARDPLUSDEMO_CHECK(Fence(7).is_completed(7));
+}
+
+FORWARDPLUSDEMO_TEST(fence, timed_waits)
+{
+	Fence fence;
+
+	const Clock::time_point start_time = Clock::now();
+	FORWARDPLUSDEMO_CHECK(fence.wait_until_for(1, std::chrono::milliseconds(20)) == false);
+	FORWARDPLUSDEMO_CHECK((Clock::now() - start_time) >= std::chrono::milliseconds(20));
+
+	fence.signal(1);
+	FORWARDPLUSDEMO_CHECK(fence.wait_until_for(1, Clock::duration::zero()));
+
+	// Signaled from another thread well before the timeout
+	std::thread signal_thread([&fence]()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		fence.signal(2);
+	});
+
+	FORWARDPLUSDEMO_CHECK(fence.wait_until_for(2, std::chrono::seconds(10)));
+	signal_thread.join();
+}
+
+FORWARDPLUSDEMO_TEST(fence, callbacks_in_value_order)
+{
+	Fence fence;
+	std::vector<uint64_t> values;
+
+	for (uint64_t current_value : { 3, 1, 5, 2, 3 })
+	{
+		fence.add_completion_callback(current_value, record_value, &values);
+	}
+
+	FORWARDPLUSDEMO_CHECK(values.empty());
+
+	fence.signal(2);
+	FORWARDPLUSDEMO_CHECK(values == std::vector<uint64_t>({ 1, 2 }));
+
+	// Already reached, runs right away
+	fence.add_completion_callback(2, record_value, &values);
+	FORWARDPLUSDEMO_CHECK(values == std::vector<uint64_t>({ 1, 2, 2 }));
+
+	// Skipping values completes everything up to the new one, each callback gets the value it was added for
+	fence.signal(10);
+	FORWARDPLUSDEMO_CHECK(values == std::vector<uint64_t>({ 1, 2, 2, 3, 3, 5 }));
+
+	fence.signal(20);
+	FORWARDPLUSDEMO_CHECK(values.size() == 6);
+}
+
+// One thread signals every value like the render thread's frames, others wait, time out & add callbacks meanwhile
+FORWARDPLUSDEMO_TEST(fence, waiters_across_threads)
+{
+	constexpr uint64_t c_last_value = 200000;
+	constexpr uint64_t c_callback_count = 20000;
+
+	Fence fence;
+	std::atomic<uint64_t> callback_count = 0;
+
+	std::thread waiting_thread([&fence]()
+	{
+		for (uint64_t current_value = 1; current_value <= c_last_value; current_value += 997)
+		{
+			fence.wait_until(current_value);
+			FORWARDPLUSDEMO_CHECK(fence.is_completed(current_value));
+		}
+	});
+
+	std::thread timed_thread([&fence]()
+	{
+		uint64_t next_value = 1;
+		while (next_value <= c_last_value)
+		{
+			if (fence.wait_until_for(next_value, std::chrono::microseconds(50)))
+			{
+				FORWARDPLUSDEMO_CHECK(fence.is_completed(next_value));
+				next_value += 1009;
+			}
+		}
+	});
+
+	std::thread callback_thread([&fence, &callback_count]()
+	{
+		for (uint64_t current_callback = 0; current_callback < c_callback_count; ++current_callback)
+		{
+			fence.add_completion_callback(1 + (current_callback * 7919) % c_last_value, count_call, &callback_count);
+		}
+	});
+
+	for (uint64_t current_value = 1; current_value <= c_last_value; ++current_value)
+	{
+		fence.signal(current_value);
+	}
+
+	waiting_thread.join();
+	timed_thread.join();
+	callback_thread.join();
+
+	// Callbacks added after their value was reached ran on the adding thread, none were lost or ran twice
+	FORWARDPLUSDEMO_CHECK(callback_count.load() == c_callback_count);
+	FORWARDPLUSDEMO_CHECK(fence.get_value() == c_last_value);
+}
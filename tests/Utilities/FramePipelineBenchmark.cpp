@@ -0,0 +1,139 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Utilities/FramePipeline.hpp>
+#include <ForwardPlusDemo/Utilities/JobSystem.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+	using Milliseconds = std::chrono::duration<double, std::milli>;
+
+	// Stand-in stages: either busy on the CPU, or blocked like a present or a GPU wait
+	struct StageCosts
+	{
+		Clock::duration prepare_time;
+		Clock::duration record_time;
+		bool blocking;
+	};
+
+	struct PipelineRun
+	{
+		StageCosts costs;
+
+		// Input time of the frame in each slot, taken when it is snapshotted like RenderSystem's camera
+		std::vector<Clock::time_point> input_times;
+
+		std::vector<Clock::time_point> frame_ends;
+		std::vector<double> latencies; // Input to the end of recording, in milliseconds
+	};
+
+	// A fixed amount of work, so CPU bound stages only overlap when there are cores to run them on
+	float run_work(uint64_t iteration_count)
+	{
+		volatile float value = 1.0f;
+		for (uint64_t current_iteration = 0; current_iteration < iteration_count; ++current_iteration)
+		{
+			value = value * 0.999f + 1.0f;
+		}
+
+		return value;
+	}
+
+	// Work iterations per millisecond on one thread, measured once
+	double get_iterations_per_ms()
+	{
+		static const double c_iterations_per_ms = []()
+		{
+			constexpr uint64_t c_iteration_count = 10000000;
+
+			const Clock::time_point start_time = Clock::now();
+			run_work(c_iteration_count);
+			return c_iteration_count / Milliseconds(Clock::now() - start_time).count();
+		}();
+
+		return c_iterations_per_ms;
+	}
+
+	void run_stage(Clock::duration stage_time, bool blocking)
+	{
+		if (blocking)
+		{
+			std::this_thread::sleep_for(stage_time);
+			return;
+		}
+
+		run_work(static_cast<uint64_t>(Milliseconds(stage_time).count() * get_iterations_per_ms()));
+	}
+
+	void prepare_frame(void* data, uint32_t /*slot_index*/)
+	{
+		const PipelineRun& run = *static_cast<const PipelineRun*>(data);
+		run_stage(run.costs.prepare_time, run.costs.blocking);
+	}
+
+	void record_frame(void* data, uint32_t slot_index)
+	{
+		PipelineRun& run = *static_cast<PipelineRun*>(data);
+		run_stage(run.costs.record_time, run.costs.blocking);
+
+		const Clock::time_point end_time = Clock::now();
+		run.frame_ends.push_back(end_time);
+		run.latencies.push_back(Milliseconds(end_time - run.input_times[slot_index]).count());
+	}
+}
+
+// Frame time against input to present latency at pipeline depths 1 to 3, with stand-in prepare & record stages
+FORWARDPLUSDEMO_BENCHMARK(frame_pipeline_depth)
+{
+	const uint32_t frame_count = context.select(200u, 10u);
+
+	const StageCosts stage_costs[] =
+	{
+		{ std::chrono::microseconds(4000), std::chrono::microseconds(6000), true },
+		{ std::chrono::microseconds(4000), std::chrono::microseconds(6000), false },
+	};
+
+	// Calibrated up front, not in the first measured frame
+	get_iterations_per_ms();
+
+	JobSystem job_system(2);
+	context.report("%u hardware threads\n", std::thread::hardware_concurrency());
+
+	for (const StageCosts& current_costs : stage_costs)
+	{
+		for (uint32_t depth = 1; depth <= 3; ++depth)
+		{
+			FramePipeline pipeline(depth);
+
+			PipelineRun run;
+			run.costs = current_costs;
+			run.input_times.resize(depth);
+
+			for (uint32_t current_frame = 0; current_frame < frame_count; ++current_frame)
+			{
+				run.input_times[pipeline.get_prepare_slot()] = Clock::now();
+				pipeline.run_frame(job_system, prepare_frame, record_frame, &run);
+			}
+
+			const double frame_time = Milliseconds(run.frame_ends.back() - run.frame_ends.front()).count() / (run.frame_ends.size() - 1);
+
+			double total_latency = 0.0;
+			for (double current_latency : run.latencies)
+			{
+				total_latency += current_latency;
+			}
+
+			context.report("%s prepare %.0f ms & record %.0f ms, depth %u: %.2f ms per frame (%.1f fps), latency %.2f ms average, %.2f ms max\n",
+				current_costs.blocking ? "blocking" : "CPU bound",
+				Milliseconds(current_costs.prepare_time).count(), Milliseconds(current_costs.record_time).count(), depth,
+				frame_time, 1000.0 / frame_time, total_latency / run.latencies.size(), *std::max_element(run.latencies.begin(), run.latencies.end()));
+		}
+	}
+}
@@ -0,0 +1,183 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Utilities/FramePipeline.hpp>
+#include <ForwardPlusDemo/Utilities/JobSystem.hpp>
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	struct StageLog
+	{
+		const FramePipeline* pipeline = nullptr;
+		std::vector<uint32_t> prepared_slots;
+		std::vector<uint32_t> recorded_slots;
+
+		// Frames prepared when each record began
+		std::vector<uint64_t> prepared_counts;
+	};
+
+	void log_prepare(void* data, uint32_t slot_index)
+	{
+		static_cast<StageLog*>(data)->prepared_slots.push_back(slot_index);
+	}
+
+	void log_record(void* data, uint32_t slot_index)
+	{
+		StageLog& log = *static_cast<StageLog*>(data);
+		log.recorded_slots.push_back(slot_index);
+		log.prepared_counts.push_back(log.pipeline->get_prepared_frame_count());
+	}
+}
+
+FORWARDPLUSDEMO_TEST(frame_pipeline, depth_one_runs_back_to_back)
+{
+	JobSystem job_system(2);
+	FramePipeline pipeline(1);
+
+	StageLog log;
+	log.pipeline = &pipeline;
+	for (uint32_t current_frame = 0; current_frame < 5; ++current_frame)
+	{
+		FORWARDPLUSDEMO_CHECK(pipeline.get_prepare_slot() == 0);
+		pipeline.run_frame(job_system, log_prepare, log_record, &log);
+
+		// Recorded right after its own preparation
+		FORWARDPLUSDEMO_CHECK(pipeline.get_prepared_frame_count() == current_frame + 1);
+		FORWARDPLUSDEMO_CHECK(pipeline.get_recorded_frame_count() == current_frame + 1);
+		FORWARDPLUSDEMO_CHECK(log.prepared_counts.back() == current_frame + 1);
+	}
+}
+
+// Frames come out in order, depth - 1 frames behind the one being prepared, with the same slot they were prepared in
+FORWARDPLUSDEMO_TEST(frame_pipeline, records_trail_by_depth)
+{
+	JobSystem job_system(1);
+
+	for (uint32_t depth : { 2u, 3u, 4u })
+	{
+		FramePipeline pipeline(depth);
+
+		StageLog log;
+		log.pipeline = &pipeline;
+		for (uint32_t current_frame = 0; current_frame < 20; ++current_frame)
+		{
+			FORWARDPLUSDEMO_CHECK(pipeline.get_prepare_slot() == (current_frame % depth));
+			pipeline.run_frame(job_system, log_prepare, log_record, &log);
+
+			const uint64_t expected_recorded_count = (current_frame >= (depth - 1)) ? (current_frame - (depth - 1) + 1) : 0;
+			FORWARDPLUSDEMO_CHECK(pipeline.get_recorded_frame_count() == expected_recorded_count);
+		}
+
+		FORWARDPLUSDEMO_CHECK(log.prepared_slots.size() == 20);
+		FORWARDPLUSDEMO_CHECK(log.recorded_slots.size() == (20 - (depth - 1)));
+		for (uint32_t current_frame = 0; current_frame < log.recorded_slots.size(); ++current_frame)
+		{
+			FORWARDPLUSDEMO_CHECK(log.prepared_slots[current_frame] == (current_frame % depth));
+			FORWARDPLUSDEMO_CHECK(log.recorded_slots[current_frame] == (current_frame % depth));
+
+			// Recording starts before the newest frame's preparation is counted
+			FORWARDPLUSDEMO_CHECK(log.prepared_counts[current_frame] == (current_frame + depth - 1));
+		}
+	}
+}
+
+FORWARDPLUSDEMO_TEST(frame_pipeline, drop_prepared_frames)
+{
+	JobSystem job_system(1);
+	FramePipeline pipeline(3);
+
+	StageLog log;
+	log.pipeline = &pipeline;
+	pipeline.run_frame(job_system, log_prepare, log_record, &log);
+	pipeline.run_frame(job_system, log_prepare, log_record, &log);
+	FORWARDPLUSDEMO_CHECK(pipeline.get_recorded_frame_count() == 0);
+
+	pipeline.drop_prepared_frames();
+	FORWARDPLUSDEMO_CHECK(pipeline.get_recorded_frame_count() == 2);
+
+	// The pipeline fills up again before the next recording, which uses the first slot prepared after the drop
+	pipeline.run_frame(job_system, log_prepare, log_record, &log);
+	pipeline.run_frame(job_system, log_prepare, log_record, &log);
+	FORWARDPLUSDEMO_CHECK(log.recorded_slots.empty());
+
+	pipeline.run_frame(job_system, log_prepare, log_record, &log);
+	FORWARDPLUSDEMO_CHECK(log.recorded_slots == std::vector<uint32_t>({ 2 }));
+
+	pipeline.reset(2);
+	FORWARDPLUSDEMO_CHECK((pipeline.get_depth() == 2) && (pipeline.get_prepare_slot() == 0));
+	FORWARDPLUSDEMO_CHECK((pipeline.get_prepared_frame_count() == 0) && (pipeline.get_recorded_frame_count() == 0));
+}
+
+// With workers the stages really overlap, a slot must never be recorded while it is being prepared
+FORWARDPLUSDEMO_TEST(frame_pipeline, stages_never_share_a_slot)
+{
+	struct SlotState
+	{
+		std::array<std::atomic<uint32_t>, 4> preparing = {};
+		std::atomic<uint32_t> overlap_count = 0;
+		std::atomic<uint32_t> shared_slot_count = 0;
+		std::atomic<bool> recording = false;
+	};
+
+	JobSystem job_system(4);
+
+	for (uint32_t depth = 1; depth <= 4; ++depth)
+	{
+		FramePipeline pipeline(depth);
+		SlotState state;
+
+		auto prepare = [](void* data, uint32_t slot_index)
+		{
+			SlotState& slot_state = *static_cast<SlotState*>(data);
+			slot_state.preparing[slot_index].store(1, std::memory_order_release);
+
+			// Long enough for the recording to start meanwhile
+			for (uint32_t current_yield = 0; current_yield < 20; ++current_yield)
+			{
+				if (slot_state.recording.load(std::memory_order_acquire))
+				{
+					slot_state.overlap_count.fetch_add(1, std::memory_order_relaxed);
+					break;
+				}
+
+				std::this_thread::yield();
+			}
+
+			slot_state.preparing[slot_index].store(0, std::memory_order_release);
+		};
+
+		auto record = [](void* data, uint32_t slot_index)
+		{
+			SlotState& slot_state = *static_cast<SlotState*>(data);
+			slot_state.recording.store(true, std::memory_order_release);
+
+			for (uint32_t current_yield = 0; current_yield < 20; ++current_yield)
+			{
+				if (slot_state.preparing[slot_index].load(std::memory_order_acquire) != 0)
+				{
+					slot_state.shared_slot_count.fetch_add(1, std::memory_order_relaxed);
+				}
+
+				std::this_thread::yield();
+			}
+
+			slot_state.recording.store(false, std::memory_order_release);
+		};
+
+		for (uint32_t current_frame = 0; current_frame < 200; ++current_frame)
+		{
+			pipeline.run_frame(job_system, prepare, record, &state);
+		}
+
+		FORWARDPLUSDEMO_CHECK(state.shared_slot_count == 0);
+
+		// Back to back at depth one, overlapped from two on
+		FORWARDPLUSDEMO_CHECK((depth == 1) == (state.overlap_count == 0));
+	}
+}
@@ -0,0 +1,73 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Utilities/FrameScheduler.hpp>
+
+#include <chrono>
+#include <thread>
+
+using namespace ForwardPlusDemo;
+using namespace ForwardPlusDemo::Testing;
+
+namespace
+{
+	using Clock = FrameScheduler::Clock;
+
+	// Busy for a while like a frame's simulation & rendering
+	void run_frame_work(Clock::duration work_time)
+	{
+		const Clock::time_point end_time = Clock::now() + work_time;
+		while (Clock::now() < end_time)
+		{
+		}
+	}
+
+	void report_intervals(const BenchmarkContext& context, const char* name, double frame_rate, const FrameTimeStatistics& statistics)
+	{
+		context.report("%.0f Hz, %s: interval %.3f ms (%.3f to %.3f), jitter %.3f ms, p99 %.3f ms",
+			frame_rate, name, statistics.average_interval, statistics.min_interval, statistics.max_interval, statistics.interval_deviation, statistics.p99_interval);
+	}
+}
+
+// Real waits on this machine's timer: FrameScheduler's sleep then spin against sleeping straight to the deadline
+FORWARDPLUSDEMO_BENCHMARK(frame_scheduler_pacing)
+{
+	const double run_seconds = context.select(3.0, 0.25);
+	const Clock::duration work_time = std::chrono::microseconds(2000);
+
+	for (double frame_rate : { 60.0, 120.0, 144.0, 240.0 })
+	{
+		const uint32_t frame_count = static_cast<uint32_t>(frame_rate * run_seconds);
+
+		FrameScheduler scheduler(frame_rate, 60.0);
+		scheduler.reset(Clock::now());
+		for (uint32_t current_frame = 0; current_frame <= frame_count; ++current_frame)
+		{
+			scheduler.begin_frame(Clock::now());
+			run_frame_work(work_time);
+			scheduler.wait_for_next_frame();
+		}
+
+		const FrameTimeStatistics statistics = scheduler.get_statistics();
+		report_intervals(context, "FrameScheduler", frame_rate, statistics);
+		context.report("%.0f Hz, FrameScheduler: %llu late, wake delay %.3f ms (max %.3f), per frame %.2f ms asleep & %.2f ms spinning",
+			frame_rate, static_cast<unsigned long long>(statistics.late_frame_count), statistics.average_wake_delay, statistics.max_wake_delay,
+			statistics.sleep_time / frame_count, statistics.spin_time / frame_count);
+
+		// The same deadlines, one sleep_until each, measured by an unlimited scheduler that never waits
+		const Clock::duration frame_interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / frame_rate));
+
+		FrameScheduler measure(0.0, 60.0);
+		Clock::time_point next_frame_time = Clock::now();
+		measure.reset(next_frame_time);
+		for (uint32_t current_frame = 0; current_frame <= frame_count; ++current_frame)
+		{
+			measure.begin_frame(Clock::now());
+			run_frame_work(work_time);
+
+			next_frame_time += frame_interval;
+			std::this_thread::sleep_until(next_frame_time);
+		}
+
+		report_intervals(context, "sleep_until", frame_rate, measure.get_statistics());
+	}
+}
@@ -0,0 +1,165 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Utilities/FrameScheduler.hpp>
+
+#include <chrono>
+#include <cmath>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	using Clock = FrameScheduler::Clock;
+
+	Clock::duration from_seconds(double seconds)
+	{
+		return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+	}
+
+	bool is_near(double value, double expected_value, double tolerance)
+	{
+		return std::abs(value - expected_value) <= tolerance;
+	}
+}
+
+// Frame times are passed in, so the stepping is checked on a synthetic clock
+FORWARDPLUSDEMO_TEST(frame_scheduler, fixed_steps_at_any_frame_rate)
+{
+	for (double frame_rate : { 30.0, 60.0, 144.0, 1000.0 })
+	{
+		FrameScheduler scheduler(frame_rate, 60.0);
+
+		const Clock::time_point start_time = Clock::now();
+		scheduler.reset(start_time);
+
+		uint64_t step_count = 0;
+		const uint32_t frame_count = static_cast<uint32_t>(frame_rate * 10.0);
+		for (uint32_t current_frame = 0; current_frame <= frame_count; ++current_frame)
+		{
+			const FrameTiming timing = scheduler.begin_frame(start_time + from_seconds(current_frame / frame_rate));
+			FORWARDPLUSDEMO_CHECK((timing.interpolation >= 0.0) && (timing.interpolation <= 1.0));
+			step_count += timing.step_count;
+		}
+
+		// Ten seconds at 60 Hz, give or take the step still accumulating
+		FORWARDPLUSDEMO_CHECK((step_count == 599) || (step_count == 600));
+
+		const FrameTimeStatistics statistics = scheduler.get_statistics();
+		FORWARDPLUSDEMO_CHECK(statistics.frame_count == frame_count);
+		FORWARDPLUSDEMO_CHECK(is_near(statistics.average_interval, 1000.0 / frame_rate, 1e-3));
+		FORWARDPLUSDEMO_CHECK(statistics.interval_deviation < 1e-3);
+		FORWARDPLUSDEMO_CHECK((statistics.late_frame_count == 0) && (statistics.dropped_step_count == 0));
+	}
+}
+
+FORWARDPLUSDEMO_TEST(frame_scheduler, long_frames_drop_steps)
+{
+	FrameScheduler scheduler(60.0, 60.0);
+
+	const Clock::time_point start_time = Clock::now();
+	scheduler.reset(start_time);
+
+	// The first frame after a reset has nothing to measure from
+	const FrameTiming first_timing = scheduler.begin_frame(start_time);
+	FORWARDPLUSDEMO_CHECK((first_timing.delta_time == 0.0) && (first_timing.step_count == 0));
+
+	// A two second hitch is simulated as a quarter second, 15 steps of which 8 run
+	const FrameTiming timing = scheduler.begin_frame(start_time + from_seconds(2.0));
+	FORWARDPLUSDEMO_CHECK(is_near(timing.delta_time, 2.0, 1e-9));
+	FORWARDPLUSDEMO_CHECK(timing.step_count == 8);
+	FORWARDPLUSDEMO_CHECK(scheduler.get_statistics().dropped_step_count == 7);
+	FORWARDPLUSDEMO_CHECK(scheduler.get_statistics().late_frame_count == 1);
+}
+
+FORWARDPLUSDEMO_TEST(frame_scheduler, late_frames)
+{
+	FrameScheduler scheduler(100.0, 60.0);
+
+	const Clock::time_point start_time = Clock::now();
+	scheduler.reset(start_time);
+	scheduler.begin_frame(start_time);
+
+	// Due at 10 ms: 4 ms late is fine, 6 ms is over half an interval
+	scheduler.begin_frame(start_time + from_seconds(0.014));
+	FORWARDPLUSDEMO_CHECK(scheduler.get_statistics().late_frame_count == 0);
+
+	scheduler.begin_frame(start_time + from_seconds(0.026));
+	FORWARDPLUSDEMO_CHECK(scheduler.get_statistics().late_frame_count == 1);
+
+	// The schedule kept its deadlines at 30 & 40 ms, so catching up on time isn't late
+	scheduler.begin_frame(start_time + from_seconds(0.030));
+	scheduler.begin_frame(start_time + from_seconds(0.040));
+	FORWARDPLUSDEMO_CHECK(scheduler.get_statistics().late_frame_count == 1);
+
+	// Over a whole interval behind (due at 50 ms), the schedule starts over from 75 ms instead of expecting frames back to back
+	scheduler.begin_frame(start_time + from_seconds(0.075));
+	FORWARDPLUSDEMO_CHECK(scheduler.get_statistics().late_frame_count == 2);
+
+	scheduler.begin_frame(start_time + from_seconds(0.088));
+	FORWARDPLUSDEMO_CHECK(scheduler.get_statistics().late_frame_count == 2);
+
+	// Unlimited frame rate has no deadlines
+	scheduler.set_frame_rate(0.0);
+	scheduler.begin_frame(start_time + from_seconds(1.0));
+	FORWARDPLUSDEMO_CHECK(scheduler.get_statistics().late_frame_count == 2);
+
+	const Clock::time_point wait_start = Clock::now();
+	scheduler.wait_for_next_frame();
+	FORWARDPLUSDEMO_CHECK((Clock::now() - wait_start) < std::chrono::milliseconds(1));
+}
+
+FORWARDPLUSDEMO_TEST(frame_scheduler, interval_statistics)
+{
+	FrameScheduler scheduler(0.0, 60.0);
+
+	const Clock::time_point start_time = Clock::now();
+	scheduler.reset(start_time);
+
+	const double frame_times[] = { 0.0, 0.010, 0.030, 0.060 };
+	for (double current_time : frame_times)
+	{
+		scheduler.begin_frame(start_time + from_seconds(current_time));
+	}
+
+	// Intervals of 10, 20 & 30 ms
+	FrameTimeStatistics statistics = scheduler.get_statistics();
+	FORWARDPLUSDEMO_CHECK(statistics.frame_count == 3);
+	FORWARDPLUSDEMO_CHECK(is_near(statistics.average_interval, 20.0, 1e-6));
+	FORWARDPLUSDEMO_CHECK(is_near(statistics.min_interval, 10.0, 1e-6));
+	FORWARDPLUSDEMO_CHECK(is_near(statistics.max_interval, 30.0, 1e-6));
+	FORWARDPLUSDEMO_CHECK(is_near(statistics.interval_deviation, 10.0, 1e-6));
+	FORWARDPLUSDEMO_CHECK(is_near(statistics.p99_interval, 30.0, 1e-6));
+
+	// Nothing waited yet
+	FORWARDPLUSDEMO_CHECK((statistics.sleep_time == 0.0) && (statistics.spin_time == 0.0) && (statistics.max_wake_delay == 0.0));
+
+	scheduler.reset_statistics();
+	statistics = scheduler.get_statistics();
+	FORWARDPLUSDEMO_CHECK((statistics.frame_count == 0) && (statistics.average_interval == 0.0) && (statistics.p99_interval == 0.0));
+
+	// A reset of the schedule doesn't count the time in between as an interval
+	scheduler.reset(start_time + from_seconds(5.0));
+	scheduler.begin_frame(start_time + from_seconds(5.0));
+	scheduler.begin_frame(start_time + from_seconds(5.005));
+	statistics = scheduler.get_statistics();
+	FORWARDPLUSDEMO_CHECK((statistics.frame_count == 1) && is_near(statistics.max_interval, 5.0, 1e-6));
+}
+
+// The only test on the real clock: waits end at or after the deadline, the loose upper bound only catches a broken schedule
+FORWARDPLUSDEMO_TEST(frame_scheduler, waits_reach_the_deadline)
+{
+	FrameScheduler scheduler(200.0, 60.0);
+	scheduler.reset(Clock::now());
+
+	for (uint32_t current_frame = 0; current_frame < 40; ++current_frame)
+	{
+		scheduler.begin_frame(Clock::now());
+		scheduler.wait_for_next_frame();
+	}
+
+	const FrameTimeStatistics statistics = scheduler.get_statistics();
+	FORWARDPLUSDEMO_CHECK(statistics.frame_count == 39);
+	FORWARDPLUSDEMO_CHECK(statistics.average_interval >= 4.9);
+	FORWARDPLUSDEMO_CHECK(statistics.average_interval < 10.0);
+	FORWARDPLUSDEMO_CHECK(statistics.average_wake_delay >= 0.0);
+}
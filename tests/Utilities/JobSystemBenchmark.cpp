@@ -0,0 +1,105 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Utilities/JobSystem.hpp>
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	// Some math per element, enough that the work dominates the scheduling
+	float get_element_value(uint32_t index)
+	{
+		float value = static_cast<float>(index);
+		for (uint32_t current_step = 0; current_step < 64; ++current_step)
+		{
+			value = std::sqrt(value + 1.0f) * 1.5f;
+		}
+
+		return value;
+	}
+
+	// A stage the old code ran by spawning a thread per range
+	template<typename Function>
+	void spawn_threads_for(uint32_t thread_count, uint32_t count, const Function& function)
+	{
+		std::vector<std::thread> threads;
+		threads.reserve(thread_count);
+
+		const uint32_t range_size = (count + thread_count - 1) / thread_count;
+		for (uint32_t begin = 0; begin < count; begin += range_size)
+		{
+			threads.emplace_back([&function, begin, end = std::min(begin + range_size, count)] { function(begin, end); });
+		}
+
+		for (std::thread& current_thread : threads)
+		{
+			current_thread.join();
+		}
+	}
+}
+
+// parallel_for from 1 to 64 threads: a compute heavy stage (speedup against one thread), and the fixed cost of a tiny stage against spawning threads for it
+FORWARDPLUSDEMO_BENCHMARK(job_system_scaling)
+{
+	const uint32_t element_count = context.select(1u << 20, 1u << 14);
+	const uint32_t stage_count = context.select(1000u, 20u);
+	const uint32_t spawn_stage_count = context.select(100u, 5u);
+
+	const std::vector<uint32_t> thread_counts = context.select(std::vector<uint32_t>{ 1, 2, 4, 8, 16, 32, 64 }, std::vector<uint32_t>{ 1, 2, 4 });
+
+	context.report("%u hardware threads\n", std::thread::hardware_concurrency());
+
+	std::vector<float> values(element_count);
+	double single_thread_ms = 0.0;
+	for (uint32_t thread_count : thread_counts)
+	{
+		JobSystem job_system(thread_count);
+
+		const double heavy_ms = context.time_ms([&]()
+		{
+			job_system.parallel_for(element_count, 256, [&values](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t current_index = begin; current_index < end; ++current_index)
+				{
+					values[current_index] = get_element_value(current_index);
+				}
+			});
+		});
+
+		if (thread_count == 1)
+		{
+			single_thread_ms = heavy_ms;
+		}
+
+		// 64 elements in batches of one, like the per-light or per-tile stages of a small scene
+		std::atomic<uint32_t> touched_count = 0;
+		auto small_stage = [&touched_count](uint32_t begin, uint32_t end)
+		{
+			touched_count.fetch_add(end - begin, std::memory_order_relaxed);
+		};
+
+		const double stage_ms = context.time_ms([&]()
+		{
+			for (uint32_t current_stage = 0; current_stage < stage_count; ++current_stage)
+			{
+				job_system.parallel_for(64, 1, small_stage);
+			}
+		});
+
+		const double spawn_ms = context.time_ms([&]()
+		{
+			for (uint32_t current_stage = 0; current_stage < spawn_stage_count; ++current_stage)
+			{
+				spawn_threads_for(thread_count, 64, small_stage);
+			}
+		});
+
+		context.report("%2u threads: heavy stage %.2f ms (%.2fx), small stage %.1f us, spawning threads for it %.1f us\n",
+			thread_count, heavy_ms, single_thread_ms / heavy_ms, (stage_ms * 1e3) / stage_count, (spawn_ms * 1e3) / spawn_stage_count);
+	}
+}
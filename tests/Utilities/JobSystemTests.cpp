@@ -0,0 +1,207 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Utilities/JobSystem.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	constexpr uint32_t c_thread_counts[] = { 1, 2, 4, 8 };
+
+	// Every index of [0, count) visited exactly once
+	bool covers_once(const std::vector<std::atomic<uint32_t>>& visit_counts)
+	{
+		for (const std::atomic<uint32_t>& current_count : visit_counts)
+		{
+			if (current_count.load(std::memory_order_relaxed) != 1)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+FORWARDPLUSDEMO_TEST(job_system, thread_count)
+{
+	FORWARDPLUSDEMO_CHECK(JobSystem(1).get_thread_count() == 1);
+	FORWARDPLUSDEMO_CHECK(JobSystem(3).get_thread_count() == 3);
+	FORWARDPLUSDEMO_CHECK(JobSystem().get_thread_count() == std::max(std::thread::hardware_concurrency(), 1u));
+}
+
+FORWARDPLUSDEMO_TEST(job_system, parallel_for_covers_range)
+{
+	for (uint32_t thread_count : c_thread_counts)
+	{
+		JobSystem job_system(thread_count);
+
+		for (uint32_t count : { 0u, 1u, 7u, 1000u, 100003u })
+		{
+			std::vector<std::atomic<uint32_t>> visit_counts(count);
+			std::atomic<uint32_t> range_count = 0;
+			job_system.parallel_for(count, 16, [&](uint32_t begin, uint32_t end)
+			{
+				FORWARDPLUSDEMO_CHECK((begin < end) && (end <= count));
+				for (uint32_t current_index = begin; current_index < end; ++current_index)
+				{
+					visit_counts[current_index].fetch_add(1, std::memory_order_relaxed);
+				}
+
+				range_count.fetch_add(1, std::memory_order_relaxed);
+			});
+
+			FORWARDPLUSDEMO_CHECK(covers_once(visit_counts));
+
+			// At most four ranges per thread, none smaller than the minimum batch size
+			FORWARDPLUSDEMO_CHECK(range_count <= std::max(thread_count * 4, 1u));
+			FORWARDPLUSDEMO_CHECK(range_count <= ((count + 15) / 16));
+		}
+	}
+}
+
+FORWARDPLUSDEMO_TEST(job_system, small_counts_stay_on_caller)
+{
+	JobSystem job_system(4);
+
+	const std::thread::id caller_id = std::this_thread::get_id();
+	uint32_t range_count = 0;
+	job_system.parallel_for(100, 100, [&](uint32_t begin, uint32_t end)
+	{
+		FORWARDPLUSDEMO_CHECK((begin == 0) && (end == 100));
+		FORWARDPLUSDEMO_CHECK(std::this_thread::get_id() == caller_id);
+		++range_count;
+	});
+
+	FORWARDPLUSDEMO_CHECK(range_count == 1);
+}
+
+FORWARDPLUSDEMO_TEST(job_system, run_and_wait)
+{
+	for (uint32_t thread_count : c_thread_counts)
+	{
+		JobSystem job_system(thread_count);
+
+		std::vector<std::atomic<uint32_t>> visit_counts(1000);
+		auto visit = [](void* data, uint32_t begin, uint32_t end)
+		{
+			std::vector<std::atomic<uint32_t>>& counts = *static_cast<std::vector<std::atomic<uint32_t>>*>(data);
+			for (uint32_t current_index = begin; current_index < end; ++current_index)
+			{
+				counts[current_index].fetch_add(1, std::memory_order_relaxed);
+			}
+		};
+
+		// Single jobs & batches in one group, the last batch is shorter
+		JobCounter counter;
+		FORWARDPLUSDEMO_CHECK(counter.is_done());
+
+		job_system.run(visit, &visit_counts, 0, 10, counter);
+		job_system.run(visit, &visit_counts, 10, 20, counter);
+		job_system.run_batches([](void* data, uint32_t begin, uint32_t end)
+		{
+			std::vector<std::atomic<uint32_t>>& counts = *static_cast<std::vector<std::atomic<uint32_t>>*>(data);
+			for (uint32_t current_index = begin; current_index < end; ++current_index)
+			{
+				counts[20 + current_index].fetch_add(1, std::memory_order_relaxed);
+			}
+		}, &visit_counts, 980, 64, counter);
+
+		// Nothing to run, the counter is untouched
+		job_system.run_batches(visit, &visit_counts, 0, 64, counter);
+
+		job_system.wait(counter);
+		FORWARDPLUSDEMO_CHECK(counter.is_done());
+		FORWARDPLUSDEMO_CHECK(covers_once(visit_counts));
+	}
+}
+
+// Jobs that submit & wait on jobs of their own, from the workers' deques
+FORWARDPLUSDEMO_TEST(job_system, nested_parallel_for)
+{
+	for (uint32_t thread_count : c_thread_counts)
+	{
+		JobSystem job_system(thread_count);
+
+		std::vector<std::atomic<uint32_t>> visit_counts(64 * 256);
+		job_system.parallel_for(64, 1, [&](uint32_t outer_begin, uint32_t outer_end)
+		{
+			for (uint32_t current_outer = outer_begin; current_outer < outer_end; ++current_outer)
+			{
+				job_system.parallel_for(256, 8, [&](uint32_t begin, uint32_t end)
+				{
+					for (uint32_t current_index = begin; current_index < end; ++current_index)
+					{
+						visit_counts[current_outer * 256 + current_index].fetch_add(1, std::memory_order_relaxed);
+					}
+				});
+			}
+		});
+
+		FORWARDPLUSDEMO_CHECK(covers_once(visit_counts));
+	}
+}
+
+// Waiting on one group returns once it is done, even with another group's jobs still queued or running
+FORWARDPLUSDEMO_TEST(job_system, independent_groups)
+{
+	JobSystem job_system(4);
+
+	std::atomic<bool> release_slow_job = false;
+	std::atomic<uint32_t> fast_count = 0;
+
+	JobCounter slow_counter;
+	job_system.run([](void* data, uint32_t, uint32_t)
+	{
+		const std::atomic<bool>& release = *static_cast<const std::atomic<bool>*>(data);
+		while (!release.load(std::memory_order_acquire))
+		{
+			std::this_thread::yield();
+		}
+	}, &release_slow_job, 0, 1, slow_counter);
+
+	JobCounter fast_counter;
+	job_system.run_batches([](void* data, uint32_t begin, uint32_t end)
+	{
+		static_cast<std::atomic<uint32_t>*>(data)->fetch_add(end - begin, std::memory_order_relaxed);
+	}, &fast_count, 100, 10, fast_counter);
+
+	job_system.wait(fast_counter);
+	FORWARDPLUSDEMO_CHECK(fast_count == 100);
+	FORWARDPLUSDEMO_CHECK(!slow_counter.is_done());
+
+	release_slow_job.store(true, std::memory_order_release);
+	job_system.wait(slow_counter);
+	FORWARDPLUSDEMO_CHECK(slow_counter.is_done());
+}
+
+// Many short stages back to back, the pattern that loses wake ups if parking races with pushing
+FORWARDPLUSDEMO_TEST(job_system, repeated_short_stages)
+{
+	JobSystem job_system(4);
+
+	uint64_t total = 0;
+	for (uint32_t current_stage = 0; current_stage < 2000; ++current_stage)
+	{
+		std::atomic<uint64_t> stage_sum = 0;
+		job_system.parallel_for(64, 1, [&](uint32_t begin, uint32_t end)
+		{
+			uint64_t sum = 0;
+			for (uint32_t current_index = begin; current_index < end; ++current_index)
+			{
+				sum += current_index;
+			}
+
+			stage_sum.fetch_add(sum, std::memory_order_relaxed);
+		});
+
+		total += stage_sum;
+	}
+
+	FORWARDPLUSDEMO_CHECK(total == 2000ull * (63 * 64 / 2));
+}
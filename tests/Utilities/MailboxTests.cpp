@@ -0,0 +1,129 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Utilities/Mailbox.hpp>
+
+#include <atomic>
+#include <thread>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	// Every field holds the same sequence number, a value mixed from two writes shows up as fields that differ
+	struct SequenceValue
+	{
+		std::array<uint64_t, 16> fields;
+
+		static SequenceValue make(uint64_t sequence)
+		{
+			SequenceValue value;
+			value.fields.fill(sequence);
+			return value;
+		}
+
+		bool is_torn() const
+		{
+			for (uint64_t current_field : fields)
+			{
+				if (current_field != fields[0])
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+	};
+}
+
+FORWARDPLUSDEMO_TEST(mailbox, newest_value_wins)
+{
+	Mailbox<uint32_t> mailbox;
+
+	uint32_t value = 0;
+	FORWARDPLUSDEMO_CHECK(mailbox.read(value) == false);
+
+	mailbox.write(1);
+	FORWARDPLUSDEMO_CHECK(mailbox.read(value) && (value == 1));
+
+	// Each value is read once
+	value = 0;
+	FORWARDPLUSDEMO_CHECK((mailbox.read(value) == false) && (value == 0));
+
+	// Older unread values are replaced
+	mailbox.write(2);
+	mailbox.write(3);
+	mailbox.write(4);
+	FORWARDPLUSDEMO_CHECK(mailbox.read(value) && (value == 4));
+	FORWARDPLUSDEMO_CHECK(mailbox.read(value) == false);
+
+	FORWARDPLUSDEMO_CHECK(mailbox.get_write_count() == 4);
+	FORWARDPLUSDEMO_CHECK(mailbox.get_read_count() == 2);
+
+	// Every slot has been through every role by now, the order still holds
+	for (uint32_t current_value = 5; current_value < 20; ++current_value)
+	{
+		mailbox.write(current_value);
+		if ((current_value % 3) == 0)
+		{
+			mailbox.write(current_value * 100);
+			FORWARDPLUSDEMO_CHECK(mailbox.read(value) && (value == current_value * 100));
+		}
+		else
+		{
+			FORWARDPLUSDEMO_CHECK(mailbox.read(value) && (value == current_value));
+		}
+	}
+
+	FORWARDPLUSDEMO_CHECK(mailbox.get_write_count() == 4 + 15 + 5);
+	FORWARDPLUSDEMO_CHECK(mailbox.get_read_count() == 2 + 15);
+}
+
+FORWARDPLUSDEMO_TEST(mailbox, concurrent_values_are_whole_and_in_order)
+{
+	constexpr uint64_t c_write_count = 2000000;
+
+	Mailbox<SequenceValue> mailbox;
+	std::atomic<bool> writer_done = false;
+
+	std::thread writer([&]()
+	{
+		for (uint64_t current_sequence = 1; current_sequence <= c_write_count; ++current_sequence)
+		{
+			mailbox.write(SequenceValue::make(current_sequence));
+		}
+
+		writer_done = true;
+	});
+
+	uint64_t torn_count = 0;
+	uint64_t out_of_order_count = 0;
+	uint64_t last_sequence = 0;
+
+	// Reads after the writer finished may still find its last value
+	SequenceValue value;
+	bool finished = false;
+	while (!finished)
+	{
+		finished = writer_done.load();
+
+		while (mailbox.read(value))
+		{
+			torn_count += value.is_torn() ? 1 : 0;
+			out_of_order_count += (value.fields[0] <= last_sequence) ? 1 : 0;
+			last_sequence = value.fields[0];
+		}
+
+		std::this_thread::yield();
+	}
+
+	writer.join();
+
+	FORWARDPLUSDEMO_CHECK(torn_count == 0);
+	FORWARDPLUSDEMO_CHECK(out_of_order_count == 0);
+
+	// The newest value always gets through
+	FORWARDPLUSDEMO_CHECK(last_sequence == c_write_count);
+	FORWARDPLUSDEMO_CHECK(mailbox.get_write_count() == c_write_count);
+	FORWARDPLUSDEMO_CHECK((mailbox.get_read_count() > 0) && (mailbox.get_read_count() <= c_write_count));
+}
@@ -0,0 +1,103 @@
+#ifndef FORWARDPLUSDEMO_TESTS_UTILITIES_OLDEVENTQUEUE_HPP
+#define FORWARDPLUSDEMO_TESTS_UTILITIES_OLDEVENTQUEUE_HPP
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+namespace ForwardPlusDemo::Testing
+{
+	// The EventQueue & EventDoubleBuffer that EventQueue's chunks & EventRing replaced, kept to benchmark against
+	// A growing vector per queue, the double buffer only swaps once the reader is done
+	namespace Old
+	{
+		class EventQueue
+		{
+		public:
+			struct Header
+			{
+				uint32_t event_id;
+				uint32_t data_size;
+			};
+
+			bool is_empty() const { return m_data.empty(); }
+			size_t get_size() const { return m_data.size(); }
+
+			void clear() { m_data.clear(); }
+
+			// Zero filled
+			char* allocate_raw_data(uint32_t id, size_t size)
+			{
+				const Header event_header = { id, static_cast<uint32_t>(size) };
+				const char* header_begin = reinterpret_cast<const char*>(&event_header);
+				m_data.insert(m_data.end(), header_begin, header_begin + sizeof(Header));
+
+				const size_t data_offset = m_data.size();
+				m_data.insert(m_data.end(), size, char(0));
+				return m_data.data() + data_offset;
+			}
+
+			template<typename T>
+			void write_event(uint32_t id, const T& event)
+			{
+				static_assert(std::is_trivially_copyable_v<T>);
+				std::memcpy(allocate_raw_data(id, sizeof(T)), &event, sizeof(T));
+			}
+
+			class Iterator
+			{
+			public:
+				explicit Iterator(const EventQueue& queue) : m_data_it(queue.m_data.data()), m_data_end(queue.m_data.data() + queue.m_data.size()) {}
+
+				bool is_valid() const { return m_data_it != m_data_end; }
+
+				void advance() { m_data_it += get_header().data_size + sizeof(Header); }
+
+				const Header& get_header() const { return *reinterpret_cast<const Header*>(m_data_it); }
+				const char* get_event_data() const { return m_data_it + sizeof(Header); }
+			private:
+				const char* m_data_it;
+				const char* m_data_end;
+			};
+		private:
+			std::vector<char> m_data;
+		};
+
+		class EventDoubleBuffer
+		{
+		public:
+			EventQueue* get_read_queue() { return m_signal ? m_read_queue : nullptr; }
+			EventQueue* get_write_queue() { return m_write_queue; }
+
+			void dispatch_write()
+			{
+				// Read thread still reading, or nothing to dispatch
+				if (m_signal || m_write_queue->is_empty())
+				{
+					return;
+				}
+
+				std::swap(m_read_queue, m_write_queue);
+				m_write_queue->clear();
+
+				m_signal = true;
+			}
+
+			void finish_read()
+			{
+				if (m_signal)
+				{
+					m_signal = false;
+				}
+			}
+		private:
+			std::array<EventQueue, 2> m_queues;
+			EventQueue* m_read_queue = &m_queues[0];
+			EventQueue* m_write_queue = &m_queues[1];
+			std::atomic<bool> m_signal = false;
+		};
+	}
+}
+#endif
@@ -0,0 +1,416 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Utilities/Profiler.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	// Just enough JSON to read the trace back, parsing fails on anything malformed
+	struct JsonValue
+	{
+		enum class Type { NULL_VALUE, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+
+		Type type = Type::NULL_VALUE;
+		bool boolean = false;
+		double number = 0.0;
+		std::string string;
+		std::vector<JsonValue> array;
+		std::map<std::string, JsonValue> object;
+
+		const JsonValue* find(const char* key) const
+		{
+			const auto member_it = object.find(key);
+			return (member_it != object.end()) ? &member_it->second : nullptr;
+		}
+	};
+
+	class JsonParser
+	{
+	public:
+		explicit JsonParser(const std::string& text) : m_text(text) {}
+
+		// The whole text has to be a single value
+		bool parse(JsonValue& value)
+		{
+			if (!parse_value(value))
+			{
+				return false;
+			}
+
+			skip_whitespace();
+			return m_position == m_text.size();
+		}
+	private:
+		void skip_whitespace()
+		{
+			while ((m_position < m_text.size()) && std::isspace(static_cast<unsigned char>(m_text[m_position])))
+			{
+				++m_position;
+			}
+		}
+
+		bool consume(char expected_char)
+		{
+			skip_whitespace();
+			if ((m_position < m_text.size()) && (m_text[m_position] == expected_char))
+			{
+				++m_position;
+				return true;
+			}
+
+			return false;
+		}
+
+		bool consume_literal(const char* literal)
+		{
+			const std::string_view literal_view(literal);
+			if (m_text.compare(m_position, literal_view.size(), literal_view) != 0)
+			{
+				return false;
+			}
+
+			m_position += literal_view.size();
+			return true;
+		}
+
+		bool parse_string(std::string& string)
+		{
+			if (!consume('"'))
+			{
+				return false;
+			}
+
+			while (m_position < m_text.size())
+			{
+				const char current_char = m_text[m_position++];
+				if (current_char == '"')
+				{
+					return true;
+				}
+
+				if (current_char == '\\')
+				{
+					if (m_position == m_text.size())
+					{
+						return false;
+					}
+
+					// The profiler only escapes quotes & backslashes
+					const char escaped_char = m_text[m_position++];
+					if ((escaped_char != '"') && (escaped_char != '\\'))
+					{
+						return false;
+					}
+
+					string += escaped_char;
+				}
+				else if (static_cast<unsigned char>(current_char) < 0x20)
+				{
+					return false;
+				}
+				else
+				{
+					string += current_char;
+				}
+			}
+
+			return false;
+		}
+
+		bool parse_value(JsonValue& value)
+		{
+			skip_whitespace();
+			if (m_position == m_text.size())
+			{
+				return false;
+			}
+
+			const char first_char = m_text[m_position];
+			if (first_char == '{')
+			{
+				value.type = JsonValue::Type::OBJECT;
+				++m_position;
+				if (consume('}'))
+				{
+					return true;
+				}
+
+				do
+				{
+					std::string key;
+					JsonValue member;
+					if (!parse_string(key) || !consume(':') || !parse_value(member) || !value.object.emplace(std::move(key), std::move(member)).second)
+					{
+						return false;
+					}
+				} while (consume(','));
+
+				return consume('}');
+			}
+
+			if (first_char == '[')
+			{
+				value.type = JsonValue::Type::ARRAY;
+				++m_position;
+				if (consume(']'))
+				{
+					return true;
+				}
+
+				do
+				{
+					if (!parse_value(value.array.emplace_back()))
+					{
+						return false;
+					}
+				} while (consume(','));
+
+				return consume(']');
+			}
+
+			if (first_char == '"')
+			{
+				value.type = JsonValue::Type::STRING;
+				return parse_string(value.string);
+			}
+
+			if (consume_literal("true") || consume_literal("false"))
+			{
+				value.type = JsonValue::Type::BOOL;
+				value.boolean = (first_char == 't');
+				return true;
+			}
+
+			if (consume_literal("null"))
+			{
+				value.type = JsonValue::Type::NULL_VALUE;
+				return true;
+			}
+
+			// strtod takes more than JSON allows (e.g "inf", "nan"), which the trace must not contain
+			if ((first_char != '-') && !std::isdigit(static_cast<unsigned char>(first_char)))
+			{
+				return false;
+			}
+
+			const char* number_begin = m_text.c_str() + m_position;
+			char* number_end = nullptr;
+			value.type = JsonValue::Type::NUMBER;
+			value.number = std::strtod(number_begin, &number_end);
+			m_position += static_cast<size_t>(number_end - number_begin);
+
+			return number_end != number_begin;
+		}
+
+		const std::string& m_text;
+		size_t m_position = 0;
+	};
+
+	struct TraceEvent
+	{
+		std::string name;
+		double begin_time = 0.0;
+		double end_time = 0.0;
+	};
+
+	// Scope names & their nesting depth, unique to this test so events from other code on the profiler don't count
+	const char* const c_frame_scope = "profiler_test::frame";
+	const char* const c_stage_scope = "profiler_test::stage";
+	const char* const c_job_scope = "profiler_test::job";
+
+	constexpr uint32_t c_frame_count = 200;
+	constexpr uint32_t c_stages_per_frame = 3;
+	constexpr uint32_t c_jobs_per_stage = 2;
+
+	// The trace keeps 3 decimals of a microsecond, begin & duration are rounded separately
+	constexpr double c_time_tolerance = 0.002;
+
+	void do_work(uint32_t iteration_count)
+	{
+		volatile uint32_t sum = 0;
+		for (uint32_t current_iteration = 0; current_iteration < iteration_count; ++current_iteration)
+		{
+			sum = sum + current_iteration;
+		}
+	}
+
+	void run_frames(const char* thread_name, std::atomic<uint32_t>& ready_count)
+	{
+		Profiler::set_thread_name(thread_name);
+
+		// Both threads record at the same time
+		ready_count.fetch_add(1);
+		while (ready_count.load() < 2)
+		{
+			std::this_thread::yield();
+		}
+
+		for (uint32_t current_frame = 0; current_frame < c_frame_count; ++current_frame)
+		{
+			const ProfileScope frame_scope(c_frame_scope);
+			for (uint32_t current_stage = 0; current_stage < c_stages_per_frame; ++current_stage)
+			{
+				const ProfileScope stage_scope(c_stage_scope);
+				do_work(100);
+
+				for (uint32_t current_job = 0; current_job < c_jobs_per_stage; ++current_job)
+				{
+					const ProfileScope job_scope(c_job_scope);
+					do_work(200);
+				}
+			}
+		}
+	}
+
+	uint32_t get_scope_depth(const std::string& name)
+	{
+		return (name == c_frame_scope) ? 0 : ((name == c_stage_scope) ? 1 : 2);
+	}
+
+	// Replays a thread's events in begin order, every scope has to end inside the one it began in, at the depth it was opened
+	bool are_scopes_nested(std::vector<TraceEvent> events)
+	{
+		// Outer scope first when two begin together
+		std::sort(events.begin(), events.end(), [](const TraceEvent& a, const TraceEvent& b)
+		{
+			return (a.begin_time != b.begin_time) ? (a.begin_time < b.begin_time) : (a.end_time > b.end_time);
+		});
+
+		std::vector<const TraceEvent*> open_scopes;
+		for (const TraceEvent& current_event : events)
+		{
+			while (!open_scopes.empty() && (open_scopes.back()->end_time <= current_event.begin_time + c_time_tolerance))
+			{
+				open_scopes.pop_back();
+			}
+
+			if ((current_event.end_time < current_event.begin_time) || (open_scopes.size() != get_scope_depth(current_event.name)))
+			{
+				return false;
+			}
+
+			if (!open_scopes.empty() && (current_event.end_time > open_scopes.back()->end_time + c_time_tolerance))
+			{
+				return false;
+			}
+
+			open_scopes.push_back(&current_event);
+		}
+
+		return true;
+	}
+}
+
+FORWARDPLUSDEMO_TEST(profiler, nested_scopes_on_two_threads)
+{
+	// Quotes & backslashes in the names have to be escaped in the JSON
+	const char* const thread_names[] = { "profiler_test \"A\"", "profiler_test \\B\\" };
+
+	std::atomic<uint32_t> ready_count = 0;
+	std::thread first_thread(run_frames, thread_names[0], std::ref(ready_count));
+	std::thread second_thread(run_frames, thread_names[1], std::ref(ready_count));
+	first_thread.join();
+	second_thread.join();
+
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "profiler_test_trace.json";
+	FORWARDPLUSDEMO_CHECK(Profiler::write_chrome_trace(path));
+
+	std::string text;
+	{
+		std::ifstream file(path);
+		text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	std::filesystem::remove(path);
+
+	JsonValue trace;
+	FORWARDPLUSDEMO_CHECK(JsonParser(text).parse(trace));
+
+	const JsonValue* trace_events = trace.find("traceEvents");
+	FORWARDPLUSDEMO_CHECK((trace_events != nullptr) && (trace_events->type == JsonValue::Type::ARRAY));
+	if (trace_events == nullptr)
+	{
+		return;
+	}
+
+	// Thread names come first, one per thread, then its complete events
+	std::map<double, std::string> thread_name_by_id;
+	std::map<double, std::vector<TraceEvent>> events_by_id;
+	uint32_t malformed_event_count = 0;
+
+	for (const JsonValue& current_event : trace_events->array)
+	{
+		const JsonValue* name = current_event.find("name");
+		const JsonValue* phase = current_event.find("ph");
+		const JsonValue* thread_id = current_event.find("tid");
+		if ((name == nullptr) || (name->type != JsonValue::Type::STRING) || (phase == nullptr) || (thread_id == nullptr) || (thread_id->type != JsonValue::Type::NUMBER))
+		{
+			++malformed_event_count;
+			continue;
+		}
+
+		if (phase->string == "M")
+		{
+			const JsonValue* args = current_event.find("args");
+			const JsonValue* thread_name = (args != nullptr) ? args->find("name") : nullptr;
+			if ((name->string != "thread_name") || (thread_name == nullptr) || !thread_name_by_id.emplace(thread_id->number, thread_name->string).second)
+			{
+				++malformed_event_count;
+			}
+		}
+		else if (phase->string == "X")
+		{
+			const JsonValue* begin_time = current_event.find("ts");
+			const JsonValue* duration = current_event.find("dur");
+			if ((begin_time == nullptr) || (begin_time->type != JsonValue::Type::NUMBER) || (duration == nullptr) || (duration->type != JsonValue::Type::NUMBER) || (thread_name_by_id.count(thread_id->number) == 0))
+			{
+				++malformed_event_count;
+				continue;
+			}
+
+			events_by_id[thread_id->number].push_back(TraceEvent{ name->string, begin_time->number, begin_time->number + duration->number });
+		}
+		else
+		{
+			++malformed_event_count;
+		}
+	}
+
+	FORWARDPLUSDEMO_CHECK(malformed_event_count == 0);
+
+	for (const char* current_thread_name : thread_names)
+	{
+		const auto thread_it = std::find_if(thread_name_by_id.begin(), thread_name_by_id.end(), [current_thread_name](const auto& entry) { return entry.second == current_thread_name; });
+		FORWARDPLUSDEMO_CHECK(thread_it != thread_name_by_id.end());
+		if (thread_it == thread_name_by_id.end())
+		{
+			continue;
+		}
+
+		const std::vector<TraceEvent>& events = events_by_id[thread_it->first];
+
+		// Every scope that began also ended, once
+		const auto count_scopes = [&events](const char* name) { return std::count_if(events.begin(), events.end(), [name](const TraceEvent& event) { return event.name == name; }); };
+		FORWARDPLUSDEMO_CHECK(count_scopes(c_frame_scope) == c_frame_count);
+		FORWARDPLUSDEMO_CHECK(count_scopes(c_stage_scope) == c_frame_count * c_stages_per_frame);
+		FORWARDPLUSDEMO_CHECK(count_scopes(c_job_scope) == c_frame_count * c_stages_per_frame * c_jobs_per_stage);
+		FORWARDPLUSDEMO_CHECK(events.size() == c_frame_count * (1 + c_stages_per_frame * (1 + c_jobs_per_stage)));
+
+		FORWARDPLUSDEMO_CHECK(are_scopes_nested(events));
+	}
+}
@@ -0,0 +1,54 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Utilities/Random.hpp>
+#include <ForwardPlusDemo/Utilities/RadixSort.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+// Draw keys (3 types, depths of a 500 m scene, instance index) and fully random keys, radix_sort against std::sort
+FORWARDPLUSDEMO_BENCHMARK(radix_sort_keys)
+{
+	const uint32_t key_count = context.select(1000000u, 10000u);
+
+	Random random(41);
+
+	std::vector<uint64_t> draw_keys(key_count);
+	std::vector<uint64_t> random_keys(key_count);
+	for (uint32_t current_index = 0; current_index < key_count; ++current_index)
+	{
+		// Top 24 bits of floats between 1 and 512
+		const uint64_t type = random.next_uint32(3);
+		const uint64_t depth = 0x3F8000 + random.next_uint32(0x48000);
+		draw_keys[current_index] = (type << 56) | (depth << 32) | current_index;
+
+		random_keys[current_index] = (static_cast<uint64_t>(random.next_uint32()) << 32) | random.next_uint32();
+	}
+
+	std::vector<uint64_t> keys;
+	std::vector<uint64_t> scratch;
+
+	for (const std::vector<uint64_t>* current_input : { &draw_keys, &random_keys })
+	{
+		const double radix_ms = context.time_ms([&]()
+		{
+			keys = *current_input;
+			radix_sort(keys, scratch);
+		});
+
+		const bool radix_sorted = std::is_sorted(keys.begin(), keys.end());
+
+		const double std_ms = context.time_ms([&]()
+		{
+			keys = *current_input;
+			std::sort(keys.begin(), keys.end());
+		});
+
+		context.report("%u %s keys: radix_sort %.2f ms (%.1f ns per key%s), std::sort %.2f ms (%.1f ns per key)\n",
+			key_count, (current_input == &draw_keys) ? "draw" : "random",
+			radix_ms, (radix_ms * 1e6) / key_count, radix_sorted ? "" : ", NOT SORTED",
+			std_ms, (std_ms * 1e6) / key_count);
+	}
+}
@@ -0,0 +1,125 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Utilities/Random.hpp>
+#include <ForwardPlusDemo/Utilities/RadixSort.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	uint64_t get_random_key(Random& random)
+	{
+		return (static_cast<uint64_t>(random.next_uint32()) << 32) | random.next_uint32();
+	}
+
+	// Sorts a copy both ways and compares
+	bool sorts_like_std_sort(const std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch)
+	{
+		std::vector<uint64_t> radix_sorted = keys;
+		radix_sort(radix_sorted, scratch);
+
+		std::vector<uint64_t> std_sorted = keys;
+		std::sort(std_sorted.begin(), std_sorted.end());
+
+		return radix_sorted == std_sorted;
+	}
+}
+
+FORWARDPLUSDEMO_TEST(radix_sort, matches_std_sort)
+{
+	Random random(29);
+	std::vector<uint64_t> scratch;
+
+	for (const uint32_t current_size : { 0u, 1u, 2u, 3u, 255u, 256u, 257u, 10000u, 100000u })
+	{
+		std::vector<uint64_t> keys(current_size);
+		for (uint64_t& current_key : keys)
+		{
+			current_key = get_random_key(random);
+		}
+
+		FORWARDPLUSDEMO_CHECK(sorts_like_std_sort(keys, scratch));
+	}
+
+	// Already sorted, reversed & many duplicates
+	std::vector<uint64_t> keys(5000);
+	for (uint32_t current_index = 0; current_index < keys.size(); ++current_index)
+	{
+		keys[current_index] = current_index * 0x0101010101ull;
+	}
+
+	FORWARDPLUSDEMO_CHECK(sorts_like_std_sort(keys, scratch));
+
+	std::reverse(keys.begin(), keys.end());
+	FORWARDPLUSDEMO_CHECK(sorts_like_std_sort(keys, scratch));
+
+	for (uint64_t& current_key : keys)
+	{
+		current_key = random.next_uint32(4);
+	}
+
+	FORWARDPLUSDEMO_CHECK(sorts_like_std_sort(keys, scratch));
+}
+
+// Passes where all keys share the digit are skipped, so the sorted keys can end up in either buffer
+FORWARDPLUSDEMO_TEST(radix_sort, skipped_passes)
+{
+	Random random(31);
+	std::vector<uint64_t> scratch;
+
+	// Every key equal, no pass runs
+	FORWARDPLUSDEMO_CHECK(sorts_like_std_sort(std::vector<uint64_t>(100, 0x1234567890ABCDEFull), scratch));
+
+	// One to eight varying bytes, each in every position
+	for (uint32_t current_byte_mask = 1; current_byte_mask < 256; current_byte_mask += 7)
+	{
+		std::vector<uint64_t> keys(1000);
+		for (uint64_t& current_key : keys)
+		{
+			current_key = 0xA5A5A5A5A5A5A5A5ull;
+			for (uint32_t current_byte = 0; current_byte < 8; ++current_byte)
+			{
+				if ((current_byte_mask & (1u << current_byte)) != 0)
+				{
+					current_key ^= static_cast<uint64_t>(random.next_uint32(256)) << (current_byte * 8);
+				}
+			}
+		}
+
+		FORWARDPLUSDEMO_CHECK(sorts_like_std_sort(keys, scratch));
+	}
+
+	// Draw key layout: object type, 24 bits of depth and the instance index
+	std::vector<uint64_t> draw_keys(20000);
+	for (uint32_t current_index = 0; current_index < draw_keys.size(); ++current_index)
+	{
+		const uint64_t type = random.next_uint32(3);
+		const uint64_t depth = 0x3F0000 + random.next_uint32(0x20000);
+		draw_keys[current_index] = (type << 56) | (depth << 32) | current_index;
+	}
+
+	FORWARDPLUSDEMO_CHECK(sorts_like_std_sort(draw_keys, scratch));
+}
+
+FORWARDPLUSDEMO_TEST(radix_sort, reuses_scratch)
+{
+	Random random(37);
+
+	// Left over contents & a larger size from a previous sort don't leak into the result
+	std::vector<uint64_t> scratch(50000, UINT64_MAX);
+	std::vector<uint64_t> keys(1000);
+	for (uint64_t& current_key : keys)
+	{
+		current_key = random.next_uint32();
+	}
+
+	FORWARDPLUSDEMO_CHECK(sorts_like_std_sort(keys, scratch));
+
+	std::vector<uint64_t> sorted_keys = keys;
+	radix_sort(sorted_keys, scratch);
+	FORWARDPLUSDEMO_CHECK(sorted_keys.size() == keys.size());
+	FORWARDPLUSDEMO_CHECK(std::is_sorted(sorted_keys.begin(), sorted_keys.end()));
+}
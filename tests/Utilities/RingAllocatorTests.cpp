@@ -0,0 +1,182 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Utilities/Random.hpp>
+#include <ForwardPlusDemo/Utilities/RingAllocator.hpp>
+
+#include <deque>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+FORWARDPLUSDEMO_TEST(ring_allocator, aligned_offsets_in_order)
+{
+	RingAllocator allocator(4096);
+
+	uint32_t offset = UINT32_MAX;
+	FORWARDPLUSDEMO_CHECK(allocator.allocate(100, 256, offset) && (offset == 0));
+	FORWARDPLUSDEMO_CHECK(allocator.allocate(100, 256, offset) && (offset == 256));
+	FORWARDPLUSDEMO_CHECK(allocator.allocate(8, 4, offset) && (offset == 356));
+
+	// Alignment padding counts as used
+	FORWARDPLUSDEMO_CHECK(allocator.get_used_size() == 364);
+	FORWARDPLUSDEMO_CHECK(allocator.get_frame_size() == 364);
+	FORWARDPLUSDEMO_CHECK(allocator.get_head() == 364);
+
+	// Empty & oversized allocations always fail
+	FORWARDPLUSDEMO_CHECK(allocator.allocate(0, 16, offset) == false);
+	FORWARDPLUSDEMO_CHECK(allocator.allocate(4097, 16, offset) == false);
+	FORWARDPLUSDEMO_CHECK(allocator.get_used_size() == 364);
+}
+
+FORWARDPLUSDEMO_TEST(ring_allocator, frames_free_on_their_fence)
+{
+	RingAllocator allocator(1024);
+
+	uint32_t offset = 0;
+	FORWARDPLUSDEMO_CHECK(allocator.allocate(512, 256, offset));
+	allocator.finish_frame(1);
+	FORWARDPLUSDEMO_CHECK(allocator.get_frame_size() == 0);
+
+	FORWARDPLUSDEMO_CHECK(allocator.allocate(512, 256, offset) && (offset == 512));
+	allocator.finish_frame(2);
+
+	// Full until frame 1 completes, an empty frame doesn't need a fence
+	FORWARDPLUSDEMO_CHECK(allocator.allocate(256, 256, offset) == false);
+	allocator.finish_frame(3);
+
+	allocator.release_completed_frames(0);
+	FORWARDPLUSDEMO_CHECK(allocator.get_used_size() == 1024);
+
+	allocator.release_completed_frames(1);
+	FORWARDPLUSDEMO_CHECK(allocator.get_used_size() == 512);
+	FORWARDPLUSDEMO_CHECK(allocator.allocate(256, 256, offset) && (offset == 0));
+
+	// Releasing the same fence again changes nothing, the current frame is not released before it is finished
+	allocator.release_completed_frames(1);
+	allocator.release_completed_frames(2);
+	FORWARDPLUSDEMO_CHECK(allocator.get_used_size() == 256);
+	FORWARDPLUSDEMO_CHECK(allocator.get_frame_size() == 256);
+}
+
+FORWARDPLUSDEMO_TEST(ring_allocator, wraps_without_splitting)
+{
+	RingAllocator allocator(1024);
+
+	uint32_t offset = 0;
+	FORWARDPLUSDEMO_CHECK(allocator.allocate(384, 256, offset) && (offset == 0));
+	allocator.finish_frame(1);
+
+	// Frame 2 owns [384, 896), its alignment padding included
+	FORWARDPLUSDEMO_CHECK(allocator.allocate(384, 256, offset) && (offset == 512));
+	allocator.finish_frame(2);
+	allocator.release_completed_frames(1);
+	FORWARDPLUSDEMO_CHECK(allocator.get_used_size() == 512);
+
+	// 128 bytes left at the end, so this one starts over at zero and the tail becomes padding
+	FORWARDPLUSDEMO_CHECK(allocator.allocate(256, 256, offset) && (offset == 0));
+	FORWARDPLUSDEMO_CHECK(allocator.get_used_size() == 512 + 128 + 256);
+	FORWARDPLUSDEMO_CHECK(allocator.get_frame_size() == 128 + 256);
+
+	// Only [256, 384) is free until frame 2 completes
+	FORWARDPLUSDEMO_CHECK(allocator.allocate(256, 256, offset) == false);
+	FORWARDPLUSDEMO_CHECK(allocator.allocate(128, 128, offset) && (offset == 256));
+	FORWARDPLUSDEMO_CHECK(allocator.get_used_size() == 1024);
+	allocator.finish_frame(3);
+
+	// The padding is freed with the frame that skipped it
+	allocator.release_completed_frames(3);
+	FORWARDPLUSDEMO_CHECK(allocator.get_used_size() == 0);
+
+	// Nothing in flight, so the next allocation starts at zero and can take the whole ring
+	FORWARDPLUSDEMO_CHECK(allocator.allocate(1024, 256, offset) && (offset == 0));
+	FORWARDPLUSDEMO_CHECK(allocator.get_head() == 0);
+}
+
+FORWARDPLUSDEMO_TEST(ring_allocator, reset_drops_frames)
+{
+	RingAllocator allocator(1024);
+
+	uint32_t offset = 0;
+	FORWARDPLUSDEMO_CHECK(allocator.allocate(1000, 8, offset));
+	allocator.finish_frame(1);
+
+	allocator.reset(2048);
+	FORWARDPLUSDEMO_CHECK(allocator.get_capacity() == 2048);
+	FORWARDPLUSDEMO_CHECK(allocator.get_used_size() == 0);
+	FORWARDPLUSDEMO_CHECK(allocator.allocate(2048, 8, offset) && (offset == 0));
+
+	// No stale marker from before the reset frees the new allocation
+	allocator.release_completed_frames(1);
+	FORWARDPLUSDEMO_CHECK(allocator.get_used_size() == 2048);
+}
+
+// Frames of random allocations with the GPU a few frames behind: live allocations must never overlap or cross the end
+FORWARDPLUSDEMO_TEST(ring_allocator, random_frames_never_overlap)
+{
+	constexpr uint32_t c_capacity = 64 * 1024;
+	constexpr uint32_t c_frames_in_flight = 3;
+
+	struct Allocation
+	{
+		uint32_t offset;
+		uint32_t size;
+	};
+
+	RingAllocator allocator(c_capacity);
+	Random random(23);
+
+	std::deque<std::vector<Allocation>> frames_in_flight;
+	std::vector<Allocation> current_frame;
+	uint64_t failed_count = 0;
+
+	for (uint64_t current_fence = 1; current_fence <= 2000; ++current_fence)
+	{
+		const uint32_t allocation_count = random.next_uint32(64);
+		for (uint32_t current_allocation = 0; current_allocation < allocation_count; ++current_allocation)
+		{
+			const uint32_t size = 1 + random.next_uint32(2048);
+			const uint32_t alignment = 1u << random.next_uint32(9);
+
+			uint32_t offset = 0;
+			if (!allocator.allocate(size, alignment, offset))
+			{
+				++failed_count;
+				continue;
+			}
+
+			FORWARDPLUSDEMO_CHECK((offset % alignment) == 0);
+			FORWARDPLUSDEMO_CHECK((static_cast<uint64_t>(offset) + size) <= c_capacity);
+
+			for (const std::vector<Allocation>& current_live_frame : frames_in_flight)
+			{
+				for (const Allocation& current_live : current_live_frame)
+				{
+					FORWARDPLUSDEMO_CHECK(((offset + size) <= current_live.offset) || ((current_live.offset + current_live.size) <= offset));
+				}
+			}
+
+			for (const Allocation& current_live : current_frame)
+			{
+				FORWARDPLUSDEMO_CHECK(((offset + size) <= current_live.offset) || ((current_live.offset + current_live.size) <= offset));
+			}
+
+			current_frame.push_back(Allocation{ offset, size });
+		}
+
+		allocator.finish_frame(current_fence);
+		frames_in_flight.push_back(std::move(current_frame));
+		current_frame.clear();
+
+		if (frames_in_flight.size() > c_frames_in_flight)
+		{
+			allocator.release_completed_frames(current_fence - c_frames_in_flight);
+			frames_in_flight.pop_front();
+		}
+	}
+
+	// Frames average over 32 KB with up to four in flight against a 64 KB ring, so some allocations have to fail
+	FORWARDPLUSDEMO_CHECK(failed_count > 0);
+
+	allocator.release_completed_frames(UINT64_MAX);
+	FORWARDPLUSDEMO_CHECK(allocator.get_used_size() == 0);
+}
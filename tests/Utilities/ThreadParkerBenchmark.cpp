@@ -0,0 +1,124 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Utilities/ThreadParker.hpp>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace ForwardPlusDemo;
+
+namespace
+{
+	// User & kernel time of every thread in the process, in seconds
+	double get_process_cpu_seconds()
+	{
+#ifdef _WIN32
+		FILETIME creation_time;
+		FILETIME exit_time;
+		FILETIME kernel_time;
+		FILETIME user_time;
+		GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time);
+
+		auto to_seconds = [](const FILETIME& time)
+		{
+			return ((static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) * 1e-7;
+		};
+
+		return to_seconds(kernel_time) + to_seconds(user_time);
+#else
+		timespec time;
+		clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+		return time.tv_sec + time.tv_nsec * 1e-9;
+#endif
+	}
+
+	struct IdleResult
+	{
+		double cpu_seconds = 0.0;
+		uint64_t iteration_count = 0;
+	};
+
+	// A paused render thread: checks for events, finds nothing most of the time, until the main thread sends one every wake_interval
+	// The main thread sleeps in between, so nearly all of the CPU time is the idle thread's
+	template<bool t_parked>
+	IdleResult run_idle_loop(std::chrono::milliseconds duration, std::chrono::milliseconds wake_interval)
+	{
+		ThreadParker parker;
+		std::atomic<uint32_t> sent_count = 0;
+		std::atomic<bool> running = true;
+
+		IdleResult result;
+		const double start_cpu_seconds = get_process_cpu_seconds();
+
+		std::thread idle_thread([&]()
+		{
+			uint32_t received_count = 0;
+			while (running.load(std::memory_order_acquire))
+			{
+				const uint32_t token = parker.get_token();
+				++result.iteration_count;
+
+				const uint32_t current_sent_count = sent_count.load(std::memory_order_acquire);
+				if (current_sent_count != received_count)
+				{
+					received_count = current_sent_count;
+					continue;
+				}
+
+				if constexpr (t_parked)
+				{
+					parker.park(token);
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+
+		for (std::chrono::milliseconds elapsed(0); elapsed < duration; elapsed += wake_interval)
+		{
+			std::this_thread::sleep_for(wake_interval);
+			sent_count.fetch_add(1, std::memory_order_release);
+			parker.wake();
+		}
+
+		running.store(false, std::memory_order_release);
+		parker.wake();
+		idle_thread.join();
+
+		result.cpu_seconds = get_process_cpu_seconds() - start_cpu_seconds;
+		return result;
+	}
+}
+
+// CPU used by an idle thread woken at 2 Hz, spinning on yield vs parked on a ThreadParker (the render thread while paused)
+FORWARDPLUSDEMO_BENCHMARK(thread_parker_idle)
+{
+	const std::chrono::milliseconds duration(context.select(3000, 250));
+	const std::chrono::milliseconds wake_interval(context.select(500, 50));
+	const double duration_seconds = duration.count() * 1e-3;
+
+	const IdleResult yield_result = run_idle_loop<false>(duration, wake_interval);
+	const IdleResult parked_result = run_idle_loop<true>(duration, wake_interval);
+
+	// Parked, the thread only runs when woken: once to take the event, once to find nothing left & park again, plus the shutdown wake
+	const uint64_t wake_count = duration / wake_interval;
+	FORWARDPLUSDEMO_CHECK(parked_result.iteration_count <= wake_count * 2 + 2);
+	FORWARDPLUSDEMO_CHECK(parked_result.cpu_seconds < yield_result.cpu_seconds);
+
+	context.report("%.2f s woken at %.0f Hz:", duration_seconds, 1000.0 / wake_interval.count());
+	context.report("yield loop: %.3f s of CPU, %.1f%% of a core, %llu iterations",
+		yield_result.cpu_seconds, yield_result.cpu_seconds * 100.0 / duration_seconds, static_cast<unsigned long long>(yield_result.iteration_count));
+	context.report("parked: %.3f s of CPU, %.1f%% of a core, %llu iterations",
+		parked_result.cpu_seconds, parked_result.cpu_seconds * 100.0 / duration_seconds, static_cast<unsigned long long>(parked_result.iteration_count));
+}
@@ -0,0 +1,115 @@
+#include <TestFramework.hpp>
+
+#include <ForwardPlusDemo/Utilities/ThreadParker.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace ForwardPlusDemo;
+
+// A lost wakeup leaves these tests blocked in park(), CTest fails them on its timeout
+
+FORWARDPLUSDEMO_TEST(thread_parker, wake_before_park_returns)
+{
+	ThreadParker parker;
+
+	// Woken between taking the token & parking, park() doesn't block
+	const uint32_t token = parker.get_token();
+	parker.wake();
+	parker.park(token);
+
+	FORWARDPLUSDEMO_CHECK(parker.get_token() != token);
+
+	// Same with a stale token after several wakes
+	const uint32_t stale_token = parker.get_token();
+	parker.wake_all();
+	parker.wake();
+	parker.park(stale_token);
+
+	FORWARDPLUSDEMO_CHECK(parker.get_token() == stale_token + 2);
+}
+
+FORWARDPLUSDEMO_TEST(thread_parker, park_returns_after_wake)
+{
+	constexpr uint32_t c_round_count = 20000;
+
+	ThreadParker work_parker;
+	ThreadParker done_parker;
+	std::atomic<uint32_t> posted_round = 0;
+	std::atomic<uint32_t> finished_round = 0;
+
+	// Token, check for work, park: the render thread's loop, the work is posted at any point in between
+	std::thread worker([&]()
+	{
+		uint32_t current_round = 0;
+		while (current_round < c_round_count)
+		{
+			const uint32_t token = work_parker.get_token();
+			if (posted_round.load(std::memory_order_acquire) == current_round)
+			{
+				work_parker.park(token);
+				continue;
+			}
+
+			++current_round;
+			finished_round.store(current_round, std::memory_order_release);
+			done_parker.wake();
+		}
+	});
+
+	for (uint32_t current_round = 1; current_round <= c_round_count; ++current_round)
+	{
+		posted_round.store(current_round, std::memory_order_release);
+		work_parker.wake();
+
+		uint32_t token = done_parker.get_token();
+		while (finished_round.load(std::memory_order_acquire) != current_round)
+		{
+			done_parker.park(token);
+			token = done_parker.get_token();
+		}
+	}
+
+	worker.join();
+
+	FORWARDPLUSDEMO_CHECK(finished_round == c_round_count);
+}
+
+FORWARDPLUSDEMO_TEST(thread_parker, wake_all_wakes_every_thread)
+{
+	constexpr uint32_t c_thread_count = 4;
+
+	ThreadParker parker;
+	std::atomic<bool> released = false;
+	std::atomic<uint32_t> woken_count = 0;
+
+	std::vector<std::thread> threads;
+	for (uint32_t current_thread = 0; current_thread < c_thread_count; ++current_thread)
+	{
+		threads.emplace_back([&]()
+		{
+			uint32_t token = parker.get_token();
+			while (!released.load(std::memory_order_acquire))
+			{
+				parker.park(token);
+				token = parker.get_token();
+			}
+
+			woken_count.fetch_add(1, std::memory_order_relaxed);
+		});
+	}
+
+	// Give the threads a chance to park first, a single wake_all has to reach all of them
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	released.store(true, std::memory_order_release);
+	parker.wake_all();
+
+	for (std::thread& current_thread : threads)
+	{
+		current_thread.join();
+	}
+
+	FORWARDPLUSDEMO_CHECK(woken_count == c_thread_count);
+}